@@ -185,7 +185,9 @@ public:
 
 
   /** Allocate the image memory. The size of the image must
-   * already be set, e.g. by calling SetRegions(). */
+   * already be set, e.g. by calling SetRegions(). Unless initializePixels is
+   * true, the values of the pixels are unspecified, so the caller must write
+   * every pixel before reading it; see ImportImageContainer::AllocateElements(). */
   void
   Allocate(bool initializePixels = false) override;
 
@@ -29,7 +29,9 @@
 #define itkImage_hxx
 
 #include "itkProcessObject.h"
+#include "itkNUMASupport.h"
 #include <algorithm>
+#include <type_traits>
 
 namespace itk
 {
@@ -43,6 +45,30 @@ Image<TPixel, VImageDimension>::Allocate(bool initializePixels)
   this->ComputeOffsetTable();
   num = static_cast<SizeValueType>(this->GetOffsetTable()[VImageDimension]);
 
+  // Value-initialization of such pixels is zero-initialization, so the
+  // placement pass may take care of it.
+  if constexpr (std::is_trivially_default_constructible_v<TPixel> && std::is_trivially_copyable_v<TPixel>)
+  {
+    if (NUMASupport::GetGlobalMemoryPolicy() != NUMASupportEnums::MemoryPolicy::Default)
+    {
+      m_Buffer->Reserve(num, false);
+
+      const RegionType & bufferedRegion = this->GetBufferedRegion();
+      ImageIORegion      ioRegion(VImageDimension);
+      for (unsigned int d = 0; d < VImageDimension; ++d)
+      {
+        ioRegion.SetIndex(d, bufferedRegion.GetIndex(d));
+        ioRegion.SetSize(d, bufferedRegion.GetSize(d));
+      }
+      if (!NUMASupport::PlaceBuffer(m_Buffer->GetBufferPointer(), ioRegion, sizeof(TPixel), initializePixels) &&
+          initializePixels)
+      {
+        std::fill_n(m_Buffer->GetBufferPointer(), num, TPixel());
+      }
+      return;
+    }
+  }
+
   m_Buffer->Reserve(num, initializePixels);
 }
 
@@ -0,0 +1,185 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkImageBufferPool_h
+#define itkImageBufferPool_h
+
+#include "itkMacro.h" // for ITKCommon_EXPORT
+#include "itkIntTypes.h"
+#include "itkSingletonMacro.h"
+
+#include <iosfwd>
+
+namespace itk
+{
+
+struct ImageBufferPoolGlobals;
+
+/** \class ImageBufferPool
+ * \brief Global cache of large image buffers that are reused instead of
+ * being returned to the operating system.
+ *
+ * Pipelines that are re-executed many times, such as the filters run for
+ * every level of a multi-resolution registration, allocate and free buffers
+ * of the same sizes over and over. Every new buffer costs page faults and
+ * the kernel zeroing its pages. When the pool is enabled,
+ * ImportImageContainer takes the buffers of trivially constructible
+ * elements from this pool, and gives them back to it when the container
+ * releases its memory, for example through DataObject::ReleaseData().
+ *
+ * Requests are rounded up to one of eight size classes per power of two,
+ * so that buffers of similar size can be reused; at most 12.5% of a buffer
+ * is unused. Buffers smaller than GetMinimumNumberOfBytes() are not pooled.
+ * The total size of idle buffers is limited by SetGlobalMaximumIdleBytes();
+ * buffers released beyond that limit are freed. All members are thread
+ * safe.
+ *
+ * Independent of pooling, every buffer that ImportImageContainer allocates
+ * without value-initialization, such as the outputs allocated by
+ * ImageSource::AllocateOutputs(), can be filled with a poison pattern. Since
+ * pooled buffers hold the pixels of earlier images, this helps to find
+ * filters that read output pixels they have not written.
+ *
+ * Pooling and poisoning are disabled by default. They may also be configured
+ * by the environment variables ITK_IMAGE_BUFFER_POOL (ON/OFF),
+ * ITK_IMAGE_BUFFER_POOL_MAXIMUM_MB and ITK_POISON_UNINITIALIZED_IMAGES (ON/OFF).
+ *
+ * \ingroup OSSystemObjects
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT ImageBufferPool
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(ImageBufferPool);
+  ImageBufferPool() = default;
+  virtual ~ImageBufferPool() = default;
+
+  /** Counters describing the use of the pool since the last call to
+   * ResetStatistics(). */
+  struct Statistics
+  {
+    /** Requests served by a previously released buffer. */
+    SizeValueType NumberOfHits{ 0 };
+    /** Requests that needed a new buffer from the operating system. */
+    SizeValueType NumberOfMisses{ 0 };
+    /** Buffers given back to the pool. */
+    SizeValueType NumberOfReleases{ 0 };
+    /** Released buffers that were freed because the pool was full, disabled or cleared. */
+    SizeValueType NumberOfEvictions{ 0 };
+    /** Bytes currently held by buffers in use. */
+    size_t OutstandingBytes{ 0 };
+    /** Bytes currently held by idle buffers. */
+    size_t IdleBytes{ 0 };
+    /** Maximum of OutstandingBytes + IdleBytes. */
+    size_t PeakBytes{ 0 };
+  };
+
+  /** Set/Get whether ImportImageContainer allocates from the pool. Disabling
+   * the pool frees the idle buffers; buffers in use are still returned to the
+   * pool correctly. */
+  static void
+  SetGlobalEnabled(bool enabled);
+  static bool
+  GetGlobalEnabled();
+
+  /** Set/Get the maximum total size of idle buffers kept by the pool. */
+  static void
+  SetGlobalMaximumIdleBytes(size_t maximumIdleBytes);
+  static size_t
+  GetGlobalMaximumIdleBytes();
+
+  /** Set/Get the alignment of pooled buffers, in bytes. Must be a power of
+   * two; the default is 64, the size of a cache line. */
+  static void
+  SetGlobalAlignment(size_t alignment);
+  static size_t
+  GetGlobalAlignment();
+
+  /** Set/Get whether buffers of at least 2 MiB are aligned to 2 MiB and
+   * advised to be backed by transparent huge pages, reducing TLB misses.
+   * Only has an effect on Linux. */
+  static void
+  SetGlobalUseHugePages(bool useHugePages);
+  static bool
+  GetGlobalUseHugePages();
+
+  /** Set/Get whether buffers of trivially copyable elements that are
+   * allocated without value-initialization are filled with all one bits.
+   * Floating point pixels then read as NaN, and integer pixels as -1 or their
+   * maximum value. Meant for debugging; it costs a pass over each buffer. */
+  static void
+  SetGlobalPoisonUninitialized(bool poison);
+  static bool
+  GetGlobalPoisonUninitialized();
+
+  /** The byte value used for poisoning. */
+  static constexpr unsigned char
+  GetPoisonByte()
+  {
+    return 0xFF;
+  }
+
+  /** Buffers smaller than this are left to the regular allocator. */
+  static constexpr size_t
+  GetMinimumNumberOfBytes()
+  {
+    return size_t{ 1 } << 16;
+  }
+
+  /** Returns an uninitialized buffer of at least numberOfBytes, aligned to at
+   * least minimumAlignment, or nullptr if the pool is disabled or the request
+   * is too small to be pooled. Throws MemoryAllocationError if the memory
+   * cannot be allocated. */
+  static void *
+  Allocate(size_t numberOfBytes, size_t minimumAlignment);
+
+  /** Gives a buffer back to the pool. Returns false, and does nothing, if the
+   * buffer was not obtained from Allocate(). */
+  static bool
+  Release(void * buffer);
+
+  /** Stops tracking a buffer obtained from Allocate() whose ownership is
+   * passed on, for example by ImportImageContainer::ContainerManageMemoryOff().
+   * Release() no longer accepts it, and it must be freed with Free(). Returns
+   * false, and does nothing, if the buffer was not obtained from Allocate(). */
+  static bool
+  Forget(void * buffer);
+
+  /** Frees a buffer passed on by Forget(). Returns false, and does nothing,
+   * if the buffer was not. */
+  static bool
+  Free(void * buffer);
+
+  /** Frees all idle buffers. */
+  static void
+  Clear();
+
+  static Statistics
+  GetStatistics();
+  static void
+  ResetStatistics();
+
+private:
+  itkGetGlobalDeclarationMacro(ImageBufferPoolGlobals, PimplGlobals);
+  static ImageBufferPoolGlobals * m_PimplGlobals;
+};
+
+extern ITKCommon_EXPORT std::ostream &
+                        operator<<(std::ostream & os, const ImageBufferPool::Statistics & statistics);
+} // end namespace itk
+
+#endif
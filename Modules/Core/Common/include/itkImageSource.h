@@ -304,7 +304,14 @@ protected:
    * outputs of a filter. Some filters may want to override this default
    * behavior. For example, a filter may have multiple outputs with
    * varying resolution. Or a filter may want to process data in place by
-   * grafting its input to its output. */
+   * grafting its input to its output.
+   *
+   * The output buffers are not initialized: a filter relying on the default
+   * implementation must write every pixel of the requested region of each
+   * output. Filters that only write some of the pixels must fill the buffer
+   * first, e.g. with FillBuffer(). Enabling
+   * ImageBufferPool::SetGlobalPoisonUninitialized() fills the buffers with
+   * NaN or all-ones values, which helps to detect violations. */
   virtual void
   AllocateOutputs();
 
@@ -154,8 +154,13 @@ public:
    *  is intended to be used by external applications.
    *  Note that the normal logic of this class set the value of the boolean
    *  flag. This may override your setting if you call this methods prematurely.
+   *  A buffer the container allocated from the ImageBufferPool is detached
+   *  from the pool when the container stops managing it. It was not allocated
+   *  by new[], so whoever takes it over must free it with
+   *  ImageBufferPool::Free() rather than delete[].
    *  \warning Improper use of these methods will result in memory leaks */
-  itkSetMacro(ContainerManageMemory, bool);
+  virtual void
+  SetContainerManageMemory(bool manage);
   itkGetConstMacro(ContainerManageMemory, bool);
   itkBooleanMacro(ContainerManageMemory);
 
@@ -171,7 +176,10 @@ protected:
 
   /**
    * Allocates elements of the array.  If UseValueInitialization is true, then
-   * POD types will be zero-initialized.
+   * POD types will be zero-initialized. Otherwise their values are
+   * unspecified; they may hold the pixels of a buffer that was given back to
+   * the ImageBufferPool, or a poison pattern when
+   * ImageBufferPool::GetGlobalPoisonUninitialized() is enabled.
    */
   virtual TElement *
   AllocateElements(ElementIdentifier size, bool UseValueInitialization = false) const;
@@ -203,13 +211,21 @@ protected:
   SetImportPointer(TElement * ptr)
   {
     m_ImportPointer = ptr;
+    m_ImportPointerIsForgotten = false;
   }
 
 private:
+  /** Fills uninitialized elements with the poison pattern, if enabled. */
+  static void
+  PoisonElements(TElement * data, ElementIdentifier size);
+
   TElement *         m_ImportPointer{};
   TElementIdentifier m_Size{};
   TElementIdentifier m_Capacity{};
   bool               m_ContainerManageMemory{ true };
+  // Whether m_ImportPointer was detached from the ImageBufferPool by
+  // SetContainerManageMemory(false), and must be freed by ImageBufferPool::Free.
+  bool m_ImportPointerIsForgotten{ false };
 };
 } // end namespace itk
 
@@ -28,7 +28,11 @@
 #ifndef itkImportImageContainer_hxx
 #define itkImportImageContainer_hxx
 
+#include "itkImageBufferPool.h"
 #include <algorithm> // For copy_n.
+#include <cstring>   // For memset.
+#include <memory>    // For uninitialized_value_construct_n.
+#include <type_traits>
 
 namespace itk
 {
@@ -150,11 +154,48 @@ ImportImageContainer<TElementIdentifier, TElement>::SetImportPointer(TElement *
   this->Modified();
 }
 
+template <typename TElementIdentifier, typename TElement>
+void
+ImportImageContainer<TElementIdentifier, TElement>::SetContainerManageMemory(const bool manage)
+{
+  if (m_ContainerManageMemory != manage)
+  {
+    // A pooled buffer passed on to its new owner is no longer tracked by the
+    // pool, so that a later buffer at the same address is not taken for it.
+    if (!manage && ImageBufferPool::Forget(m_ImportPointer))
+    {
+      m_ImportPointerIsForgotten = true;
+    }
+    m_ContainerManageMemory = manage;
+    this->Modified();
+  }
+}
+
 template <typename TElementIdentifier, typename TElement>
 TElement *
 ImportImageContainer<TElementIdentifier, TElement>::AllocateElements(ElementIdentifier size,
                                                                      bool              UseValueInitialization) const
 {
+  // Buffers of trivial elements may be served by the global pool. These are
+  // recognized and given back to the pool by DeallocateManagedMemory.
+  if constexpr (std::is_trivially_default_constructible_v<TElement> && std::is_trivially_destructible_v<TElement>)
+  {
+    void * const pooled = ImageBufferPool::Allocate(size * sizeof(TElement), alignof(TElement));
+    if (pooled)
+    {
+      auto * const data = static_cast<TElement *>(pooled);
+      if (UseValueInitialization)
+      {
+        std::uninitialized_value_construct_n(data, size);
+      }
+      else
+      {
+        PoisonElements(data, size);
+      }
+      return data;
+    }
+  }
+
   TElement * data;
 
   try
@@ -178,9 +219,26 @@ ImportImageContainer<TElementIdentifier, TElement>::AllocateElements(ElementIden
     // of memory.  Do not use the exception macro.
     throw MemoryAllocationError(__FILE__, __LINE__, "Failed to allocate memory for image.", ITK_LOCATION);
   }
+  if (!UseValueInitialization)
+  {
+    PoisonElements(data, size);
+  }
   return data;
 }
 
+template <typename TElementIdentifier, typename TElement>
+void
+ImportImageContainer<TElementIdentifier, TElement>::PoisonElements(TElement * data, ElementIdentifier size)
+{
+  if constexpr (std::is_trivially_copyable_v<TElement>)
+  {
+    if (ImageBufferPool::GetGlobalPoisonUninitialized())
+    {
+      std::memset(static_cast<void *>(data), ImageBufferPool::GetPoisonByte(), size * sizeof(TElement));
+    }
+  }
+}
+
 template <typename TElementIdentifier, typename TElement>
 void
 ImportImageContainer<TElementIdentifier, TElement>::DeallocateManagedMemory()
@@ -188,9 +246,17 @@ ImportImageContainer<TElementIdentifier, TElement>::DeallocateManagedMemory()
   // Encapsulate all image memory deallocation here
   if (m_ContainerManageMemory)
   {
-    delete[] m_ImportPointer;
+    if (m_ImportPointerIsForgotten)
+    {
+      ImageBufferPool::Free(m_ImportPointer);
+    }
+    else if (!ImageBufferPool::Release(m_ImportPointer))
+    {
+      delete[] m_ImportPointer;
+    }
   }
   m_ImportPointer = nullptr;
+  m_ImportPointerIsForgotten = false;
   m_Capacity = 0;
   m_Size = 0;
 }
@@ -0,0 +1,158 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkNUMASupport_h
+#define itkNUMASupport_h
+
+#include "itkMacro.h" // for ITKCommon_EXPORT
+#include "itkIntTypes.h"
+#include "itkImageIORegion.h"
+#include "itkSingletonMacro.h"
+
+namespace itk
+{
+/** \class NUMASupportEnums
+ * \brief Contains all enum classes used by NUMASupport class.
+ * \ingroup ITKCommon
+ */
+class NUMASupportEnums
+{
+public:
+  /**
+   * \ingroup ITKCommon
+   * Placement of the pages of newly allocated image buffers on
+   * non-uniform memory access (NUMA) machines. */
+  enum class MemoryPolicy : uint8_t
+  {
+    /** Leave placement to the operating system: the pages end up on the
+     * node of the thread that first writes to them, usually the one that
+     * called Allocate(). */
+    Default,
+    /** Touch the pages of the buffer from the worker threads, using the
+     * same region split that multi-threaded filters use, so that every
+     * split of the image resides on the node of the thread processing it. */
+    FirstTouch,
+    /** Spread the pages round-robin over all nodes. Bandwidth is then
+     * independent of which thread processes which split. */
+    Interleave
+  };
+};
+// Define how to print enumeration
+extern ITKCommon_EXPORT std::ostream &
+                        operator<<(std::ostream & out, const NUMASupportEnums::MemoryPolicy value);
+
+/** \class NUMASupport
+ * \brief Opt-in control of memory placement and thread affinity on NUMA machines.
+ *
+ * On multi-socket machines every worker that processes a split of an image
+ * whose pages reside on another socket pays for cross-node bandwidth. The
+ * global memory policy is applied by Image::Allocate() and
+ * VectorImage::Allocate() to newly allocated buffers; see
+ * NUMASupportEnums::MemoryPolicy.
+ *
+ * When thread pinning is enabled, the workers of ThreadPool and
+ * WorkStealingThreadPool, and the threads spawned by PlatformMultiThreader
+ * for work unit i, are bound to one CPU each. CPUs are assigned in order of
+ * their node, so that consecutive work units, which the default splitter
+ * maps to consecutive slabs of the image, share a node. Combined with the
+ * FirstTouch policy and the PlatformMultiThreader, the same split is then
+ * always processed on the node that owns its memory. The pool based
+ * multi-threaders assign work units to workers dynamically, so there the
+ * match is only statistical, but pinned workers at least never migrate
+ * away from the pages they touched.
+ *
+ * Both settings default to off and may also be set by the environment
+ * variables ITK_NUMA_MEMORY_POLICY (Default, FirstTouch or Interleave) and
+ * ITK_NUMA_PIN_THREADS (ON/OFF). Thread pinning is only applied to threads
+ * started after it has been enabled. Both features are implemented for
+ * Linux; elsewhere they are accepted but have no effect.
+ *
+ * \ingroup OSSystemObjects
+ * \ingroup ITKCommon
+ */
+
+struct NUMASupportGlobals;
+
+class ITKCommon_EXPORT NUMASupport
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(NUMASupport);
+  NUMASupport() = default;
+  virtual ~NUMASupport() = default;
+
+  using MemoryPolicyEnum = NUMASupportEnums::MemoryPolicy;
+
+  /** Set/Get the policy applied to newly allocated image buffers. */
+  static void
+  SetGlobalMemoryPolicy(MemoryPolicyEnum policy);
+  static MemoryPolicyEnum
+  GetGlobalMemoryPolicy();
+
+  /** Set/Get whether worker threads are bound to individual CPUs. */
+  static void
+  SetGlobalThreadPinning(bool pinThreads);
+  static bool
+  GetGlobalThreadPinning();
+
+  /** Convert a policy name into its enum type. Returns Default for unknown names. */
+  static MemoryPolicyEnum
+  MemoryPolicyFromString(std::string policyString);
+
+  /** Number of NUMA nodes of this machine, 1 if it cannot be determined. */
+  static unsigned int
+  GetNumberOfNodes();
+
+  /** Binds the calling thread to the CPU assigned to the given worker index,
+   * if thread pinning is enabled. Returns whether the thread was pinned. */
+  static bool
+  PinCurrentThread(ThreadIdType workerIndex);
+
+  /** The CPU assigned to the given worker index, or -1 if thread pinning is
+   * disabled or not supported. */
+  static int
+  GetCPUForWorker(ThreadIdType workerIndex);
+
+  /** Binds the calling thread to the given CPU; does nothing for a negative
+   * CPU. Unlike PinCurrentThread(), it does not access the global settings,
+   * so pool threads can use it even when they only start while the process
+   * is exiting. */
+  static bool
+  PinCurrentThreadToCPU(int cpu);
+
+  /** Requests that the whole pages within [buffer, buffer + numberOfBytes)
+   * are interleaved over all nodes. Must be called before the pages are first
+   * written to. Returns false if this is not supported. */
+  static bool
+  InterleavePages(void * buffer, size_t numberOfBytes);
+
+  /** Applies the global memory policy to a freshly allocated, untouched
+   * buffer holding the pixels of bufferedRegion, each pixelSize bytes large.
+   * The pages are touched in parallel according to the global default
+   * multi-threader and splitter. If zeroInitialize is true, every byte of
+   * the buffer is set to zero, otherwise only one byte per page is rewritten
+   * with its current value.
+   * Returns false if the policy is Default and nothing was done. */
+  static bool
+  PlaceBuffer(void * buffer, const ImageIORegion & bufferedRegion, size_t pixelSize, bool zeroInitialize);
+
+private:
+  itkGetGlobalDeclarationMacro(NUMASupportGlobals, PimplGlobals);
+  static NUMASupportGlobals * m_PimplGlobals;
+};
+} // end namespace itk
+
+#endif
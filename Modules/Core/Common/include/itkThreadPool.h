@@ -166,9 +166,10 @@ private:
   /** To lock on the internal variables */
   static ThreadPoolGlobals * m_PimplGlobals;
 
-  /** The continuously running thread function */
+  /** The continuously running thread function. The thread is bound to the
+   * given CPU, unless it is negative; see NUMASupport::GetCPUForWorker(). */
   static void
-  ThreadExecute();
+  ThreadExecute(int cpu);
 };
 
 } // namespace itk
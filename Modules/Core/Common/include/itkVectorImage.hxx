@@ -28,6 +28,9 @@
 #ifndef itkVectorImage_hxx
 #define itkVectorImage_hxx
 #include "itkProcessObject.h"
+#include "itkNUMASupport.h"
+#include <algorithm>
+#include <type_traits>
 
 namespace itk
 {
@@ -46,6 +49,32 @@ VectorImage<TPixel, VImageDimension>::Allocate(const bool UseValueInitialization
   this->ComputeOffsetTable();
   num = this->GetOffsetTable()[VImageDimension];
 
+  if constexpr (std::is_trivially_default_constructible_v<InternalPixelType> &&
+                std::is_trivially_copyable_v<InternalPixelType>)
+  {
+    if (NUMASupport::GetGlobalMemoryPolicy() != NUMASupportEnums::MemoryPolicy::Default)
+    {
+      m_Buffer->Reserve(num * m_VectorLength, false);
+
+      const RegionType & bufferedRegion = this->GetBufferedRegion();
+      ImageIORegion      ioRegion(VImageDimension);
+      for (unsigned int d = 0; d < VImageDimension; ++d)
+      {
+        ioRegion.SetIndex(d, bufferedRegion.GetIndex(d));
+        ioRegion.SetSize(d, bufferedRegion.GetSize(d));
+      }
+      if (!NUMASupport::PlaceBuffer(m_Buffer->GetBufferPointer(),
+                                    ioRegion,
+                                    sizeof(InternalPixelType) * m_VectorLength,
+                                    UseValueInitialization) &&
+          UseValueInitialization)
+      {
+        std::fill_n(m_Buffer->GetBufferPointer(), num * m_VectorLength, InternalPixelType());
+      }
+      return;
+    }
+  }
+
   m_Buffer->Reserve(num * m_VectorLength, UseValueInitialization);
 }
 
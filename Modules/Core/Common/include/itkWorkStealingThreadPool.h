@@ -0,0 +1,239 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkWorkStealingThreadPool_h
+#define itkWorkStealingThreadPool_h
+
+#include "itkConfigure.h"
+#include "itkIntTypes.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkSingletonMacro.h"
+
+
+namespace itk
+{
+
+/**
+ * \class WorkStealingThreadPool
+ * \brief Thread pool in which every worker owns its own queue of jobs.
+ *
+ * Unlike ThreadPool, which serializes all submissions through one shared
+ * queue and one mutex, every worker of this pool owns a lock-free
+ * Chase-Lev deque. A worker pushes and pops jobs at the bottom of its own
+ * deque, while idle workers steal from the top of a randomly chosen
+ * victim. Jobs submitted by threads that do not belong to the pool are
+ * distributed round-robin over small per-worker inboxes, so concurrent
+ * submitters rarely contend on the same mutex.
+ *
+ * A thread waiting for a job may call ExecutePendingWork() to run other
+ * queued jobs in the meantime (see WaitForFuture()). This makes it safe
+ * to submit work from within a job and to wait for it there: the waiting
+ * worker keeps the pool busy instead of blocking it, so nested
+ * parallelism cannot deadlock.
+ *
+ * Initially the pool is started with GlobalDefaultNumberOfThreads workers.
+ * It is used by the WorkStealingMultiThreader.
+ *
+ * \ingroup OSSystemObjects
+ * \ingroup ITKCommon
+ */
+
+struct WorkStealingThreadPoolGlobals;
+
+class ITKCommon_EXPORT WorkStealingThreadPool : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(WorkStealingThreadPool);
+
+  /** Standard class type aliases. */
+  using Self = WorkStealingThreadPool;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** \see LightObject::GetNameOfClass() */
+  itkOverrideGetNameOfClassMacro(WorkStealingThreadPool);
+
+  /** Returns the global instance */
+  static Pointer
+  New();
+
+  /** Returns the global singleton instance of the WorkStealingThreadPool */
+  static Pointer
+  GetInstance();
+
+  /** Add this job to the thread pool.
+   *
+   * When called from one of the pool's workers, the job is pushed onto that
+   * worker's own deque without taking any lock. Otherwise it is handed to
+   * one of the workers' inboxes. The returned std::future should be waited
+   * on by WaitForFuture() rather than by get() when the caller might itself
+   * be a pool worker. Example usage:
+\code
+auto result = pool->AddWork([](int param) { return param; }, 7);
+pool->WaitForFuture(result);
+std::cout << result.get() << std::endl;
+\endcode
+   */
+  template <class Function, class... Arguments>
+  auto
+  AddWork(Function && function, Arguments &&... arguments) -> std::future<std::invoke_result_t<Function, Arguments...>>
+  {
+    using return_type = std::invoke_result_t<Function, Arguments...>;
+
+    auto task = std::make_shared<std::packaged_task<return_type()>>(
+      [function, arguments...]() -> return_type { return function(arguments...); });
+
+    std::future<return_type> res = task->get_future();
+    this->Submit(new TaskType([task]() { (*task)(); }));
+    return res;
+  }
+
+  /** Runs at most one queued job on the calling thread. Pool workers first
+   * look into their own deque; any thread may steal from the others.
+   * Returns false if no job could be found. */
+  bool
+  ExecutePendingWork();
+
+  /** Blocks until the future is ready, executing other queued jobs while
+   * waiting. The optional callback is invoked roughly every
+   * pollingInterval, e.g. to keep progress reporting alive. */
+  template <class T>
+  void
+  WaitForFuture(const std::future<T> &              future,
+                const std::function<void()> &       callback = {},
+                std::chrono::steady_clock::duration pollingInterval = std::chrono::milliseconds(10))
+  {
+    auto lastCallback = std::chrono::steady_clock::now();
+    while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    {
+      if (!this->ExecutePendingWork())
+      {
+        // Nothing left to help with: the job we wait for is being executed.
+        future.wait_for(std::chrono::microseconds(100));
+      }
+      if (callback && std::chrono::steady_clock::now() - lastCallback >= pollingInterval)
+      {
+        callback();
+        lastCallback = std::chrono::steady_clock::now();
+      }
+    }
+  }
+
+  /** Can call this method if we want to add extra threads to the pool. */
+  void
+  AddThreads(ThreadIdType count);
+
+  ThreadIdType
+  GetMaximumNumberOfThreads() const
+  {
+    return m_NumberOfWorkers.load();
+  }
+
+  /** The approximate number of idle threads. */
+  int
+  GetNumberOfCurrentlyIdleThreads() const;
+
+  /** Returns the index of the calling worker, or -1 if the calling thread
+   * does not belong to this pool. */
+  static int
+  GetCurrentWorkerIndex();
+
+protected:
+  WorkStealingThreadPool();
+
+  /** Stop the pool and release threads. To be called by the destructor and atfork. */
+  void
+  CleanUp();
+
+  ~WorkStealingThreadPool() override;
+
+  static void
+  PrepareForFork();
+  static void
+  ResumeFromFork();
+
+private:
+  using TaskType = std::function<void()>;
+
+  /** Lock-free single-owner, multiple-thief deque of tasks
+   * (Chase and Lev, "Dynamic Circular Work-Stealing Deque", SPAA 2005,
+   * using the C11 memory orderings of Le et al., PPoPP 2013). */
+  class TaskDeque;
+
+  /** Per worker state, padded to a cache line to avoid false sharing. */
+  struct Worker;
+
+  /** Only used to synchronize the global variable across static libraries.*/
+  itkGetGlobalDeclarationMacro(WorkStealingThreadPoolGlobals, PimplGlobals);
+
+  void
+  Submit(TaskType * task);
+
+  TaskType *
+  FindTask(int workerIndex);
+
+  static void
+  Execute(TaskType * task);
+
+  /** Starts the thread of the worker with the given index. */
+  void
+  StartWorker(ThreadIdType workerIndex);
+
+  /** Workers, allocated once for ITK_MAX_THREADS entries so that thieves can
+   * access them without locking while threads are being added. Only the
+   * first m_NumberOfWorkers entries are in use. */
+  std::unique_ptr<std::unique_ptr<Worker>[]> m_Workers;
+  std::atomic<ThreadIdType>                   m_NumberOfWorkers{ 0 };
+
+  /** Jobs submitted, but not yet taken by any thread. May transiently be
+   * off by the number of submissions in flight. */
+  std::atomic<int64_t> m_NumberOfPendingTasks{ 0 };
+
+  /** Idle workers sleep on m_Condition, guarded by m_SleepMutex. */
+  std::atomic<int>        m_NumberOfSleepingWorkers{ 0 };
+  std::mutex              m_SleepMutex;
+  std::condition_variable m_Condition;
+
+  /** Round-robin counter distributing external submissions over inboxes. */
+  std::atomic<unsigned int> m_NextInbox{ 0 };
+
+  /* Has destruction started? */
+  std::atomic<bool> m_Stopping{ false };
+
+  /** To lock on the internal variables */
+  static WorkStealingThreadPoolGlobals * m_PimplGlobals;
+
+  /** The continuously running thread function. The thread is bound to the
+   * given CPU, unless it is negative; see NUMASupport::GetCPUForWorker(). */
+  static void
+  ThreadExecute(ThreadIdType workerIndex, int cpu);
+};
+
+} // namespace itk
+#endif
@@ -0,0 +1,505 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkImageBufferPool.h"
+#include "itkSingleton.h"
+#include "itksys/SystemTools.hxx"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__linux__)
+#  include <sys/mman.h>
+#endif
+
+namespace itk
+{
+
+namespace
+{
+constexpr size_t hugePageSize = size_t{ 2 } << 20;
+
+// Rounds numberOfBytes up to one of eight classes per power of two.
+size_t
+SizeClass(size_t numberOfBytes)
+{
+  size_t powerOfTwo = ImageBufferPool::GetMinimumNumberOfBytes();
+  while (powerOfTwo <= numberOfBytes / 2)
+  {
+    powerOfTwo *= 2;
+  }
+  const size_t step = powerOfTwo / 8;
+  return (numberOfBytes + step - 1) / step * step;
+}
+
+bool
+IsOn(std::string value)
+{
+  value = itksys::SystemTools::UpperCase(value);
+  return !(value.empty() || value == "0" || value == "NO" || value == "OFF" || value == "FALSE");
+}
+} // namespace
+
+struct ImageBufferPoolGlobals
+{
+  struct Buffer
+  {
+    void * m_Pointer;
+    size_t m_NumberOfBytes;
+    size_t m_Alignment;
+  };
+
+  ImageBufferPoolGlobals() = default;
+
+  std::mutex m_Mutex;
+
+  // Whether the environment variables have been examined, see InitializeFromEnvironment.
+  // The flags read on every image allocation are atomic, so that a disabled
+  // pool or poisoning costs no lock once they are initialized.
+  std::atomic<bool> m_IsInitialized{ false };
+  std::atomic<bool> m_Enabled{ false };
+  size_t            m_MaximumIdleBytes{ size_t{ 1 } << 30 };
+  size_t            m_Alignment{ 64 };
+  bool              m_UseHugePages{ false };
+  std::atomic<bool> m_PoisonUninitialized{ false };
+
+  // Set when the globals are destroyed at exit; buffers released later are freed.
+  bool m_IsShutDown{ false };
+
+  // Buffers handed out by Allocate, by address.
+  std::unordered_map<void *, Buffer> m_Outstanding;
+  // Lets Release skip the lock while no pooled buffer is in use.
+  std::atomic<size_t> m_NumberOfOutstanding{ 0 };
+  // Buffers passed on by Forget, by address, until they are freed.
+  std::unordered_map<void *, Buffer> m_Forgotten;
+  // Released buffers, by size class.
+  std::unordered_map<size_t, std::vector<Buffer>> m_Idle;
+
+  ImageBufferPool::Statistics m_Statistics;
+
+  // Must be called with m_Mutex held.
+  void
+  InitializeFromEnvironment()
+  {
+    if (m_IsInitialized.load(std::memory_order_relaxed))
+    {
+      return;
+    }
+    std::string envVar;
+    if (itksys::SystemTools::GetEnv("ITK_IMAGE_BUFFER_POOL", envVar))
+    {
+      m_Enabled = IsOn(envVar);
+    }
+    if (itksys::SystemTools::GetEnv("ITK_POISON_UNINITIALIZED_IMAGES", envVar))
+    {
+      m_PoisonUninitialized = IsOn(envVar);
+    }
+    if (itksys::SystemTools::GetEnv("ITK_IMAGE_BUFFER_POOL_MAXIMUM_MB", envVar))
+    {
+      try
+      {
+        m_MaximumIdleBytes = static_cast<size_t>(std::stoull(envVar)) << 20;
+      }
+      catch (const std::exception &)
+      {
+        // keep the default for malformed values
+      }
+    }
+    m_IsInitialized.store(true, std::memory_order_release);
+  }
+
+  // Initializes the settings from the environment unless already done.
+  void
+  EnsureInitialized()
+  {
+    if (!m_IsInitialized.load(std::memory_order_acquire))
+    {
+      const std::lock_guard<std::mutex> lockGuard(m_Mutex);
+      InitializeFromEnvironment();
+    }
+  }
+
+  // Must be called with m_Mutex held. Moves the idle buffers into evicted,
+  // to be freed after the lock has been released.
+  void
+  TakeIdleBuffers(std::vector<Buffer> & evicted)
+  {
+    for (auto & bucket : m_Idle)
+    {
+      evicted.insert(evicted.end(), bucket.second.begin(), bucket.second.end());
+    }
+    m_Idle.clear();
+    m_Statistics.IdleBytes = 0;
+    m_Statistics.NumberOfEvictions += evicted.size();
+  }
+
+  static void
+  Free(const std::vector<Buffer> & buffers)
+  {
+    for (const auto & buffer : buffers)
+    {
+      ::operator delete(buffer.m_Pointer, std::align_val_t{ buffer.m_Alignment });
+    }
+  }
+};
+
+// Not created by itkGetGlobalSimpleMacro: buffers may be released by static
+// images that are destroyed after the singletons, so at exit only the idle
+// buffers are freed and the bookkeeping itself is kept alive.
+ImageBufferPoolGlobals *
+ImageBufferPool::GetPimplGlobalsPointer()
+{
+  if (m_PimplGlobals == nullptr)
+  {
+    const auto shutDownLambda = []() {
+      std::vector<ImageBufferPoolGlobals::Buffer> evicted;
+      {
+        const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
+        m_PimplGlobals->m_IsShutDown = true;
+        m_PimplGlobals->TakeIdleBuffers(evicted);
+      }
+      ImageBufferPoolGlobals::Free(evicted);
+    };
+    m_PimplGlobals = Singleton<ImageBufferPoolGlobals>("ImageBufferPool", shutDownLambda);
+  }
+  return m_PimplGlobals;
+}
+
+ImageBufferPoolGlobals * ImageBufferPool::m_PimplGlobals;
+
+void
+ImageBufferPool::SetGlobalEnabled(bool enabled)
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  std::vector<ImageBufferPoolGlobals::Buffer> evicted;
+  {
+    const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
+    m_PimplGlobals->InitializeFromEnvironment();
+    m_PimplGlobals->m_Enabled = enabled;
+    if (!enabled)
+    {
+      m_PimplGlobals->TakeIdleBuffers(evicted);
+    }
+  }
+  ImageBufferPoolGlobals::Free(evicted);
+}
+
+bool
+ImageBufferPool::GetGlobalEnabled()
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  m_PimplGlobals->EnsureInitialized();
+  return m_PimplGlobals->m_Enabled.load(std::memory_order_relaxed);
+}
+
+void
+ImageBufferPool::SetGlobalMaximumIdleBytes(size_t maximumIdleBytes)
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  std::vector<ImageBufferPoolGlobals::Buffer> evicted;
+  {
+    const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
+    m_PimplGlobals->InitializeFromEnvironment();
+    m_PimplGlobals->m_MaximumIdleBytes = maximumIdleBytes;
+    if (m_PimplGlobals->m_Statistics.IdleBytes > maximumIdleBytes)
+    {
+      m_PimplGlobals->TakeIdleBuffers(evicted);
+    }
+  }
+  ImageBufferPoolGlobals::Free(evicted);
+}
+
+size_t
+ImageBufferPool::GetGlobalMaximumIdleBytes()
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
+  m_PimplGlobals->InitializeFromEnvironment();
+  return m_PimplGlobals->m_MaximumIdleBytes;
+}
+
+void
+ImageBufferPool::SetGlobalAlignment(size_t alignment)
+{
+  if (alignment == 0 || (alignment & (alignment - 1)) != 0)
+  {
+    itkGenericExceptionMacro("Alignment must be a power of two, not " << alignment);
+  }
+  itkInitGlobalsMacro(PimplGlobals);
+  const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
+  m_PimplGlobals->InitializeFromEnvironment();
+  m_PimplGlobals->m_Alignment = alignment;
+}
+
+size_t
+ImageBufferPool::GetGlobalAlignment()
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
+  m_PimplGlobals->InitializeFromEnvironment();
+  return m_PimplGlobals->m_Alignment;
+}
+
+void
+ImageBufferPool::SetGlobalUseHugePages(bool useHugePages)
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
+  m_PimplGlobals->InitializeFromEnvironment();
+  m_PimplGlobals->m_UseHugePages = useHugePages;
+}
+
+bool
+ImageBufferPool::GetGlobalUseHugePages()
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
+  m_PimplGlobals->InitializeFromEnvironment();
+  return m_PimplGlobals->m_UseHugePages;
+}
+
+void
+ImageBufferPool::SetGlobalPoisonUninitialized(bool poison)
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
+  m_PimplGlobals->InitializeFromEnvironment();
+  m_PimplGlobals->m_PoisonUninitialized = poison;
+}
+
+bool
+ImageBufferPool::GetGlobalPoisonUninitialized()
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  m_PimplGlobals->EnsureInitialized();
+  return m_PimplGlobals->m_PoisonUninitialized.load(std::memory_order_relaxed);
+}
+
+void *
+ImageBufferPool::Allocate(size_t numberOfBytes, size_t minimumAlignment)
+{
+  if (numberOfBytes < GetMinimumNumberOfBytes())
+  {
+    return nullptr;
+  }
+  itkInitGlobalsMacro(PimplGlobals);
+  m_PimplGlobals->EnsureInitialized();
+  if (!m_PimplGlobals->m_Enabled.load(std::memory_order_relaxed))
+  {
+    return nullptr;
+  }
+
+  ImageBufferPoolGlobals::Buffer buffer{ nullptr, SizeClass(numberOfBytes), 0 };
+  bool                           useHugePages;
+  {
+    const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
+    if (!m_PimplGlobals->m_Enabled || m_PimplGlobals->m_IsShutDown)
+    {
+      return nullptr;
+    }
+    useHugePages = m_PimplGlobals->m_UseHugePages && buffer.m_NumberOfBytes >= hugePageSize;
+    buffer.m_Alignment = std::max({ m_PimplGlobals->m_Alignment,
+                                    minimumAlignment,
+                                    useHugePages ? hugePageSize : size_t{ 1 },
+                                    size_t{ __STDCPP_DEFAULT_NEW_ALIGNMENT__ } });
+
+    auto & statistics = m_PimplGlobals->m_Statistics;
+    auto   bucket = m_PimplGlobals->m_Idle.find(buffer.m_NumberOfBytes);
+    if (bucket != m_PimplGlobals->m_Idle.end())
+    {
+      auto & idleBuffers = bucket->second;
+      const auto match = std::find_if(idleBuffers.rbegin(), idleBuffers.rend(), [&buffer](const auto & idle) {
+        return idle.m_Alignment >= buffer.m_Alignment;
+      });
+      if (match != idleBuffers.rend())
+      {
+        buffer = *match;
+        idleBuffers.erase(std::next(match).base());
+        statistics.IdleBytes -= buffer.m_NumberOfBytes;
+        statistics.OutstandingBytes += buffer.m_NumberOfBytes;
+        ++statistics.NumberOfHits;
+        m_PimplGlobals->m_Outstanding.emplace(buffer.m_Pointer, buffer);
+        ++m_PimplGlobals->m_NumberOfOutstanding;
+        return buffer.m_Pointer;
+      }
+    }
+  }
+
+  buffer.m_Pointer = ::operator new(buffer.m_NumberOfBytes, std::align_val_t{ buffer.m_Alignment }, std::nothrow);
+  if (buffer.m_Pointer == nullptr)
+  {
+    // We cannot construct an error string here because we may be out
+    // of memory.  Do not use the exception macro.
+    throw MemoryAllocationError(__FILE__, __LINE__, "Failed to allocate memory for image.", ITK_LOCATION);
+  }
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  if (useHugePages)
+  {
+    madvise(buffer.m_Pointer, buffer.m_NumberOfBytes, MADV_HUGEPAGE);
+  }
+#endif
+
+  const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
+  auto &                            statistics = m_PimplGlobals->m_Statistics;
+  ++statistics.NumberOfMisses;
+  statistics.OutstandingBytes += buffer.m_NumberOfBytes;
+  statistics.PeakBytes = std::max(statistics.PeakBytes, statistics.OutstandingBytes + statistics.IdleBytes);
+  m_PimplGlobals->m_Outstanding.emplace(buffer.m_Pointer, buffer);
+  ++m_PimplGlobals->m_NumberOfOutstanding;
+  return buffer.m_Pointer;
+}
+
+bool
+ImageBufferPool::Release(void * buffer)
+{
+  if (buffer == nullptr)
+  {
+    return false;
+  }
+  itkInitGlobalsMacro(PimplGlobals);
+  if (m_PimplGlobals->m_NumberOfOutstanding == 0)
+  {
+    return false;
+  }
+
+  std::vector<ImageBufferPoolGlobals::Buffer> evicted;
+  {
+    const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
+    const auto                        found = m_PimplGlobals->m_Outstanding.find(buffer);
+    if (found == m_PimplGlobals->m_Outstanding.end())
+    {
+      return false;
+    }
+    const ImageBufferPoolGlobals::Buffer released = found->second;
+    m_PimplGlobals->m_Outstanding.erase(found);
+    --m_PimplGlobals->m_NumberOfOutstanding;
+
+    auto & statistics = m_PimplGlobals->m_Statistics;
+    ++statistics.NumberOfReleases;
+    statistics.OutstandingBytes -= released.m_NumberOfBytes;
+    if (!m_PimplGlobals->m_Enabled || m_PimplGlobals->m_IsShutDown ||
+        statistics.IdleBytes + released.m_NumberOfBytes > m_PimplGlobals->m_MaximumIdleBytes)
+    {
+      ++statistics.NumberOfEvictions;
+      evicted.push_back(released);
+    }
+    else
+    {
+      statistics.IdleBytes += released.m_NumberOfBytes;
+      m_PimplGlobals->m_Idle[released.m_NumberOfBytes].push_back(released);
+    }
+  }
+  ImageBufferPoolGlobals::Free(evicted);
+  return true;
+}
+
+bool
+ImageBufferPool::Forget(void * buffer)
+{
+  if (buffer == nullptr)
+  {
+    return false;
+  }
+  itkInitGlobalsMacro(PimplGlobals);
+  if (m_PimplGlobals->m_NumberOfOutstanding == 0)
+  {
+    return false;
+  }
+
+  const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
+  const auto                        found = m_PimplGlobals->m_Outstanding.find(buffer);
+  if (found == m_PimplGlobals->m_Outstanding.end())
+  {
+    return false;
+  }
+  m_PimplGlobals->m_Statistics.OutstandingBytes -= found->second.m_NumberOfBytes;
+  m_PimplGlobals->m_Forgotten.emplace(buffer, found->second);
+  m_PimplGlobals->m_Outstanding.erase(found);
+  --m_PimplGlobals->m_NumberOfOutstanding;
+  return true;
+}
+
+bool
+ImageBufferPool::Free(void * buffer)
+{
+  if (buffer == nullptr)
+  {
+    return false;
+  }
+  itkInitGlobalsMacro(PimplGlobals);
+  std::vector<ImageBufferPoolGlobals::Buffer> forgotten;
+  {
+    const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
+    const auto                        found = m_PimplGlobals->m_Forgotten.find(buffer);
+    if (found == m_PimplGlobals->m_Forgotten.end())
+    {
+      return false;
+    }
+    forgotten.push_back(found->second);
+    m_PimplGlobals->m_Forgotten.erase(found);
+  }
+  ImageBufferPoolGlobals::Free(forgotten);
+  return true;
+}
+
+void
+ImageBufferPool::Clear()
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  std::vector<ImageBufferPoolGlobals::Buffer> evicted;
+  {
+    const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
+    m_PimplGlobals->TakeIdleBuffers(evicted);
+  }
+  ImageBufferPoolGlobals::Free(evicted);
+}
+
+ImageBufferPool::Statistics
+ImageBufferPool::GetStatistics()
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
+  return m_PimplGlobals->m_Statistics;
+}
+
+void
+ImageBufferPool::ResetStatistics()
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
+  auto & statistics = m_PimplGlobals->m_Statistics;
+  statistics.NumberOfHits = 0;
+  statistics.NumberOfMisses = 0;
+  statistics.NumberOfReleases = 0;
+  statistics.NumberOfEvictions = 0;
+  statistics.PeakBytes = statistics.OutstandingBytes + statistics.IdleBytes;
+}
+
+std::ostream &
+operator<<(std::ostream & os, const ImageBufferPool::Statistics & statistics)
+{
+  return os << "Hits: " << statistics.NumberOfHits << ", Misses: " << statistics.NumberOfMisses
+            << ", Releases: " << statistics.NumberOfReleases << ", Evictions: " << statistics.NumberOfEvictions
+            << ", OutstandingBytes: " << statistics.OutstandingBytes << ", IdleBytes: " << statistics.IdleBytes
+            << ", PeakBytes: " << statistics.PeakBytes;
+}
+
+} // end namespace itk
@@ -30,6 +30,7 @@
 
 #if defined(ITK_USE_POOL_MULTI_THREADER)
 #  include "itkPoolMultiThreader.h"
+#  include "itkWorkStealingMultiThreader.h"
 #endif
 #include "itkNumericTraits.h"
 #include <mutex>
@@ -39,6 +40,7 @@
 #include "itkImageSourceCommon.h"
 #include "itkSingleton.h"
 #include "itkProcessObject.h"
+#include "itkNUMASupport.h"
 
 #include <algorithm> // For clamp.
 #include <iostream>
@@ -207,6 +209,10 @@ MultiThreaderBase::ThreaderTypeFromString(std::string threaderString)
   {
     return ThreaderEnum::TBB;
   }
+  else if (threaderString == "WORKSTEALING")
+  {
+    return ThreaderEnum::WorkStealing;
+  }
   else
   {
     return ThreaderEnum::Unknown;
@@ -404,6 +410,12 @@ MultiThreaderBase::New()
         return TBBMultiThreader::New();
 #else
         itkGenericExceptionMacro("ITK has been built without TBB support!");
+#endif
+      case ThreaderEnum::WorkStealing:
+#if defined(ITK_USE_POOL_MULTI_THREADER)
+        return WorkStealingMultiThreader::New();
+#else
+        itkGenericExceptionMacro("ITK has been built without WorkStealingMultiThreader support!");
 #endif
       default:
         itkGenericExceptionMacro("MultiThreaderBase::GetGlobalDefaultThreader returned Unknown!");
@@ -428,6 +440,9 @@ MultiThreaderBase::SingleMethodProxy(void * arg)
   // grab the WorkUnitInfo originally prescribed
   auto * workUnitInfoStruct = static_cast<MultiThreaderBase::WorkUnitInfo *>(arg);
 
+  // the thread was spawned for this work unit only, so keep the work unit on the same CPU
+  NUMASupport::PinCurrentThread(workUnitInfoStruct->WorkUnitID);
+
   // execute the user specified threader callback, catching any exceptions
   try
   {
@@ -602,6 +617,8 @@ operator<<(std::ostream & out, const MultiThreaderBaseEnums::Threader value)
         return "itk::MultiThreaderBaseEnums::Threader::Pool";
       case MultiThreaderBaseEnums::Threader::TBB:
         return "itk::MultiThreaderBaseEnums::Threader::TBB";
+      case MultiThreaderBaseEnums::Threader::WorkStealing:
+        return "itk::MultiThreaderBaseEnums::Threader::WorkStealing";
         //      TODO    case MultiThreaderBaseEnums::Threader::Last:
         //                    return "itk::MultiThreaderBaseEnums::Threader::Last";
       case MultiThreaderBaseEnums::Threader::Unknown:
@@ -0,0 +1,421 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkNUMASupport.h"
+#include "itkMultiThreaderBase.h"
+#include "itkSingleton.h"
+#include "itksys/SystemTools.hxx"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+#if defined(ITK_HAS_SCHED_GETAFFINITY)
+#  include <sched.h>
+#endif
+#if defined(__linux__)
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#endif
+
+namespace itk
+{
+
+namespace
+{
+// Buffers smaller than this are not worth a parallel pass.
+constexpr size_t minimumNumberOfBytesToPlace = size_t{ 1 } << 20;
+
+#if defined(__linux__)
+constexpr int mpolInterleave = 3; // MPOL_INTERLEAVE from <linux/mempolicy.h>
+
+// Parses a kernel CPU list such as "0-3,8,10-11".
+std::vector<int>
+ParseCPUList(const std::string & list)
+{
+  std::vector<int>  cpus;
+  std::stringstream stream(list);
+  std::string       item;
+  while (std::getline(stream, item, ','))
+  {
+    const auto dash = item.find('-');
+    try
+    {
+      const int first = std::stoi(item.substr(0, dash));
+      const int last = (dash == std::string::npos) ? first : std::stoi(item.substr(dash + 1));
+      for (int cpu = first; cpu <= last; ++cpu)
+      {
+        cpus.push_back(cpu);
+      }
+    }
+    catch (const std::exception &)
+    {
+      // ignore malformed items
+    }
+  }
+  return cpus;
+}
+#endif
+} // namespace
+
+struct NUMASupportGlobals
+{
+  NUMASupportGlobals() = default;
+
+  std::mutex m_Mutex;
+
+  // Whether the environment variables have been examined, see
+  // InitializeFromEnvironment. The settings are atomic, so that once they are
+  // initialized, Image::Allocate() and the pool threads read them without
+  // taking m_Mutex.
+  std::atomic<bool>                           m_IsInitialized{ false };
+  std::atomic<NUMASupportEnums::MemoryPolicy> m_MemoryPolicy{ NUMASupportEnums::MemoryPolicy::Default };
+  std::atomic<bool>                           m_PinThreads{ false };
+
+  // CPUs this process may run on, ordered by node; computed on first use.
+  bool             m_TopologyIsKnown{ false };
+  std::vector<int> m_CPUsByNode;
+  unsigned int     m_NumberOfNodes{ 1 };
+
+  // Must be called with m_Mutex held.
+  void
+  InitializeFromEnvironment()
+  {
+    if (m_IsInitialized.load(std::memory_order_relaxed))
+    {
+      return;
+    }
+    std::string envVar;
+    if (itksys::SystemTools::GetEnv("ITK_NUMA_MEMORY_POLICY", envVar))
+    {
+      m_MemoryPolicy = NUMASupport::MemoryPolicyFromString(envVar);
+    }
+    if (itksys::SystemTools::GetEnv("ITK_NUMA_PIN_THREADS", envVar))
+    {
+      envVar = itksys::SystemTools::UpperCase(envVar);
+      m_PinThreads = !(envVar.empty() || envVar == "0" || envVar == "NO" || envVar == "OFF" || envVar == "FALSE");
+    }
+    m_IsInitialized.store(true, std::memory_order_release);
+  }
+
+  // Initializes the settings from the environment unless already done.
+  void
+  EnsureInitialized()
+  {
+    if (!m_IsInitialized.load(std::memory_order_acquire))
+    {
+      const std::lock_guard<std::mutex> lockGuard(m_Mutex);
+      InitializeFromEnvironment();
+    }
+  }
+
+  // Must be called with m_Mutex held.
+  void
+  InitializeTopology()
+  {
+    if (m_TopologyIsKnown)
+    {
+      return;
+    }
+    m_TopologyIsKnown = true;
+
+#if defined(__linux__)
+    unsigned int node = 0;
+    for (;; ++node)
+    {
+      std::ifstream cpuList("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+      if (!cpuList)
+      {
+        break;
+      }
+      std::string line;
+      std::getline(cpuList, line);
+      for (const int cpu : ParseCPUList(line))
+      {
+        m_CPUsByNode.push_back(cpu);
+      }
+    }
+    m_NumberOfNodes = std::max(1u, node);
+#endif
+
+#if defined(ITK_HAS_SCHED_GETAFFINITY)
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0)
+    {
+      if (m_CPUsByNode.empty())
+      {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+        {
+          m_CPUsByNode.push_back(cpu);
+        }
+      }
+      const auto isNotAllowed = [&allowed](int cpu) { return cpu >= CPU_SETSIZE || !CPU_ISSET(cpu, &allowed); };
+      m_CPUsByNode.erase(std::remove_if(m_CPUsByNode.begin(), m_CPUsByNode.end(), isNotAllowed), m_CPUsByNode.end());
+    }
+#endif
+  }
+};
+
+itkGetGlobalSimpleMacro(NUMASupport, NUMASupportGlobals, PimplGlobals);
+
+NUMASupportGlobals * NUMASupport::m_PimplGlobals;
+
+void
+NUMASupport::SetGlobalMemoryPolicy(MemoryPolicyEnum policy)
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
+  m_PimplGlobals->InitializeFromEnvironment();
+  m_PimplGlobals->m_MemoryPolicy = policy;
+}
+
+NUMASupport::MemoryPolicyEnum
+NUMASupport::GetGlobalMemoryPolicy()
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  m_PimplGlobals->EnsureInitialized();
+  return m_PimplGlobals->m_MemoryPolicy.load(std::memory_order_relaxed);
+}
+
+void
+NUMASupport::SetGlobalThreadPinning(bool pinThreads)
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
+  m_PimplGlobals->InitializeFromEnvironment();
+  m_PimplGlobals->m_PinThreads = pinThreads;
+}
+
+bool
+NUMASupport::GetGlobalThreadPinning()
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  m_PimplGlobals->EnsureInitialized();
+  return m_PimplGlobals->m_PinThreads.load(std::memory_order_relaxed);
+}
+
+NUMASupport::MemoryPolicyEnum
+NUMASupport::MemoryPolicyFromString(std::string policyString)
+{
+  policyString = itksys::SystemTools::UpperCase(policyString);
+  if (policyString == "FIRSTTOUCH")
+  {
+    return MemoryPolicyEnum::FirstTouch;
+  }
+  if (policyString == "INTERLEAVE")
+  {
+    return MemoryPolicyEnum::Interleave;
+  }
+  return MemoryPolicyEnum::Default;
+}
+
+unsigned int
+NUMASupport::GetNumberOfNodes()
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
+  m_PimplGlobals->InitializeTopology();
+  return m_PimplGlobals->m_NumberOfNodes;
+}
+
+bool
+NUMASupport::PinCurrentThread(ThreadIdType workerIndex)
+{
+  return PinCurrentThreadToCPU(GetCPUForWorker(workerIndex));
+}
+
+int
+NUMASupport::GetCPUForWorker(ThreadIdType workerIndex)
+{
+  if (!GetGlobalThreadPinning())
+  {
+    return -1;
+  }
+#if defined(ITK_HAS_SCHED_GETAFFINITY)
+  const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
+  m_PimplGlobals->InitializeTopology();
+  if (m_PimplGlobals->m_CPUsByNode.empty())
+  {
+    return -1;
+  }
+  return m_PimplGlobals->m_CPUsByNode[workerIndex % m_PimplGlobals->m_CPUsByNode.size()];
+#else
+  (void)workerIndex;
+  return -1;
+#endif
+}
+
+bool
+NUMASupport::PinCurrentThreadToCPU(int cpu)
+{
+  if (cpu < 0)
+  {
+    return false;
+  }
+#if defined(ITK_HAS_SCHED_GETAFFINITY)
+  cpu_set_t cpuSet;
+  CPU_ZERO(&cpuSet);
+  CPU_SET(cpu, &cpuSet);
+  return sched_setaffinity(0, sizeof(cpuSet), &cpuSet) == 0;
+#else
+  return false;
+#endif
+}
+
+bool
+NUMASupport::InterleavePages(void * buffer, size_t numberOfBytes)
+{
+#if defined(__linux__) && defined(SYS_mbind)
+  const unsigned int numberOfNodes = GetNumberOfNodes();
+  if (numberOfNodes < 2)
+  {
+    return false;
+  }
+  const auto pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+  const auto begin = (reinterpret_cast<uintptr_t>(buffer) + pageSize - 1) & ~(pageSize - 1);
+  const auto end = (reinterpret_cast<uintptr_t>(buffer) + numberOfBytes) & ~(pageSize - 1);
+  if (end <= begin)
+  {
+    return false;
+  }
+
+  constexpr unsigned int bitsPerWord = 8 * sizeof(unsigned long);
+  std::vector<unsigned long> nodeMask((numberOfNodes + bitsPerWord - 1) / bitsPerWord, 0);
+  for (unsigned int node = 0; node < numberOfNodes; ++node)
+  {
+    nodeMask[node / bitsPerWord] |= 1ul << (node % bitsPerWord);
+  }
+  return syscall(SYS_mbind,
+                 reinterpret_cast<void *>(begin),
+                 static_cast<unsigned long>(end - begin),
+                 mpolInterleave,
+                 nodeMask.data(),
+                 static_cast<unsigned long>(nodeMask.size() * bitsPerWord + 1),
+                 0u) == 0;
+#else
+  (void)buffer;
+  (void)numberOfBytes;
+  return false;
+#endif
+}
+
+bool
+NUMASupport::PlaceBuffer(void * buffer, const ImageIORegion & bufferedRegion, size_t pixelSize, bool zeroInitialize)
+{
+  const MemoryPolicyEnum policy = GetGlobalMemoryPolicy();
+  const size_t           numberOfBytes = bufferedRegion.GetNumberOfPixels() * pixelSize;
+  if (policy == MemoryPolicyEnum::Default || numberOfBytes < minimumNumberOfBytesToPlace)
+  {
+    return false;
+  }
+
+  if (policy == MemoryPolicyEnum::Interleave)
+  {
+    InterleavePages(buffer, numberOfBytes);
+  }
+
+  // Touch the pages using the same split of the region as the filters do.
+  const unsigned int          dimension = bufferedRegion.GetImageDimension();
+  std::vector<IndexValueType> index(dimension);
+  std::vector<SizeValueType>  size(dimension);
+  std::vector<size_t>         strides(dimension);
+  size_t                      stride = pixelSize;
+  for (unsigned int d = 0; d < dimension; ++d)
+  {
+    index[d] = bufferedRegion.GetIndex(d);
+    size[d] = bufferedRegion.GetSize(d);
+    strides[d] = stride;
+    stride *= size[d];
+  }
+
+#if defined(__linux__)
+  const auto pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#else
+  constexpr size_t pageSize = 4096;
+#endif
+  auto * const bytes = static_cast<unsigned char *>(buffer);
+
+  const MultiThreaderBase::Pointer threader = MultiThreaderBase::New();
+  threader->ParallelizeImageRegion(
+    dimension,
+    index.data(),
+    size.data(),
+    [&](const IndexValueType splitIndex[], const SizeValueType splitSize[]) {
+      const size_t  runLength = splitSize[0] * pixelSize;
+      SizeValueType numberOfRuns = 1;
+      for (unsigned int d = 1; d < dimension; ++d)
+      {
+        numberOfRuns *= splitSize[d];
+      }
+      for (SizeValueType run = 0; run < numberOfRuns; ++run)
+      {
+        // Offset of the first pixel of this run within the buffer.
+        size_t        offset = (splitIndex[0] - index[0]) * pixelSize;
+        SizeValueType remainder = run;
+        for (unsigned int d = 1; d < dimension; ++d)
+        {
+          offset += (splitIndex[d] - index[d] + remainder % splitSize[d]) * strides[d];
+          remainder /= splitSize[d];
+        }
+        unsigned char * const begin = bytes + offset;
+        if (zeroInitialize)
+        {
+          std::memset(begin, 0, runLength);
+        }
+        else
+        {
+          // Rewrite the current value, so that a poison fill (see
+          // ImageBufferPool::SetGlobalPoisonUninitialized) is preserved.
+          volatile unsigned char * const page = begin;
+          page[0] = page[0];
+          const size_t firstPage = (pageSize - reinterpret_cast<uintptr_t>(begin) % pageSize) % pageSize;
+          for (size_t i = firstPage; i < runLength; i += pageSize)
+          {
+            page[i] = page[i];
+          }
+        }
+      }
+    },
+    nullptr);
+  return true;
+}
+
+/** Print enum values */
+std::ostream &
+operator<<(std::ostream & out, const NUMASupportEnums::MemoryPolicy value)
+{
+  return out << [value] {
+    switch (value)
+    {
+      case NUMASupportEnums::MemoryPolicy::Default:
+        return "itk::NUMASupportEnums::MemoryPolicy::Default";
+      case NUMASupportEnums::MemoryPolicy::FirstTouch:
+        return "itk::NUMASupportEnums::MemoryPolicy::FirstTouch";
+      case NUMASupportEnums::MemoryPolicy::Interleave:
+        return "itk::NUMASupportEnums::MemoryPolicy::Interleave";
+      default:
+        return "INVALID VALUE FOR itk::NUMASupportEnums::MemoryPolicy";
+    }
+  }();
+}
+
+} // end namespace itk
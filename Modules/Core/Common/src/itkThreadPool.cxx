@@ -23,6 +23,7 @@
 #include "itkNumericTraits.h"
 #include "itkMultiThreaderBase.h"
 #include "itkSingleton.h"
+#include "itkNUMASupport.h"
 
 #include <algorithm>
 #include <atomic>
@@ -115,7 +116,7 @@ ThreadPool::ThreadPool()
   m_Threads.reserve(threadCount);
   for (ThreadIdType i = 0; i < threadCount; ++i)
   {
-    m_Threads.emplace_back(&ThreadPool::ThreadExecute);
+    m_Threads.emplace_back(&ThreadPool::ThreadExecute, NUMASupport::GetCPUForWorker(i));
   }
 }
 
@@ -123,10 +124,11 @@ void
 ThreadPool::AddThreads(ThreadIdType count)
 {
   const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
+  const auto first = static_cast<ThreadIdType>(m_Threads.size());
   m_Threads.reserve(m_Threads.size() + count);
-  for (ThreadIdType i = 0; i < count; ++i)
+  for (ThreadIdType i = first; i < first + count; ++i)
   {
-    m_Threads.emplace_back(&ThreadPool::ThreadExecute);
+    m_Threads.emplace_back(&ThreadPool::ThreadExecute, NUMASupport::GetCPUForWorker(i));
   }
 }
 
@@ -187,10 +189,11 @@ ThreadPool::ResumeFromFork()
 }
 
 void
-ThreadPool::ThreadExecute()
+ThreadPool::ThreadExecute(int cpu)
 {
   // plain pointer does not increase reference count
   ThreadPool * threadPool = m_PimplGlobals->m_ThreadPoolInstance.GetPointer();
+  NUMASupport::PinCurrentThreadToCPU(cpu);
 
   while (true)
   {
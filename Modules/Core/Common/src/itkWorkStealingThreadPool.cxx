@@ -0,0 +1,504 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkWorkStealingThreadPool.h"
+#include "itkThreadPool.h"
+#include "itkThreadSupport.h"
+#include "itkMultiThreaderBase.h"
+#include "itkSingleton.h"
+#include "itkNUMASupport.h"
+
+#include <algorithm>
+#include <cassert>
+#include <deque>
+#include <random>
+#include <vector>
+
+
+namespace itk
+{
+
+namespace
+{
+// Index of the pool worker running on this thread, -1 for other threads.
+thread_local int tlWorkerIndex = -1;
+
+// Number of times an idle worker yields before it goes to sleep. Fine-grained
+// jobs tend to be submitted in bursts, so a short spin avoids most of the
+// wake-up latency of the condition variable.
+constexpr unsigned int idleSpinCount = 64;
+
+unsigned int
+RandomVictimOffset()
+{
+  thread_local std::minstd_rand generator(
+    static_cast<std::minstd_rand::result_type>(std::hash<std::thread::id>{}(std::this_thread::get_id()) | 1));
+  return static_cast<unsigned int>(generator());
+}
+} // namespace
+
+struct WorkStealingThreadPoolGlobals
+{
+  WorkStealingThreadPoolGlobals() = default;
+
+  // To serialize the addition of workers.
+  std::mutex m_Mutex;
+
+  // To allow singleton creation of WorkStealingThreadPool.
+  std::once_flag m_ThreadPoolOnceFlag;
+
+  // The singleton instance of WorkStealingThreadPool.
+  WorkStealingThreadPool::Pointer m_ThreadPoolInstance;
+};
+
+
+class WorkStealingThreadPool::TaskDeque
+{
+public:
+  TaskDeque()
+  {
+    m_Arrays.emplace_back(std::make_unique<Array>(initialCapacity));
+    m_Array.store(m_Arrays.back().get(), std::memory_order_relaxed);
+  }
+
+  ~TaskDeque()
+  {
+    while (TaskType * task = this->Pop())
+    {
+      delete task;
+    }
+  }
+
+  /** Only to be called by the owner. */
+  void
+  Push(TaskType * task)
+  {
+    const int64_t bottom = m_Bottom.load(std::memory_order_relaxed);
+    const int64_t top = m_Top.load(std::memory_order_acquire);
+    Array *       array = m_Array.load(std::memory_order_relaxed);
+    if (bottom - top > array->Capacity - 1)
+    {
+      // Thieves may still read from the old array, so it is retired rather than deleted.
+      m_Arrays.emplace_back(array->Grow(bottom, top));
+      array = m_Arrays.back().get();
+      m_Array.store(array, std::memory_order_release);
+    }
+    array->Put(bottom, task);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+  }
+
+  /** Only to be called by the owner. Takes the most recently pushed task. */
+  TaskType *
+  Pop()
+  {
+    const int64_t bottom = m_Bottom.load(std::memory_order_relaxed) - 1;
+    Array *       array = m_Array.load(std::memory_order_relaxed);
+    m_Bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = m_Top.load(std::memory_order_relaxed);
+
+    TaskType * task = nullptr;
+    if (top <= bottom)
+    {
+      task = array->Get(bottom);
+      if (top == bottom)
+      {
+        // Last element: race against the thieves.
+        if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+          task = nullptr;
+        }
+        m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+      }
+    }
+    else
+    {
+      m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return task;
+  }
+
+  /** May be called by any thread. Takes the oldest task. Returns nullptr
+   * if the deque is empty or if another thread won the race for the task. */
+  TaskType *
+  Steal()
+  {
+    int64_t top = m_Top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t bottom = m_Bottom.load(std::memory_order_acquire);
+
+    if (top < bottom)
+    {
+      const Array * array = m_Array.load(std::memory_order_acquire);
+      TaskType *    task = array->Get(top);
+      if (m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+      {
+        return task;
+      }
+    }
+    return nullptr;
+  }
+
+private:
+  static constexpr int64_t initialCapacity = 256;
+
+  struct Array
+  {
+    explicit Array(int64_t capacity)
+      : Capacity(capacity)
+      , Buffer(std::make_unique<std::atomic<TaskType *>[]>(static_cast<size_t>(capacity)))
+    {}
+
+    TaskType *
+    Get(int64_t i) const
+    {
+      return Buffer[static_cast<size_t>(i & (Capacity - 1))].load(std::memory_order_relaxed);
+    }
+
+    void
+    Put(int64_t i, TaskType * task)
+    {
+      Buffer[static_cast<size_t>(i & (Capacity - 1))].store(task, std::memory_order_relaxed);
+    }
+
+    std::unique_ptr<Array>
+    Grow(int64_t bottom, int64_t top) const
+    {
+      auto grown = std::make_unique<Array>(2 * Capacity);
+      for (int64_t i = top; i < bottom; ++i)
+      {
+        grown->Put(i, this->Get(i));
+      }
+      return grown;
+    }
+
+    const int64_t                              Capacity; // always a power of two
+    std::unique_ptr<std::atomic<TaskType *>[]> Buffer;
+  };
+
+  alignas(64) std::atomic<int64_t> m_Top{ 0 };
+  alignas(64) std::atomic<int64_t> m_Bottom{ 0 };
+  std::atomic<Array *> m_Array{ nullptr };
+
+  // The current and all retired arrays, only accessed by the owner.
+  std::vector<std::unique_ptr<Array>> m_Arrays;
+};
+
+
+struct alignas(64) WorkStealingThreadPool::Worker
+{
+  TaskDeque Deque;
+
+  // Tasks submitted by threads outside of the pool.
+  std::mutex             InboxMutex;
+  std::deque<TaskType *> Inbox;
+  std::atomic<size_t>    InboxSize{ 0 };
+
+  std::thread Thread;
+
+  TaskType *
+  TakeFromInbox(bool wait)
+  {
+    if (InboxSize.load(std::memory_order_relaxed) == 0)
+    {
+      return nullptr;
+    }
+    std::unique_lock<std::mutex> lock(InboxMutex, std::defer_lock);
+    if (wait)
+    {
+      lock.lock();
+    }
+    else if (!lock.try_lock())
+    {
+      return nullptr;
+    }
+    if (Inbox.empty())
+    {
+      return nullptr;
+    }
+    TaskType * task = Inbox.front();
+    Inbox.pop_front();
+    --InboxSize;
+    return task;
+  }
+};
+
+
+itkGetGlobalSimpleMacro(WorkStealingThreadPool, WorkStealingThreadPoolGlobals, PimplGlobals);
+
+WorkStealingThreadPool::Pointer
+WorkStealingThreadPool::New()
+{
+  return Self::GetInstance();
+}
+
+
+WorkStealingThreadPool::Pointer
+WorkStealingThreadPool::GetInstance()
+{
+  // This is called once, on-demand to ensure that m_PimplGlobals is
+  // initialized.
+  itkInitGlobalsMacro(PimplGlobals);
+
+  // Create a singleton WorkStealingThreadPool.
+  std::call_once(m_PimplGlobals->m_ThreadPoolOnceFlag, []() {
+    m_PimplGlobals->m_ThreadPoolInstance = ObjectFactory<Self>::Create();
+    if (m_PimplGlobals->m_ThreadPoolInstance.IsNull())
+    {
+      new WorkStealingThreadPool(); // constructor sets m_PimplGlobals->m_ThreadPoolInstance
+    }
+#if defined(ITK_USE_PTHREADS)
+    pthread_atfork(WorkStealingThreadPool::PrepareForFork,
+                   WorkStealingThreadPool::ResumeFromFork,
+                   WorkStealingThreadPool::ResumeFromFork);
+#endif
+  });
+
+  return m_PimplGlobals->m_ThreadPoolInstance;
+}
+
+int
+WorkStealingThreadPool::GetCurrentWorkerIndex()
+{
+  return tlWorkerIndex;
+}
+
+WorkStealingThreadPool::WorkStealingThreadPool()
+  : m_Workers(std::make_unique<std::unique_ptr<Worker>[]>(ITK_MAX_THREADS))
+{
+  // Construction only occurs via GetInstance which is protected by call_once.
+  m_PimplGlobals->m_ThreadPoolInstance = this;        // threads need this
+  m_PimplGlobals->m_ThreadPoolInstance->UnRegister(); // Remove extra reference
+  this->AddThreads(MultiThreaderBase::GetGlobalDefaultNumberOfThreads());
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool()
+{
+  this->CleanUp();
+}
+
+void
+WorkStealingThreadPool::AddThreads(ThreadIdType count)
+{
+  const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
+
+  const ThreadIdType first = m_NumberOfWorkers.load();
+  const ThreadIdType last = std::min<ThreadIdType>(first + count, ITK_MAX_THREADS);
+  for (ThreadIdType i = first; i < last; ++i)
+  {
+    m_Workers[i] = std::make_unique<Worker>();
+  }
+  // Publish the new workers before they start, so that they can be stolen from.
+  m_NumberOfWorkers.store(last);
+  for (ThreadIdType i = first; i < last; ++i)
+  {
+    this->StartWorker(i);
+  }
+}
+
+void
+WorkStealingThreadPool::StartWorker(ThreadIdType workerIndex)
+{
+  m_Workers[workerIndex]->Thread =
+    std::thread(&WorkStealingThreadPool::ThreadExecute, workerIndex, NUMASupport::GetCPUForWorker(workerIndex));
+}
+
+int
+WorkStealingThreadPool::GetNumberOfCurrentlyIdleThreads() const
+{
+  return m_NumberOfSleepingWorkers.load();
+}
+
+void
+WorkStealingThreadPool::Submit(TaskType * task)
+{
+  // Announce the task before it becomes visible, so that no worker goes to
+  // sleep while it is available.
+  ++m_NumberOfPendingTasks;
+
+  const int self = tlWorkerIndex;
+  if (self >= 0)
+  {
+    m_Workers[self]->Deque.Push(task);
+  }
+  else
+  {
+    Worker &                          worker = *m_Workers[m_NextInbox++ % m_NumberOfWorkers.load()];
+    const std::lock_guard<std::mutex> lockGuard(worker.InboxMutex);
+    worker.Inbox.push_back(task);
+    ++worker.InboxSize;
+  }
+
+  // Sequentially consistent with the sleeper's increment, so either we see
+  // the sleeper here or it sees the pending task before waiting.
+  if (m_NumberOfSleepingWorkers.load() > 0)
+  {
+    {
+      const std::lock_guard<std::mutex> lockGuard(m_SleepMutex);
+    }
+    m_Condition.notify_one();
+  }
+}
+
+WorkStealingThreadPool::TaskType *
+WorkStealingThreadPool::FindTask(int workerIndex)
+{
+  TaskType * task = nullptr;
+  if (workerIndex >= 0)
+  {
+    Worker & self = *m_Workers[workerIndex];
+    task = self.Deque.Pop();
+    if (task == nullptr)
+    {
+      task = self.TakeFromInbox(true);
+    }
+  }
+
+  const ThreadIdType numberOfWorkers = m_NumberOfWorkers.load();
+  const unsigned int offset = RandomVictimOffset();
+  for (ThreadIdType i = 0; task == nullptr && i < numberOfWorkers; ++i)
+  {
+    const ThreadIdType victimIndex = (offset + i) % numberOfWorkers;
+    if (static_cast<int>(victimIndex) == workerIndex)
+    {
+      continue;
+    }
+    Worker & victim = *m_Workers[victimIndex];
+    task = victim.Deque.Steal();
+    if (task == nullptr)
+    {
+      task = victim.TakeFromInbox(false);
+    }
+  }
+
+  if (task != nullptr)
+  {
+    --m_NumberOfPendingTasks;
+  }
+  return task;
+}
+
+void
+WorkStealingThreadPool::Execute(TaskType * task)
+{
+  const std::unique_ptr<TaskType> owner(task);
+  (*task)(); // exceptions are captured by the packaged_task
+}
+
+bool
+WorkStealingThreadPool::ExecutePendingWork()
+{
+  if (m_NumberOfPendingTasks.load() <= 0)
+  {
+    return false;
+  }
+  TaskType * task = this->FindTask(tlWorkerIndex);
+  if (task == nullptr)
+  {
+    return false;
+  }
+  Execute(task);
+  return true;
+}
+
+void
+WorkStealingThreadPool::CleanUp()
+{
+  {
+    const std::lock_guard<std::mutex> lockGuard(m_SleepMutex);
+    m_Stopping = true;
+  }
+
+  const ThreadIdType numberOfWorkers = m_NumberOfWorkers.load();
+  if (!ThreadPool::GetDoNotWaitForThreads() && numberOfWorkers > 0)
+  {
+    m_Condition.notify_all();
+  }
+
+  for (ThreadIdType i = 0; i < numberOfWorkers; ++i)
+  {
+    std::thread & thread = m_Workers[i]->Thread;
+    if (thread.joinable())
+    {
+      thread.join();
+    }
+  }
+}
+
+void
+WorkStealingThreadPool::PrepareForFork()
+{
+  m_PimplGlobals->m_ThreadPoolInstance->CleanUp();
+}
+
+void
+WorkStealingThreadPool::ResumeFromFork()
+{
+  WorkStealingThreadPool * instance = m_PimplGlobals->m_ThreadPoolInstance.GetPointer();
+  instance->m_Stopping = false;
+  const ThreadIdType numberOfWorkers = instance->m_NumberOfWorkers.load();
+  for (ThreadIdType i = 0; i < numberOfWorkers; ++i)
+  {
+    instance->StartWorker(i);
+  }
+}
+
+void
+WorkStealingThreadPool::ThreadExecute(ThreadIdType workerIndex, int cpu)
+{
+  // plain pointer does not increase reference count
+  WorkStealingThreadPool * threadPool = m_PimplGlobals->m_ThreadPoolInstance.GetPointer();
+  tlWorkerIndex = static_cast<int>(workerIndex);
+  NUMASupport::PinCurrentThreadToCPU(cpu);
+
+  while (true)
+  {
+    if (TaskType * task = threadPool->FindTask(tlWorkerIndex))
+    {
+      Execute(task);
+      continue;
+    }
+
+    bool workAppeared = false;
+    for (unsigned int spin = 0; spin < idleSpinCount && !workAppeared; ++spin)
+    {
+      std::this_thread::yield();
+      workAppeared = threadPool->m_NumberOfPendingTasks.load() > 0;
+    }
+    if (workAppeared)
+    {
+      continue;
+    }
+
+    std::unique_lock<std::mutex> mutexHolder(threadPool->m_SleepMutex);
+    ++threadPool->m_NumberOfSleepingWorkers;
+    threadPool->m_Condition.wait(mutexHolder, [threadPool] {
+      return threadPool->m_Stopping || threadPool->m_NumberOfPendingTasks.load() > 0;
+    });
+    --threadPool->m_NumberOfSleepingWorkers;
+    if (threadPool->m_Stopping && threadPool->m_NumberOfPendingTasks.load() <= 0)
+    {
+      return;
+    }
+  }
+}
+
+WorkStealingThreadPoolGlobals * WorkStealingThreadPool::m_PimplGlobals;
+
+} // namespace itk
@@ -0,0 +1,167 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageBufferPool.h"
+#include "itkImage.h"
+#include "itkVectorImage.h"
+#include "itkMultiThreaderBase.h"
+#include "itkTimeProbe.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+using ImageType = itk::Image<float, 3>;
+
+ImageType::Pointer
+MakeImage(itk::SizeValueType size, bool initialize)
+{
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType::Filled(size));
+  image->Allocate(initialize);
+  return image;
+}
+
+double
+TimeRepeatedAllocation(unsigned int repetitions)
+{
+  itk::TimeProbe probe;
+  for (unsigned int i = 0; i < repetitions; ++i)
+  {
+    probe.Start();
+    const auto image = MakeImage(200, true);
+    image->GetBufferPointer()[0] = 1.0f;
+    probe.Stop();
+  }
+  return probe.GetMean();
+}
+} // namespace
+
+int
+itkImageBufferPoolTest(int, char *[])
+{
+  using PoolType = itk::ImageBufferPool;
+
+  PoolType::SetGlobalEnabled(false);
+  ITK_TEST_EXPECT_TRUE(!PoolType::GetGlobalEnabled());
+  ITK_TEST_EXPECT_TRUE(PoolType::Allocate(size_t{ 1 } << 20, 1) == nullptr);
+
+  ITK_TRY_EXPECT_EXCEPTION(PoolType::SetGlobalAlignment(48));
+  PoolType::SetGlobalAlignment(128);
+  ITK_TEST_EXPECT_EQUAL(PoolType::GetGlobalAlignment(), 128u);
+
+  PoolType::SetGlobalEnabled(true);
+  PoolType::ResetStatistics();
+
+  // Releasing an image gives its buffer back; the next image of the same size reuses it.
+  auto         image = MakeImage(64, false);
+  const auto * firstBuffer = image->GetBufferPointer();
+  ITK_TEST_EXPECT_EQUAL(reinterpret_cast<uintptr_t>(firstBuffer) % 128, 0u);
+  std::fill_n(image->GetBufferPointer(), image->GetPixelContainer()->Size(), 3.0f);
+  image->ReleaseData();
+  ITK_TEST_EXPECT_EQUAL(PoolType::GetStatistics().NumberOfReleases, 1u);
+
+  // Slightly smaller requests fall into the same size class.
+  image = MakeImage(63, true);
+  ITK_TEST_EXPECT_TRUE(image->GetBufferPointer() == firstBuffer);
+  for (itk::SizeValueType i = 0; i < image->GetPixelContainer()->Size(); ++i)
+  {
+    if (image->GetBufferPointer()[i] != 0.0f)
+    {
+      std::cerr << "Reused buffer was not zero initialized at " << i << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  PoolType::Statistics statistics = PoolType::GetStatistics();
+  std::cout << statistics << std::endl;
+  ITK_TEST_EXPECT_EQUAL(statistics.NumberOfHits, 1u);
+  ITK_TEST_EXPECT_EQUAL(statistics.NumberOfMisses, 1u);
+  ITK_TEST_EXPECT_TRUE(statistics.OutstandingBytes >= 63 * 63 * 63 * sizeof(float));
+  ITK_TEST_EXPECT_EQUAL(statistics.IdleBytes, 0u);
+
+  // Small buffers and imported buffers are not pooled, but are still freed correctly.
+  const auto small = MakeImage(8, true);
+  ITK_TEST_EXPECT_EQUAL(PoolType::GetStatistics().NumberOfMisses, 1u);
+  auto vectorImage = itk::VectorImage<short, 2>::New();
+  vectorImage->SetRegions(itk::Size<2>::Filled(300));
+  vectorImage->SetVectorLength(2);
+  vectorImage->Allocate(true);
+  ITK_TEST_EXPECT_EQUAL(PoolType::GetStatistics().NumberOfMisses, 2u);
+  vectorImage->GetPixelContainer()->SetImportPointer(new short[10], 10, true);
+  vectorImage = nullptr;
+  ITK_TEST_EXPECT_EQUAL(PoolType::GetStatistics().NumberOfReleases, 2u);
+
+  // Buffers released beyond the cap are freed.
+  PoolType::SetGlobalMaximumIdleBytes(0);
+  image = nullptr;
+  statistics = PoolType::GetStatistics();
+  ITK_TEST_EXPECT_EQUAL(statistics.IdleBytes, 0u);
+  ITK_TEST_EXPECT_TRUE(statistics.NumberOfEvictions >= 1u);
+  PoolType::SetGlobalMaximumIdleBytes(size_t{ 1 } << 30);
+  ITK_TEST_EXPECT_EQUAL(PoolType::GetGlobalMaximumIdleBytes(), size_t{ 1 } << 30);
+
+  // Concurrent allocation and release.
+  itk::MultiThreaderBase::New()->ParallelizeArray(
+    0,
+    64,
+    [](itk::SizeValueType i) {
+      for (unsigned int repetition = 0; repetition < 4; ++repetition)
+      {
+        const auto threadImage = MakeImage(40 + i % 8, repetition % 2 == 0);
+        threadImage->GetBufferPointer()[0] = 1.0f;
+      }
+    },
+    nullptr);
+  statistics = PoolType::GetStatistics();
+  std::cout << statistics << std::endl;
+  ITK_TEST_EXPECT_EQUAL(statistics.OutstandingBytes, 0u);
+  ITK_TEST_EXPECT_EQUAL(statistics.NumberOfHits + statistics.NumberOfMisses, 3u + 64u * 4u);
+
+  // A buffer passed on by its container is detached from the pool, and freed through it.
+  image = MakeImage(64, false);
+  float * const passedOnBuffer = image->GetBufferPointer();
+  image->GetPixelContainer()->ContainerManageMemoryOff();
+  ITK_TEST_EXPECT_EQUAL(PoolType::GetStatistics().OutstandingBytes, 0u);
+  ITK_TEST_EXPECT_TRUE(!PoolType::Release(passedOnBuffer));
+  image = nullptr;
+  ITK_TEST_EXPECT_TRUE(PoolType::Free(passedOnBuffer));
+  ITK_TEST_EXPECT_TRUE(!PoolType::Free(passedOnBuffer));
+
+  // A container managing such a buffer again frees it through the pool.
+  image = MakeImage(64, false);
+  float * const managedAgainBuffer = image->GetBufferPointer();
+  image->GetPixelContainer()->ContainerManageMemoryOff();
+  image->GetPixelContainer()->ContainerManageMemoryOn();
+  image = nullptr;
+  ITK_TEST_EXPECT_TRUE(!PoolType::Free(managedAgainBuffer));
+  ITK_TEST_EXPECT_EQUAL(PoolType::GetStatistics().OutstandingBytes, 0u);
+
+  // Compare the cost of repeatedly allocating a 32 MB image.
+  PoolType::SetGlobalUseHugePages(true);
+  ITK_TEST_EXPECT_TRUE(PoolType::GetGlobalUseHugePages());
+  std::cout << "Pooled allocation: " << TimeRepeatedAllocation(10) << " s" << std::endl;
+  PoolType::SetGlobalEnabled(false);
+  std::cout << "Regular allocation: " << TimeRepeatedAllocation(10) << " s" << std::endl;
+
+  statistics = PoolType::GetStatistics();
+  ITK_TEST_EXPECT_EQUAL(statistics.IdleBytes, 0u);
+  PoolType::SetGlobalUseHugePages(false);
+  PoolType::SetGlobalAlignment(64);
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
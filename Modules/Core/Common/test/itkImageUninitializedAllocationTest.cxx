@@ -0,0 +1,136 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// Checks the poison fill of uninitialized image buffers, and measures what the
+// zero pass of Allocate(true) costs for a filter that writes every pixel anyway.
+
+#include "itkImageBufferPool.h"
+#include "itkExtractImageFilter.h"
+#include "itkImage.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkVectorImage.h"
+#include "itkTimeProbe.h"
+#include "itkTestingMacros.h"
+
+#include <cmath>
+
+namespace
+{
+template <typename TImage>
+bool
+IsPoisoned(const TImage * image)
+{
+  const auto * bytes = reinterpret_cast<const unsigned char *>(image->GetBufferPointer());
+  const auto   numberOfBytes = image->GetPixelContainer()->Size() * sizeof(typename TImage::PixelContainer::Element);
+  for (size_t i = 0; i < numberOfBytes; ++i)
+  {
+    if (bytes[i] != itk::ImageBufferPool::GetPoisonByte())
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Allocates a buffer and writes every pixel, returning the achieved bandwidth in GB/s.
+double
+MeasureAllocateAndWrite(itk::SizeValueType numberOfPixels, bool initializePixels)
+{
+  using ImageType = itk::Image<float, 1>;
+  itk::TimeProbe probe;
+  for (unsigned int repetition = 0; repetition < 3; ++repetition)
+  {
+    auto image = ImageType::New();
+    image->SetRegions(ImageType::SizeType{ { numberOfPixels } });
+    probe.Start();
+    image->Allocate(initializePixels);
+    std::fill_n(image->GetBufferPointer(), numberOfPixels, 1.0f);
+    probe.Stop();
+  }
+  return static_cast<double>(numberOfPixels * sizeof(float)) / probe.GetMean() * 1e-9;
+}
+} // namespace
+
+int
+itkImageUninitializedAllocationTest(int argc, char * argv[])
+{
+  const itk::SizeValueType megabytes = (argc > 1) ? static_cast<itk::SizeValueType>(std::stoi(argv[1])) : 64;
+
+  itk::ImageBufferPool::SetGlobalPoisonUninitialized(true);
+  ITK_TEST_EXPECT_TRUE(itk::ImageBufferPool::GetGlobalPoisonUninitialized());
+
+  using FloatImageType = itk::Image<float, 3>;
+  auto floatImage = FloatImageType::New();
+  floatImage->SetRegions(FloatImageType::SizeType::Filled(20));
+  floatImage->Allocate();
+  ITK_TEST_EXPECT_TRUE(IsPoisoned(floatImage.GetPointer()));
+  ITK_TEST_EXPECT_TRUE(std::isnan(floatImage->GetPixel({ { 3, 4, 5 } })));
+
+  // Value-initialized buffers are not poisoned.
+  floatImage->Initialize();
+  floatImage->SetRegions(FloatImageType::SizeType::Filled(20));
+  floatImage->AllocateInitialized();
+  ITK_TEST_EXPECT_EQUAL(floatImage->GetPixel({ { 3, 4, 5 } }), 0.0f);
+
+  auto vectorImage = itk::VectorImage<short, 2>::New();
+  vectorImage->SetRegions(itk::Size<2>::Filled(200));
+  vectorImage->SetVectorLength(3);
+  vectorImage->Allocate();
+  ITK_TEST_EXPECT_TRUE(IsPoisoned(vectorImage.GetPointer()));
+
+  // Pooled buffers are poisoned again when they are reused.
+  itk::ImageBufferPool::SetGlobalEnabled(true);
+  using ByteImageType = itk::Image<unsigned char, 3>;
+  auto byteImage = ByteImageType::New();
+  byteImage->SetRegions(ByteImageType::SizeType::Filled(64));
+  byteImage->Allocate();
+  byteImage->FillBuffer(7);
+  byteImage->Initialize();
+  byteImage->SetRegions(ByteImageType::SizeType::Filled(64));
+  byteImage->Allocate();
+  ITK_TEST_EXPECT_TRUE(IsPoisoned(byteImage.GetPointer()));
+  itk::ImageBufferPool::SetGlobalEnabled(false);
+
+  // A filter relying on ImageSource::AllocateOutputs must write every output pixel.
+  floatImage->FillBuffer(2.5f);
+  using ExtractFilterType = itk::ExtractImageFilter<FloatImageType, FloatImageType>;
+  auto                       extract = ExtractFilterType::New();
+  FloatImageType::RegionType extractionRegion({ { 2, 3, 4 } }, FloatImageType::SizeType::Filled(10));
+  extract->SetInput(floatImage);
+  extract->SetExtractionRegion(extractionRegion);
+  extract->SetDirectionCollapseToIdentity();
+  ITK_TRY_EXPECT_NO_EXCEPTION(extract->Update());
+  for (itk::ImageRegionConstIterator<FloatImageType> it(extract->GetOutput(), extractionRegion); !it.IsAtEnd(); ++it)
+  {
+    if (it.Get() != 2.5f)
+    {
+      std::cerr << "Output pixel " << it.GetIndex() << " was not written: " << it.Get() << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  itk::ImageBufferPool::SetGlobalPoisonUninitialized(false);
+
+  // Writing every pixel of a value-initialized buffer touches its memory twice.
+  const itk::SizeValueType numberOfPixels = (megabytes << 20) / sizeof(float);
+  std::cout << "Allocate and write " << megabytes << " MB" << std::endl;
+  std::cout << "  initialized:   " << MeasureAllocateAndWrite(numberOfPixels, true) << " GB/s" << std::endl;
+  std::cout << "  uninitialized: " << MeasureAllocateAndWrite(numberOfPixels, false) << " GB/s" << std::endl;
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,120 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkNUMASupport.h"
+#include "itkImage.h"
+#include "itkVectorImage.h"
+#include "itkTestingMacros.h"
+
+#include <set>
+#include <type_traits>
+
+namespace
+{
+
+template <typename TImage>
+bool
+AllocateAndCheckZero(typename TImage::RegionType region)
+{
+  auto image = TImage::New();
+  image->SetRegions(region);
+  if constexpr (std::is_same_v<TImage, itk::VectorImage<short, 3>>)
+  {
+    image->SetVectorLength(3);
+  }
+  image->Allocate(true);
+
+  const auto * buffer = image->GetBufferPointer();
+  const auto   numberOfValues = image->GetPixelContainer()->Size();
+  for (itk::SizeValueType i = 0; i < numberOfValues; ++i)
+  {
+    if (buffer[i] != 0)
+    {
+      std::cerr << "Value " << i << " was not zero initialized" << std::endl;
+      return false;
+    }
+  }
+
+  // Uninitialized allocation must still give a usable buffer.
+  auto uninitialized = TImage::New();
+  uninitialized->SetRegions(region);
+  if constexpr (std::is_same_v<TImage, itk::VectorImage<short, 3>>)
+  {
+    uninitialized->SetVectorLength(3);
+  }
+  uninitialized->Allocate(false);
+  return uninitialized->GetBufferPointer() != nullptr;
+}
+
+} // namespace
+
+int
+itkNUMASupportTest(int, char *[])
+{
+  using PolicyEnum = itk::NUMASupportEnums::MemoryPolicy;
+
+  // Test streaming enumeration for NUMASupportEnums::MemoryPolicy elements
+  const std::set<PolicyEnum> allPolicies{ PolicyEnum::Default, PolicyEnum::FirstTouch, PolicyEnum::Interleave };
+  for (const auto & ee : allPolicies)
+  {
+    std::cout << "STREAMED ENUM VALUE NUMASupportEnums::MemoryPolicy: " << ee << std::endl;
+  }
+
+  ITK_TEST_EXPECT_EQUAL(itk::NUMASupport::MemoryPolicyFromString("firstTouch"), PolicyEnum::FirstTouch);
+  ITK_TEST_EXPECT_EQUAL(itk::NUMASupport::MemoryPolicyFromString("INTERLEAVE"), PolicyEnum::Interleave);
+  ITK_TEST_EXPECT_EQUAL(itk::NUMASupport::MemoryPolicyFromString("unknown"), PolicyEnum::Default);
+
+  std::cout << "Number of NUMA nodes: " << itk::NUMASupport::GetNumberOfNodes() << std::endl;
+  ITK_TEST_EXPECT_TRUE(itk::NUMASupport::GetNumberOfNodes() >= 1);
+
+  // Pinning is off by default and only applies when enabled.
+  itk::NUMASupport::SetGlobalThreadPinning(false);
+  ITK_TEST_EXPECT_TRUE(!itk::NUMASupport::GetGlobalThreadPinning());
+  ITK_TEST_EXPECT_TRUE(!itk::NUMASupport::PinCurrentThread(0));
+  ITK_TEST_EXPECT_EQUAL(itk::NUMASupport::GetCPUForWorker(0), -1);
+  ITK_TEST_EXPECT_TRUE(!itk::NUMASupport::PinCurrentThreadToCPU(-1));
+  itk::NUMASupport::SetGlobalThreadPinning(true);
+  ITK_TEST_EXPECT_TRUE(itk::NUMASupport::GetGlobalThreadPinning());
+  std::cout << "CPU of worker 0: " << itk::NUMASupport::GetCPUForWorker(0) << std::endl;
+  itk::NUMASupport::SetGlobalThreadPinning(false);
+
+  // Large enough for the placement pass, with a non-zero start index.
+  itk::ImageRegion<3> region;
+  region.SetIndex({ { -3, 5, 2 } });
+  region.SetSize({ { 67, 61, 71 } });
+
+  bool success = true;
+  for (const auto policy : allPolicies)
+  {
+    itk::NUMASupport::SetGlobalMemoryPolicy(policy);
+    ITK_TEST_EXPECT_EQUAL(itk::NUMASupport::GetGlobalMemoryPolicy(), policy);
+    std::cout << "Allocating with " << policy << std::endl;
+    success &= AllocateAndCheckZero<itk::Image<float, 3>>(region);
+    success &= AllocateAndCheckZero<itk::Image<unsigned char, 3>>(region);
+    success &= AllocateAndCheckZero<itk::VectorImage<short, 3>>(region);
+  }
+  itk::NUMASupport::SetGlobalMemoryPolicy(PolicyEnum::Default);
+
+  if (!success)
+  {
+    std::cout << "Test FAILED!" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,199 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkWorkStealingThreadPool.h"
+#include "itkWorkStealingMultiThreader.h"
+#include "itkPoolMultiThreader.h"
+#ifdef ITK_USE_TBB
+#  include "itkTBBMultiThreader.h"
+#endif
+#include "itkTimeProbe.h"
+#include "itkTestingMacros.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+
+// Outer jobs submit inner jobs and wait for them from within the pool.
+// With a plain FIFO pool this deadlocks as soon as all workers wait.
+bool
+TestNestedSubmission(itk::WorkStealingThreadPool * pool)
+{
+  constexpr int outerCount = 64;
+  constexpr int innerCount = 32;
+
+  std::vector<std::future<int>> outer;
+  for (int i = 0; i < outerCount; ++i)
+  {
+    outer.push_back(pool->AddWork([pool, i]() {
+      std::vector<std::future<int>> inner;
+      for (int j = 0; j < innerCount; ++j)
+      {
+        inner.push_back(pool->AddWork([i, j]() { return i * innerCount + j; }));
+      }
+      int sum = 0;
+      for (auto & future : inner)
+      {
+        pool->WaitForFuture(future);
+        sum += future.get();
+      }
+      return sum;
+    }));
+  }
+
+  long long total = 0;
+  for (auto & future : outer)
+  {
+    pool->WaitForFuture(future);
+    total += future.get();
+  }
+
+  constexpr long long n = outerCount * innerCount;
+  if (total != n * (n - 1) / 2)
+  {
+    std::cerr << "Nested submission: expected " << n * (n - 1) / 2 << ", got " << total << std::endl;
+    return false;
+  }
+  return true;
+}
+
+// Nested ParallelizeArray calls through separate multi-threaders.
+bool
+TestNestedParallelize()
+{
+  constexpr itk::SizeValueType rows = 97;
+  constexpr itk::SizeValueType columns = 131;
+  std::vector<int>             values(rows * columns, 0);
+
+  auto outer = itk::WorkStealingMultiThreader::New();
+  outer->ParallelizeArray(
+    0,
+    rows,
+    [&values](itk::SizeValueType row) {
+      auto inner = itk::WorkStealingMultiThreader::New();
+      inner->ParallelizeArray(
+        0, columns, [&values, row](itk::SizeValueType column) { values[row * columns + column] += 1; }, nullptr);
+    },
+    nullptr);
+
+  for (const int value : values)
+  {
+    if (value != 1)
+    {
+      std::cerr << "Nested ParallelizeArray did not visit every element exactly once" << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// Fine-grained ParallelizeImageRegion workload: many tiny work units,
+// so that the cost is dominated by scheduling rather than by the work.
+// Returns the mean time; the time is only reported, but every pixel must
+// have been visited once per repetition.
+double
+TimeSmallChunks(itk::MultiThreaderBase * threader, bool & success)
+{
+  constexpr unsigned int    repetitions = 200;
+  const itk::IndexValueType index[2] = { 0, 0 };
+  const itk::SizeValueType  size[2] = { 256, 256 };
+  std::vector<unsigned int> buffer(size[0] * size[1], 0);
+
+  threader->SetNumberOfWorkUnits(itk::ITK_MAX_THREADS);
+  itk::TimeProbe probe;
+  for (unsigned int r = 0; r < repetitions; ++r)
+  {
+    probe.Start();
+    threader->ParallelizeImageRegion(
+      2,
+      index,
+      size,
+      [&buffer, &size](const itk::IndexValueType regionIndex[], const itk::SizeValueType regionSize[]) {
+        for (itk::SizeValueType y = 0; y < regionSize[1]; ++y)
+        {
+          unsigned int * line = &buffer[(regionIndex[1] + y) * size[0] + regionIndex[0]];
+          for (itk::SizeValueType x = 0; x < regionSize[0]; ++x)
+          {
+            ++line[x];
+          }
+        }
+      },
+      nullptr);
+    probe.Stop();
+  }
+  if (std::any_of(buffer.begin(), buffer.end(), [](unsigned int count) { return count != repetitions; }))
+  {
+    std::cerr << threader->GetNameOfClass() << " did not visit every pixel once per repetition" << std::endl;
+    success = false;
+  }
+  return probe.GetMean();
+}
+
+} // namespace
+
+int
+itkWorkStealingThreadPoolTest(int, char *[])
+{
+  const itk::WorkStealingThreadPool::Pointer pool = itk::WorkStealingThreadPool::GetInstance();
+  ITK_EXERCISE_BASIC_OBJECT_METHODS(pool, WorkStealingThreadPool, Object);
+  ITK_TEST_EXPECT_TRUE(pool == itk::WorkStealingThreadPool::New());
+  ITK_TEST_EXPECT_EQUAL(itk::WorkStealingThreadPool::GetCurrentWorkerIndex(), -1);
+
+  const itk::ThreadIdType threadCount = pool->GetMaximumNumberOfThreads();
+  pool->AddThreads(3);
+  ITK_TEST_EXPECT_EQUAL(pool->GetMaximumNumberOfThreads(),
+                        std::min<itk::ThreadIdType>(threadCount + 3, itk::ITK_MAX_THREADS));
+
+  auto result = pool->AddWork([](int param) { return param; }, 7);
+  pool->WaitForFuture(result);
+  ITK_TEST_EXPECT_EQUAL(result.get(), 7);
+
+  auto workerIndex = pool->AddWork([]() { return itk::WorkStealingThreadPool::GetCurrentWorkerIndex(); });
+  pool->WaitForFuture(workerIndex);
+  // The waiting thread may have executed the job itself.
+  ITK_TEST_EXPECT_TRUE(workerIndex.get() < static_cast<int>(pool->GetMaximumNumberOfThreads()));
+
+  auto throwing = pool->AddWork([]() -> int { itkGenericExceptionMacro("expected"); });
+  pool->WaitForFuture(throwing);
+  ITK_TRY_EXPECT_EXCEPTION(throwing.get());
+
+  bool success = TestNestedSubmission(pool);
+  success &= TestNestedParallelize();
+
+  // Report the scheduling overhead of the multi-threaders on small chunks;
+  // the timings are machine dependent, so they are not compared.
+  auto workStealing = itk::WorkStealingMultiThreader::New();
+  auto poolThreader = itk::PoolMultiThreader::New();
+  std::cout << "Mean time of " << itk::ITK_MAX_THREADS << " small work units:" << std::endl;
+  std::cout << "  Pool:         " << TimeSmallChunks(poolThreader, success) << " s" << std::endl;
+  std::cout << "  WorkStealing: " << TimeSmallChunks(workStealing, success) << " s" << std::endl;
+#ifdef ITK_USE_TBB
+  auto tbbThreader = itk::TBBMultiThreader::New();
+  std::cout << "  TBB:          " << TimeSmallChunks(tbbThreader, success) << " s" << std::endl;
+#endif
+
+  if (!success)
+  {
+    std::cout << "Test FAILED!" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -147,9 +147,14 @@ public:
   EvaluateAtContinuousIndex(const ContinuousIndexType & index) const override
   {
     // Don't know thread information, make evaluateIndex, weights on the stack.
-    // Slower, but safer.
-    vnl_matrix<long>   evaluateIndex(ImageDimension, (m_SplineOrder + 1));
-    vnl_matrix<double> weights(ImageDimension, (m_SplineOrder + 1));
+    // Slower, but safer. The fixed order kernels need neither.
+    vnl_matrix<long>   evaluateIndex;
+    vnl_matrix<double> weights;
+    if (!this->HasFixedOrderKernel())
+    {
+      evaluateIndex.set_size(ImageDimension, m_SplineOrder + 1);
+      weights.set_size(ImageDimension, m_SplineOrder + 1);
+    }
 
     // Pass evaluateIndex, weights by reference. They're only good as long
     // as this method is in scope.
@@ -163,6 +168,17 @@ public:
     return this->EvaluateAtContinuousIndexInternal(x, m_ThreadedEvaluateIndex[threadId], m_ThreadedWeights[threadId]);
   }
 
+  /** Interpolate the image at numberOfIndices continuous index positions.
+   * For spline orders 1 to 3, the weights of a dimension are only computed
+   * again where the index changes in that dimension. When the indices only
+   * change in one dimension, as along a scanline of an axis aligned
+   * resampling, the coefficients are summed across the other dimensions once
+   * per position along the line, and shared by the neighboring indices. */
+  void
+  EvaluateAtContinuousIndices(const ContinuousIndexType * indices,
+                              OutputType *                values,
+                              SizeValueType               numberOfIndices) const override;
+
   CovariantVectorType
   EvaluateDerivative(const PointType & point) const
   {
@@ -187,10 +203,16 @@ public:
     // Don't know thread information, make evaluateIndex, weights,
     // weightsDerivative
     // on the stack.
-    // Slower, but safer.
-    vnl_matrix<long>   evaluateIndex(ImageDimension, (m_SplineOrder + 1));
-    vnl_matrix<double> weights(ImageDimension, (m_SplineOrder + 1));
-    vnl_matrix<double> weightsDerivative(ImageDimension, (m_SplineOrder + 1));
+    // Slower, but safer. The fixed order kernels need none of them.
+    vnl_matrix<long>   evaluateIndex;
+    vnl_matrix<double> weights;
+    vnl_matrix<double> weightsDerivative;
+    if (!this->HasFixedOrderKernel())
+    {
+      evaluateIndex.set_size(ImageDimension, m_SplineOrder + 1);
+      weights.set_size(ImageDimension, m_SplineOrder + 1);
+      weightsDerivative.set_size(ImageDimension, m_SplineOrder + 1);
+    }
 
     // Pass evaluateIndex, weights, weightsDerivative by reference. They're only
     // good
@@ -234,10 +256,16 @@ public:
     // Don't know thread information, make evaluateIndex, weights,
     // weightsDerivative
     // on the stack.
-    // Slower, but safer.
-    vnl_matrix<long>   evaluateIndex(ImageDimension, (m_SplineOrder + 1));
-    vnl_matrix<double> weights(ImageDimension, (m_SplineOrder + 1));
-    vnl_matrix<double> weightsDerivative(ImageDimension, (m_SplineOrder + 1));
+    // Slower, but safer. The fixed order kernels need none of them.
+    vnl_matrix<long>   evaluateIndex;
+    vnl_matrix<double> weights;
+    vnl_matrix<double> weightsDerivative;
+    if (!this->HasFixedOrderKernel())
+    {
+      evaluateIndex.set_size(ImageDimension, m_SplineOrder + 1);
+      weights.set_size(ImageDimension, m_SplineOrder + 1);
+      weightsDerivative.set_size(ImageDimension, m_SplineOrder + 1);
+    }
 
     // Pass evaluateIndex, weights, weightsDerivative by reference. They're only
     // good
@@ -314,6 +342,9 @@ protected:
    *  (hopefully) by looking up pre-allocated working space in arrays that are indexed by thread.
    *  The efficiency gain is likely dependent on the size of the working variables, which are
    *  in-turn dependent on the dimensionality of the image and the order of the spline.
+   *
+   *  Spline orders 1 to 3 are evaluated by fixed order kernels with their working space on the
+   *  stack. For those orders the methods without threadId pass empty working variables.
    */
   virtual OutputType
   EvaluateAtContinuousIndexInternal(const ContinuousIndexType & x,
@@ -381,6 +412,57 @@ private:
   void
   ApplyMirrorBoundaryConditions(vnl_matrix<long> & evaluateIndex, unsigned int splineOrder) const;
 
+  /** Whether the spline order is evaluated by EvaluateWithSplineOrder. */
+  bool
+  HasFixedOrderKernel() const
+  {
+    return m_SplineOrder >= 1 && m_SplineOrder <= 3;
+  }
+
+  /** Evaluates the value and/or the derivative for a spline order known at
+   * compile time (1, 2 or 3). The weights and the buffer offsets of the region
+   * of support are kept in fixed size arrays on the stack, the coefficients
+   * are read through the buffer pointer, and the separable sum is reduced one
+   * dimension at a time. The results agree with the generic code up to
+   * rounding. */
+  template <unsigned int VSplineOrder, bool VEvaluateValue, bool VEvaluateDerivative>
+  void
+  EvaluateWithSplineOrder(const ContinuousIndexType & x, double & value, CovariantVectorType & derivativeValue) const;
+
+  /** Computes the weights of the fixed order kernel at the coordinate x, and
+   * its derivative weights if VEvaluateDerivative, and returns the first index
+   * of the region of support. */
+  template <unsigned int VSplineOrder, bool VEvaluateDerivative>
+  static IndexValueType
+  ComputeWeightsWithSplineOrder(const TCoordinate x, double * weights, double * derivativeWeights);
+
+  /** Computes the offsets in the coefficient buffer of numberOfIndices
+   * consecutive indices along dimension n, from firstIndex, after the mirror
+   * boundary conditions. */
+  void
+  ComputeMirroredBufferOffsets(const unsigned int   n,
+                               const IndexValueType firstIndex,
+                               const unsigned int   numberOfIndices,
+                               OffsetValueType *    offsets) const;
+
+  /** Sums the coefficients at the offsets of the region of support, one row
+   * along the first dimension at a time. The derivatives are not yet divided
+   * by the spacing. */
+  template <unsigned int VSplineOrder, bool VEvaluateValue, bool VEvaluateDerivative>
+  void
+  SumSupportWithSplineOrder(const double (&weights)[ImageDimension][VSplineOrder + 1],
+                            const double (&derivativeWeights)[ImageDimension][VSplineOrder + 1],
+                            const OffsetValueType (&offsets)[ImageDimension][VSplineOrder + 1],
+                            double &              value,
+                            CovariantVectorType & derivativeValue) const;
+
+  /** EvaluateAtContinuousIndices for a spline order known at compile time. */
+  template <unsigned int VSplineOrder>
+  void
+  EvaluateAtContinuousIndicesWithSplineOrder(const ContinuousIndexType * indices,
+                                             OutputType *                values,
+                                             SizeValueType               numberOfIndices) const;
+
   Iterator m_CIterator{};                         // Iterator for
                                                   // traversing spline
                                                   // coefficients.
@@ -37,6 +37,8 @@
 #include "itkMatrix.h"
 #include "itkPrintHelper.h"
 
+#include <algorithm>
+
 namespace itk
 {
 
@@ -496,6 +498,23 @@ BSplineInterpolateImageFunction<TImageType, TCoordinate, TCoefficientType>::Eval
   vnl_matrix<long> &          evaluateIndex,
   vnl_matrix<double> &        weights) const -> OutputType
 {
+  double              interpolated = 0.0;
+  CovariantVectorType unusedDerivative;
+  switch (m_SplineOrder)
+  {
+    case 1:
+      this->EvaluateWithSplineOrder<1, true, false>(x, interpolated, unusedDerivative);
+      return interpolated;
+    case 2:
+      this->EvaluateWithSplineOrder<2, true, false>(x, interpolated, unusedDerivative);
+      return interpolated;
+    case 3:
+      this->EvaluateWithSplineOrder<3, true, false>(x, interpolated, unusedDerivative);
+      return interpolated;
+    default:
+      break;
+  }
+
   // compute the interpolation indexes
   this->DetermineRegionOfSupport((evaluateIndex), x, m_SplineOrder);
 
@@ -506,7 +525,6 @@ BSplineInterpolateImageFunction<TImageType, TCoordinate, TCoefficientType>::Eval
   this->ApplyMirrorBoundaryConditions((evaluateIndex), m_SplineOrder);
 
   // perform interpolation
-  double    interpolated = 0.0;
   IndexType coefficientIndex;
   // Step through each point in the n-dimensional interpolation cube.
   for (unsigned int p = 0; p < m_MaxNumberInterpolationPoints; ++p)
@@ -534,6 +552,25 @@ BSplineInterpolateImageFunction<TImageType, TCoordinate, TCoefficientType>::
                                                       vnl_matrix<double> &        weights,
                                                       vnl_matrix<double> &        weightsDerivative) const
 {
+  double interpolated = 0.0;
+  switch (m_SplineOrder)
+  {
+    case 1:
+      this->EvaluateWithSplineOrder<1, true, true>(x, interpolated, derivativeValue);
+      value = interpolated;
+      return;
+    case 2:
+      this->EvaluateWithSplineOrder<2, true, true>(x, interpolated, derivativeValue);
+      value = interpolated;
+      return;
+    case 3:
+      this->EvaluateWithSplineOrder<3, true, true>(x, interpolated, derivativeValue);
+      value = interpolated;
+      return;
+    default:
+      break;
+  }
+
   this->DetermineRegionOfSupport((evaluateIndex), x, m_SplineOrder);
 
   SetInterpolationWeights(x, (evaluateIndex), (weights), m_SplineOrder);
@@ -605,6 +642,25 @@ BSplineInterpolateImageFunction<TImageType, TCoordinate, TCoefficientType>::Eval
   vnl_matrix<double> &        weights,
   vnl_matrix<double> &        weightsDerivative) const -> CovariantVectorType
 {
+  // Calculate derivative
+  CovariantVectorType derivativeValue;
+
+  double unusedValue = 0.0;
+  switch (m_SplineOrder)
+  {
+    case 1:
+      this->EvaluateWithSplineOrder<1, false, true>(x, unusedValue, derivativeValue);
+      return derivativeValue;
+    case 2:
+      this->EvaluateWithSplineOrder<2, false, true>(x, unusedValue, derivativeValue);
+      return derivativeValue;
+    case 3:
+      this->EvaluateWithSplineOrder<3, false, true>(x, unusedValue, derivativeValue);
+      return derivativeValue;
+    default:
+      break;
+  }
+
   this->DetermineRegionOfSupport((evaluateIndex), x, m_SplineOrder);
 
   SetInterpolationWeights(x, (evaluateIndex), (weights), m_SplineOrder);
@@ -617,9 +673,6 @@ BSplineInterpolateImageFunction<TImageType, TCoordinate, TCoefficientType>::Eval
   const InputImageType *                       inputImage = this->GetInputImage();
   const typename InputImageType::SpacingType & spacing = inputImage->GetSpacing();
 
-  // Calculate derivative
-  CovariantVectorType derivativeValue;
-
   IndexType coefficientIndex;
   for (unsigned int n = 0; n < ImageDimension; ++n)
   {
@@ -653,6 +706,385 @@ BSplineInterpolateImageFunction<TImageType, TCoordinate, TCoefficientType>::Eval
 
   return (derivativeValue);
 }
+
+template <typename TImageType, typename TCoordinate, typename TCoefficientType>
+void
+BSplineInterpolateImageFunction<TImageType, TCoordinate, TCoefficientType>::EvaluateAtContinuousIndices(
+  const ContinuousIndexType * indices,
+  OutputType *                values,
+  SizeValueType               numberOfIndices) const
+{
+  switch (m_SplineOrder)
+  {
+    case 1:
+      this->EvaluateAtContinuousIndicesWithSplineOrder<1>(indices, values, numberOfIndices);
+      break;
+    case 2:
+      this->EvaluateAtContinuousIndicesWithSplineOrder<2>(indices, values, numberOfIndices);
+      break;
+    case 3:
+      this->EvaluateAtContinuousIndicesWithSplineOrder<3>(indices, values, numberOfIndices);
+      break;
+    default:
+      Superclass::EvaluateAtContinuousIndices(indices, values, numberOfIndices);
+      break;
+  }
+}
+
+template <typename TImageType, typename TCoordinate, typename TCoefficientType>
+template <unsigned int VSplineOrder, bool VEvaluateDerivative>
+IndexValueType
+BSplineInterpolateImageFunction<TImageType, TCoordinate, TCoefficientType>::ComputeWeightsWithSplineOrder(
+  const TCoordinate x,
+  double *          weights,
+  double *          derivativeWeights)
+{
+  static_assert(VSplineOrder >= 1 && VSplineOrder <= 3, "Only spline orders 1 to 3 have a fixed order kernel.");
+
+  // The region of support of DetermineRegionOfSupport and the weights of
+  // SetInterpolationWeights and SetDerivativeWeights.
+  constexpr float      halfOffset = VSplineOrder & 1 ? 0.0 : 0.5;
+  const IndexValueType firstIndex =
+    static_cast<long>(std::floor(static_cast<float>(x) + halfOffset)) - VSplineOrder / 2;
+
+  if constexpr (VSplineOrder == 1)
+  {
+    const double w = x - static_cast<double>(firstIndex);
+    weights[1] = w;
+    weights[0] = 1.0 - w;
+    if constexpr (VEvaluateDerivative)
+    {
+      derivativeWeights[0] = -1.0;
+      derivativeWeights[1] = 1.0;
+    }
+  }
+  else if constexpr (VSplineOrder == 2)
+  {
+    const double w = x - static_cast<double>(firstIndex + 1);
+    weights[1] = 0.75 - w * w;
+    weights[2] = 0.5 * (w - weights[1] + 1.0);
+    weights[0] = 1.0 - weights[1] - weights[2];
+    if constexpr (VEvaluateDerivative)
+    {
+      const double dw = x + 0.5 - static_cast<double>(firstIndex + 1);
+      const double w1 = 1.0 - dw;
+      derivativeWeights[0] = 0.0 - w1;
+      derivativeWeights[1] = w1 - dw;
+      derivativeWeights[2] = dw;
+    }
+  }
+  else
+  {
+    const double w = x - static_cast<double>(firstIndex + 1);
+    weights[3] = (1.0 / 6.0) * w * w * w;
+    weights[0] = (1.0 / 6.0) + 0.5 * w * (w - 1.0) - weights[3];
+    weights[2] = w + weights[0] - 2.0 * weights[3];
+    weights[1] = 1.0 - weights[0] - weights[2] - weights[3];
+    if constexpr (VEvaluateDerivative)
+    {
+      const double dw = x + 0.5 - static_cast<double>(firstIndex + 2);
+      const double w2 = 0.75 - dw * dw;
+      const double w3 = 0.5 * (dw - w2 + 1.0);
+      const double w1 = 1.0 - w2 - w3;
+      derivativeWeights[0] = 0.0 - w1;
+      derivativeWeights[1] = w1 - w2;
+      derivativeWeights[2] = w2 - w3;
+      derivativeWeights[3] = w3;
+    }
+  }
+  return firstIndex;
+}
+
+template <typename TImageType, typename TCoordinate, typename TCoefficientType>
+void
+BSplineInterpolateImageFunction<TImageType, TCoordinate, TCoefficientType>::ComputeMirroredBufferOffsets(
+  const unsigned int   n,
+  const IndexValueType firstIndex,
+  const unsigned int   numberOfIndices,
+  OffsetValueType *    offsets) const
+{
+  // The mirror boundary conditions of ApplyMirrorBoundaryConditions.
+  const bool            isSingleSample = m_DataLength[n] == 1;
+  const IndexValueType  startIndex = this->GetStartIndex()[n];
+  const IndexValueType  endIndex = this->GetEndIndex()[n];
+  const IndexValueType  bufferIndex = m_Coefficients->GetBufferedRegion().GetIndex(n);
+  const OffsetValueType stride = m_Coefficients->GetOffsetTable()[n];
+  for (unsigned int k = 0; k < numberOfIndices; ++k)
+  {
+    IndexValueType index = firstIndex + k;
+    if (isSingleSample)
+    {
+      index = 0;
+    }
+    else
+    {
+      if (index < startIndex)
+      {
+        index = startIndex + (startIndex - index);
+      }
+      if (index >= endIndex)
+      {
+        index = endIndex - (index - endIndex);
+      }
+    }
+    offsets[k] = (index - bufferIndex) * stride;
+  }
+}
+
+template <typename TImageType, typename TCoordinate, typename TCoefficientType>
+template <unsigned int VSplineOrder, bool VEvaluateValue, bool VEvaluateDerivative>
+void
+BSplineInterpolateImageFunction<TImageType, TCoordinate, TCoefficientType>::SumSupportWithSplineOrder(
+  const double (&weights)[ImageDimension][VSplineOrder + 1],
+  const double (&derivativeWeights)[ImageDimension][VSplineOrder + 1],
+  const OffsetValueType (&offsets)[ImageDimension][VSplineOrder + 1],
+  double &              value,
+  CovariantVectorType & derivativeValue) const
+{
+  constexpr unsigned int SupportSize = VSplineOrder + 1;
+
+  // Step through the region of support one row along the first dimension at a
+  // time. The kernel is separable, so each row is first reduced with the
+  // weights of the first dimension, then weighted by the other dimensions.
+  const CoefficientDataType * coefficients = m_Coefficients->GetBufferPointer();
+  double                      interpolated = 0.0;
+  double                      derivatives[ImageDimension]{};
+  unsigned int                rowPosition[ImageDimension]{};
+  unsigned int                n = 0;
+  do
+  {
+    OffsetValueType rowOffset = 0;
+    double          rowWeight = 1.0;
+    for (unsigned int m = 1; m < ImageDimension; ++m)
+    {
+      rowOffset += offsets[m][rowPosition[m]];
+      rowWeight *= weights[m][rowPosition[m]];
+    }
+    const CoefficientDataType * row = coefficients + rowOffset;
+    double                      rowSum = 0.0;
+    double                      rowDerivativeSum = 0.0;
+    for (unsigned int k = 0; k < SupportSize; ++k)
+    {
+      const double coefficient = row[offsets[0][k]];
+      rowSum += weights[0][k] * coefficient;
+      if constexpr (VEvaluateDerivative)
+      {
+        rowDerivativeSum += derivativeWeights[0][k] * coefficient;
+      }
+    }
+
+    if constexpr (VEvaluateValue)
+    {
+      interpolated += rowWeight * rowSum;
+    }
+    if constexpr (VEvaluateDerivative)
+    {
+      derivatives[0] += rowWeight * rowDerivativeSum;
+      for (unsigned int d = 1; d < ImageDimension; ++d)
+      {
+        double rowDerivativeWeight = 1.0;
+        for (unsigned int m = 1; m < ImageDimension; ++m)
+        {
+          rowDerivativeWeight *= (m == d) ? derivativeWeights[m][rowPosition[m]] : weights[m][rowPosition[m]];
+        }
+        derivatives[d] += rowDerivativeWeight * rowSum;
+      }
+    }
+
+    for (n = 1; n < ImageDimension; ++n)
+    {
+      if (++rowPosition[n] < SupportSize)
+      {
+        break;
+      }
+      rowPosition[n] = 0;
+    }
+  } while (n < ImageDimension);
+
+  if constexpr (VEvaluateValue)
+  {
+    value = interpolated;
+  }
+  if constexpr (VEvaluateDerivative)
+  {
+    for (unsigned int d = 0; d < ImageDimension; ++d)
+    {
+      derivativeValue[d] = derivatives[d];
+    }
+  }
+}
+
+template <typename TImageType, typename TCoordinate, typename TCoefficientType>
+template <unsigned int VSplineOrder, bool VEvaluateValue, bool VEvaluateDerivative>
+void
+BSplineInterpolateImageFunction<TImageType, TCoordinate, TCoefficientType>::EvaluateWithSplineOrder(
+  const ContinuousIndexType & x,
+  double &                    value,
+  CovariantVectorType &       derivativeValue) const
+{
+  constexpr unsigned int SupportSize = VSplineOrder + 1;
+
+  // The weights and the mirrored buffer offsets of the region of support.
+  double          weights[ImageDimension][SupportSize];
+  double          derivativeWeights[ImageDimension][SupportSize];
+  OffsetValueType offsets[ImageDimension][SupportSize];
+  for (unsigned int n = 0; n < ImageDimension; ++n)
+  {
+    const IndexValueType firstIndex =
+      Self::ComputeWeightsWithSplineOrder<VSplineOrder, VEvaluateDerivative>(x[n], weights[n], derivativeWeights[n]);
+    this->ComputeMirroredBufferOffsets(n, firstIndex, SupportSize, offsets[n]);
+  }
+
+  this->SumSupportWithSplineOrder<VSplineOrder, VEvaluateValue, VEvaluateDerivative>(
+    weights, derivativeWeights, offsets, value, derivativeValue);
+
+  if constexpr (VEvaluateDerivative)
+  {
+    const InputImageType * inputImage = this->GetInputImage();
+    for (unsigned int d = 0; d < ImageDimension; ++d)
+    {
+      derivativeValue[d] /= inputImage->GetSpacing()[d];
+    }
+    if (this->m_UseImageDirection)
+    {
+      derivativeValue = inputImage->TransformLocalVectorToPhysicalVector(derivativeValue);
+    }
+  }
+}
+
+template <typename TImageType, typename TCoordinate, typename TCoefficientType>
+template <unsigned int VSplineOrder>
+void
+BSplineInterpolateImageFunction<TImageType, TCoordinate, TCoefficientType>::EvaluateAtContinuousIndicesWithSplineOrder(
+  const ContinuousIndexType * indices,
+  OutputType *                values,
+  SizeValueType               numberOfIndices) const
+{
+  constexpr unsigned int SupportSize = VSplineOrder + 1;
+  if (numberOfIndices == 0)
+  {
+    return;
+  }
+
+  // Find the dimensions in which the indices change.
+  unsigned int numberOfChangingDimensions = 0;
+  unsigned int lineDimension = 0;
+  for (unsigned int n = 0; n < ImageDimension; ++n)
+  {
+    for (SizeValueType i = 1; i < numberOfIndices; ++i)
+    {
+      if (indices[i][n] != indices[0][n])
+      {
+        ++numberOfChangingDimensions;
+        lineDimension = n;
+        break;
+      }
+    }
+  }
+
+  double              weights[ImageDimension][SupportSize];
+  double              unusedDerivativeWeights[ImageDimension][SupportSize];
+  OffsetValueType     offsets[ImageDimension][SupportSize];
+  CovariantVectorType unusedDerivative;
+
+  if (numberOfChangingDimensions > 1)
+  {
+    // Recompute the weights and offsets of a dimension only where the index
+    // changes in that dimension, as along a scanline rotated about an axis.
+    for (SizeValueType i = 0; i < numberOfIndices; ++i)
+    {
+      for (unsigned int n = 0; n < ImageDimension; ++n)
+      {
+        if (i == 0 || indices[i][n] != indices[i - 1][n])
+        {
+          const IndexValueType firstIndex = Self::ComputeWeightsWithSplineOrder<VSplineOrder, false>(
+            indices[i][n], weights[n], unusedDerivativeWeights[n]);
+          this->ComputeMirroredBufferOffsets(n, firstIndex, SupportSize, offsets[n]);
+        }
+      }
+      double value = 0.0;
+      this->SumSupportWithSplineOrder<VSplineOrder, true, false>(
+        weights, unusedDerivativeWeights, offsets, value, unusedDerivative);
+      values[i] = value;
+    }
+    return;
+  }
+
+  // The indices lie on a line along lineDimension, as along the scanlines of
+  // an axis aligned resampling. The kernel is separable: the coefficients of
+  // the region of support are first summed across the other dimensions, with
+  // weights that are the same for all indices, once per position along the
+  // line. Each value is then a sum of SupportSize of these line values.
+  constexpr unsigned int NumberOfRows = Math::UnsignedPower(SupportSize, ImageDimension - 1);
+  OffsetValueType        rowOffsets[NumberOfRows];
+  double                 rowWeights[NumberOfRows];
+  rowOffsets[0] = 0;
+  rowWeights[0] = 1.0;
+  unsigned int numberOfRows = 1;
+  for (unsigned int n = 0; n < ImageDimension; ++n)
+  {
+    if (n == lineDimension)
+    {
+      continue;
+    }
+    const IndexValueType firstIndex =
+      Self::ComputeWeightsWithSplineOrder<VSplineOrder, false>(indices[0][n], weights[n], unusedDerivativeWeights[n]);
+    this->ComputeMirroredBufferOffsets(n, firstIndex, SupportSize, offsets[n]);
+    // Expand the rows in place, those for k = 0 last.
+    for (unsigned int k = SupportSize; k-- > 0;)
+    {
+      const OffsetValueType offset = offsets[n][k];
+      for (unsigned int r = numberOfRows; r-- > 0;)
+      {
+        rowOffsets[k * numberOfRows + r] = rowOffsets[r] + offset;
+        rowWeights[k * numberOfRows + r] = rowWeights[r] * weights[n][k];
+      }
+    }
+    numberOfRows *= SupportSize;
+  }
+
+  // The line values are computed when first needed, within a window of
+  // positions along the line that follows the indices.
+  constexpr IndexValueType    WindowSize = 64;
+  double                      lineValues[WindowSize];
+  bool                        isLineValueComputed[WindowSize];
+  IndexValueType              windowStart = 0;
+  bool                        isWindowValid = false;
+  const CoefficientDataType * coefficients = m_Coefficients->GetBufferPointer();
+  for (SizeValueType i = 0; i < numberOfIndices; ++i)
+  {
+    double *             lineWeights = weights[lineDimension];
+    const IndexValueType firstIndex = Self::ComputeWeightsWithSplineOrder<VSplineOrder, false>(
+      indices[i][lineDimension], lineWeights, unusedDerivativeWeights[lineDimension]);
+    if (!isWindowValid || firstIndex < windowStart || firstIndex + SupportSize > windowStart + WindowSize)
+    {
+      windowStart = (isWindowValid && firstIndex < windowStart) ? firstIndex + SupportSize - WindowSize : firstIndex;
+      std::fill_n(isLineValueComputed, WindowSize, false);
+      isWindowValid = true;
+    }
+
+    double value = 0.0;
+    for (unsigned int k = 0; k < SupportSize; ++k)
+    {
+      const IndexValueType position = firstIndex + k - windowStart;
+      if (!isLineValueComputed[position])
+      {
+        OffsetValueType lineOffset;
+        this->ComputeMirroredBufferOffsets(lineDimension, firstIndex + k, 1, &lineOffset);
+        const CoefficientDataType * line = coefficients + lineOffset;
+        double                      lineValue = 0.0;
+        for (unsigned int r = 0; r < NumberOfRows; ++r)
+        {
+          lineValue += rowWeights[r] * line[rowOffsets[r]];
+        }
+        lineValues[position] = lineValue;
+        isLineValueComputed[position] = true;
+      }
+      value += lineWeights[k] * lineValues[position];
+    }
+    values[i] = value;
+  }
+}
 } // namespace itk
 
 #endif
@@ -113,6 +113,27 @@ public:
   OutputType
   EvaluateAtContinuousIndex(const ContinuousIndexType & index) const override = 0;
 
+  /** Interpolate the image at numberOfIndices continuous index positions
+   *
+   * Writes the interpolated image intensity at each index to values. No
+   * bounds checking is done. The indices are assumed to lie within the image
+   * buffer.
+   *
+   * The default calls EvaluateAtContinuousIndex for each index. Interpolators
+   * with separable kernels override it to share work between consecutive
+   * indices, such as the weights of the dimensions in which the index does not
+   * change along a scanline of ResampleImageFilter. */
+  virtual void
+  EvaluateAtContinuousIndices(const ContinuousIndexType * indices,
+                              OutputType *                values,
+                              SizeValueType               numberOfIndices) const
+  {
+    for (SizeValueType i = 0; i < numberOfIndices; ++i)
+    {
+      values[i] = this->EvaluateAtContinuousIndex(indices[i]);
+    }
+  }
+
   /** Interpolate the image at an index position.
    *
    * Simply returns the image value at the
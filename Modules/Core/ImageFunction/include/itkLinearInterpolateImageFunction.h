@@ -104,6 +104,18 @@ public:
     return this->EvaluateOptimized(Dispatch<ImageDimension>(), index);
   }
 
+  /** Evaluate the function at numberOfIndices ContinuousIndex positions
+   *
+   * For images of type VectorImage, the neighbors and the distances to them
+   * are computed once per index, and the components of the neighbors are
+   * interpolated in a contiguous inner loop. The values are resized in place,
+   * so that values that already have the number of components of the image
+   * are not allocated again. */
+  void
+  EvaluateAtContinuousIndices(const ContinuousIndexType * indices,
+                              OutputType *                values,
+                              SizeValueType               numberOfIndices) const override;
+
   SizeType
   GetRadius() const override
   {
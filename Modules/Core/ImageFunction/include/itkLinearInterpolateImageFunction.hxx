@@ -21,7 +21,9 @@
 #include "itkConceptChecking.h"
 
 #include "itkMath.h"
+#include "itkVectorImage.h"
 #include <algorithm> // For min and max.
+#include <type_traits>
 
 namespace itk
 {
@@ -95,6 +97,95 @@ LinearInterpolateImageFunction<TInputImage, TCoordinate>::EvaluateUnoptimized(co
   return (static_cast<OutputType>(value));
 }
 
+template <typename TInputImage, typename TCoordinate>
+void
+LinearInterpolateImageFunction<TInputImage, TCoordinate>::EvaluateAtContinuousIndices(
+  const ContinuousIndexType * indices,
+  OutputType *                values,
+  SizeValueType               numberOfIndices) const
+{
+  using InternalPixelType = typename TInputImage::InternalPixelType;
+  if constexpr (std::is_same_v<TInputImage, VectorImage<InternalPixelType, ImageDimension>>)
+  {
+    const TInputImage * const inputImagePtr = this->GetInputImage();
+    const unsigned int        numberOfComponents = inputImagePtr->GetNumberOfComponentsPerPixel();
+    const InternalPixelType * buffer = inputImagePtr->GetBufferPointer();
+    const OffsetValueType *   offsetTable = inputImagePtr->GetOffsetTable();
+    const IndexType &         bufferIndex = inputImagePtr->GetBufferedRegion().GetIndex();
+    using ValueType = typename OutputType::ValueType;
+
+    // Number of neighbors used in the interpolation
+    constexpr unsigned int numberOfNeighbors = 1 << ImageDimension;
+
+    for (SizeValueType i = 0; i < numberOfIndices; ++i)
+    {
+      // As in EvaluateOptimized, a dimension is not interpolated across when
+      // the distance to the base index is not positive, or when the upper
+      // neighbor is past the end index. Its upper neighbors are then the
+      // lower ones, at distance zero.
+      OffsetValueType         baseOffset = 0;
+      OffsetValueType         upperOffsets[ImageDimension];
+      InternalComputationType distance[ImageDimension];
+      for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+      {
+        const IndexValueType baseIndex =
+          std::max(Math::Floor<IndexValueType>(indices[i][dim]), this->m_StartIndex[dim]);
+        distance[dim] = indices[i][dim] - static_cast<InternalComputationType>(baseIndex);
+        baseOffset += (baseIndex - bufferIndex[dim]) * offsetTable[dim];
+        upperOffsets[dim] = offsetTable[dim];
+        if (distance[dim] <= 0. || baseIndex + 1 > this->m_EndIndex[dim])
+        {
+          distance[dim] = 0.;
+          upperOffsets[dim] = 0;
+        }
+      }
+
+      // Bit dim of a neighbor number tells whether it is the upper neighbor
+      // in dimension dim.
+      const InternalPixelType * neighbors[numberOfNeighbors];
+      for (unsigned int neighbor = 0; neighbor < numberOfNeighbors; ++neighbor)
+      {
+        OffsetValueType offset = baseOffset;
+        for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+        {
+          if ((neighbor >> dim) & 1)
+          {
+            offset += upperOffsets[dim];
+          }
+        }
+        neighbors[neighbor] = buffer + offset * numberOfComponents;
+      }
+
+      // Interpolate across "x", then across "y", and so on, in the order of
+      // EvaluateOptimized. The unoptimized evaluation of images of more than
+      // three dimensions sums weighted neighbors instead, which agrees up to
+      // rounding.
+      OutputType & value = values[i];
+      value.SetSize(numberOfComponents, typename OutputType::DontShrinkToFit(), typename OutputType::DumpOldValues());
+      for (unsigned int c = 0; c < numberOfComponents; ++c)
+      {
+        ValueType interpolated[numberOfNeighbors];
+        for (unsigned int neighbor = 0; neighbor < numberOfNeighbors; ++neighbor)
+        {
+          interpolated[neighbor] = static_cast<ValueType>(neighbors[neighbor][c]);
+        }
+        for (unsigned int dim = 0, width = numberOfNeighbors / 2; dim < ImageDimension; ++dim, width /= 2)
+        {
+          for (unsigned int n = 0; n < width; ++n)
+          {
+            interpolated[n] = interpolated[2 * n] + (interpolated[2 * n + 1] - interpolated[2 * n]) * distance[dim];
+          }
+        }
+        value[c] = interpolated[0];
+      }
+    }
+  }
+  else
+  {
+    Superclass::EvaluateAtContinuousIndices(indices, values, numberOfIndices);
+  }
+}
+
 template <typename TInputImage, typename TCoordinate>
 void
 LinearInterpolateImageFunction<TInputImage, TCoordinate>::PrintSelf(std::ostream & os, Indent indent) const
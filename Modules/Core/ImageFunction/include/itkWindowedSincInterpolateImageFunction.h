@@ -306,6 +306,22 @@ public:
   OutputType
   EvaluateAtContinuousIndex(const ContinuousIndexType & index) const override;
 
+  /** Evaluate the function at numberOfIndices ContinuousIndex positions
+   *
+   * The weights of a dimension are only computed again where the index
+   * changes in that dimension, and the pixels of neighborhoods within the
+   * buffered region are read without a neighborhood iterator. When the
+   * indices only change in one dimension, as along a scanline of an axis
+   * aligned resampling, and the pixels are scalars, the neighborhood is
+   * summed across the other dimensions once per position along the line, and
+   * shared by the neighboring indices. Neighborhoods that cross the border
+   * are evaluated by EvaluateAtContinuousIndex.
+   */
+  void
+  EvaluateAtContinuousIndices(const ContinuousIndexType * indices,
+                              OutputType *                values,
+                              SizeValueType               numberOfIndices) const override;
+
   SizeType
   GetRadius() const override
   {
@@ -326,6 +342,16 @@ private:
   // Constant to store twice the radius
   static constexpr unsigned int m_WindowSize{ 2 * VRadius };
 
+  /** Computes the weights of the neighbors in one dimension, and returns the
+   * floor of the coordinate x. */
+  IndexValueType
+  ComputeWeights(const TCoordinate x, double * weights) const;
+
+  /** Returns whether the neighborhood of baseIndex along dimension dim is
+   * within the buffered region. */
+  bool
+  IsNeighborhoodInsideBuffer(const unsigned int dim, const IndexValueType baseIndex) const;
+
   /** The function object, used to compute window */
   TWindowFunction m_WindowFunction{};
 
@@ -21,6 +21,9 @@
 
 #include "itkMath.h"
 
+#include <algorithm>
+#include <type_traits>
+
 namespace itk
 {
 template <typename TInputImage,
@@ -110,14 +113,10 @@ WindowedSincInterpolateImageFunction<TInputImage, VRadius, TWindowFunction, TBou
   EvaluateAtContinuousIndex(const ContinuousIndexType & index) const -> OutputType
 {
   IndexType baseIndex;
-  double    distance[ImageDimension];
-
-  // Compute the integer index based on the continuous one by
-  // 'flooring' the index
+  double    xWeight[ImageDimension][2 * VRadius];
   for (unsigned int dim = 0; dim < ImageDimension; ++dim)
   {
-    baseIndex[dim] = Math::Floor<IndexValueType>(index[dim]);
-    distance[dim] = index[dim] - static_cast<double>(baseIndex[dim]);
+    baseIndex[dim] = this->ComputeWeights(index[dim], xWeight[dim]);
   }
 
   // Position the neighborhood at the index of interest
@@ -125,38 +124,6 @@ WindowedSincInterpolateImageFunction<TInputImage, VRadius, TWindowFunction, TBou
   IteratorType nit(radius, this->GetInputImage(), this->GetInputImage()->GetBufferedRegion());
   nit.SetLocation(baseIndex);
 
-  // Compute the sinc function for each dimension
-  double xWeight[ImageDimension][2 * VRadius];
-  for (unsigned int dim = 0; dim < ImageDimension; ++dim)
-  {
-    // x is the offset, hence the parameter of the kernel
-    double x = distance[dim] + VRadius;
-
-    // If distance is zero, i.e. the index falls precisely on the
-    // pixel boundary, the weights form a delta function.
-    if (distance[dim] == 0.0)
-    {
-      for (unsigned int i = 0; i < m_WindowSize; ++i)
-      {
-        xWeight[dim][i] = static_cast<int>(i) == VRadius - 1 ? 1 : 0;
-      }
-    }
-    else
-    {
-      // i is the relative offset in dimension dim.
-      for (unsigned int i = 0; i < m_WindowSize; ++i)
-      {
-        // Increment the offset, taking it through the range
-        // (dist + rad - 1, ..., dist - rad), i.e. all x
-        // such that itk::Math::abs(x) <= rad
-        x -= 1.0;
-
-        // Compute the weight for this m
-        xWeight[dim][i] = m_WindowFunction(x) * Sinc(x);
-      }
-    }
-  }
-
   // Iterate over the neighborhood, taking the correct set
   // of weights in each dimension
   using PixelType = typename NumericTraits<typename TInputImage::PixelType>::RealType;
@@ -183,6 +150,257 @@ WindowedSincInterpolateImageFunction<TInputImage, VRadius, TWindowFunction, TBou
   // Return the interpolated value
   return static_cast<OutputType>(xPixelValue);
 }
+
+template <typename TInputImage,
+          unsigned int VRadius,
+          typename TWindowFunction,
+          typename TBoundaryCondition,
+          typename TCoordinate>
+auto
+WindowedSincInterpolateImageFunction<TInputImage, VRadius, TWindowFunction, TBoundaryCondition, TCoordinate>::
+  ComputeWeights(const TCoordinate x, double * weights) const -> IndexValueType
+{
+  // Compute the integer index based on the continuous one by
+  // 'flooring' the index
+  const IndexValueType baseIndex = Math::Floor<IndexValueType>(x);
+  const double         distance = x - static_cast<double>(baseIndex);
+
+  // If distance is zero, i.e. the index falls precisely on the
+  // pixel boundary, the weights form a delta function.
+  if (distance == 0.0)
+  {
+    for (unsigned int i = 0; i < m_WindowSize; ++i)
+    {
+      weights[i] = static_cast<int>(i) == VRadius - 1 ? 1 : 0;
+    }
+  }
+  else
+  {
+    // xi is the offset, hence the parameter of the kernel
+    double xi = distance + VRadius;
+
+    // i is the relative offset in dimension dim.
+    for (unsigned int i = 0; i < m_WindowSize; ++i)
+    {
+      // Increment the offset, taking it through the range
+      // (dist + rad - 1, ..., dist - rad), i.e. all x
+      // such that itk::Math::abs(x) <= rad
+      xi -= 1.0;
+
+      // Compute the weight for this m
+      weights[i] = m_WindowFunction(xi) * Sinc(xi);
+    }
+  }
+  return baseIndex;
+}
+
+template <typename TInputImage,
+          unsigned int VRadius,
+          typename TWindowFunction,
+          typename TBoundaryCondition,
+          typename TCoordinate>
+bool
+WindowedSincInterpolateImageFunction<TInputImage, VRadius, TWindowFunction, TBoundaryCondition, TCoordinate>::
+  IsNeighborhoodInsideBuffer(const unsigned int dim, const IndexValueType baseIndex) const
+{
+  const auto &         bufferedRegion = this->GetInputImage()->GetBufferedRegion();
+  const IndexValueType first = bufferedRegion.GetIndex(dim);
+  const auto           size = static_cast<IndexValueType>(bufferedRegion.GetSize(dim));
+  return baseIndex - static_cast<IndexValueType>(VRadius) + 1 >= first &&
+         baseIndex + static_cast<IndexValueType>(VRadius) < first + size;
+}
+
+template <typename TInputImage,
+          unsigned int VRadius,
+          typename TWindowFunction,
+          typename TBoundaryCondition,
+          typename TCoordinate>
+void
+WindowedSincInterpolateImageFunction<TInputImage, VRadius, TWindowFunction, TBoundaryCondition, TCoordinate>::
+  EvaluateAtContinuousIndices(const ContinuousIndexType * indices,
+                              OutputType *                values,
+                              SizeValueType               numberOfIndices) const
+{
+  if (numberOfIndices == 0)
+  {
+    return;
+  }
+  const ImageType *       image = this->GetInputImage();
+  const OffsetValueType * offsetTable = image->GetOffsetTable();
+  const auto *            buffer = image->GetBufferPointer();
+  auto                    accessor = image->GetNeighborhoodAccessor();
+  accessor.SetBegin(buffer);
+
+  // Find the dimensions in which the indices change.
+  unsigned int numberOfChangingDimensions = 0;
+  unsigned int lineDimension = 0;
+  for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+  {
+    for (SizeValueType i = 1; i < numberOfIndices; ++i)
+    {
+      if (indices[i][dim] != indices[0][dim])
+      {
+        ++numberOfChangingDimensions;
+        lineDimension = dim;
+        break;
+      }
+    }
+  }
+
+  double         xWeight[ImageDimension][2 * VRadius];
+  IndexType      baseIndex;
+  bool           isInside[ImageDimension];
+  constexpr auto firstNeighbor = static_cast<IndexValueType>(VRadius) - 1;
+
+  if constexpr (std::is_arithmetic_v<RealType>)
+  {
+    bool isLineInside = numberOfChangingDimensions <= 1;
+    for (unsigned int dim = 0; dim < ImageDimension && isLineInside; ++dim)
+    {
+      if (dim != lineDimension)
+      {
+        baseIndex[dim] = this->ComputeWeights(indices[0][dim], xWeight[dim]);
+        isLineInside = this->IsNeighborhoodInsideBuffer(dim, baseIndex[dim]);
+      }
+    }
+
+    if (isLineInside)
+    {
+      // The indices lie on a line along lineDimension, and the neighborhoods
+      // are within the buffered region in the other dimensions. The kernel is
+      // separable: the neighborhood is first summed across the other
+      // dimensions, with weights that are the same for all indices, once per
+      // position along the line. Each value is then a sum of m_WindowSize of
+      // these line values.
+      constexpr unsigned int NumberOfRows = Math::UnsignedPower(m_WindowSize, ImageDimension - 1);
+      OffsetValueType        rowOffsets[NumberOfRows];
+      double                 rowWeights[NumberOfRows];
+      rowOffsets[0] = 0;
+      rowWeights[0] = 1.0;
+      unsigned int numberOfRows = 1;
+      for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+      {
+        if (dim == lineDimension)
+        {
+          continue;
+        }
+        const IndexValueType first = baseIndex[dim] - firstNeighbor - image->GetBufferedRegion().GetIndex(dim);
+        // Expand the rows in place, those for i = 0 last.
+        for (unsigned int i = m_WindowSize; i-- > 0;)
+        {
+          const OffsetValueType offset = (first + i) * offsetTable[dim];
+          for (unsigned int r = numberOfRows; r-- > 0;)
+          {
+            rowOffsets[i * numberOfRows + r] = rowOffsets[r] + offset;
+            rowWeights[i * numberOfRows + r] = rowWeights[r] * xWeight[dim][i];
+          }
+        }
+        numberOfRows *= m_WindowSize;
+      }
+
+      // The line values are computed when first needed, within a window of
+      // positions along the line that follows the indices. The cache holds at
+      // least two windows, so that wide kernels fit as well.
+      constexpr IndexValueType WindowSize = m_WindowSize;
+      constexpr IndexValueType CacheSize = std::max<IndexValueType>(64, 2 * WindowSize);
+      double                   lineValues[CacheSize];
+      bool                     isLineValueComputed[CacheSize];
+      IndexValueType           cacheStart = 0;
+      bool                     isCacheValid = false;
+      const IndexValueType     lineBufferIndex = image->GetBufferedRegion().GetIndex(lineDimension);
+      double *                 lineWeights = xWeight[lineDimension];
+      for (SizeValueType i = 0; i < numberOfIndices; ++i)
+      {
+        const IndexValueType lineBaseIndex = this->ComputeWeights(indices[i][lineDimension], lineWeights);
+        if (!this->IsNeighborhoodInsideBuffer(lineDimension, lineBaseIndex))
+        {
+          values[i] = this->EvaluateAtContinuousIndex(indices[i]);
+          continue;
+        }
+        const IndexValueType first = lineBaseIndex - firstNeighbor;
+        if (!isCacheValid || first < cacheStart || first + WindowSize > cacheStart + CacheSize)
+        {
+          cacheStart = (isCacheValid && first < cacheStart) ? first + WindowSize - CacheSize : first;
+          std::fill_n(isLineValueComputed, CacheSize, false);
+          isCacheValid = true;
+        }
+
+        double value = 0.0;
+        for (unsigned int k = 0; k < m_WindowSize; ++k)
+        {
+          const IndexValueType position = first + k - cacheStart;
+          if (!isLineValueComputed[position])
+          {
+            const OffsetValueType lineOffset = (first + k - lineBufferIndex) * offsetTable[lineDimension];
+            double                lineValue = 0.0;
+            for (unsigned int r = 0; r < NumberOfRows; ++r)
+            {
+              lineValue += rowWeights[r] * static_cast<double>(accessor.Get(buffer + lineOffset + rowOffsets[r]));
+            }
+            lineValues[position] = lineValue;
+            isLineValueComputed[position] = true;
+          }
+          value += lineWeights[k] * lineValues[position];
+        }
+        values[i] = static_cast<OutputType>(value);
+      }
+      return;
+    }
+  }
+
+  // The buffer offsets of the neighbors in m_OffsetTable, relative to the
+  // first neighbor.
+  OffsetValueType neighborOffsets[m_OffsetTableSize];
+  for (unsigned int j = 0; j < m_OffsetTableSize; ++j)
+  {
+    neighborOffsets[j] = 0;
+    for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+    {
+      neighborOffsets[j] += static_cast<OffsetValueType>(m_WeightOffsetTable[j][dim]) * offsetTable[dim];
+    }
+  }
+
+  // Compute the weights of a dimension only where the index changes in that
+  // dimension, and iterate over the neighborhood in the order of
+  // EvaluateAtContinuousIndex.
+  using PixelType = typename NumericTraits<typename TInputImage::PixelType>::RealType;
+  for (SizeValueType i = 0; i < numberOfIndices; ++i)
+  {
+    bool isAllInside = true;
+    for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+    {
+      if (i == 0 || indices[i][dim] != indices[i - 1][dim])
+      {
+        baseIndex[dim] = this->ComputeWeights(indices[i][dim], xWeight[dim]);
+        isInside[dim] = this->IsNeighborhoodInsideBuffer(dim, baseIndex[dim]);
+      }
+      isAllInside &= isInside[dim];
+    }
+    if (!isAllInside)
+    {
+      values[i] = this->EvaluateAtContinuousIndex(indices[i]);
+      continue;
+    }
+
+    IndexType firstIndex;
+    for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+    {
+      firstIndex[dim] = baseIndex[dim] - firstNeighbor;
+    }
+    const auto * first = buffer + image->ComputeOffset(firstIndex);
+    PixelType    xPixelValue{};
+    for (unsigned int j = 0; j < m_OffsetTableSize; ++j)
+    {
+      PixelType xVal = accessor.Get(first + neighborOffsets[j]);
+      for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+      {
+        xVal *= xWeight[dim][m_WeightOffsetTable[j][dim]];
+      }
+      xPixelValue += xVal;
+    }
+    values[i] = static_cast<OutputType>(xPixelValue);
+  }
+}
 } // namespace itk
 
 #endif
@@ -0,0 +1,241 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkBSplineInterpolateImageFunction.h"
+#include "itkBSplineDecompositionImageFilter.h"
+#include "itkBSplineDerivativeKernelFunction.h"
+#include "itkBSplineKernelFunction.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkLinearInterpolateImageFunction.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkTimeProbe.h"
+#include "itkTestingMacros.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+/*
+ * Reports the number of evaluations per second of the B-spline interpolator
+ * for each spline order, next to the linear interpolator, and checks the
+ * values and derivatives away from the borders against sums of B-spline
+ * kernels over the coefficients.
+ */
+
+namespace
+{
+template <unsigned int VDimension, unsigned int VSplineOrder>
+bool
+CompareToKernelSums(const itk::Image<float, VDimension> *                                       image,
+                    const itk::BSplineInterpolateImageFunction<itk::Image<float, VDimension>> * interpolator,
+                    const std::vector<itk::ContinuousIndex<double, VDimension>> &               indices)
+{
+  using ImageType = itk::Image<float, VDimension>;
+  using InterpolatorType = itk::BSplineInterpolateImageFunction<ImageType>;
+  using CoefficientImageType = typename InterpolatorType::CoefficientImageType;
+
+  auto decomposition = itk::BSplineDecompositionImageFilter<ImageType, CoefficientImageType>::New();
+  decomposition->SetSplineOrder(VSplineOrder);
+  decomposition->SetInput(image);
+  decomposition->Update();
+  const CoefficientImageType * coefficients = decomposition->GetOutput();
+
+  auto kernel = itk::BSplineKernelFunction<VSplineOrder>::New();
+  auto derivativeKernel = itk::BSplineDerivativeKernelFunction<VSplineOrder>::New();
+
+  const auto size = image->GetBufferedRegion().GetSize();
+  for (const auto & x : indices)
+  {
+    // Only where the region of support needs no mirroring.
+    bool inside = true;
+    for (unsigned int d = 0; d < VDimension; ++d)
+    {
+      inside &= x[d] > VSplineOrder && x[d] < size[d] - 1.0 - VSplineOrder;
+    }
+    if (!inside)
+    {
+      continue;
+    }
+
+    itk::Index<VDimension> first;
+    itk::Size<VDimension>  supportSize;
+    for (unsigned int d = 0; d < VDimension; ++d)
+    {
+      first[d] = static_cast<itk::IndexValueType>(std::ceil(x[d] - 0.5 * (VSplineOrder + 1)));
+      supportSize[d] = VSplineOrder + 1;
+    }
+    double                                   expectedValue = 0.0;
+    itk::CovariantVector<double, VDimension> expectedDerivative{};
+    for (itk::ImageRegionConstIteratorWithIndex<CoefficientImageType> it(coefficients, { first, supportSize });
+         !it.IsAtEnd();
+         ++it)
+    {
+      double weight = 1.0;
+      double derivativeWeights[VDimension];
+      std::fill_n(derivativeWeights, VDimension, 1.0);
+      for (unsigned int d = 0; d < VDimension; ++d)
+      {
+        const double u = x[d] - it.GetIndex()[d];
+        weight *= kernel->Evaluate(u);
+        for (unsigned int e = 0; e < VDimension; ++e)
+        {
+          derivativeWeights[e] *= (e == d) ? derivativeKernel->Evaluate(u) : kernel->Evaluate(u);
+        }
+      }
+      expectedValue += weight * it.Get();
+      for (unsigned int d = 0; d < VDimension; ++d)
+      {
+        expectedDerivative[d] += derivativeWeights[d] * it.Get();
+      }
+    }
+
+    typename InterpolatorType::OutputType          value;
+    typename InterpolatorType::CovariantVectorType derivative;
+    interpolator->EvaluateValueAndDerivativeAtContinuousIndex(x, value, derivative);
+    const double valueOnly = interpolator->EvaluateAtContinuousIndex(x);
+    const auto   derivativeOnly = interpolator->EvaluateDerivativeAtContinuousIndex(x);
+
+    constexpr double tolerance = 1e-9;
+    bool             success = std::abs(value - expectedValue) <= tolerance * (1.0 + std::abs(expectedValue)) &&
+                   value == valueOnly && derivative == derivativeOnly;
+    for (unsigned int d = 0; d < VDimension; ++d)
+    {
+      success &= std::abs(derivative[d] - expectedDerivative[d]) <= tolerance * (1.0 + expectedDerivative.GetNorm());
+    }
+    if (!success)
+    {
+      std::cerr << "Order " << VSplineOrder << " at " << x << ": value " << value << " (" << valueOnly
+                << ") derivative " << derivative << " (" << derivativeOnly << ") instead of " << expectedValue << " "
+                << expectedDerivative << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+template <unsigned int VDimension>
+bool
+TimeInterpolators(const unsigned int imageSize, const unsigned int numberOfIndices)
+{
+  using ImageType = itk::Image<float, VDimension>;
+  using IndexType = itk::ContinuousIndex<double, VDimension>;
+  using InterpolatorType = itk::BSplineInterpolateImageFunction<ImageType>;
+
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType::Filled(imageSize));
+  image->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    double value = 0.0;
+    for (unsigned int d = 0; d < VDimension; ++d)
+    {
+      value += std::sin(0.3 * (d + 1) * it.GetIndex()[d]);
+    }
+    it.Set(static_cast<float>(100.0 * value));
+  }
+
+  // Within the buffer, including the mirrored borders.
+  auto generator = itk::Statistics::MersenneTwisterRandomVariateGenerator::New();
+  generator->Initialize(20240612);
+  std::vector<IndexType> indices(numberOfIndices);
+  for (auto & index : indices)
+  {
+    for (unsigned int d = 0; d < VDimension; ++d)
+    {
+      index[d] = generator->GetUniformVariate(-0.5, imageSize - 0.5);
+    }
+  }
+
+  const auto report = [numberOfIndices, &indices](const char * name, const auto & evaluate) {
+    itk::TimeProbe probe;
+    double         total = 0.0;
+    probe.Start();
+    for (const auto & index : indices)
+    {
+      total += evaluate(index);
+    }
+    probe.Stop();
+    std::cout << "  " << name << ": " << 1e-6 * numberOfIndices / probe.GetTotal() << " M/s (" << total << ")"
+              << std::endl;
+  };
+
+  std::cout << VDimension << "D, " << imageSize << " voxels per side, " << numberOfIndices << " evaluations"
+            << std::endl;
+  auto linear = itk::LinearInterpolateImageFunction<ImageType>::New();
+  linear->SetInputImage(image);
+  report("linear value", [&linear](const IndexType & index) { return linear->EvaluateAtContinuousIndex(index); });
+
+  bool success = true;
+  auto interpolator = InterpolatorType::New();
+  for (unsigned int splineOrder = 0; splineOrder <= 5; ++splineOrder)
+  {
+    interpolator->SetSplineOrder(splineOrder);
+    interpolator->SetInputImage(image);
+    std::cout << " spline order " << splineOrder << std::endl;
+    report("value",
+           [&interpolator](const IndexType & index) { return interpolator->EvaluateAtContinuousIndex(index); });
+    if (splineOrder == 0)
+    {
+      continue;
+    }
+    report("derivative", [&interpolator](const IndexType & index) {
+      return interpolator->EvaluateDerivativeAtContinuousIndex(index)[0];
+    });
+    report("value and derivative", [&interpolator](const IndexType & index) {
+      typename InterpolatorType::OutputType          value;
+      typename InterpolatorType::CovariantVectorType derivative;
+      interpolator->EvaluateValueAndDerivativeAtContinuousIndex(index, value, derivative);
+      return value + derivative[0];
+    });
+
+    switch (splineOrder)
+    {
+      case 1:
+        success &= CompareToKernelSums<VDimension, 1>(image, interpolator, indices);
+        break;
+      case 2:
+        success &= CompareToKernelSums<VDimension, 2>(image, interpolator, indices);
+        break;
+      case 3:
+        success &= CompareToKernelSums<VDimension, 3>(image, interpolator, indices);
+        break;
+      default:
+        break;
+    }
+  }
+  return success;
+}
+} // namespace
+
+int
+itkBSplineInterpolateImageFunctionSpeedTest(int argc, char * argv[])
+{
+  const unsigned int imageSize = (argc > 1) ? std::stoi(argv[1]) : 32;
+  const unsigned int numberOfIndices = (argc > 2) ? std::stoi(argv[2]) : 100000;
+
+  bool success = true;
+  success &= TimeInterpolators<2>(imageSize, numberOfIndices);
+  success &= TimeInterpolators<3>(imageSize, numberOfIndices);
+
+  if (!success)
+  {
+    std::cout << "Test FAILED!" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -23,6 +23,9 @@
 #include "itkImageRegionIteratorWithIndex.h"
 #include "itkRGBPixel.h"
 
+#include <cmath>
+#include <vector>
+
 namespace SincInterpolate
 {
 
@@ -121,6 +124,63 @@ TestContinuousIndex(const InterpolatorType *    interp,
   return true;
 }
 
+/**
+ * Compare EvaluateAtContinuousIndices to EvaluateAtContinuousIndex for a
+ * kernel of radius 40, along a scanline whose neighborhoods fit across the
+ * line, where the batch sums each kernel line once, and along a diagonal. Returns true if test has passed,
+ * returns false otherwise
+ */
+bool
+TestWideKernelBatch()
+{
+  using WideImageType = itk::Image<float, 2>;
+  using WideInterpolatorType = itk::WindowedSincInterpolateImageFunction<WideImageType, 40>;
+
+  auto image = WideImageType::New();
+  image->SetRegions(WideImageType::SizeType{ { 200, 120 } });
+  image->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<WideImageType> iter(image, image->GetBufferedRegion()); !iter.IsAtEnd();
+       ++iter)
+  {
+    const itk::IndexValueType x = iter.GetIndex()[0];
+    const itk::IndexValueType y = iter.GetIndex()[1];
+    iter.Set(static_cast<float>(50.0 * std::sin(0.2 * x) * std::cos(0.15 * y) + ((x * 7 + y * 13) % 11)));
+  }
+
+  auto interp = WideInterpolatorType::New();
+  interp->SetInputImage(image);
+
+  std::vector<WideInterpolatorType::ContinuousIndexType> scanline;
+  std::vector<WideInterpolatorType::ContinuousIndexType> diagonal;
+  for (double t = 0.2; t < 198.5; t += 0.61)
+  {
+    WideInterpolatorType::ContinuousIndexType cindex;
+    cindex[0] = t;
+    cindex[1] = 60.4;
+    scanline.push_back(cindex);
+    cindex[1] = 0.5 * t + 10.3;
+    diagonal.push_back(cindex);
+  }
+
+  bool passed = true;
+  for (const auto * indices : { &scanline, &diagonal })
+  {
+    std::vector<WideInterpolatorType::OutputType> values(indices->size());
+    interp->EvaluateAtContinuousIndices(indices->data(), values.data(), indices->size());
+    for (size_t i = 0; i < indices->size(); ++i)
+    {
+      const WideInterpolatorType::OutputType expected = interp->EvaluateAtContinuousIndex((*indices)[i]);
+      if (itk::Math::abs(values[i] - expected) > 1e-9 * (1.0 + itk::Math::abs(expected)))
+      {
+        std::cout << " *** Error: Batch value at " << (*indices)[i] << " is " << values[i] << " but should be "
+                  << expected << std::endl;
+        passed = false;
+      }
+    }
+  }
+  return passed;
+}
+
 // Test instantiation with RGB pixel type
 using RGBInterpolatorType = itk::WindowedSincInterpolateImageFunction<itk::Image<itk::RGBPixel<short>>, 3>;
 
@@ -303,6 +363,12 @@ itkWindowedSincInterpolateImageFunctionTest(int, char *[])
     flag = 1;
   }
 
+  std::cout << "Batch evaluation with radius 40" << std::endl;
+  if (!SincInterpolate::TestWideKernelBatch())
+  {
+    flag = 1;
+  }
+
   /* Return results of test */
   if (flag != 0)
   {
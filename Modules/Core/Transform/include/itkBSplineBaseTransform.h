@@ -255,6 +255,26 @@ public:
                  ParameterIndexArrayType & indices,
                  bool &                    inside) const = 0;
 
+  using Superclass::TransformPoints;
+
+  /**
+   * Transform a batch of points, returning for each of them the sparse
+   * Jacobian with respect to the parameters: the interpolation weights, the
+   * indices of the coefficient parameters they apply to, and whether the point
+   * was inside the valid region, as the TransformPoint overload above does for
+   * a single point. As Transform::TransformPoints, it uses the batched form,
+   * BatchedTransformPoints, only for objects of exactly the class returned by
+   * GetBatchedTransformClass(), and calls that overload for each point
+   * otherwise.
+   */
+  void
+  TransformPoints(const InputPointType *    inputPoints,
+                  OutputPointType *         outputPoints,
+                  WeightsType *             weights,
+                  ParameterIndexArrayType * indices,
+                  bool *                    inside,
+                  SizeValueType             numberOfPoints) const;
+
 #if !defined(ITK_LEGACY_REMOVE)
   /** Get number of weights. */
   itkLegacyMacro(unsigned long GetNumberOfWeights() const)
@@ -352,6 +372,19 @@ protected:
   void
   WrapAsImages();
 
+  using Superclass::BatchedTransformPoints;
+
+  /** Batched form of the TransformPoints overload returning sparse
+   * Jacobians. The default implementation calls the TransformPoint overload
+   * returning them for each point. */
+  virtual void
+  BatchedTransformPoints(const InputPointType *    inputPoints,
+                         OutputPointType *         outputPoints,
+                         WeightsType *             weights,
+                         ParameterIndexArrayType * indices,
+                         bool *                    inside,
+                         SizeValueType             numberOfPoints) const;
+
 protected:
   /** Construct control point grid from transform domain information */
   void
@@ -307,5 +307,46 @@ BSplineBaseTransform<TParametersValueType, VDimension, VSplineOrder>::TransformP
   return outputPoint;
 }
 
+
+template <typename TParametersValueType, unsigned int VDimension, unsigned int VSplineOrder>
+void
+BSplineBaseTransform<TParametersValueType, VDimension, VSplineOrder>::TransformPoints(
+  const InputPointType *    inputPoints,
+  OutputPointType *         outputPoints,
+  WeightsType *             weights,
+  ParameterIndexArrayType * indices,
+  bool *                    inside,
+  SizeValueType             numberOfPoints) const
+{
+  if (this->IsOfBatchedTransformClass())
+  {
+    this->BatchedTransformPoints(inputPoints, outputPoints, weights, indices, inside, numberOfPoints);
+  }
+  else
+  {
+    this->BSplineBaseTransform::BatchedTransformPoints(
+      inputPoints, outputPoints, weights, indices, inside, numberOfPoints);
+  }
+}
+
+
+template <typename TParametersValueType, unsigned int VDimension, unsigned int VSplineOrder>
+void
+BSplineBaseTransform<TParametersValueType, VDimension, VSplineOrder>::BatchedTransformPoints(
+  const InputPointType *    inputPoints,
+  OutputPointType *         outputPoints,
+  WeightsType *             weights,
+  ParameterIndexArrayType * indices,
+  bool *                    inside,
+  SizeValueType             numberOfPoints) const
+{
+  for (SizeValueType i = 0; i < numberOfPoints; ++i)
+  {
+    // Copied, since the output may overwrite it.
+    const InputPointType point = inputPoints[i];
+    this->TransformPoint(point, outputPoints[i], weights[i], indices[i], inside[i]);
+  }
+}
+
 } // namespace itk
 #endif
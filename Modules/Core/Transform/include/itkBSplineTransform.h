@@ -292,6 +292,30 @@ protected:
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
+  /** \see Transform::GetBatchedTransformClass() */
+  const std::type_info *
+  GetBatchedTransformClass() const override
+  {
+    return &typeid(Self);
+  }
+
+  /** Transform a batch of points, with the coefficient buffers and the
+   * layout of the support region looked up once for the whole batch. */
+  void
+  BatchedTransformPoints(const InputPointType * inputPoints,
+                         OutputPointType *      outputPoints,
+                         SizeValueType          numberOfPoints) const override;
+
+  /** Transform a batch of points, returning their sparse Jacobians as the
+   * TransformPoint overload above does. */
+  void
+  BatchedTransformPoints(const InputPointType *    inputPoints,
+                         OutputPointType *         outputPoints,
+                         WeightsType *             weights,
+                         ParameterIndexArrayType * indices,
+                         bool *                    inside,
+                         SizeValueType             numberOfPoints) const override;
+
   BSplineTransform();
   ~BSplineTransform() override = default;
 
@@ -318,6 +342,19 @@ private:
   bool
   InsideValidRegion(ContinuousIndexType &) const override;
 
+  /** Shared implementation of the BatchedTransformPoints overloads. The weights,
+   * indices and inside flag of each point are stored at the point's position
+   * in the arrays when \c sparseJacobianPerPoint is true, and in their
+   * first elements, overwritten from point to point, otherwise. */
+  void
+  TransformPointsWithSparseJacobians(const InputPointType *    inputPoints,
+                                     OutputPointType *         outputPoints,
+                                     WeightsType *             weights,
+                                     ParameterIndexArrayType * indices,
+                                     bool *                    inside,
+                                     SizeValueType             numberOfPoints,
+                                     bool                      sparseJacobianPerPoint) const;
+
   void
   SetFixedParametersFromCoefficientImageInformation();
 
@@ -592,6 +592,120 @@ BSplineTransform<TParametersValueType, VDimension, VSplineOrder>::TransformPoint
   }
 }
 
+template <typename TParametersValueType, unsigned int VDimension, unsigned int VSplineOrder>
+void
+BSplineTransform<TParametersValueType, VDimension, VSplineOrder>::BatchedTransformPoints(
+  const InputPointType * inputPoints,
+  OutputPointType *      outputPoints,
+  SizeValueType          numberOfPoints) const
+{
+  WeightsType             weights;
+  ParameterIndexArrayType indices;
+  bool                    inside;
+
+  this->TransformPointsWithSparseJacobians(
+    inputPoints, outputPoints, &weights, &indices, &inside, numberOfPoints, false);
+}
+
+template <typename TParametersValueType, unsigned int VDimension, unsigned int VSplineOrder>
+void
+BSplineTransform<TParametersValueType, VDimension, VSplineOrder>::BatchedTransformPoints(
+  const InputPointType *    inputPoints,
+  OutputPointType *         outputPoints,
+  WeightsType *             weights,
+  ParameterIndexArrayType * indices,
+  bool *                    inside,
+  SizeValueType             numberOfPoints) const
+{
+  this->TransformPointsWithSparseJacobians(inputPoints, outputPoints, weights, indices, inside, numberOfPoints, true);
+}
+
+template <typename TParametersValueType, unsigned int VDimension, unsigned int VSplineOrder>
+void
+BSplineTransform<TParametersValueType, VDimension, VSplineOrder>::TransformPointsWithSparseJacobians(
+  const InputPointType *    inputPoints,
+  OutputPointType *         outputPoints,
+  WeightsType *             weights,
+  ParameterIndexArrayType * indices,
+  bool *                    inside,
+  SizeValueType             numberOfPoints,
+  bool                      sparseJacobianPerPoint) const
+{
+  const ImageType * coefficientImage = this->m_CoefficientImages[0];
+  if (!coefficientImage->GetBufferPointer())
+  {
+    itkWarningMacro("B-spline coefficients have not been set");
+    for (SizeValueType i = 0; i < numberOfPoints; ++i)
+    {
+      inside[sparseJacobianPerPoint ? i : 0] = true;
+      outputPoints[i] = inputPoints[i];
+    }
+    return;
+  }
+
+  const ParametersValueType * coefficients[SpaceDimension];
+  for (unsigned int j = 0; j < SpaceDimension; ++j)
+  {
+    coefficients[j] = this->m_CoefficientImages[j]->GetBufferPointer();
+  }
+
+  // Offsets of the coefficients of the support region from its first one, in
+  // the order of the weights, which is the order TransformPoint visits them in.
+  const OffsetValueType * offsetTable = coefficientImage->GetOffsetTable();
+  OffsetValueType         supportOffsets[Superclass::NumberOfWeights];
+  for (unsigned int k = 0; k < Superclass::NumberOfWeights; ++k)
+  {
+    unsigned int remainder = k;
+    supportOffsets[k] = 0;
+    for (unsigned int d = 0; d < SpaceDimension; ++d)
+    {
+      supportOffsets[k] += static_cast<OffsetValueType>(remainder % (SplineOrder + 1)) * offsetTable[d];
+      remainder /= SplineOrder + 1;
+    }
+  }
+
+  for (SizeValueType i = 0; i < numberOfPoints; ++i)
+  {
+    // Copied, since the output may overwrite it.
+    const InputPointType      point = inputPoints[i];
+    const SizeValueType       s = sparseJacobianPerPoint ? i : 0;
+    WeightsType &             pointWeights = weights[s];
+    ParameterIndexArrayType & pointIndices = indices[s];
+    using ContinuousIndexValueType = typename ContinuousIndexType::ValueType;
+    ContinuousIndexType index =
+      coefficientImage->template TransformPhysicalPointToContinuousIndex<ContinuousIndexValueType>(point);
+
+    // NOTE: if the support region does not lie totally within the grid
+    // we assume zero displacement and return the input point
+    inside[s] = this->InsideValidRegion(index);
+    if (!inside[s])
+    {
+      outputPoints[i] = point;
+      continue;
+    }
+
+    IndexType supportIndex;
+    this->m_WeightsFunction->Evaluate(index, pointWeights, supportIndex);
+    const OffsetValueType supportStart = coefficientImage->ComputeOffset(supportIndex);
+
+    // Same order of operations as TransformPoint, for identical results.
+    ScalarType displacement[SpaceDimension]{};
+    for (unsigned int k = 0; k < Superclass::NumberOfWeights; ++k)
+    {
+      const OffsetValueType offset = supportStart + supportOffsets[k];
+      for (unsigned int j = 0; j < SpaceDimension; ++j)
+      {
+        displacement[j] += static_cast<ScalarType>(pointWeights[k] * coefficients[j][offset]);
+      }
+      pointIndices[k] = static_cast<unsigned long>(offset);
+    }
+    for (unsigned int j = 0; j < SpaceDimension; ++j)
+    {
+      outputPoints[i][j] = displacement[j] + point[j];
+    }
+  }
+}
+
 template <typename TParametersValueType, unsigned int VDimension, unsigned int VSplineOrder>
 void
 BSplineTransform<TParametersValueType, VDimension, VSplineOrder>::ComputeJacobianWithRespectToParameters(
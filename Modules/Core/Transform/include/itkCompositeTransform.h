@@ -19,8 +19,14 @@
 #define itkCompositeTransform_h
 
 #include "itkMultiTransform.h"
+#include "itkImageBase.h"
 
+#include <algorithm>
+#include <atomic>
 #include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 namespace itk
 {
@@ -81,6 +87,12 @@ namespace itk
  * sub transform and adding them to a composite transform in reverse order.
  * The m_TransformsToOptimizeFlags is copied in reverse for the inverse.
  *
+ * Flattened displacement field:
+ * FlattenToDisplacementField() samples the whole queue on a grid once, so
+ * that TransformPoint and TransformPoints map each point inside the grid by
+ * a single lookup in the resulting displacement field. This is meant for
+ * resampling many images through the same queue.
+ *
  * \ingroup ITKTransform
  */
 template <typename TParametersValueType = double, unsigned int VDimension = 3>
@@ -386,6 +398,61 @@ public:
   virtual void
   FlattenTransformQueue();
 
+  /** Grid of the flattened displacement field. */
+  using FlattenedDisplacementFieldGridType = ImageBase<VDimension>;
+
+  /** Flatten the transform queue into a displacement field on the grid of
+   * the given image, of which only the largest possible region, spacing,
+   * origin and direction are used. The grid needs at least two points along
+   * each axis.
+   *
+   * TransformPoint and TransformPoints then map the points inside the grid
+   * by multilinear interpolation of the field, rather than through every
+   * transform of the queue. The field is computed one tile of
+   * FlattenedDisplacementFieldTileSize cells along each axis at a time, when
+   * a point first falls in the tile, or for all tiles at once by
+   * MaterializeFlattenedDisplacementField().
+   *
+   * Each tile is checked at the centers of its cells against the queue. A
+   * tile where the error exceeds the tolerance, a distance in physical
+   * units, keeps using the queue. So do the points outside the grid and the
+   * other methods, such as TransformVector and the Jacobians.
+   *
+   * The field is no longer used once the composite transform, or one of the
+   * transforms of its queue or of the queues of the composite transforms
+   * nested in it, is modified, that is once the latest of their modified
+   * times is after the field was created. TransformPoint checks that for
+   * each point, TransformPoints once per batch. Changes that leave these
+   * modified times alone are not detected: in particular, editing in place
+   * the displacement field of a DisplacementFieldTransform or the
+   * coefficient images of a B-spline transform, even when the image is then
+   * marked Modified(). Call Modified() on the transform after such changes,
+   * or drop the field. The field is not copied by Clone(). */
+  void
+  FlattenToDisplacementField(const FlattenedDisplacementFieldGridType * grid, double tolerance);
+
+  /** Compute all the tiles of the flattened displacement field, in
+   * parallel. */
+  void
+  MaterializeFlattenedDisplacementField() const;
+
+  /** Drop the flattened displacement field. */
+  void
+  ClearFlattenedDisplacementField();
+
+  /** Whether TransformPoint uses a flattened displacement field. */
+  bool
+  HasFlattenedDisplacementField() const;
+
+  /** The largest error at the checked points of the tiles computed so far
+   * that use the flattened displacement field. */
+  double
+  GetFlattenedDisplacementFieldMaximumError() const;
+
+  /** Number of cells along each axis of a tile of the flattened
+   * displacement field. */
+  static constexpr unsigned int FlattenedDisplacementFieldTileSize = 8;
+
   /**
    * Compute the Jacobian with respect to the parameters for the composite
    * transform using Jacobian rule. See comments in the implementation.
@@ -412,6 +479,20 @@ protected:
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
+  /** \see Transform::GetBatchedTransformClass() */
+  const std::type_info *
+  GetBatchedTransformClass() const override
+  {
+    return &typeid(Self);
+  }
+
+  /** Transform a batch of points, passing the whole batch through each
+   * sub transform in turn. */
+  void
+  BatchedTransformPoints(const InputPointType * inputPoints,
+                         OutputPointType *      outputPoints,
+                         SizeValueType          numberOfPoints) const override;
+
   /** Clone the current transform */
   typename LightObject::Pointer
   InternalClone() const override;
@@ -454,7 +535,55 @@ protected:
   TransformsToOptimizeFlagsType m_TransformsToOptimizeFlags{};
 
 private:
+  /** A tile of the flattened displacement field, computed once by the
+   * first thread that needs it. The displacements at the points on its
+   * upper faces are shared with the next tiles. */
+  struct FlattenedDisplacementFieldTile
+  {
+    std::once_flag                ComputeFlag{};
+    std::atomic<bool>             IsComputed{ false };
+    bool                          IsAccurate{ false };
+    double                        MaximumError{ 0.0 };
+    Size<VDimension>              PointSize{};
+    std::vector<OutputVectorType> Displacements{};
+  };
+
+  struct FlattenedDisplacementField
+  {
+    typename FlattenedDisplacementFieldGridType::Pointer Grid{};
+    double                                               Tolerance{ 0.0 };
+    ModifiedTimeType                                     ModifiedTime{ 0 };
+    Size<VDimension>                                     NumberOfTiles{};
+    SizeValueType                                        TotalNumberOfTiles{ 0 };
+    std::unique_ptr<FlattenedDisplacementFieldTile[]>    Tiles{};
+  };
+
+  /** Apply the transforms of the queue to a batch of points. */
+  void
+  TransformPointsThroughQueue(const InputPointType * inputPoints,
+                              OutputPointType *      outputPoints,
+                              SizeValueType          numberOfPoints) const;
+
+  /** Latest modified time of the composite transform and the transforms of
+   * its queue, recursing into the nested composite transforms. */
+  ModifiedTimeType
+  GetModifiedTimeOfTransformQueue() const;
+
+  /** Map the point by the flattened displacement field. Returns false if
+   * the point is outside the grid or in an inaccurate tile. */
+  bool
+  TransformPointByFlattenedDisplacementField(const InputPointType & inputPoint, OutputPointType & outputPoint) const;
+
+  /** Get the tile, computing it on first use. */
+  const FlattenedDisplacementFieldTile &
+  GetFlattenedDisplacementFieldTile(SizeValueType tileNumber) const;
+
+  void
+  ComputeFlattenedDisplacementFieldTile(SizeValueType tileNumber, FlattenedDisplacementFieldTile & tile) const;
+
   mutable ModifiedTimeType m_PreviousTransformsToOptimizeUpdateTime{};
+
+  std::unique_ptr<FlattenedDisplacementField> m_FlattenedDisplacementField{};
 };
 
 } // end namespace itk
@@ -18,6 +18,8 @@
 #ifndef itkCompositeTransform_hxx
 #define itkCompositeTransform_hxx
 
+#include "itkMultiThreaderBase.h"
+
 
 namespace itk
 {
@@ -60,8 +62,15 @@ CompositeTransform<TParametersValueType, VDimension>::TransformPoint(const Input
   -> OutputPointType
 {
 
+  OutputPointType outputPoint;
+  if (this->HasFlattenedDisplacementField() &&
+      this->TransformPointByFlattenedDisplacementField(inputPoint, outputPoint))
+  {
+    return outputPoint;
+  }
+
   /* Apply in reverse queue order.  */
-  OutputPointType outputPoint(inputPoint);
+  outputPoint = inputPoint;
   for (auto it = this->m_TransformQueue.rbegin(); it != this->m_TransformQueue.rend(); ++it)
   {
     outputPoint = (*it)->TransformPoint(outputPoint);
@@ -70,6 +79,65 @@ CompositeTransform<TParametersValueType, VDimension>::TransformPoint(const Input
 }
 
 
+template <typename TParametersValueType, unsigned int VDimension>
+void
+CompositeTransform<TParametersValueType, VDimension>::BatchedTransformPoints(
+  const InputPointType * inputPoints,
+  OutputPointType *      outputPoints,
+  SizeValueType          numberOfPoints) const
+{
+  if (this->HasFlattenedDisplacementField())
+  {
+    // The points that the field does not cover go through the queue in one
+    // batch.
+    std::vector<SizeValueType>   uncoveredPoints;
+    std::vector<InputPointType>  uncoveredInputPoints;
+    std::vector<OutputPointType> uncoveredOutputPoints;
+    for (SizeValueType i = 0; i < numberOfPoints; ++i)
+    {
+      if (!this->TransformPointByFlattenedDisplacementField(inputPoints[i], outputPoints[i]))
+      {
+        uncoveredPoints.push_back(i);
+        uncoveredInputPoints.push_back(inputPoints[i]);
+      }
+    }
+    if (!uncoveredPoints.empty())
+    {
+      uncoveredOutputPoints.resize(uncoveredPoints.size());
+      this->TransformPointsThroughQueue(
+        uncoveredInputPoints.data(), uncoveredOutputPoints.data(), uncoveredInputPoints.size());
+      for (size_t k = 0; k < uncoveredPoints.size(); ++k)
+      {
+        outputPoints[uncoveredPoints[k]] = uncoveredOutputPoints[k];
+      }
+    }
+    return;
+  }
+  this->TransformPointsThroughQueue(inputPoints, outputPoints, numberOfPoints);
+}
+
+
+template <typename TParametersValueType, unsigned int VDimension>
+void
+CompositeTransform<TParametersValueType, VDimension>::TransformPointsThroughQueue(
+  const InputPointType * inputPoints,
+  OutputPointType *      outputPoints,
+  SizeValueType          numberOfPoints) const
+{
+  /* Apply in reverse queue order, in place after the first one.  */
+  const InputPointType * points = inputPoints;
+  for (auto it = this->m_TransformQueue.rbegin(); it != this->m_TransformQueue.rend(); ++it)
+  {
+    (*it)->TransformPoints(points, outputPoints, numberOfPoints);
+    points = outputPoints;
+  }
+  if (points != outputPoints)
+  {
+    std::copy(inputPoints, inputPoints + numberOfPoints, outputPoints);
+  }
+}
+
+
 template <typename TParametersValueType, unsigned int VDimension>
 auto
 CompositeTransform<TParametersValueType, VDimension>::TransformVector(const InputVectorType & inputVector) const
@@ -938,6 +1006,321 @@ CompositeTransform<TParametersValueType, VDimension>::FlattenTransformQueue()
 }
 
 
+template <typename TParametersValueType, unsigned int VDimension>
+void
+CompositeTransform<TParametersValueType, VDimension>::FlattenToDisplacementField(
+  const FlattenedDisplacementFieldGridType * grid,
+  double                                     tolerance)
+{
+  if (grid == nullptr)
+  {
+    itkExceptionMacro("The grid of the flattened displacement field is not set.");
+  }
+  if (this->GetNumberOfTransforms() == 0)
+  {
+    itkExceptionMacro("The transform queue is empty.");
+  }
+
+  auto field = std::make_unique<FlattenedDisplacementField>();
+  field->Grid = FlattenedDisplacementFieldGridType::New();
+  field->Grid->CopyInformation(grid);
+  field->Tolerance = tolerance;
+
+  const auto & gridSize = field->Grid->GetLargestPossibleRegion().GetSize();
+  field->TotalNumberOfTiles = 1;
+  for (unsigned int d = 0; d < VDimension; ++d)
+  {
+    if (gridSize[d] < 2)
+    {
+      itkExceptionMacro("The grid of the flattened displacement field has " << gridSize[d] << " points along axis "
+                                                                            << d << ", it needs at least 2.");
+    }
+    const SizeValueType numberOfCells = gridSize[d] - 1;
+    field->NumberOfTiles[d] =
+      (numberOfCells + FlattenedDisplacementFieldTileSize - 1) / FlattenedDisplacementFieldTileSize;
+    field->TotalNumberOfTiles *= field->NumberOfTiles[d];
+  }
+  field->Tiles = std::make_unique<FlattenedDisplacementFieldTile[]>(field->TotalNumberOfTiles);
+
+  // The field is a snapshot of the queue as it is now.
+  field->ModifiedTime = this->GetModifiedTimeOfTransformQueue();
+  m_FlattenedDisplacementField = std::move(field);
+}
+
+
+template <typename TParametersValueType, unsigned int VDimension>
+void
+CompositeTransform<TParametersValueType, VDimension>::MaterializeFlattenedDisplacementField() const
+{
+  if (!this->HasFlattenedDisplacementField())
+  {
+    itkExceptionMacro("There is no flattened displacement field to materialize.");
+  }
+  MultiThreaderBase::New()->ParallelizeArray(
+    0,
+    m_FlattenedDisplacementField->TotalNumberOfTiles,
+    [this](SizeValueType tileNumber) { this->GetFlattenedDisplacementFieldTile(tileNumber); },
+    nullptr);
+}
+
+
+template <typename TParametersValueType, unsigned int VDimension>
+void
+CompositeTransform<TParametersValueType, VDimension>::ClearFlattenedDisplacementField()
+{
+  m_FlattenedDisplacementField.reset();
+}
+
+
+template <typename TParametersValueType, unsigned int VDimension>
+bool
+CompositeTransform<TParametersValueType, VDimension>::HasFlattenedDisplacementField() const
+{
+  return m_FlattenedDisplacementField != nullptr &&
+         this->GetModifiedTimeOfTransformQueue() <= m_FlattenedDisplacementField->ModifiedTime;
+}
+
+
+template <typename TParametersValueType, unsigned int VDimension>
+double
+CompositeTransform<TParametersValueType, VDimension>::GetFlattenedDisplacementFieldMaximumError() const
+{
+  double maximumError = 0.0;
+  if (m_FlattenedDisplacementField != nullptr)
+  {
+    for (SizeValueType t = 0; t < m_FlattenedDisplacementField->TotalNumberOfTiles; ++t)
+    {
+      const FlattenedDisplacementFieldTile & tile = m_FlattenedDisplacementField->Tiles[t];
+      if (tile.IsComputed.load(std::memory_order_acquire) && tile.IsAccurate)
+      {
+        maximumError = std::max(maximumError, tile.MaximumError);
+      }
+    }
+  }
+  return maximumError;
+}
+
+
+template <typename TParametersValueType, unsigned int VDimension>
+ModifiedTimeType
+CompositeTransform<TParametersValueType, VDimension>::GetModifiedTimeOfTransformQueue() const
+{
+  ModifiedTimeType latestTime = this->GetMTime();
+  for (const auto & transform : this->m_TransformQueue)
+  {
+    // A nested composite transform is not modified with its transforms.
+    const auto * const composite = dynamic_cast<const Self *>(transform.GetPointer());
+    latestTime = std::max(latestTime,
+                          composite != nullptr ? composite->GetModifiedTimeOfTransformQueue() : transform->GetMTime());
+  }
+  return latestTime;
+}
+
+
+template <typename TParametersValueType, unsigned int VDimension>
+bool
+CompositeTransform<TParametersValueType, VDimension>::TransformPointByFlattenedDisplacementField(
+  const InputPointType & inputPoint,
+  OutputPointType &      outputPoint) const
+{
+  const FlattenedDisplacementField & field = *m_FlattenedDisplacementField;
+  const auto &                       gridRegion = field.Grid->GetLargestPossibleRegion();
+
+  const auto continuousIndex = field.Grid->template TransformPhysicalPointToContinuousIndex<double>(inputPoint);
+
+  // Locate the cell of the point, its tile, and the cell within the tile.
+  double         fractions[VDimension];
+  IndexValueType cellInTile[VDimension];
+  SizeValueType  tileNumber = 0;
+  SizeValueType  tileStride = 1;
+  for (unsigned int d = 0; d < VDimension; ++d)
+  {
+    const double x = continuousIndex[d] - gridRegion.GetIndex(d);
+    const auto   numberOfCells = static_cast<IndexValueType>(gridRegion.GetSize(d)) - 1;
+    if (!(x >= 0.0 && x <= numberOfCells))
+    {
+      return false;
+    }
+    const IndexValueType cell = std::min(static_cast<IndexValueType>(x), numberOfCells - 1);
+    fractions[d] = x - cell;
+
+    const IndexValueType tileIndex = cell / FlattenedDisplacementFieldTileSize;
+    cellInTile[d] = cell - tileIndex * FlattenedDisplacementFieldTileSize;
+    tileNumber += tileIndex * tileStride;
+    tileStride *= field.NumberOfTiles[d];
+  }
+
+  const FlattenedDisplacementFieldTile & tile = this->GetFlattenedDisplacementFieldTile(tileNumber);
+  if (!tile.IsAccurate)
+  {
+    return false;
+  }
+
+  // Multilinear interpolation between the 2^VDimension corners of the cell.
+  SizeValueType strides[VDimension];
+  SizeValueType cellOffset = 0;
+  SizeValueType stride = 1;
+  for (unsigned int d = 0; d < VDimension; ++d)
+  {
+    strides[d] = stride;
+    cellOffset += cellInTile[d] * stride;
+    stride *= tile.PointSize[d];
+  }
+
+  OutputVectorType displacement{};
+  for (unsigned int corner = 0; corner < (1u << VDimension); ++corner)
+  {
+    double        weight = 1.0;
+    SizeValueType offset = cellOffset;
+    for (unsigned int d = 0; d < VDimension; ++d)
+    {
+      if (corner & (1u << d))
+      {
+        weight *= fractions[d];
+        offset += strides[d];
+      }
+      else
+      {
+        weight *= 1.0 - fractions[d];
+      }
+    }
+    displacement += tile.Displacements[offset] * static_cast<TParametersValueType>(weight);
+  }
+  outputPoint = inputPoint + displacement;
+  return true;
+}
+
+
+template <typename TParametersValueType, unsigned int VDimension>
+auto
+CompositeTransform<TParametersValueType, VDimension>::GetFlattenedDisplacementFieldTile(SizeValueType tileNumber) const
+  -> const FlattenedDisplacementFieldTile &
+{
+  FlattenedDisplacementFieldTile & tile = m_FlattenedDisplacementField->Tiles[tileNumber];
+  if (!tile.IsComputed.load(std::memory_order_acquire))
+  {
+    std::call_once(tile.ComputeFlag, [this, tileNumber, &tile]() {
+      this->ComputeFlattenedDisplacementFieldTile(tileNumber, tile);
+      tile.IsComputed.store(true, std::memory_order_release);
+    });
+  }
+  return tile;
+}
+
+
+template <typename TParametersValueType, unsigned int VDimension>
+void
+CompositeTransform<TParametersValueType, VDimension>::ComputeFlattenedDisplacementFieldTile(
+  SizeValueType                    tileNumber,
+  FlattenedDisplacementFieldTile & tile) const
+{
+  using IndexType = Index<VDimension>;
+  using ContinuousIndexType = ContinuousIndex<double, VDimension>;
+
+  const FlattenedDisplacementField & field = *m_FlattenedDisplacementField;
+  const auto &                       gridRegion = field.Grid->GetLargestPossibleRegion();
+
+  // First grid index of the tile, and its number of points along each axis,
+  // which is less than FlattenedDisplacementFieldTileSize + 1 at the upper
+  // end of the grid.
+  IndexType     firstIndex;
+  SizeValueType numberOfPoints = 1;
+  SizeValueType numberOfCells = 1;
+  for (unsigned int d = 0; d < VDimension; ++d)
+  {
+    const SizeValueType tileIndex = tileNumber % field.NumberOfTiles[d];
+    tileNumber /= field.NumberOfTiles[d];
+    const SizeValueType firstCell = tileIndex * FlattenedDisplacementFieldTileSize;
+    firstIndex[d] = gridRegion.GetIndex(d) + static_cast<IndexValueType>(firstCell);
+    tile.PointSize[d] =
+      std::min<SizeValueType>(FlattenedDisplacementFieldTileSize, gridRegion.GetSize(d) - 1 - firstCell) + 1;
+    numberOfPoints *= tile.PointSize[d];
+    numberOfCells *= tile.PointSize[d] - 1;
+  }
+
+  // Map the points of the tile through the queue, in one batch.
+  std::vector<InputPointType>  points(numberOfPoints);
+  std::vector<OutputPointType> mappedPoints(numberOfPoints);
+  IndexType                    index = firstIndex;
+  for (SizeValueType i = 0; i < numberOfPoints; ++i)
+  {
+    field.Grid->TransformIndexToPhysicalPoint(index, points[i]);
+    for (unsigned int d = 0; d < VDimension; ++d)
+    {
+      if (++index[d] < firstIndex[d] + static_cast<IndexValueType>(tile.PointSize[d]))
+      {
+        break;
+      }
+      index[d] = firstIndex[d];
+    }
+  }
+  this->TransformPointsThroughQueue(points.data(), mappedPoints.data(), numberOfPoints);
+
+  tile.Displacements.resize(numberOfPoints);
+  for (SizeValueType i = 0; i < numberOfPoints; ++i)
+  {
+    tile.Displacements[i] = mappedPoints[i] - points[i];
+  }
+
+  // Check the field at the centers of the cells, where the interpolation is
+  // farthest from the grid points, against the queue.
+  points.resize(numberOfCells);
+  mappedPoints.resize(numberOfCells);
+  std::vector<OutputVectorType> interpolatedDisplacements(numberOfCells);
+  IndexType                     cell{};
+  for (SizeValueType c = 0; c < numberOfCells; ++c)
+  {
+    ContinuousIndexType center;
+    SizeValueType       cellOffset = 0;
+    SizeValueType       stride = 1;
+    SizeValueType       strides[VDimension];
+    for (unsigned int d = 0; d < VDimension; ++d)
+    {
+      center[d] = firstIndex[d] + cell[d] + 0.5;
+      strides[d] = stride;
+      cellOffset += cell[d] * stride;
+      stride *= tile.PointSize[d];
+    }
+    field.Grid->TransformContinuousIndexToPhysicalPoint(center, points[c]);
+
+    OutputVectorType & displacement = interpolatedDisplacements[c];
+    displacement.Fill(0.0);
+    for (unsigned int corner = 0; corner < (1u << VDimension); ++corner)
+    {
+      SizeValueType offset = cellOffset;
+      for (unsigned int d = 0; d < VDimension; ++d)
+      {
+        if (corner & (1u << d))
+        {
+          offset += strides[d];
+        }
+      }
+      displacement += tile.Displacements[offset];
+    }
+    displacement /= static_cast<TParametersValueType>(1u << VDimension);
+
+    for (unsigned int d = 0; d < VDimension; ++d)
+    {
+      if (++cell[d] < static_cast<IndexValueType>(tile.PointSize[d] - 1))
+      {
+        break;
+      }
+      cell[d] = 0;
+    }
+  }
+  this->TransformPointsThroughQueue(points.data(), mappedPoints.data(), numberOfCells);
+
+  double maximumError = 0.0;
+  for (SizeValueType c = 0; c < numberOfCells; ++c)
+  {
+    const double error = (points[c] + interpolatedDisplacements[c]).EuclideanDistanceTo(mappedPoints[c]);
+    maximumError = std::max(maximumError, error);
+  }
+  tile.MaximumError = maximumError;
+  tile.IsAccurate = (maximumError <= field.Tolerance);
+}
+
+
 template <typename TParametersValueType, unsigned int VDimension>
 void
 CompositeTransform<TParametersValueType, VDimension>::PrintSelf(std::ostream & os, Indent indent) const
@@ -961,6 +1344,13 @@ CompositeTransform<TParametersValueType, VDimension>::PrintSelf(std::ostream & o
   os << indent << "PreviousTransformsToOptimizeUpdateTime: "
      << static_cast<typename NumericTraits<ModifiedTimeType>::PrintType>(m_PreviousTransformsToOptimizeUpdateTime)
      << std::endl;
+
+  os << indent << "HasFlattenedDisplacementField: " << (this->HasFlattenedDisplacementField() ? "On" : "Off")
+     << std::endl;
+  if (m_FlattenedDisplacementField != nullptr)
+  {
+    os << indent << "FlattenedDisplacementFieldTolerance: " << m_FlattenedDisplacementField->Tolerance << std::endl;
+  }
 }
 
 
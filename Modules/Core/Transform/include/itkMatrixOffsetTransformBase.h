@@ -520,6 +520,20 @@ protected:
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
+  /** \see Transform::GetBatchedTransformClass() */
+  const std::type_info *
+  GetBatchedTransformClass() const override
+  {
+    return &typeid(Self);
+  }
+
+  /** Transform a batch of points by the affine transformation, with the
+   * matrix and offset loaded once for the whole batch. */
+  void
+  BatchedTransformPoints(const InputPointType * inputPoints,
+                         OutputPointType *      outputPoints,
+                         SizeValueType          numberOfPoints) const override;
+
   const InverseMatrixType &
   GetVarInverseMatrix() const
   {
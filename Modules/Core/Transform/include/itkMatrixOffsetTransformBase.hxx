@@ -128,6 +128,43 @@ MatrixOffsetTransformBase<TParametersValueType, VInputDimension, VOutputDimensio
 }
 
 
+template <typename TParametersValueType, unsigned int VInputDimension, unsigned int VOutputDimension>
+void
+MatrixOffsetTransformBase<TParametersValueType, VInputDimension, VOutputDimension>::BatchedTransformPoints(
+  const InputPointType * inputPoints,
+  OutputPointType *      outputPoints,
+  SizeValueType          numberOfPoints) const
+{
+  // Local copies let the compiler keep the coefficients in registers, since
+  // the output points could otherwise alias them.
+  TParametersValueType matrix[VOutputDimension][VInputDimension];
+  TParametersValueType offset[VOutputDimension];
+  for (unsigned int r = 0; r < VOutputDimension; ++r)
+  {
+    for (unsigned int c = 0; c < VInputDimension; ++c)
+    {
+      matrix[r][c] = m_Matrix(r, c);
+    }
+    offset[r] = m_Offset[r];
+  }
+
+  for (SizeValueType i = 0; i < numberOfPoints; ++i)
+  {
+    const InputPointType point = inputPoints[i];
+    for (unsigned int r = 0; r < VOutputDimension; ++r)
+    {
+      // Same order of operations as TransformPoint, for identical results.
+      TParametersValueType sum{};
+      for (unsigned int c = 0; c < VInputDimension; ++c)
+      {
+        sum += matrix[r][c] * point[c];
+      }
+      outputPoints[i][r] = sum + offset[r];
+    }
+  }
+}
+
+
 template <typename TParametersValueType, unsigned int VInputDimension, unsigned int VOutputDimension>
 auto
 MatrixOffsetTransformBase<TParametersValueType, VInputDimension, VOutputDimension>::TransformVector(
@@ -217,6 +217,19 @@ protected:
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
+  /** \see Transform::GetBatchedTransformClass() */
+  const std::type_info *
+  GetBatchedTransformClass() const override
+  {
+    return &typeid(Self);
+  }
+
+  /** Transform a batch of points by the scaling about the center. */
+  void
+  BatchedTransformPoints(const InputPointType * inputPoints,
+                         OutputPointType *      outputPoints,
+                         SizeValueType          numberOfPoints) const override;
+
 private:
   ScaleType m_Scale{}; // Scales of the transformation
 
@@ -117,6 +117,25 @@ ScaleTransform<TParametersValueType, VDimension>::TransformPoint(const InputPoin
 }
 
 
+template <typename TParametersValueType, unsigned int VDimension>
+void
+ScaleTransform<TParametersValueType, VDimension>::BatchedTransformPoints(const InputPointType * inputPoints,
+                                                                         OutputPointType *      outputPoints,
+                                                                         SizeValueType          numberOfPoints) const
+{
+  const InputPointType center = this->GetCenter();
+  const ScaleType      scale = m_Scale;
+
+  for (SizeValueType i = 0; i < numberOfPoints; ++i)
+  {
+    for (unsigned int j = 0; j < SpaceDimension; ++j)
+    {
+      outputPoints[i][j] = (inputPoints[i][j] - center[j]) * scale[j] + center[j];
+    }
+  }
+}
+
+
 template <typename TParametersValueType, unsigned int VDimension>
 auto
 ScaleTransform<TParametersValueType, VDimension>::TransformVector(const InputVectorType & vect) const
@@ -28,6 +28,8 @@
 #include "vnl/vnl_matrix_fixed.h"
 #include "itkMatrix.h"
 
+#include <typeinfo>
+
 namespace itk
 {
 /**
@@ -180,6 +182,21 @@ public:
   virtual OutputPointType
   TransformPoint(const InputPointType &) const = 0;
 
+  /** Method to transform a batch of points.
+   * Transforms \c numberOfPoints points from \c inputPoints into \c outputPoints,
+   * giving the same results as calling TransformPoint on each of them.
+   * Transforms with a cheaper batched form, which pays for the virtual call
+   * and the setup once per batch, provide it as BatchedTransformPoints; it is
+   * used only for objects of exactly the class returned by
+   * GetBatchedTransformClass(), and TransformPoint is called for each point
+   * otherwise, so that a subclass overriding TransformPoint keeps its results.
+   * \c outputPoints may be the same array as \c inputPoints.
+   * \warning This method must be thread-safe. */
+  void
+  TransformPoints(const InputPointType * inputPoints,
+                  OutputPointType *      outputPoints,
+                  SizeValueType          numberOfPoints) const;
+
   /**  Method to transform a vector. */
   virtual OutputVectorType
   TransformVector(const InputVectorType &) const
@@ -506,6 +523,18 @@ public:
   ComputeJacobianWithRespectToParameters(const InputPointType & itkNotUsed(p),
                                          JacobianType &         itkNotUsed(jacobian)) const = 0;
 
+  /** Compute the Jacobians with respect to the parameters at a batch of
+   * points, as ComputeJacobianWithRespectToParameters does for each of them.
+   * Each of the \c numberOfPoints \c jacobians is resized as needed, so
+   * passing the same, already sized, array from call to call avoids
+   * allocations. As TransformPoints, it uses the batched form,
+   * BatchedComputeJacobiansWithRespectToParameters, only for objects of
+   * exactly the class returned by GetBatchedTransformClass(). */
+  void
+  ComputeJacobiansWithRespectToParameters(const InputPointType * points,
+                                          JacobianType *         jacobians,
+                                          SizeValueType          numberOfPoints) const;
+
   virtual void
   ComputeJacobianWithRespectToParametersCachedTemporaries(const InputPointType & p,
                                                           JacobianType &         jacobian,
@@ -599,6 +628,39 @@ protected:
     return transform.GetInverse(inverse) ? inverse.GetPointer() : nullptr;
   }
 
+  /** The class whose batched code BatchedTransformPoints and
+   * BatchedComputeJacobiansWithRespectToParameters implement, or nullptr,
+   * the default, when there is none. A class that overrides them returns
+   * &typeid(Self) here, so that TransformPoints and
+   * ComputeJacobiansWithRespectToParameters leave its subclasses on the per
+   * point methods. */
+  virtual const std::type_info *
+  GetBatchedTransformClass() const
+  {
+    return nullptr;
+  }
+
+  /** Whether this object is exactly of the class returned by
+   * GetBatchedTransformClass(), so that its batched code gives the results
+   * of its per point methods. */
+  bool
+  IsOfBatchedTransformClass() const;
+
+  /** Batched form of TransformPoint, see TransformPoints. The default
+   * implementation calls TransformPoint for each point. */
+  virtual void
+  BatchedTransformPoints(const InputPointType * inputPoints,
+                         OutputPointType *      outputPoints,
+                         SizeValueType          numberOfPoints) const;
+
+  /** Batched form of ComputeJacobianWithRespectToParameters, see
+   * ComputeJacobiansWithRespectToParameters. The default implementation
+   * calls ComputeJacobianWithRespectToParameters for each point. */
+  virtual void
+  BatchedComputeJacobiansWithRespectToParameters(const InputPointType * points,
+                                                 JacobianType *         jacobians,
+                                                 SizeValueType          numberOfPoints) const;
+
 private:
   template <typename TType>
   static std::string
@@ -119,6 +119,79 @@ Transform<TParametersValueType, VInputDimension, VOutputDimension>::UpdateTransf
 }
 
 
+template <typename TParametersValueType, unsigned int VInputDimension, unsigned int VOutputDimension>
+void
+Transform<TParametersValueType, VInputDimension, VOutputDimension>::TransformPoints(
+  const InputPointType * inputPoints,
+  OutputPointType *      outputPoints,
+  SizeValueType          numberOfPoints) const
+{
+  if (this->IsOfBatchedTransformClass())
+  {
+    this->BatchedTransformPoints(inputPoints, outputPoints, numberOfPoints);
+  }
+  else
+  {
+    this->Transform::BatchedTransformPoints(inputPoints, outputPoints, numberOfPoints);
+  }
+}
+
+
+template <typename TParametersValueType, unsigned int VInputDimension, unsigned int VOutputDimension>
+void
+Transform<TParametersValueType, VInputDimension, VOutputDimension>::ComputeJacobiansWithRespectToParameters(
+  const InputPointType * points,
+  JacobianType *         jacobians,
+  SizeValueType          numberOfPoints) const
+{
+  if (this->IsOfBatchedTransformClass())
+  {
+    this->BatchedComputeJacobiansWithRespectToParameters(points, jacobians, numberOfPoints);
+  }
+  else
+  {
+    this->Transform::BatchedComputeJacobiansWithRespectToParameters(points, jacobians, numberOfPoints);
+  }
+}
+
+
+template <typename TParametersValueType, unsigned int VInputDimension, unsigned int VOutputDimension>
+bool
+Transform<TParametersValueType, VInputDimension, VOutputDimension>::IsOfBatchedTransformClass() const
+{
+  const std::type_info * const batchedTransformClass = this->GetBatchedTransformClass();
+  return batchedTransformClass != nullptr && *batchedTransformClass == typeid(*this);
+}
+
+
+template <typename TParametersValueType, unsigned int VInputDimension, unsigned int VOutputDimension>
+void
+Transform<TParametersValueType, VInputDimension, VOutputDimension>::BatchedTransformPoints(
+  const InputPointType * inputPoints,
+  OutputPointType *      outputPoints,
+  SizeValueType          numberOfPoints) const
+{
+  for (SizeValueType i = 0; i < numberOfPoints; ++i)
+  {
+    outputPoints[i] = this->TransformPoint(inputPoints[i]);
+  }
+}
+
+
+template <typename TParametersValueType, unsigned int VInputDimension, unsigned int VOutputDimension>
+void
+Transform<TParametersValueType, VInputDimension, VOutputDimension>::BatchedComputeJacobiansWithRespectToParameters(
+  const InputPointType * points,
+  JacobianType *         jacobians,
+  SizeValueType          numberOfPoints) const
+{
+  for (SizeValueType i = 0; i < numberOfPoints; ++i)
+  {
+    this->ComputeJacobianWithRespectToParameters(points[i], jacobians[i]);
+  }
+}
+
+
 template <typename TParametersValueType, unsigned int VInputDimension, unsigned int VOutputDimension>
 auto
 Transform<TParametersValueType, VInputDimension, VOutputDimension>::TransformVector(const InputVectorType & vector,
@@ -250,6 +250,25 @@ protected:
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
+  /** \see Transform::GetBatchedTransformClass() */
+  const std::type_info *
+  GetBatchedTransformClass() const override
+  {
+    return &typeid(Self);
+  }
+
+  /** Translate a batch of points. */
+  void
+  BatchedTransformPoints(const InputPointType * inputPoints,
+                         OutputPointType *      outputPoints,
+                         SizeValueType          numberOfPoints) const override;
+
+  /** The Jacobian is the same identity at every point, so only the copies are made. */
+  void
+  BatchedComputeJacobiansWithRespectToParameters(const InputPointType * points,
+                                                 JacobianType *         jacobians,
+                                                 SizeValueType          numberOfPoints) const override;
+
 private:
   JacobianType     m_IdentityJacobian{};
   OutputVectorType m_Offset{}; // Offset of the transformation
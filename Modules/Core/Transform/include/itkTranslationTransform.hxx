@@ -125,6 +125,25 @@ TranslationTransform<TParametersValueType, VDimension>::TransformPoint(const Inp
 }
 
 
+template <typename TParametersValueType, unsigned int VDimension>
+void
+TranslationTransform<TParametersValueType, VDimension>::BatchedTransformPoints(
+  const InputPointType * inputPoints,
+  OutputPointType *      outputPoints,
+  SizeValueType          numberOfPoints) const
+{
+  const OutputVectorType offset = m_Offset;
+
+  for (SizeValueType i = 0; i < numberOfPoints; ++i)
+  {
+    for (unsigned int j = 0; j < SpaceDimension; ++j)
+    {
+      outputPoints[i][j] = inputPoints[i][j] + offset[j];
+    }
+  }
+}
+
+
 template <typename TParametersValueType, unsigned int VDimension>
 auto
 TranslationTransform<TParametersValueType, VDimension>::TransformVector(const InputVectorType & vect) const
@@ -187,6 +206,20 @@ TranslationTransform<TParametersValueType, VDimension>::ComputeJacobianWithRespe
 }
 
 
+template <typename TParametersValueType, unsigned int VDimension>
+void
+TranslationTransform<TParametersValueType, VDimension>::BatchedComputeJacobiansWithRespectToParameters(
+  const InputPointType * itkNotUsed(points),
+  JacobianType *         jacobians,
+  SizeValueType          numberOfPoints) const
+{
+  for (SizeValueType i = 0; i < numberOfPoints; ++i)
+  {
+    jacobians[i] = this->m_IdentityJacobian;
+  }
+}
+
+
 template <typename TParametersValueType, unsigned int VDimension>
 void
 TranslationTransform<TParametersValueType, VDimension>::ComputeJacobianWithRespectToPosition(
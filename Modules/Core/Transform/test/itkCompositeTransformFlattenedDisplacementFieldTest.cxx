@@ -0,0 +1,263 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkAffineTransform.h"
+#include "itkBSplineTransform.h"
+#include "itkCompositeTransform.h"
+#include "itkDisplacementFieldTransform.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkTimeProbe.h"
+#include "itkTransformToDisplacementFieldFilter.h"
+#include "itkTestingMacros.h"
+
+#include <cmath>
+#include <vector>
+
+/*
+ * Flattens a composite of an affine, a B-spline and a displacement field
+ * transform into a displacement field. Checks the field at its grid points
+ * against TransformToDisplacementFieldFilter, checks the error between the
+ * grid points and outside the grid, checks that modifying a transform, also
+ * one of a nested composite transform, stops the use of the field, and
+ * reports the speedup of TransformPoints.
+ */
+
+namespace
+{
+constexpr unsigned int Dimension = 3;
+using CompositeTransformType = itk::CompositeTransform<double, Dimension>;
+using PointType = CompositeTransformType::InputPointType;
+using GridType = itk::Image<float, Dimension>;
+using DisplacementFieldTransformType = itk::DisplacementFieldTransform<double, Dimension>;
+using DisplacementFieldType = DisplacementFieldTransformType::DisplacementFieldType;
+} // namespace
+
+int
+itkCompositeTransformFlattenedDisplacementFieldTest(int argc, char * argv[])
+{
+  const itk::SizeValueType numberOfPoints = (argc > 1) ? std::stoul(argv[1]) : 100000;
+  const double             tolerance = 0.05;
+
+  auto affine = itk::AffineTransform<double, Dimension>::New();
+  affine->SetCenter(itk::MakeFilled<PointType>(50.0));
+  affine->Rotate(0, 1, 0.1);
+  affine->Scale(1.05);
+
+  using BSplineTransformType = itk::BSplineTransform<double, Dimension, 3>;
+  auto bspline = BSplineTransformType::New();
+  bspline->SetTransformDomainOrigin(BSplineTransformType::OriginType(0.0));
+  bspline->SetTransformDomainPhysicalDimensions(itk::MakeFilled<BSplineTransformType::PhysicalDimensionsType>(100.0));
+  bspline->SetTransformDomainMeshSize(itk::MakeFilled<BSplineTransformType::MeshSizeType>(5));
+  BSplineTransformType::ParametersType bsplineParameters(bspline->GetNumberOfParameters());
+  for (unsigned int p = 0; p < bsplineParameters.Size(); ++p)
+  {
+    bsplineParameters[p] = 2.0 * std::sin(0.37 * p);
+  }
+  bspline->SetParametersByValue(bsplineParameters);
+
+  // A smooth displacement field over [0, 100]^3.
+  auto field = DisplacementFieldType::New();
+  field->SetRegions(DisplacementFieldType::SizeType::Filled(26));
+  field->SetSpacing(itk::MakeFilled<DisplacementFieldType::SpacingType>(4.0));
+  field->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<DisplacementFieldType> it(field, field->GetBufferedRegion()); !it.IsAtEnd();
+       ++it)
+  {
+    PointType point;
+    field->TransformIndexToPhysicalPoint(it.GetIndex(), point);
+    it.Set(itk::MakeVector(
+      1.5 * std::sin(0.05 * point[1]), 1.5 * std::cos(0.04 * point[2]), 1.0 * std::sin(0.03 * (point[0] + point[1]))));
+  }
+  auto displacementFieldTransform = DisplacementFieldTransformType::New();
+  displacementFieldTransform->SetDisplacementField(field);
+
+  auto composite = CompositeTransformType::New();
+  composite->AddTransform(affine);
+  composite->AddTransform(bspline);
+  composite->AddTransform(displacementFieldTransform);
+
+  // The same queue, which a clone does not flatten.
+  const auto exactComposite = composite->Clone();
+
+  // The grid covers [0, 98]^3 with points 2 apart.
+  auto grid = GridType::New();
+  grid->SetRegions(GridType::SizeType::Filled(50));
+  grid->SetSpacing(itk::MakeFilled<GridType::SpacingType>(2.0));
+
+  ITK_TEST_EXPECT_TRUE(!composite->HasFlattenedDisplacementField());
+  ITK_TRY_EXPECT_EXCEPTION(composite->MaterializeFlattenedDisplacementField());
+  auto tooSmallGrid = GridType::New();
+  tooSmallGrid->SetRegions(itk::MakeSize(50, 1, 50));
+  ITK_TRY_EXPECT_EXCEPTION(composite->FlattenToDisplacementField(tooSmallGrid, tolerance));
+
+  ITK_TRY_EXPECT_NO_EXCEPTION(composite->FlattenToDisplacementField(grid, tolerance));
+  ITK_TEST_EXPECT_TRUE(composite->HasFlattenedDisplacementField());
+
+  // The tiles are computed on first use.
+  ITK_TEST_EXPECT_EQUAL(composite->GetFlattenedDisplacementFieldMaximumError(), 0.0);
+  composite->TransformPoint(itk::MakeFilled<PointType>(50.0));
+  ITK_TEST_EXPECT_TRUE(composite->GetFlattenedDisplacementFieldMaximumError() > 0.0);
+
+  itk::TimeProbe materializeProbe;
+  materializeProbe.Start();
+  composite->MaterializeFlattenedDisplacementField();
+  materializeProbe.Stop();
+  std::cout << "Materialized in " << materializeProbe.GetTotal() << " s, maximum error at the cell centers "
+            << composite->GetFlattenedDisplacementFieldMaximumError() << std::endl;
+  ITK_TEST_EXPECT_TRUE(composite->GetFlattenedDisplacementFieldMaximumError() <= tolerance);
+
+  bool success = true;
+
+  // At the grid points the flattened field is the field of
+  // TransformToDisplacementFieldFilter.
+  using FilterType = itk::TransformToDisplacementFieldFilter<DisplacementFieldType, double>;
+  auto filter = FilterType::New();
+  filter->SetTransform(exactComposite);
+  filter->SetReferenceImage(grid);
+  filter->UseReferenceImageOn();
+  filter->Update();
+  const DisplacementFieldType * expectedField = filter->GetOutput();
+  double                        maximumGridPointError = 0.0;
+  for (itk::ImageRegionConstIteratorWithIndex<DisplacementFieldType> it(expectedField,
+                                                                        expectedField->GetBufferedRegion());
+       !it.IsAtEnd();
+       ++it)
+  {
+    PointType point;
+    expectedField->TransformIndexToPhysicalPoint(it.GetIndex(), point);
+    maximumGridPointError =
+      std::max(maximumGridPointError, composite->TransformPoint(point).EuclideanDistanceTo(point + it.Get()));
+  }
+  std::cout << "Maximum error at the grid points " << maximumGridPointError << std::endl;
+  if (maximumGridPointError > 1e-9)
+  {
+    std::cerr << "The flattened field differs from TransformToDisplacementFieldFilter at the grid points" << std::endl;
+    success = false;
+  }
+
+  // Points over [-10, 110)^3, partly outside the grid.
+  auto generator = itk::Statistics::MersenneTwisterRandomVariateGenerator::New();
+  generator->Initialize(20240611);
+  std::vector<PointType> points(numberOfPoints);
+  for (auto & point : points)
+  {
+    for (unsigned int d = 0; d < Dimension; ++d)
+    {
+      point[d] = generator->GetUniformVariate(-10.0, 110.0);
+    }
+  }
+
+  std::vector<PointType> expectedPoints(numberOfPoints);
+  std::vector<PointType> flattenedPoints(numberOfPoints);
+  exactComposite->TransformPoints(points.data(), expectedPoints.data(), numberOfPoints);
+  composite->TransformPoints(points.data(), flattenedPoints.data(), numberOfPoints);
+
+  // Time the points of a finer grid in the interior of the field, where the
+  // tiles meet the tolerance, in scanline order as a resampling would map
+  // them.
+  {
+    std::vector<PointType> scanlinePoints(numberOfPoints);
+    std::vector<PointType> mappedPoints(numberOfPoints);
+    for (itk::SizeValueType i = 0; i < numberOfPoints; ++i)
+    {
+      scanlinePoints[i] =
+        itk::MakePoint(20.0 + 0.5 * (i % 128), 20.0 + 0.5 * ((i / 128) % 128), 20.0 + 0.5 * ((i / 16384) % 128));
+    }
+    itk::TimeProbe exactProbe;
+    itk::TimeProbe flattenedProbe;
+    exactProbe.Start();
+    exactComposite->TransformPoints(scanlinePoints.data(), mappedPoints.data(), numberOfPoints);
+    exactProbe.Stop();
+    flattenedProbe.Start();
+    composite->TransformPoints(scanlinePoints.data(), mappedPoints.data(), numberOfPoints);
+    flattenedProbe.Stop();
+    std::cout << "TransformPoints: " << exactProbe.GetTotal() << " s through the queue, " << flattenedProbe.GetTotal()
+              << " s flattened, speedup " << exactProbe.GetTotal() / flattenedProbe.GetTotal() << std::endl;
+  }
+
+  const auto & gridRegion = grid->GetLargestPossibleRegion();
+  double       maximumInsideError = 0.0;
+  for (itk::SizeValueType i = 0; i < numberOfPoints; ++i)
+  {
+    const auto continuousIndex = grid->TransformPhysicalPointToContinuousIndex<double>(points[i]);
+    if (gridRegion.IsInside(continuousIndex))
+    {
+      maximumInsideError = std::max(maximumInsideError, flattenedPoints[i].EuclideanDistanceTo(expectedPoints[i]));
+    }
+    else if (flattenedPoints[i] != expectedPoints[i])
+    {
+      std::cerr << "The point " << points[i] << " outside the grid is mapped to " << flattenedPoints[i]
+                << " instead of " << expectedPoints[i] << std::endl;
+      success = false;
+      break;
+    }
+    if (composite->TransformPoint(points[i]) != flattenedPoints[i])
+    {
+      std::cerr << "TransformPoint and TransformPoints differ at " << points[i] << std::endl;
+      success = false;
+      break;
+    }
+  }
+  std::cout << "Maximum error inside the grid " << maximumInsideError << std::endl;
+  if (maximumInsideError > 2.0 * tolerance)
+  {
+    std::cerr << "The error inside the grid exceeds twice the tolerance" << std::endl;
+    success = false;
+  }
+
+  // A tolerance that no tile meets leaves every point to the queue.
+  composite->FlattenToDisplacementField(grid, 0.0);
+  composite->TransformPoints(points.data(), flattenedPoints.data(), numberOfPoints);
+  ITK_TEST_EXPECT_TRUE(flattenedPoints == expectedPoints);
+  ITK_TEST_EXPECT_EQUAL(composite->GetFlattenedDisplacementFieldMaximumError(), 0.0);
+
+  // Modifying a transform of the queue stops the use of the field.
+  composite->FlattenToDisplacementField(grid, tolerance);
+  ITK_TEST_EXPECT_TRUE(composite->HasFlattenedDisplacementField());
+  bsplineParameters[0] += 1.0;
+  bspline->SetParametersByValue(bsplineParameters);
+  ITK_TEST_EXPECT_TRUE(!composite->HasFlattenedDisplacementField());
+  exactComposite->GetNthTransform(1)->SetParametersByValue(bsplineParameters);
+  composite->TransformPoints(points.data(), flattenedPoints.data(), numberOfPoints);
+  exactComposite->TransformPoints(points.data(), expectedPoints.data(), numberOfPoints);
+  ITK_TEST_EXPECT_TRUE(flattenedPoints == expectedPoints);
+
+  // So does modifying a transform of a nested composite transform.
+  auto nestedAffine = itk::AffineTransform<double, Dimension>::New();
+  auto nestedComposite = CompositeTransformType::New();
+  nestedComposite->AddTransform(nestedAffine);
+  auto outerComposite = CompositeTransformType::New();
+  outerComposite->AddTransform(nestedComposite);
+  outerComposite->FlattenToDisplacementField(grid, tolerance);
+  ITK_TEST_EXPECT_TRUE(outerComposite->HasFlattenedDisplacementField());
+  nestedAffine->Translate(itk::MakeVector(1.0, 0.0, 0.0));
+  ITK_TEST_EXPECT_TRUE(!outerComposite->HasFlattenedDisplacementField());
+  ITK_TEST_EXPECT_EQUAL(outerComposite->TransformPoint(points[0]), points[0] + itk::MakeVector(1.0, 0.0, 0.0));
+
+  composite->ClearFlattenedDisplacementField();
+  ITK_TEST_EXPECT_TRUE(!composite->HasFlattenedDisplacementField());
+
+  if (!success)
+  {
+    std::cout << "Test FAILED!" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,310 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkAffineTransform.h"
+#include "itkAzimuthElevationToCartesianTransform.h"
+#include "itkBSplineTransform.h"
+#include "itkCompositeTransform.h"
+#include "itkDisplacementFieldTransform.h"
+#include "itkEuler3DTransform.h"
+#include "itkImageRegionIterator.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkScaleTransform.h"
+#include "itkTimeProbe.h"
+#include "itkTranslationTransform.h"
+#include "itkTestingMacros.h"
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+/*
+ * Checks that the batched TransformPoints and
+ * ComputeJacobiansWithRespectToParameters give the results of the per point
+ * methods, also when transforming in place, and reports the time per point of
+ * both. Subclasses that override only TransformPoint must get their own
+ * results from the batched methods too.
+ */
+
+namespace
+{
+constexpr unsigned int Dimension = 3;
+using TransformType = itk::Transform<double, Dimension, Dimension>;
+using PointType = TransformType::InputPointType;
+
+bool
+PointsAlmostEqual(const PointType & point, const PointType & expectedPoint)
+{
+  for (unsigned int d = 0; d < Dimension; ++d)
+  {
+    if (std::abs(point[d] - expectedPoint[d]) > 1e-12 * (1.0 + std::abs(expectedPoint[d])))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// A subclass that overrides only TransformPoint, shifting the points of its
+// superclass along the first axis.
+template <typename TTransform>
+class ShiftedTransform : public TTransform
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(ShiftedTransform);
+
+  using Self = ShiftedTransform;
+  using Superclass = TTransform;
+  using Pointer = itk::SmartPointer<Self>;
+  using ConstPointer = itk::SmartPointer<const Self>;
+
+  itkOverrideGetNameOfClassMacro(ShiftedTransform);
+
+  itkNewMacro(Self);
+
+  using typename Superclass::InputPointType;
+  using typename Superclass::OutputPointType;
+  using Superclass::TransformPoint;
+
+  OutputPointType
+  TransformPoint(const InputPointType & point) const override
+  {
+    OutputPointType shiftedPoint = Superclass::TransformPoint(point);
+    shiftedPoint[0] += 1.0;
+    return shiftedPoint;
+  }
+
+protected:
+  ShiftedTransform() = default;
+  ~ShiftedTransform() override = default;
+};
+
+bool
+CompareToPerPoint(const char * name, const TransformType * transform, const std::vector<PointType> & points)
+{
+  const auto             numberOfPoints = static_cast<itk::SizeValueType>(points.size());
+  std::vector<PointType> expectedPoints(numberOfPoints);
+  std::vector<PointType> batchedPoints(numberOfPoints);
+  itk::TimeProbe         perPointProbe;
+  itk::TimeProbe         batchedProbe;
+  constexpr unsigned int numberOfReps = 5;
+  for (unsigned int r = 0; r < numberOfReps; ++r)
+  {
+    perPointProbe.Start();
+    for (itk::SizeValueType i = 0; i < numberOfPoints; ++i)
+    {
+      expectedPoints[i] = transform->TransformPoint(points[i]);
+    }
+    perPointProbe.Stop();
+    batchedProbe.Start();
+    transform->TransformPoints(points.data(), batchedPoints.data(), numberOfPoints);
+    batchedProbe.Stop();
+  }
+  std::cout << name << ": " << 1e9 * perPointProbe.GetTotal() / (numberOfReps * numberOfPoints) << " ns per point, "
+            << 1e9 * batchedProbe.GetTotal() / (numberOfReps * numberOfPoints) << " ns per point batched"
+            << std::endl;
+
+  std::vector<PointType> inPlacePoints(points);
+  transform->TransformPoints(inPlacePoints.data(), inPlacePoints.data(), numberOfPoints);
+
+  bool success = true;
+  for (itk::SizeValueType i = 0; i < numberOfPoints; ++i)
+  {
+    if (!PointsAlmostEqual(batchedPoints[i], expectedPoints[i]) ||
+        !PointsAlmostEqual(inPlacePoints[i], expectedPoints[i]))
+    {
+      std::cerr << name << ": point " << points[i] << " was mapped to " << batchedPoints[i] << " and in place to "
+                << inPlacePoints[i] << " instead of " << expectedPoints[i] << std::endl;
+      success = false;
+      break;
+    }
+  }
+
+  constexpr itk::SizeValueType             numberOfJacobians = 100;
+  std::vector<TransformType::JacobianType> jacobians(numberOfJacobians);
+  transform->ComputeJacobiansWithRespectToParameters(points.data(), jacobians.data(), numberOfJacobians);
+  TransformType::JacobianType expectedJacobian;
+  for (itk::SizeValueType i = 0; i < numberOfJacobians; ++i)
+  {
+    transform->ComputeJacobianWithRespectToParameters(points[i], expectedJacobian);
+    if (jacobians[i] != expectedJacobian)
+    {
+      std::cerr << name << ": the batched Jacobian at " << points[i] << " differs" << std::endl;
+      success = false;
+      break;
+    }
+  }
+  return success;
+}
+} // namespace
+
+int
+itkTransformPointsTest(int argc, char * argv[])
+{
+  const itk::SizeValueType numberOfPoints = (argc > 1) ? std::stoul(argv[1]) : 20000;
+
+  // Points over [-10, 110)^3, partly outside the domains of the field transforms.
+  auto generator = itk::Statistics::MersenneTwisterRandomVariateGenerator::New();
+  generator->Initialize(20240611);
+  std::vector<PointType> points(numberOfPoints);
+  for (auto & point : points)
+  {
+    for (unsigned int d = 0; d < Dimension; ++d)
+    {
+      point[d] = generator->GetUniformVariate(-10.0, 110.0);
+    }
+  }
+
+  bool success = true;
+
+  auto affine = itk::AffineTransform<double, Dimension>::New();
+  auto affineParameters = affine->GetParameters();
+  for (unsigned int p = 0; p < affineParameters.Size(); ++p)
+  {
+    affineParameters[p] += generator->GetUniformVariate(-0.2, 0.2);
+  }
+  affine->SetParameters(affineParameters);
+  affine->SetCenter(PointType(50.0));
+  success &= CompareToPerPoint("Affine", affine, points);
+
+  auto euler = itk::Euler3DTransform<double>::New();
+  euler->SetRotation(0.1, -0.2, 0.3);
+  euler->SetCenter(PointType(40.0));
+  success &= CompareToPerPoint("Euler3D", euler, points);
+
+  auto translation = itk::TranslationTransform<double, Dimension>::New();
+  translation->SetOffset(itk::MakeVector(1.5, -2.0, 0.25));
+  success &= CompareToPerPoint("Translation", translation, points);
+
+  auto scale = itk::ScaleTransform<double, Dimension>::New();
+  scale->SetScale(itk::MakeFilled<itk::ScaleTransform<double, Dimension>::ScaleType>(1.1));
+  scale->SetCenter(PointType(30.0));
+  success &= CompareToPerPoint("Scale", scale, points);
+
+  auto azimuthElevation = itk::AzimuthElevationToCartesianTransform<double, Dimension>::New();
+  azimuthElevation->SetAzimuthElevationToCartesianParameters(0.5, 2.0, 64, 64);
+  success &= CompareToPerPoint("AzimuthElevationToCartesian", azimuthElevation, points);
+
+  using BSplineTransformType = itk::BSplineTransform<double, Dimension, 3>;
+  auto bspline = BSplineTransformType::New();
+  bspline->SetTransformDomainOrigin(BSplineTransformType::OriginType(0.0));
+  bspline->SetTransformDomainPhysicalDimensions(itk::MakeFilled<BSplineTransformType::PhysicalDimensionsType>(100.0));
+  bspline->SetTransformDomainMeshSize(itk::MakeFilled<BSplineTransformType::MeshSizeType>(6));
+  BSplineTransformType::ParametersType bsplineParameters(bspline->GetNumberOfParameters());
+  for (unsigned int p = 0; p < bsplineParameters.Size(); ++p)
+  {
+    bsplineParameters[p] = generator->GetUniformVariate(-3.0, 3.0);
+  }
+  bspline->SetParametersByValue(bsplineParameters);
+  success &= CompareToPerPoint("BSpline", bspline, points);
+
+  // The batched sparse Jacobians are those of the per point overload.
+  {
+    std::vector<PointType>                                     outputPoints(numberOfPoints);
+    std::vector<BSplineTransformType::WeightsType>             weights(numberOfPoints);
+    std::vector<BSplineTransformType::ParameterIndexArrayType> indices(numberOfPoints);
+    auto                                                       inside = std::make_unique<bool[]>(numberOfPoints);
+    bspline->TransformPoints(
+      points.data(), outputPoints.data(), weights.data(), indices.data(), inside.get(), numberOfPoints);
+    itk::SizeValueType numberOfInsidePoints = 0;
+    for (itk::SizeValueType i = 0; i < numberOfPoints; ++i)
+    {
+      PointType                                     expectedPoint;
+      BSplineTransformType::WeightsType             expectedWeights;
+      BSplineTransformType::ParameterIndexArrayType expectedIndices;
+      bool                                          expectedInside = false;
+      bspline->TransformPoint(points[i], expectedPoint, expectedWeights, expectedIndices, expectedInside);
+      if (inside[i] != expectedInside || !PointsAlmostEqual(outputPoints[i], expectedPoint) ||
+          (expectedInside && (weights[i] != expectedWeights || indices[i] != expectedIndices)))
+      {
+        std::cerr << "BSpline: the sparse Jacobian at " << points[i] << " differs" << std::endl;
+        success = false;
+        break;
+      }
+      numberOfInsidePoints += expectedInside;
+    }
+    std::cout << "BSpline: " << numberOfInsidePoints << " of " << numberOfPoints << " points inside" << std::endl;
+    ITK_TEST_EXPECT_TRUE(numberOfInsidePoints > 0 && numberOfInsidePoints < numberOfPoints);
+  }
+
+  using DisplacementFieldTransformType = itk::DisplacementFieldTransform<double, Dimension>;
+  using DisplacementFieldType = DisplacementFieldTransformType::DisplacementFieldType;
+  auto field = DisplacementFieldType::New();
+  field->SetRegions(DisplacementFieldType::SizeType::Filled(25));
+  field->SetSpacing(itk::MakeFilled<DisplacementFieldType::SpacingType>(4.0));
+  field->Allocate();
+  for (itk::ImageRegionIterator<DisplacementFieldType> it(field, field->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    it.Set(itk::MakeVector(generator->GetUniformVariate(-2.0, 2.0),
+                           generator->GetUniformVariate(-2.0, 2.0),
+                           generator->GetUniformVariate(-2.0, 2.0)));
+  }
+  auto displacementFieldTransform = DisplacementFieldTransformType::New();
+  displacementFieldTransform->SetDisplacementField(field);
+  success &= CompareToPerPoint("DisplacementField", displacementFieldTransform, points);
+
+  auto composite = itk::CompositeTransform<double, Dimension>::New();
+  composite->AddTransform(affine);
+  composite->AddTransform(displacementFieldTransform);
+  composite->AddTransform(translation);
+  composite->SetAllTransformsToOptimizeOff();
+  composite->SetOnlyMostRecentTransformToOptimizeOn();
+  success &= CompareToPerPoint("Composite", composite, points);
+
+  // Subclasses take the per point path of the methods they override.
+  auto shiftedAffine = ShiftedTransform<itk::AffineTransform<double, Dimension>>::New();
+  shiftedAffine->SetParameters(affineParameters);
+  shiftedAffine->SetCenter(PointType(50.0));
+  success &= CompareToPerPoint("ShiftedAffine", shiftedAffine, points);
+
+  auto shiftedTranslation = ShiftedTransform<itk::TranslationTransform<double, Dimension>>::New();
+  shiftedTranslation->SetOffset(itk::MakeVector(1.5, -2.0, 0.25));
+  success &= CompareToPerPoint("ShiftedTranslation", shiftedTranslation, points);
+
+  auto shiftedBSpline = ShiftedTransform<BSplineTransformType>::New();
+  shiftedBSpline->SetFixedParameters(bspline->GetFixedParameters());
+  shiftedBSpline->SetParametersByValue(bsplineParameters);
+  success &= CompareToPerPoint("ShiftedBSpline", shiftedBSpline, points);
+
+  auto shiftedDisplacementFieldTransform = ShiftedTransform<DisplacementFieldTransformType>::New();
+  shiftedDisplacementFieldTransform->SetDisplacementField(field);
+  success &= CompareToPerPoint("ShiftedDisplacementField", shiftedDisplacementFieldTransform, points);
+
+  auto shiftedComposite = ShiftedTransform<itk::CompositeTransform<double, Dimension>>::New();
+  shiftedComposite->AddTransform(affine);
+  shiftedComposite->AddTransform(displacementFieldTransform);
+  success &= CompareToPerPoint("ShiftedComposite", shiftedComposite, points);
+
+  // A composite of such subclasses gets their results as well.
+  auto compositeOfShifted = itk::CompositeTransform<double, Dimension>::New();
+  compositeOfShifted->AddTransform(shiftedAffine);
+  compositeOfShifted->AddTransform(shiftedDisplacementFieldTransform);
+  success &= CompareToPerPoint("CompositeOfShifted", compositeOfShifted, points);
+
+  auto                   emptyComposite = itk::CompositeTransform<double, Dimension>::New();
+  std::vector<PointType> copiedPoints(numberOfPoints);
+  emptyComposite->TransformPoints(points.data(), copiedPoints.data(), numberOfPoints);
+  ITK_TEST_EXPECT_TRUE(copiedPoints == points);
+
+  if (!success)
+  {
+    std::cout << "Test FAILED!" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,185 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkAutomaticConvolutionImageFilter_h
+#define itkAutomaticConvolutionImageFilter_h
+
+#include "itkConvolutionImageFilterBase.h"
+#include "itkConvolutionCostModel.h"
+#include "itkProgressAccumulator.h"
+
+#include <vector>
+
+namespace itk
+{
+/**
+ * \class AutomaticConvolutionImageFilter
+ * \brief Convolve an image with an arbitrary image kernel, choosing the
+ * fastest way on this machine.
+ *
+ * This filter produces the output of ConvolutionImageFilter. Before each
+ * update it estimates the time of computing the output requested region
+ *  - in the spatial domain, with ConvolutionImageFilter,
+ *  - as a sequence of one dimensional convolutions, one per dimension, when
+ *    the kernel is the outer product of one dimensional kernels, such as a
+ *    Gaussian or a box kernel,
+ *  - in the Fourier domain, with FFTConvolutionImageFilter,
+ *  - in the Fourier domain block by block, with FFTConvolutionImageFilter in
+ *    block mode, whose blocks fit in the BlockMemorySize,
+ *
+ * and delegates to the fastest one. The estimates are the amount of work,
+ * that is the number of multiply-adds or the size of the Fourier transforms,
+ * times the cost per unit of work for the number of work units of the
+ * filter, which ConvolutionCostModel measures once per machine.
+ *
+ * The separable convolution requires scalar pixels and, in SAME output region
+ * mode, the default ZeroFluxNeumannBoundaryCondition. The Fourier domain
+ * requires scalar pixels. The method may also be set explicitly by
+ * SetConvolutionMethod().
+ *
+ * \warning This filter ignores the spacing, origin, and orientation
+ * of the kernel image and treats them as identical to those in the
+ * input image.
+ *
+ * \ingroup ITKConvolution
+ * \sa ConvolutionImageFilter
+ * \sa FFTConvolutionImageFilter
+ * \sa ConvolutionCostModel
+ */
+template <typename TInputImage, typename TKernelImage = TInputImage, typename TOutputImage = TInputImage>
+class ITK_TEMPLATE_EXPORT AutomaticConvolutionImageFilter
+  : public ConvolutionImageFilterBase<TInputImage, TKernelImage, TOutputImage>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(AutomaticConvolutionImageFilter);
+
+  using Self = AutomaticConvolutionImageFilter;
+  using Superclass = ConvolutionImageFilterBase<TInputImage, TKernelImage, TOutputImage>;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** \see LightObject::GetNameOfClass() */
+  itkOverrideGetNameOfClassMacro(AutomaticConvolutionImageFilter);
+
+  /** Dimensionality of input and output data is assumed to be the same. */
+  static constexpr unsigned int ImageDimension = TInputImage::ImageDimension;
+
+  using typename Superclass::InputImageType;
+  using typename Superclass::OutputImageType;
+  using typename Superclass::KernelImageType;
+  using typename Superclass::InputPixelType;
+  using typename Superclass::OutputPixelType;
+  using typename Superclass::KernelPixelType;
+  using typename Superclass::KernelSizeType;
+  using typename Superclass::SizeValueType;
+  using typename Superclass::InputRegionType;
+  using typename Superclass::OutputRegionType;
+  using typename Superclass::BoundaryConditionType;
+  using typename Superclass::DefaultBoundaryConditionType;
+
+  using ConvolutionMethodEnum = ConvolutionCostModelEnums::ConvolutionMethod;
+
+  /** Set/Get how the convolution is computed. The default, AUTOMATIC,
+   * chooses the fastest method before each update. */
+  itkSetEnumMacro(ConvolutionMethod, ConvolutionMethodEnum);
+  itkGetEnumMacro(ConvolutionMethod, ConvolutionMethodEnum);
+
+  /** Get the method that computed the output of the last update. */
+  itkGetEnumMacro(SelectedConvolutionMethod, ConvolutionMethodEnum);
+
+  /** Set/Get the memory, in bytes, that the buffers of one block of the
+   * BLOCK_FFT method may take. Defaults to the default of
+   * FFTConvolutionImageFilter. */
+  itkSetMacro(BlockMemorySize, SizeValueType);
+  itkGetConstMacro(BlockMemorySize, SizeValueType);
+
+  /** Estimate the time, in seconds, that method takes to compute region of
+   * the output. Requires the output information to be up to date, and, for
+   * the SEPARABLE method, the kernel image to be buffered. Returns the
+   * largest double for a method that cannot compute the output. Measures the
+   * costs that ConvolutionCostModel does not know yet. */
+  double
+  EstimateTime(ConvolutionMethodEnum method, const OutputRegionType & region) const;
+
+  /** Measure the costs of the methods, in seconds per unit of work, with the
+   * given number of work units, for ConvolutionCostModel. */
+  static double
+  CalibrateSpatialConvolution(ThreadIdType numberOfWorkUnits);
+  static double
+  CalibrateFFTConvolution(ThreadIdType numberOfWorkUnits);
+
+protected:
+  AutomaticConvolutionImageFilter() = default;
+  ~AutomaticConvolutionImageFilter() override = default;
+
+  /** The type of the one dimensional kernels of a separable kernel, and of
+   * the intermediate results of the separable convolution. */
+  using RealPixelType = typename NumericTraits<KernelPixelType>::RealType;
+  using RealImageType = Image<RealPixelType, ImageDimension>;
+
+  /** The input requested region is the output requested region padded by
+   * the kernel radius, within the input largest possible region.
+   *
+   * \sa ProcessObject::GenerateInputRequestedRegion() */
+  void
+  GenerateInputRequestedRegion() override;
+
+  /** Selects the method and runs a minipipeline. */
+  void
+  GenerateData() override;
+
+  /** Returns the method of the smallest estimated time for region. */
+  ConvolutionMethodEnum
+  SelectConvolutionMethod(const OutputRegionType & region) const;
+
+  /** Computes the one dimensional kernels whose outer product is the kernel
+   * image, normalized if Normalize is on. Returns false if the kernel image
+   * is not such a product, within a relative tolerance of 1e-6. */
+  bool
+  ComputeSeparableKernels(std::vector<typename RealImageType::Pointer> & kernels) const;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  /** Runs filter, a convolution filter with the parameters of this filter,
+   * on input, and grafts its output. */
+  template <typename TFilter>
+  void
+  ConvolveWith(TFilter * filter, const InputImageType * input, ProgressAccumulator * progress);
+
+  /** Runs one ConvolutionImageFilter per dimension, with the kernels from
+   * ComputeSeparableKernels(). */
+  void
+  SeparableGenerateData(const InputImageType *                               input,
+                        const std::vector<typename RealImageType::Pointer> & kernels,
+                        ProgressAccumulator *                                progress);
+
+  ConvolutionMethodEnum m_ConvolutionMethod{ ConvolutionMethodEnum::AUTOMATIC };
+  ConvolutionMethodEnum m_SelectedConvolutionMethod{ ConvolutionMethodEnum::AUTOMATIC };
+  SizeValueType         m_BlockMemorySize{ 32 * 1024 * 1024 };
+};
+} // namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkAutomaticConvolutionImageFilter.hxx"
+#endif
+
+#endif
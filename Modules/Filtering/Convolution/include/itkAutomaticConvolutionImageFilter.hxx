@@ -0,0 +1,489 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkAutomaticConvolutionImageFilter_hxx
+#define itkAutomaticConvolutionImageFilter_hxx
+
+#include "itkConvolutionImageFilter.h"
+#include "itkFFTConvolutionImageFilter.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageRegionIterator.h"
+
+#include <cmath>
+#include <type_traits>
+
+namespace itk
+{
+template <typename TInputImage, typename TKernelImage, typename TOutputImage>
+double
+AutomaticConvolutionImageFilter<TInputImage, TKernelImage, TOutputImage>::CalibrateSpatialConvolution(
+  ThreadIdType numberOfWorkUnits)
+{
+  using ImageType = Image<float, 3>;
+
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType::Filled(32));
+  image->AllocateInitialized();
+  auto kernel = ImageType::New();
+  kernel->SetRegions(ImageType::SizeType::Filled(5));
+  kernel->Allocate();
+  kernel->FillBuffer(1.0f / 125.0f);
+
+  auto filter = ConvolutionImageFilter<ImageType>::New();
+  filter->SetInput(image);
+  filter->SetKernelImage(kernel);
+  filter->SetNumberOfWorkUnits(numberOfWorkUnits);
+  const double time = ConvolutionCostModel::MeasureShortestTime([&filter] {
+    filter->Modified();
+    filter->Update();
+  });
+  return time / (image->GetBufferedRegion().GetNumberOfPixels() * kernel->GetBufferedRegion().GetNumberOfPixels());
+}
+
+template <typename TInputImage, typename TKernelImage, typename TOutputImage>
+double
+AutomaticConvolutionImageFilter<TInputImage, TKernelImage, TOutputImage>::CalibrateFFTConvolution(
+  ThreadIdType numberOfWorkUnits)
+{
+  using ImageType = Image<float, 3>;
+
+  // The input padded by the kernel radius is 64^3.
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType::Filled(60));
+  image->AllocateInitialized();
+  auto kernel = ImageType::New();
+  kernel->SetRegions(ImageType::SizeType::Filled(5));
+  kernel->Allocate();
+  kernel->FillBuffer(1.0f / 125.0f);
+
+  auto filter = FFTConvolutionImageFilter<ImageType>::New();
+  filter->SetInput(image);
+  filter->SetKernelImage(kernel);
+  filter->SetNumberOfWorkUnits(numberOfWorkUnits);
+  const double time = ConvolutionCostModel::MeasureShortestTime([&filter] {
+    filter->Modified();
+    filter->Update();
+  });
+  SizeValueType paddedSize = 1;
+  for (unsigned int dim = 0; dim < 3; ++dim)
+  {
+    paddedSize *= ConvolutionCostModel::GetFFTSize(60 + 4, filter->GetSizeGreatestPrimeFactor());
+  }
+  return time / ConvolutionCostModel::GetFFTWork(paddedSize);
+}
+
+template <typename TInputImage, typename TKernelImage, typename TOutputImage>
+double
+AutomaticConvolutionImageFilter<TInputImage, TKernelImage, TOutputImage>::EstimateTime(
+  ConvolutionMethodEnum      method,
+  const OutputRegionType & region) const
+{
+  constexpr bool isScalar = std::is_arithmetic_v<InputPixelType> && std::is_arithmetic_v<KernelPixelType> &&
+                            std::is_arithmetic_v<OutputPixelType>;
+  constexpr double notApplicable = NumericTraits<double>::max();
+
+  const KernelSizeType kernelSize = this->GetKernelImage()->GetLargestPossibleRegion().GetSize();
+  const double         numberOfPixels = region.GetNumberOfPixels();
+  const ThreadIdType   numberOfWorkUnits = this->GetNumberOfWorkUnits();
+
+  switch (method)
+  {
+    case ConvolutionMethodEnum::SPATIAL:
+    {
+      const double cost =
+        ConvolutionCostModel::GetCost("ConvolutionImageFilter", numberOfWorkUnits, &Self::CalibrateSpatialConvolution);
+      return cost * numberOfPixels * this->GetKernelImage()->GetLargestPossibleRegion().GetNumberOfPixels();
+    }
+    case ConvolutionMethodEnum::SEPARABLE:
+    {
+      if constexpr (isScalar)
+      {
+        std::vector<typename RealImageType::Pointer> kernels;
+        if (!this->ComputeSeparableKernels(kernels))
+        {
+          return notApplicable;
+        }
+        double sumOfKernelWidths = 0.0;
+        for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+        {
+          sumOfKernelWidths += kernelSize[dim];
+        }
+        const double cost = ConvolutionCostModel::GetCost(
+          "ConvolutionImageFilter", numberOfWorkUnits, &Self::CalibrateSpatialConvolution);
+        return cost * numberOfPixels * sumOfKernelWidths;
+      }
+      return notApplicable;
+    }
+    case ConvolutionMethodEnum::FFT:
+    {
+      if constexpr (isScalar)
+      {
+        // The requested region padded by the kernel radius, then to a size
+        // suitable for the Fourier transform.
+        const SizeValueType greatestPrimeFactor =
+          FFTConvolutionImageFilter<InputImageType, KernelImageType, OutputImageType>::New()
+            ->GetSizeGreatestPrimeFactor();
+        double paddedSize = 1.0;
+        for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+        {
+          paddedSize *= ConvolutionCostModel::GetFFTSize(region.GetSize(dim) + 2 * (kernelSize[dim] / 2),
+                                                         greatestPrimeFactor);
+        }
+        const double cost = ConvolutionCostModel::GetCost(
+          "FFTConvolutionImageFilter", numberOfWorkUnits, &Self::CalibrateFFTConvolution);
+        return cost * ConvolutionCostModel::GetFFTWork(paddedSize);
+      }
+      return notApplicable;
+    }
+    case ConvolutionMethodEnum::BLOCK_FFT:
+    {
+      if constexpr (isScalar)
+      {
+        // Every block is transformed at the same size.
+        auto fftFilter = FFTConvolutionImageFilter<InputImageType, KernelImageType, OutputImageType>::New();
+        fftFilter->SetKernelImage(this->GetKernelImage());
+        fftFilter->SetBlockMemorySize(m_BlockMemorySize);
+        const auto fftSize = fftFilter->ComputeBlockFFTSize(region);
+        double     numberOfBlocks = 1.0;
+        double     blockFFTSize = 1.0;
+        for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+        {
+          const SizeValueType blockSize = fftSize[dim] - 2 * (kernelSize[dim] / 2);
+          numberOfBlocks *= (region.GetSize(dim) + blockSize - 1) / blockSize;
+          blockFFTSize *= fftSize[dim];
+        }
+        const double cost = ConvolutionCostModel::GetCost(
+          "FFTConvolutionImageFilter", numberOfWorkUnits, &Self::CalibrateFFTConvolution);
+        return cost * numberOfBlocks * ConvolutionCostModel::GetFFTWork(blockFFTSize);
+      }
+      return notApplicable;
+    }
+    default:
+      itkExceptionMacro("Cannot estimate the time of " << method);
+  }
+}
+
+template <typename TInputImage, typename TKernelImage, typename TOutputImage>
+auto
+AutomaticConvolutionImageFilter<TInputImage, TKernelImage, TOutputImage>::SelectConvolutionMethod(
+  const OutputRegionType & region) const -> ConvolutionMethodEnum
+{
+  ConvolutionMethodEnum selectedMethod = ConvolutionMethodEnum::SPATIAL;
+  double                shortestTime = this->EstimateTime(selectedMethod, region);
+  for (const auto method :
+       { ConvolutionMethodEnum::SEPARABLE, ConvolutionMethodEnum::FFT, ConvolutionMethodEnum::BLOCK_FFT })
+  {
+    const double time = this->EstimateTime(method, region);
+    itkDebugMacro("Estimated time of " << method << ": " << time << " s");
+    if (time < shortestTime)
+    {
+      selectedMethod = method;
+      shortestTime = time;
+    }
+  }
+  return selectedMethod;
+}
+
+template <typename TInputImage, typename TKernelImage, typename TOutputImage>
+bool
+AutomaticConvolutionImageFilter<TInputImage, TKernelImage, TOutputImage>::ComputeSeparableKernels(
+  std::vector<typename RealImageType::Pointer> & kernels) const
+{
+  kernels.clear();
+  if constexpr (std::is_arithmetic_v<KernelPixelType>)
+  {
+    // The one dimensional passes clamp the indices dimension by dimension,
+    // which only matches the default boundary condition.
+    if (this->GetOutputRegionMode() == ConvolutionImageFilterBaseEnums::ConvolutionImageFilterOutputRegion::SAME &&
+        dynamic_cast<const DefaultBoundaryConditionType *>(this->GetBoundaryCondition()) == nullptr)
+    {
+      return false;
+    }
+
+    const KernelImageType * kernel = this->GetKernelImage();
+    const auto &            kernelRegion = kernel->GetLargestPossibleRegion();
+
+    // The lines through the element of largest magnitude are the one
+    // dimensional kernels, up to a factor.
+    typename KernelImageType::IndexType pivotIndex = kernelRegion.GetIndex();
+    double                              pivot = 0.0;
+    for (ImageRegionConstIteratorWithIndex<KernelImageType> it(kernel, kernelRegion); !it.IsAtEnd(); ++it)
+    {
+      if (std::abs(static_cast<double>(it.Get())) > std::abs(pivot))
+      {
+        pivot = static_cast<double>(it.Get());
+        pivotIndex = it.GetIndex();
+      }
+    }
+    if (pivot == 0.0)
+    {
+      return false;
+    }
+
+    std::vector<std::vector<double>> lines(ImageDimension);
+    for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+    {
+      typename KernelImageType::IndexType index = pivotIndex;
+      for (SizeValueType i = 0; i < kernelRegion.GetSize(dim); ++i)
+      {
+        index[dim] = kernelRegion.GetIndex(dim) + static_cast<IndexValueType>(i);
+        lines[dim].push_back(static_cast<double>(kernel->GetPixel(index)));
+      }
+    }
+    // The outer product of the lines is the kernel times pivot^(ImageDimension-1).
+    const double scale = std::pow(pivot, static_cast<double>(ImageDimension) - 1.0);
+    for (double & value : lines[0])
+    {
+      value /= scale;
+    }
+    for (ImageRegionConstIteratorWithIndex<KernelImageType> it(kernel, kernelRegion); !it.IsAtEnd(); ++it)
+    {
+      const auto & index = it.GetIndex();
+      double       product = 1.0;
+      for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+      {
+        product *= lines[dim][index[dim] - kernelRegion.GetIndex(dim)];
+      }
+      if (std::abs(product - static_cast<double>(it.Get())) > 1e-6 * std::abs(pivot))
+      {
+        return false;
+      }
+    }
+
+    if (this->GetNormalize())
+    {
+      for (auto & line : lines)
+      {
+        double sum = 0.0;
+        for (const double value : line)
+        {
+          sum += value;
+        }
+        if (sum == 0.0)
+        {
+          return false;
+        }
+        for (double & value : line)
+        {
+          value /= sum;
+        }
+      }
+    }
+
+    for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+    {
+      auto size = RealImageType::SizeType::Filled(1);
+      size[dim] = kernelRegion.GetSize(dim);
+      auto lineKernel = RealImageType::New();
+      lineKernel->SetRegions(size);
+      lineKernel->Allocate();
+      auto value = lines[dim].cbegin();
+      for (ImageRegionIterator<RealImageType> it(lineKernel, lineKernel->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+      {
+        it.Set(static_cast<RealPixelType>(*value++));
+      }
+      kernels.push_back(lineKernel);
+    }
+    return true;
+  }
+  return false;
+}
+
+template <typename TInputImage, typename TKernelImage, typename TOutputImage>
+void
+AutomaticConvolutionImageFilter<TInputImage, TKernelImage, TOutputImage>::GenerateInputRequestedRegion()
+{
+  // Pad the input image with the radius of the kernel.
+  if (this->GetInput())
+  {
+    InputRegionType inputRegion = this->GetOutput()->GetRequestedRegion();
+
+    KernelSizeType radius;
+    for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+    {
+      radius[dim] = this->GetKernelImage()->GetLargestPossibleRegion().GetSize(dim) / 2;
+    }
+    inputRegion.PadByRadius(radius);
+
+    // Crop the output request region to fit within the largest
+    // possible region.
+    const typename InputImageType::Pointer inputPtr = const_cast<InputImageType *>(this->GetInput());
+    const bool                             cropped = inputRegion.Crop(inputPtr->GetLargestPossibleRegion());
+    if (!cropped)
+    {
+      InvalidRequestedRegionError e(__FILE__, __LINE__);
+      e.SetLocation(ITK_LOCATION);
+      e.SetDescription("Requested region is (at least partially) outside the largest possible region.");
+      e.SetDataObject(inputPtr);
+      throw e;
+    }
+    inputPtr->SetRequestedRegion(inputRegion);
+  }
+
+  // Request the largest possible region for the kernel image.
+  if (this->GetKernelImage())
+  {
+    const typename KernelImageType::Pointer kernelPtr = const_cast<KernelImageType *>(this->GetKernelImage());
+    kernelPtr->SetRequestedRegionToLargestPossibleRegion();
+  }
+}
+
+template <typename TInputImage, typename TKernelImage, typename TOutputImage>
+void
+AutomaticConvolutionImageFilter<TInputImage, TKernelImage, TOutputImage>::GenerateData()
+{
+  const OutputRegionType region = this->GetOutput()->GetRequestedRegion();
+  m_SelectedConvolutionMethod = m_ConvolutionMethod;
+  if (m_SelectedConvolutionMethod == ConvolutionMethodEnum::AUTOMATIC)
+  {
+    m_SelectedConvolutionMethod = this->SelectConvolutionMethod(region);
+  }
+  itkDebugMacro("Convolving with " << m_SelectedConvolutionMethod);
+
+  // Create a process accumulator for tracking the progress of this minipipeline
+  auto progress = ProgressAccumulator::New();
+  progress->SetMiniPipelineFilter(this);
+
+  // Protect the requested region of the input from the minipipeline.
+  auto localInput = InputImageType::New();
+  localInput->Graft(this->GetInput());
+
+  if (m_SelectedConvolutionMethod == ConvolutionMethodEnum::SPATIAL)
+  {
+    this->ConvolveWith(ConvolutionImageFilter<InputImageType, KernelImageType, OutputImageType>::New().GetPointer(),
+                       localInput,
+                       progress);
+    return;
+  }
+
+  constexpr bool isScalar = std::is_arithmetic_v<InputPixelType> && std::is_arithmetic_v<KernelPixelType> &&
+                            std::is_arithmetic_v<OutputPixelType>;
+  if constexpr (isScalar)
+  {
+    if (m_SelectedConvolutionMethod == ConvolutionMethodEnum::FFT ||
+        m_SelectedConvolutionMethod == ConvolutionMethodEnum::BLOCK_FFT)
+    {
+      auto fftFilter = FFTConvolutionImageFilter<InputImageType, KernelImageType, OutputImageType>::New();
+      fftFilter->SetBlockConvolution(m_SelectedConvolutionMethod == ConvolutionMethodEnum::BLOCK_FFT);
+      fftFilter->SetBlockMemorySize(m_BlockMemorySize);
+      this->ConvolveWith(fftFilter.GetPointer(), localInput, progress);
+      return;
+    }
+    std::vector<typename RealImageType::Pointer> kernels;
+    if (m_SelectedConvolutionMethod == ConvolutionMethodEnum::SEPARABLE && this->ComputeSeparableKernels(kernels))
+    {
+      this->SeparableGenerateData(localInput, kernels, progress);
+      return;
+    }
+  }
+  itkExceptionMacro("Cannot convolve with " << m_SelectedConvolutionMethod);
+}
+
+template <typename TInputImage, typename TKernelImage, typename TOutputImage>
+template <typename TFilter>
+void
+AutomaticConvolutionImageFilter<TInputImage, TKernelImage, TOutputImage>::ConvolveWith(TFilter *              filter,
+                                                                                      const InputImageType * input,
+                                                                                      ProgressAccumulator *  progress)
+{
+  filter->SetInput(input);
+  filter->SetKernelImage(this->GetKernelImage());
+  filter->SetNormalize(this->GetNormalize());
+  filter->SetBoundaryCondition(this->GetBoundaryCondition());
+  filter->SetOutputRegionMode(this->GetOutputRegionMode());
+  filter->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+  progress->RegisterInternalFilter(filter, 1.0f);
+
+  filter->GetOutput()->SetRequestedRegion(this->GetOutput()->GetRequestedRegion());
+  filter->Update();
+  this->GraftOutput(filter->GetOutput());
+}
+
+template <typename TInputImage, typename TKernelImage, typename TOutputImage>
+void
+AutomaticConvolutionImageFilter<TInputImage, TKernelImage, TOutputImage>::SeparableGenerateData(
+  const InputImageType *                               input,
+  const std::vector<typename RealImageType::Pointer> & kernels,
+  ProgressAccumulator *                                progress)
+{
+  using FirstFilterType = ConvolutionImageFilter<InputImageType, RealImageType, RealImageType>;
+  using MiddleFilterType = ConvolutionImageFilter<RealImageType, RealImageType, RealImageType>;
+  using LastFilterType = ConvolutionImageFilter<RealImageType, RealImageType, OutputImageType>;
+  using SingleFilterType = ConvolutionImageFilter<InputImageType, RealImageType, OutputImageType>;
+
+  const float passWeight = 1.0f / ImageDimension;
+  const auto  configure = [this, &kernels, progress, passWeight](auto * filter, unsigned int dim) {
+    filter->SetKernelImage(kernels[dim]);
+    filter->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+    filter->ReleaseDataFlagOn();
+    progress->RegisterInternalFilter(filter, passWeight);
+  };
+
+  typename OutputImageType::Pointer output;
+  if constexpr (ImageDimension == 1)
+  {
+    auto filter = SingleFilterType::New();
+    configure(filter.GetPointer(), 0);
+    filter->SetInput(input);
+    filter->GetOutput()->SetRequestedRegion(this->GetOutput()->GetRequestedRegion());
+    filter->Update();
+    output = filter->GetOutput();
+  }
+  else
+  {
+    // The passes form a pipeline, so that each requests the region its
+    // successor needs.
+    auto firstFilter = FirstFilterType::New();
+    configure(firstFilter.GetPointer(), 0);
+    firstFilter->SetInput(input);
+    const RealImageType *                          previousOutput = firstFilter->GetOutput();
+    std::vector<typename MiddleFilterType::Pointer> middleFilters;
+    for (unsigned int dim = 1; dim + 1 < ImageDimension; ++dim)
+    {
+      auto middleFilter = MiddleFilterType::New();
+      configure(middleFilter.GetPointer(), dim);
+      middleFilter->SetInput(previousOutput);
+      previousOutput = middleFilter->GetOutput();
+      middleFilters.push_back(middleFilter);
+    }
+    auto lastFilter = LastFilterType::New();
+    configure(lastFilter.GetPointer(), ImageDimension - 1);
+    lastFilter->SetInput(previousOutput);
+    lastFilter->GetOutput()->SetRequestedRegion(this->GetOutput()->GetRequestedRegion());
+    lastFilter->Update();
+    output = lastFilter->GetOutput();
+  }
+
+  // In VALID output region mode, the passes compute the requested region
+  // from pixels inside the input only.
+  output->SetLargestPossibleRegion(this->GetOutput()->GetLargestPossibleRegion());
+  this->GraftOutput(output);
+}
+
+template <typename TInputImage, typename TKernelImage, typename TOutputImage>
+void
+AutomaticConvolutionImageFilter<TInputImage, TKernelImage, TOutputImage>::PrintSelf(std::ostream & os,
+                                                                                   Indent         indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "ConvolutionMethod: " << m_ConvolutionMethod << std::endl;
+  os << indent << "SelectedConvolutionMethod: " << m_SelectedConvolutionMethod << std::endl;
+  os << indent << "BlockMemorySize: " << m_BlockMemorySize << std::endl;
+}
+} // namespace itk
+#endif
@@ -0,0 +1,147 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkConvolutionCostModel_h
+#define itkConvolutionCostModel_h
+
+#include "itkIntTypes.h"
+#include "itkMacro.h"
+#include "itkSingletonMacro.h"
+#include "ITKConvolutionExport.h"
+
+#include <functional>
+#include <iosfwd>
+#include <string>
+
+namespace itk
+{
+/** \class ConvolutionCostModelEnums
+ * \brief Contains all enum classes used by ConvolutionCostModel and by the
+ * filters that choose how to convolve.
+ * \ingroup ITKConvolution
+ */
+class ConvolutionCostModelEnums
+{
+public:
+  /**
+   * \ingroup ITKConvolution
+   * The ways of computing a convolution. AUTOMATIC lets the filter choose the
+   * cheapest one according to ConvolutionCostModel. BLOCK_FFT is FFT block by
+   * block, see FFTConvolutionImageFilter::SetBlockConvolution().
+   */
+  enum class ConvolutionMethod : uint8_t
+  {
+    AUTOMATIC = 0,
+    SPATIAL,
+    SEPARABLE,
+    FFT,
+    BLOCK_FFT
+  };
+};
+/** Define how to print enumerations */
+extern ITKConvolution_EXPORT std::ostream &
+operator<<(std::ostream & out, const ConvolutionCostModelEnums::ConvolutionMethod value);
+
+struct ConvolutionCostModelGlobals;
+
+/** \class ConvolutionCostModel
+ * \brief Process wide costs of the ways of computing a convolution on this
+ * machine.
+ *
+ * A cost is the time, in seconds, that one way of computing a convolution
+ * takes per unit of work with a given number of work units. The unit of work
+ * is defined by the filter that uses the cost, for example one multiply-add
+ * of a spatial convolution, or GetFFTWork() of the padded image of an FFT
+ * convolution. Costs are identified by a key, usually the name of the filter
+ * class that computes the convolution.
+ *
+ * When a filter asks for a cost that is not known yet, it passes a
+ * calibration function, which times the computation on a small image. The
+ * result is kept for the lifetime of the process and written to a cache
+ * file, from which later processes read it, so that each cost is measured
+ * once per machine. Costs that are SetCost() explicitly, for example by tests
+ * that need a deterministic choice, are not written.
+ *
+ * The cache file defaults to .itkconvolutioncostmodel-<host name> in the home
+ * directory. It may be set by SetGlobalCacheFileName() or by the environment
+ * variable ITK_CONVOLUTION_COST_MODEL_FILE; setting that variable to OFF keeps
+ * the costs in memory only. All members are thread safe.
+ *
+ * \sa AutomaticConvolutionImageFilter
+ * \ingroup ITKConvolution
+ */
+class ITKConvolution_EXPORT ConvolutionCostModel
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(ConvolutionCostModel);
+  ConvolutionCostModel() = default;
+  virtual ~ConvolutionCostModel() = default;
+
+  /** Measures a cost, in seconds per unit of work, with the given number of
+   * work units. */
+  using CalibrationFunctionType = std::function<double(ThreadIdType)>;
+
+  /** Returns the cost identified by key for numberOfWorkUnits. A cost that is
+   * neither known nor in the cache file is measured by calibration, and the
+   * cache file is updated. Calibrations run one at a time, so that they do not
+   * disturb each other's timings. */
+  static double
+  GetCost(const std::string & key, ThreadIdType numberOfWorkUnits, const CalibrationFunctionType & calibration);
+
+  /** Returns whether the cost identified by key for numberOfWorkUnits is known
+   * or in the cache file. */
+  static bool
+  HasCost(const std::string & key, ThreadIdType numberOfWorkUnits);
+
+  /** Sets a cost for the lifetime of the process, without writing it to the
+   * cache file. */
+  static void
+  SetCost(const std::string & key, ThreadIdType numberOfWorkUnits, double cost);
+
+  /** Forgets all costs. The cache file is read again when a cost is needed. */
+  static void
+  Clear();
+
+  /** Set/Get the cache file. An empty name keeps the costs in memory only.
+   * Setting the file forgets the costs read from the previous one. */
+  static void
+  SetGlobalCacheFileName(const std::string & fileName);
+  static std::string
+  GetGlobalCacheFileName();
+
+  /** Returns the shortest wall clock time, in seconds, of numberOfRuns calls
+   * of run. Meant for calibration functions. */
+  static double
+  MeasureShortestTime(const std::function<void()> & run, unsigned int numberOfRuns = 3);
+
+  /** The size to which FFTPadImageFilter pads size, for the given greatest
+   * prime factor. */
+  static SizeValueType
+  GetFFTSize(SizeValueType size, SizeValueType sizeGreatestPrimeFactor);
+
+  /** The unit of work of a Fourier transform of numberOfPixels pixels:
+   * numberOfPixels * log2(numberOfPixels). */
+  static double
+  GetFFTWork(double numberOfPixels);
+
+private:
+  itkGetGlobalDeclarationMacro(ConvolutionCostModelGlobals, PimplGlobals);
+  static ConvolutionCostModelGlobals * m_PimplGlobals;
+};
+} // end namespace itk
+
+#endif
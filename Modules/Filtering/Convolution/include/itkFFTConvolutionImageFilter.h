@@ -41,6 +41,18 @@ namespace itk
  * of the kernel image and treats them as identical to those in the
  * input image.
  *
+ * By default the output requested region, padded by the kernel radius, is
+ * transformed at once, which takes several times the memory of the padded
+ * region. In block mode (see SetBlockConvolution()) the output requested
+ * region is instead computed block by block with the overlap-save method,
+ * so the memory taken is bounded by the size of a block, and the requested
+ * region may be streamed to convolve images larger than the memory.
+ * The iterative deconvolution filters derived from this class run the
+ * convolutions of each iteration block by block in this mode (see
+ * IterativeDeconvolutionImageFilter). The inverse, Wiener and Tikhonov
+ * deconvolution filters invert the kernel spectrum, which is not a local
+ * operation, so they throw an exception when it is turned on.
+ *
  * This code was adapted from the Insight Journal contribution
  * \cite Lehmann_2010_b.
  *
@@ -108,6 +120,37 @@ public:
   itkSetMacro(SizeGreatestPrimeFactor, SizeValueType);
   itkGetMacro(SizeGreatestPrimeFactor, SizeValueType);
 
+  /** Set/Get whether to compute the output requested region block by block
+   * (overlap-save), instead of transforming it at once. Each block of the
+   * output is computed from the block of the input it depends on, padded to
+   * the same size for every block, so the spectrum of the kernel is computed
+   * once and reused for all the blocks. Off by default. */
+  itkSetMacro(BlockConvolution, bool);
+  itkGetConstMacro(BlockConvolution, bool);
+  itkBooleanMacro(BlockConvolution);
+
+  /** Set/Get the size of the output blocks in block mode. A zero size along a
+   * dimension, the default, lets ComputeBlockFFTSize() choose it from the
+   * BlockMemorySize. */
+  itkSetMacro(BlockSize, OutputSizeType);
+  itkGetConstReferenceMacro(BlockSize, OutputSizeType);
+
+  /** Set/Get the memory, in bytes, that the buffers of one block may take
+   * when the block size is chosen automatically. The default of 32 MiB keeps
+   * the blocks about the size of a last level cache; a larger budget wastes
+   * less work on the overlap of the blocks. */
+  itkSetMacro(BlockMemorySize, SizeValueType);
+  itkGetConstMacro(BlockMemorySize, SizeValueType);
+
+  /** Returns the size of the Fourier transforms of the blocks that cover
+   * region of the output in block mode. Each block computes this size minus
+   * twice the kernel radius output pixels along each dimension. Sizes chosen
+   * automatically grow from twice the kernel size while the buffers of a
+   * block fit in the BlockMemorySize, or stay at that minimum if they never
+   * do. Requires the kernel image. */
+  InternalSizeType
+  ComputeBlockFFTSize(const OutputRegionType & region) const;
+
 protected:
   FFTConvolutionImageFilter();
   ~FFTConvolutionImageFilter() override = default;
@@ -130,6 +173,11 @@ protected:
   void
   GenerateData() override;
 
+  /** Compute the output requested region block by block, multiplying the
+   * spectrum of each block of the input by the spectrum of the kernel. */
+  void
+  BlockGenerateData();
+
   /** Prepare the input images for operations in the Fourier
    * domain. This includes resizing the input and kernel images,
    * normalizing the kernel if requested, shifting the kernel, and
@@ -206,6 +254,9 @@ private:
   SizeValueType      m_SizeGreatestPrimeFactor{};
   InternalSizeType   m_FFTPadSize{ { 0 } };
   InternalRegionType m_PaddedInputRegion{};
+  bool               m_BlockConvolution{ false };
+  OutputSizeType     m_BlockSize{ { 0 } };
+  SizeValueType      m_BlockMemorySize{ 32 * 1024 * 1024 };
 };
 } // namespace itk
 
@@ -25,7 +25,10 @@
 #include "itkCyclicShiftImageFilter.h"
 #include "itkExtractImageFilter.h"
 #include "itkFFTPadImageFilter.h"
+#include "itkImageAlgorithm.h"
 #include "itkImageBase.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkIndexRange.h"
 #include "itkMultiplyImageFilter.h"
 #include "itkNormalizeToConstantImageFilter.h"
 #include "itkMath.h"
@@ -82,6 +85,12 @@ template <typename TInputImage, typename TKernelImage, typename TOutputImage, ty
 void
 FFTConvolutionImageFilter<TInputImage, TKernelImage, TOutputImage, TInternalPrecision>::GenerateData()
 {
+  if (m_BlockConvolution)
+  {
+    this->BlockGenerateData();
+    return;
+  }
+
   // Create a process accumulator for tracking the progress of this minipipeline
   auto progress = ProgressAccumulator::New();
   progress->SetMiniPipelineFilter(this);
@@ -112,6 +121,197 @@ FFTConvolutionImageFilter<TInputImage, TKernelImage, TOutputImage, TInternalPrec
   this->ProduceOutput(multiplyFilter->GetOutput(), progress, 0.2);
 }
 
+template <typename TInputImage, typename TKernelImage, typename TOutputImage, typename TInternalPrecision>
+auto
+FFTConvolutionImageFilter<TInputImage, TKernelImage, TOutputImage, TInternalPrecision>::ComputeBlockFFTSize(
+  const OutputRegionType & region) const -> InternalSizeType
+{
+  // Pad as FFTPadImageFilter does.
+  const auto padForFFT = [this](SizeValueType size) {
+    if (m_SizeGreatestPrimeFactor > 1)
+    {
+      while (Math::GreatestPrimeFactor(size) > m_SizeGreatestPrimeFactor)
+      {
+        ++size;
+      }
+    }
+    else if (m_SizeGreatestPrimeFactor == 1)
+    {
+      size += size % 2;
+    }
+    return size;
+  };
+  // The real block, the spectra of the block and of the kernel, and the
+  // inverse transform of the product.
+  const auto memorySize = [](const InternalSizeType & fftSize) {
+    double numberOfPixels = 1.0;
+    for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+    {
+      numberOfPixels *= fftSize[dim];
+    }
+    return 4.0 * sizeof(TInternalPrecision) * numberOfPixels;
+  };
+
+  const KernelSizeType kernelRadius = this->GetKernelRadius();
+  const OutputSizeType regionSize = region.GetSize();
+
+  InternalSizeType                  fftSize;
+  FixedArray<bool, ImageDimension> canGrow;
+  for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+  {
+    const SizeValueType overlap = 2 * kernelRadius[dim];
+    const SizeValueType blockSize = m_BlockSize[dim] > 0 ? m_BlockSize[dim] : std::max<SizeValueType>(overlap, 1);
+    fftSize[dim] = padForFFT(std::min(blockSize, std::max<SizeValueType>(regionSize[dim], 1)) + overlap);
+    canGrow[dim] = m_BlockSize[dim] == 0 && fftSize[dim] - overlap < regionSize[dim];
+  }
+
+  // Double the automatic block sizes, the one that wastes the largest part of
+  // its transform on the overlap first, while the buffers fit in the budget.
+  while (true)
+  {
+    unsigned int growingDim = ImageDimension;
+    double       smallestEfficiency = 1.0;
+    for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+    {
+      const double efficiency = static_cast<double>(fftSize[dim] - 2 * kernelRadius[dim]) / fftSize[dim];
+      if (canGrow[dim] && (growingDim == ImageDimension || efficiency < smallestEfficiency))
+      {
+        growingDim = dim;
+        smallestEfficiency = efficiency;
+      }
+    }
+    if (growingDim == ImageDimension)
+    {
+      break;
+    }
+    const SizeValueType overlap = 2 * kernelRadius[growingDim];
+    const SizeValueType blockSize = std::min(2 * (fftSize[growingDim] - overlap), regionSize[growingDim]);
+    InternalSizeType    grownFFTSize = fftSize;
+    grownFFTSize[growingDim] = padForFFT(blockSize + overlap);
+    if (memorySize(grownFFTSize) > m_BlockMemorySize)
+    {
+      canGrow[growingDim] = false;
+      continue;
+    }
+    fftSize = grownFFTSize;
+    canGrow[growingDim] = fftSize[growingDim] - overlap < regionSize[growingDim];
+  }
+  return fftSize;
+}
+
+template <typename TInputImage, typename TKernelImage, typename TOutputImage, typename TInternalPrecision>
+void
+FFTConvolutionImageFilter<TInputImage, TKernelImage, TOutputImage, TInternalPrecision>::BlockGenerateData()
+{
+  // Create a process accumulator for tracking the progress of the kernel
+  // preparation; the blocks report their progress directly.
+  auto progress = ProgressAccumulator::New();
+  progress->SetMiniPipelineFilter(this);
+  const float kernelProgressWeight = 0.05f;
+
+  const InputImageType *        input = this->GetInput();
+  const InputRegionType         inputLargestRegion = input->GetLargestPossibleRegion();
+  const BoundaryConditionType * boundaryCondition = this->GetBoundaryCondition();
+  const OutputRegionType        outputRequestedRegion = this->GetOutput()->GetRequestedRegion();
+  const KernelSizeType          kernelRadius = this->GetKernelRadius();
+  const InternalSizeType        fftSize = this->ComputeBlockFFTSize(outputRequestedRegion);
+  itkDebugMacro("Convolving block by block with Fourier transforms of size " << fftSize);
+
+  // All the blocks are transformed at the same size, so the spectrum of the
+  // kernel is computed once.
+  m_PaddedInputRegion = InternalRegionType(fftSize);
+  InternalComplexImagePointerType kernelSpectrum;
+  this->PrepareKernel(this->GetKernelImage(), kernelSpectrum, progress, kernelProgressWeight);
+
+  this->AllocateOutputs();
+  OutputImageType * output = this->GetOutput();
+
+  OutputSizeType blockSize;
+  OutputSizeType numberOfBlocks;
+  for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+  {
+    blockSize[dim] = fftSize[dim] - 2 * kernelRadius[dim];
+    numberOfBlocks[dim] = (outputRequestedRegion.GetSize(dim) + blockSize[dim] - 1) / blockSize[dim];
+  }
+  const OutputRegionType blockGrid(numberOfBlocks);
+  const SizeValueType    totalNumberOfBlocks = blockGrid.GetNumberOfPixels();
+  SizeValueType          numberOfDoneBlocks = 0;
+
+  // The padding of a smaller block at the end of the requested region keeps
+  // the values of a previous block; they do not reach its output pixels.
+  auto paddedBlock = InternalImageType::New();
+  paddedBlock->SetRegions(m_PaddedInputRegion);
+  paddedBlock->AllocateInitialized();
+
+  for (const auto & gridIndex : ImageRegionIndexRange<ImageDimension>(blockGrid))
+  {
+    OutputRegionType outputBlock;
+    InputRegionType  inputBlock;
+    for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+    {
+      const SizeValueType offset = gridIndex[dim] * blockSize[dim];
+      outputBlock.SetIndex(dim, outputRequestedRegion.GetIndex(dim) + static_cast<IndexValueType>(offset));
+      outputBlock.SetSize(dim, std::min(blockSize[dim], outputRequestedRegion.GetSize(dim) - offset));
+      inputBlock.SetIndex(dim, outputBlock.GetIndex(dim) - static_cast<IndexValueType>(kernelRadius[dim]));
+      inputBlock.SetSize(dim, outputBlock.GetSize(dim) + 2 * kernelRadius[dim]);
+    }
+
+    // Copy the input block, taking the pixels outside the input from the
+    // boundary condition.
+    const InternalRegionType bufferBlock(inputBlock.GetSize());
+    if (inputLargestRegion.IsInside(inputBlock))
+    {
+      ImageAlgorithm::Copy(input, paddedBlock.GetPointer(), inputBlock, bufferBlock);
+    }
+    else
+    {
+      const auto blockOffset = inputBlock.GetIndex() - InputIndexType();
+      for (ImageRegionIteratorWithIndex<InternalImageType> it(paddedBlock, bufferBlock); !it.IsAtEnd(); ++it)
+      {
+        const InputIndexType index = it.GetIndex() + blockOffset;
+        it.Set(static_cast<TInternalPrecision>(inputLargestRegion.IsInside(index)
+                                                 ? input->GetPixel(index)
+                                                 : boundaryCondition->GetPixel(index, input)));
+      }
+    }
+
+    auto fftFilter = FFTFilterType::New();
+    fftFilter->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+    fftFilter->SetInput(paddedBlock);
+    fftFilter->Update();
+    InternalComplexImagePointerType spectrum = fftFilter->GetOutput();
+    spectrum->DisconnectPipeline();
+
+    InternalComplexType *       spectrumBuffer = spectrum->GetBufferPointer();
+    const InternalComplexType * kernelSpectrumBuffer = kernelSpectrum->GetBufferPointer();
+    const SizeValueType         spectrumSize = spectrum->GetBufferedRegion().GetNumberOfPixels();
+    for (SizeValueType i = 0; i < spectrumSize; ++i)
+    {
+      spectrumBuffer[i] *= kernelSpectrumBuffer[i];
+    }
+
+    auto ifftFilter = IFFTFilterType::New();
+    ifftFilter->SetActualXDimensionIsOdd(this->GetXDimensionIsOdd());
+    ifftFilter->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+    ifftFilter->SetInput(spectrum);
+    ifftFilter->Update();
+
+    // Keep the output pixels that the circular convolution computes from the
+    // input block only.
+    InternalIndexType validIndex;
+    for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+    {
+      validIndex[dim] = static_cast<IndexValueType>(kernelRadius[dim]);
+    }
+    ImageAlgorithm::Copy(
+      ifftFilter->GetOutput(), output, InternalRegionType(validIndex, outputBlock.GetSize()), outputBlock);
+
+    this->UpdateProgress(kernelProgressWeight +
+                         (1.0f - kernelProgressWeight) * static_cast<float>(++numberOfDoneBlocks) /
+                           static_cast<float>(totalNumberOfBlocks));
+  }
+}
+
 template <typename TInputImage, typename TKernelImage, typename TOutputImage, typename TInternalPrecision>
 void
 FFTConvolutionImageFilter<TInputImage, TKernelImage, TOutputImage, TInternalPrecision>::PrepareInputs(
@@ -524,6 +724,9 @@ FFTConvolutionImageFilter<TInputImage, TKernelImage, TOutputImage, TInternalPrec
 {
   Superclass::PrintSelf(os, indent);
   os << indent << "SizeGreatestPrimeFactor: " << m_SizeGreatestPrimeFactor << std::endl;
+  os << indent << "BlockConvolution: " << (m_BlockConvolution ? "On" : "Off") << std::endl;
+  os << indent << "BlockSize: " << m_BlockSize << std::endl;
+  os << indent << "BlockMemorySize: " << m_BlockMemorySize << std::endl;
 }
 
 } // namespace itk
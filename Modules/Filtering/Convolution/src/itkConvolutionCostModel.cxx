@@ -0,0 +1,320 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkConvolutionCostModel.h"
+#include "itkMath.h"
+#include "itkNumericTraits.h"
+#include "itkSingleton.h"
+#include "itkTimeProbe.h"
+#include "itksys/SystemInformation.hxx"
+#include "itksys/SystemTools.hxx"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <utility>
+
+namespace itk
+{
+
+namespace
+{
+using CostKeyType = std::pair<std::string, ThreadIdType>;
+using CostMapType = std::map<CostKeyType, double>;
+
+bool
+IsOff(std::string value)
+{
+  value = itksys::SystemTools::UpperCase(value);
+  return value.empty() || value == "0" || value == "NO" || value == "OFF" || value == "FALSE";
+}
+
+// Reads the lines "key numberOfWorkUnits cost" of fileName into costs,
+// skipping comments and malformed lines.
+void
+ReadCosts(const std::string & fileName, CostMapType & costs)
+{
+  std::ifstream file(fileName);
+  std::string   line;
+  while (std::getline(file, line))
+  {
+    if (line.empty() || line[0] == '#')
+    {
+      continue;
+    }
+    std::istringstream stream(line);
+    std::string        key;
+    ThreadIdType       numberOfWorkUnits = 0;
+    double             cost = 0.0;
+    if (stream >> key >> numberOfWorkUnits >> cost && numberOfWorkUnits > 0 && std::isfinite(cost) && cost > 0.0)
+    {
+      costs[CostKeyType(key, numberOfWorkUnits)] = cost;
+    }
+  }
+}
+} // namespace
+
+struct ConvolutionCostModelGlobals
+{
+  ConvolutionCostModelGlobals() = default;
+
+  std::mutex m_Mutex;
+  // Held while a cost is measured.
+  std::mutex m_CalibrationMutex;
+
+  // Whether the environment variable has been examined, see InitializeFromEnvironment.
+  bool        m_IsInitialized{ false };
+  std::string m_CacheFileName;
+  bool        m_CacheFileIsRead{ false };
+
+  // Costs that were measured or read from the cache file.
+  CostMapType m_Costs;
+  // Costs set by SetCost, which take precedence and are not written.
+  CostMapType m_SetCosts;
+
+  // Must be called with m_Mutex held.
+  void
+  InitializeFromEnvironment()
+  {
+    if (m_IsInitialized)
+    {
+      return;
+    }
+    m_IsInitialized = true;
+    std::string envVar;
+    if (itksys::SystemTools::GetEnv("ITK_CONVOLUTION_COST_MODEL_FILE", envVar))
+    {
+      m_CacheFileName = IsOff(envVar) ? std::string() : envVar;
+      return;
+    }
+    std::string homeDirectory;
+    if (itksys::SystemTools::GetEnv("HOME", homeDirectory) || itksys::SystemTools::GetEnv("USERPROFILE", homeDirectory))
+    {
+      itksys::SystemInformation systemInformation;
+      systemInformation.RunOSCheck();
+      const char * hostName = systemInformation.GetHostname();
+      m_CacheFileName = homeDirectory + "/.itkconvolutioncostmodel-" + (hostName ? hostName : "localhost");
+    }
+  }
+
+  // Must be called with m_Mutex held. Returns the cost, or 0 if it is not known.
+  double
+  FindCost(const CostKeyType & key)
+  {
+    InitializeFromEnvironment();
+    if (const auto it = m_SetCosts.find(key); it != m_SetCosts.end())
+    {
+      return it->second;
+    }
+    if (!m_CacheFileIsRead)
+    {
+      m_CacheFileIsRead = true;
+      if (!m_CacheFileName.empty())
+      {
+        CostMapType costs;
+        ReadCosts(m_CacheFileName, costs);
+        // Costs measured by this process are newer.
+        costs.insert(m_Costs.begin(), m_Costs.end());
+        m_Costs.swap(costs);
+      }
+    }
+    if (const auto it = m_Costs.find(key); it != m_Costs.end())
+    {
+      return it->second;
+    }
+    return 0.0;
+  }
+
+  // Must be called with m_Mutex held. Adds the measured costs to those
+  // other processes may have written meanwhile.
+  void
+  WriteCacheFile()
+  {
+    if (m_CacheFileName.empty())
+    {
+      return;
+    }
+    CostMapType costs;
+    ReadCosts(m_CacheFileName, costs);
+    for (const auto & cost : m_Costs)
+    {
+      costs[cost.first] = cost.second;
+    }
+    std::ofstream file(m_CacheFileName);
+    file << "# ITK convolution cost model: key, number of work units, seconds per unit of work\n";
+    file.precision(17);
+    for (const auto & cost : costs)
+    {
+      file << cost.first.first << ' ' << cost.first.second << ' ' << cost.second << '\n';
+    }
+  }
+};
+
+itkGetGlobalSimpleMacro(ConvolutionCostModel, ConvolutionCostModelGlobals, PimplGlobals);
+
+ConvolutionCostModelGlobals * ConvolutionCostModel::m_PimplGlobals;
+
+double
+ConvolutionCostModel::GetCost(const std::string &             key,
+                              ThreadIdType                    numberOfWorkUnits,
+                              const CalibrationFunctionType & calibration)
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  const CostKeyType costKey(key, numberOfWorkUnits);
+  {
+    const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
+    if (const double cost = m_PimplGlobals->FindCost(costKey); cost > 0.0)
+    {
+      return cost;
+    }
+  }
+
+  const std::lock_guard<std::mutex> calibrationLockGuard(m_PimplGlobals->m_CalibrationMutex);
+  {
+    // Another thread may have measured the cost meanwhile.
+    const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
+    if (const double cost = m_PimplGlobals->FindCost(costKey); cost > 0.0)
+    {
+      return cost;
+    }
+  }
+  const double cost = calibration(numberOfWorkUnits);
+  if (!std::isfinite(cost) || cost <= 0.0)
+  {
+    itkGenericExceptionMacro("The calibration of " << key << " returned the cost " << cost);
+  }
+
+  const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
+  m_PimplGlobals->m_Costs[costKey] = cost;
+  m_PimplGlobals->WriteCacheFile();
+  return cost;
+}
+
+bool
+ConvolutionCostModel::HasCost(const std::string & key, ThreadIdType numberOfWorkUnits)
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
+  return m_PimplGlobals->FindCost(CostKeyType(key, numberOfWorkUnits)) > 0.0;
+}
+
+void
+ConvolutionCostModel::SetCost(const std::string & key, ThreadIdType numberOfWorkUnits, double cost)
+{
+  if (!std::isfinite(cost) || cost <= 0.0)
+  {
+    itkGenericExceptionMacro("The cost of " << key << " must be positive, not " << cost);
+  }
+  itkInitGlobalsMacro(PimplGlobals);
+  const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
+  m_PimplGlobals->m_SetCosts[CostKeyType(key, numberOfWorkUnits)] = cost;
+}
+
+void
+ConvolutionCostModel::Clear()
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
+  m_PimplGlobals->m_Costs.clear();
+  m_PimplGlobals->m_SetCosts.clear();
+  m_PimplGlobals->m_CacheFileIsRead = false;
+}
+
+void
+ConvolutionCostModel::SetGlobalCacheFileName(const std::string & fileName)
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
+  m_PimplGlobals->InitializeFromEnvironment();
+  m_PimplGlobals->m_CacheFileName = fileName;
+  m_PimplGlobals->m_Costs.clear();
+  m_PimplGlobals->m_CacheFileIsRead = false;
+}
+
+std::string
+ConvolutionCostModel::GetGlobalCacheFileName()
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
+  m_PimplGlobals->InitializeFromEnvironment();
+  return m_PimplGlobals->m_CacheFileName;
+}
+
+double
+ConvolutionCostModel::MeasureShortestTime(const std::function<void()> & run, unsigned int numberOfRuns)
+{
+  double shortestTime = NumericTraits<double>::max();
+  for (unsigned int i = 0; i < numberOfRuns; ++i)
+  {
+    TimeProbe probe;
+    probe.Start();
+    run();
+    probe.Stop();
+    shortestTime = std::min(shortestTime, probe.GetTotal());
+  }
+  return shortestTime;
+}
+
+SizeValueType
+ConvolutionCostModel::GetFFTSize(SizeValueType size, SizeValueType sizeGreatestPrimeFactor)
+{
+  if (sizeGreatestPrimeFactor > 1)
+  {
+    while (Math::GreatestPrimeFactor(size) > sizeGreatestPrimeFactor)
+    {
+      ++size;
+    }
+  }
+  else if (sizeGreatestPrimeFactor == 1)
+  {
+    size += size % 2;
+  }
+  return size;
+}
+
+double
+ConvolutionCostModel::GetFFTWork(double numberOfPixels)
+{
+  return numberOfPixels > 1.0 ? numberOfPixels * std::log2(numberOfPixels) : 1.0;
+}
+
+/** Define how to print enumerations */
+std::ostream &
+operator<<(std::ostream & out, const ConvolutionCostModelEnums::ConvolutionMethod value)
+{
+  return out << [value] {
+    switch (value)
+    {
+      case ConvolutionCostModelEnums::ConvolutionMethod::AUTOMATIC:
+        return "ConvolutionCostModelEnums::ConvolutionMethod::AUTOMATIC";
+      case ConvolutionCostModelEnums::ConvolutionMethod::SPATIAL:
+        return "ConvolutionCostModelEnums::ConvolutionMethod::SPATIAL";
+      case ConvolutionCostModelEnums::ConvolutionMethod::SEPARABLE:
+        return "ConvolutionCostModelEnums::ConvolutionMethod::SEPARABLE";
+      case ConvolutionCostModelEnums::ConvolutionMethod::FFT:
+        return "ConvolutionCostModelEnums::ConvolutionMethod::FFT";
+      case ConvolutionCostModelEnums::ConvolutionMethod::BLOCK_FFT:
+        return "ConvolutionCostModelEnums::ConvolutionMethod::BLOCK_FFT";
+      default:
+        return "INVALID VALUE FOR ConvolutionCostModelEnums::ConvolutionMethod";
+    }
+  }();
+}
+} // end namespace itk
@@ -0,0 +1,256 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkAutomaticConvolutionImageFilter.h"
+#include "itkConvolutionImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkStreamingImageFilter.h"
+#include "itkTimeProbe.h"
+#include "itkTestingMacros.h"
+#include "itksys/SystemTools.hxx"
+
+#include <algorithm>
+#include <cmath>
+
+/*
+ * Convolves 3D images with separable, non separable and even sized kernels
+ * through each method of AutomaticConvolutionImageFilter, compares the
+ * outputs with ConvolutionImageFilter, and checks the methods chosen with
+ * given costs and with costs measured on this machine.
+ */
+
+namespace
+{
+constexpr unsigned int Dimension = 3;
+using ImageType = itk::Image<float, Dimension>;
+using FilterType = itk::AutomaticConvolutionImageFilter<ImageType>;
+using ConvolutionMethodEnum = itk::ConvolutionCostModelEnums::ConvolutionMethod;
+using OutputRegionModeEnum = itk::ConvolutionImageFilterBaseEnums::ConvolutionImageFilterOutputRegion;
+
+ImageType::Pointer
+MakeNoiseImage(const ImageType::SizeType & size, unsigned int seed)
+{
+  auto image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  auto generator = itk::Statistics::MersenneTwisterRandomVariateGenerator::New();
+  generator->Initialize(seed);
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    it.Set(static_cast<float>(generator->GetUniformVariate(-1.0, 1.0)));
+  }
+  return image;
+}
+
+// The outer product of a triangle in each dimension.
+ImageType::Pointer
+MakeSeparableKernel(const ImageType::SizeType & size)
+{
+  auto kernel = ImageType::New();
+  kernel->SetRegions(size);
+  kernel->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(kernel, kernel->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    float value = 1.0f;
+    for (unsigned int dim = 0; dim < Dimension; ++dim)
+    {
+      value *= 1.0f + std::min(it.GetIndex()[dim], static_cast<itk::IndexValueType>(size[dim]) - it.GetIndex()[dim]);
+    }
+    it.Set(value);
+  }
+  return kernel;
+}
+
+ImageType::Pointer
+Convolve(const ImageType *     image,
+         const ImageType *     kernel,
+         ConvolutionMethodEnum method,
+         bool                  normalize = false,
+         OutputRegionModeEnum  outputRegionMode = OutputRegionModeEnum::SAME,
+         unsigned int          numberOfStreamDivisions = 1)
+{
+  auto filter = FilterType::New();
+  filter->SetInput(image);
+  filter->SetKernelImage(kernel);
+  filter->SetConvolutionMethod(method);
+  filter->SetNormalize(normalize);
+  filter->SetOutputRegionMode(outputRegionMode);
+  auto streamer = itk::StreamingImageFilter<ImageType, ImageType>::New();
+  streamer->SetInput(filter->GetOutput());
+  streamer->SetNumberOfStreamDivisions(numberOfStreamDivisions);
+  streamer->Update();
+  return streamer->GetOutput();
+}
+
+ImageType::Pointer
+ConvolveSpatially(const ImageType *    image,
+                  const ImageType *    kernel,
+                  bool                 normalize = false,
+                  OutputRegionModeEnum outputRegionMode = OutputRegionModeEnum::SAME)
+{
+  auto filter = itk::ConvolutionImageFilter<ImageType>::New();
+  filter->SetInput(image);
+  filter->SetKernelImage(kernel);
+  filter->SetNormalize(normalize);
+  filter->SetOutputRegionMode(outputRegionMode);
+  filter->Update();
+  return filter->GetOutput();
+}
+
+bool
+AreClose(const std::string & name, const ImageType * output, const ImageType * reference)
+{
+  if (output->GetBufferedRegion() != reference->GetBufferedRegion())
+  {
+    std::cerr << name << ": the output region is " << output->GetBufferedRegion() << " instead of "
+              << reference->GetBufferedRegion() << std::endl;
+    return false;
+  }
+  double maximumValue = 0.0;
+  double maximumDifference = 0.0;
+  itk::ImageRegionConstIterator<ImageType> outputIt(output, output->GetBufferedRegion());
+  for (itk::ImageRegionConstIterator<ImageType> it(reference, reference->GetBufferedRegion()); !it.IsAtEnd();
+       ++it, ++outputIt)
+  {
+    maximumValue = std::max(maximumValue, std::abs(static_cast<double>(it.Get())));
+    maximumDifference = std::max(maximumDifference, std::abs(static_cast<double>(outputIt.Get() - it.Get())));
+  }
+  std::cout << name << ": largest difference " << maximumDifference << " for values up to " << maximumValue
+            << std::endl;
+  if (maximumDifference > 1e-5 * maximumValue)
+  {
+    std::cerr << name << ": the output differs from ConvolutionImageFilter" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+ConvolutionMethodEnum
+SelectedMethod(const ImageType * image, const ImageType * kernel)
+{
+  auto filter = FilterType::New();
+  filter->SetInput(image);
+  filter->SetKernelImage(kernel);
+  filter->Update();
+  return filter->GetSelectedConvolutionMethod();
+}
+} // namespace
+
+int
+itkAutomaticConvolutionImageFilterTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " costModelCacheFile" << std::endl;
+    return EXIT_FAILURE;
+  }
+  itksys::SystemTools::RemoveFile(argv[1]);
+  itk::ConvolutionCostModel::SetGlobalCacheFileName(argv[1]);
+  ITK_TEST_EXPECT_EQUAL(itk::ConvolutionCostModel::GetGlobalCacheFileName(), std::string(argv[1]));
+
+  auto filter = FilterType::New();
+  ITK_EXERCISE_BASIC_OBJECT_METHODS(filter, AutomaticConvolutionImageFilter, ConvolutionImageFilterBase);
+  ITK_TEST_SET_GET_VALUE(ConvolutionMethodEnum::AUTOMATIC, filter->GetConvolutionMethod());
+  filter->SetConvolutionMethod(ConvolutionMethodEnum::FFT);
+  ITK_TEST_SET_GET_VALUE(ConvolutionMethodEnum::FFT, filter->GetConvolutionMethod());
+
+  const auto image = MakeNoiseImage(itk::MakeSize(37, 30, 24), 20240614);
+  const auto separableKernel = MakeSeparableKernel(itk::MakeSize(7, 5, 3));
+  const auto evenKernel = MakeSeparableKernel(itk::MakeSize(4, 6, 2));
+  const auto generalKernel = MakeNoiseImage(itk::MakeSize(5, 5, 5), 20240615);
+
+  bool success = true;
+
+  // Every method computes the output of ConvolutionImageFilter.
+  const auto reference = ConvolveSpatially(image, separableKernel);
+  success &= AreClose("Spatial", Convolve(image, separableKernel, ConvolutionMethodEnum::SPATIAL), reference);
+  success &= AreClose("Separable", Convolve(image, separableKernel, ConvolutionMethodEnum::SEPARABLE), reference);
+  success &= AreClose("FFT", Convolve(image, separableKernel, ConvolutionMethodEnum::FFT), reference);
+  success &= AreClose("Block FFT", Convolve(image, separableKernel, ConvolutionMethodEnum::BLOCK_FFT), reference);
+  success &= AreClose("Separable, even kernel",
+                      Convolve(image, evenKernel, ConvolutionMethodEnum::SEPARABLE),
+                      ConvolveSpatially(image, evenKernel));
+  success &= AreClose("Separable, normalized",
+                      Convolve(image, separableKernel, ConvolutionMethodEnum::SEPARABLE, true),
+                      ConvolveSpatially(image, separableKernel, true));
+  success &=
+    AreClose("Separable, valid region, streamed",
+             Convolve(image, evenKernel, ConvolutionMethodEnum::SEPARABLE, false, OutputRegionModeEnum::VALID, 4),
+             ConvolveSpatially(image, evenKernel, false, OutputRegionModeEnum::VALID));
+  success &= AreClose("FFT, valid region, streamed",
+                      Convolve(image, generalKernel, ConvolutionMethodEnum::FFT, false, OutputRegionModeEnum::VALID, 3),
+                      ConvolveSpatially(image, generalKernel, false, OutputRegionModeEnum::VALID));
+
+  // A kernel that is not separable cannot be convolved separably.
+  filter = FilterType::New();
+  filter->SetInput(image);
+  filter->SetKernelImage(generalKernel);
+  filter->SetConvolutionMethod(ConvolutionMethodEnum::SEPARABLE);
+  ITK_TRY_EXPECT_EXCEPTION(filter->Update());
+  filter->UpdateOutputInformation();
+  ITK_TEST_EXPECT_EQUAL(filter->EstimateTime(ConvolutionMethodEnum::SEPARABLE, image->GetLargestPossibleRegion()),
+                        itk::NumericTraits<double>::max());
+
+  // Given costs select the cheapest method, for the number of work units of
+  // the filter.
+  const itk::ThreadIdType numberOfWorkUnits = filter->GetNumberOfWorkUnits();
+  itk::ConvolutionCostModel::SetCost("ConvolutionImageFilter", numberOfWorkUnits, 1e-9);
+  itk::ConvolutionCostModel::SetCost("FFTConvolutionImageFilter", numberOfWorkUnits, 1.0);
+  ITK_TEST_EXPECT_EQUAL(SelectedMethod(image, separableKernel), ConvolutionMethodEnum::SEPARABLE);
+  ITK_TEST_EXPECT_EQUAL(SelectedMethod(image, generalKernel), ConvolutionMethodEnum::SPATIAL);
+  itk::ConvolutionCostModel::SetCost("ConvolutionImageFilter", numberOfWorkUnits, 1.0);
+  itk::ConvolutionCostModel::SetCost("FFTConvolutionImageFilter", numberOfWorkUnits, 1e-9);
+  ITK_TEST_EXPECT_EQUAL(SelectedMethod(image, separableKernel), ConvolutionMethodEnum::FFT);
+  ITK_TEST_EXPECT_TRUE(!itksys::SystemTools::FileExists(argv[1]));
+
+  // Measured costs select the Fourier domain for a large kernel that is not
+  // separable, and are written to the cache file.
+  itk::ConvolutionCostModel::Clear();
+  ITK_TEST_EXPECT_TRUE(!itk::ConvolutionCostModel::HasCost("FFTConvolutionImageFilter", numberOfWorkUnits));
+  const auto     largeKernel = MakeNoiseImage(itk::MakeSize(21, 21, 21), 20240616);
+  itk::TimeProbe probe;
+  probe.Start();
+  const auto selectedMethod = SelectedMethod(image, largeKernel);
+  probe.Stop();
+  std::cout << "Calibrated and selected " << selectedMethod << " in " << probe.GetTotal() << " s" << std::endl;
+  ITK_TEST_EXPECT_EQUAL(selectedMethod, ConvolutionMethodEnum::FFT);
+  ITK_TEST_EXPECT_TRUE(itk::ConvolutionCostModel::HasCost("ConvolutionImageFilter", numberOfWorkUnits));
+  ITK_TEST_EXPECT_TRUE(itk::ConvolutionCostModel::HasCost("FFTConvolutionImageFilter", numberOfWorkUnits));
+  ITK_TEST_EXPECT_TRUE(itksys::SystemTools::FileExists(argv[1]));
+
+  // Another process reads the costs from the cache file.
+  itk::ConvolutionCostModel::Clear();
+  ITK_TEST_EXPECT_TRUE(itk::ConvolutionCostModel::HasCost("FFTConvolutionImageFilter", numberOfWorkUnits));
+  const double cachedCost =
+    itk::ConvolutionCostModel::GetCost("FFTConvolutionImageFilter", numberOfWorkUnits, [](itk::ThreadIdType) {
+      std::cerr << "The cost is measured again" << std::endl;
+      return 1.0;
+    });
+  std::cout << "Cost of FFTConvolutionImageFilter: " << cachedCost << " s per unit of work" << std::endl;
+  ITK_TEST_EXPECT_TRUE(cachedCost < 1.0);
+
+  if (!success)
+  {
+    std::cout << "Test FAILED!" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
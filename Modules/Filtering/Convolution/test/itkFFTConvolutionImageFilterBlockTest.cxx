@@ -0,0 +1,215 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkFFTConvolutionImageFilter.h"
+#include "itkConstantBoundaryCondition.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMath.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkPeriodicBoundaryCondition.h"
+#include "itkStreamingImageFilter.h"
+#include "itkTestingMacros.h"
+
+#include <algorithm>
+#include <cmath>
+
+/*
+ * Convolves a 3D image with odd and even sized kernels block by block, with
+ * given and automatic block sizes, boundary conditions, output region modes
+ * and streaming, and compares the outputs with FFTConvolutionImageFilter
+ * transforming the requested region at once.
+ */
+
+namespace
+{
+constexpr unsigned int Dimension = 3;
+using ImageType = itk::Image<float, Dimension>;
+using FilterType = itk::FFTConvolutionImageFilter<ImageType>;
+using OutputRegionModeEnum = itk::ConvolutionImageFilterBaseEnums::ConvolutionImageFilterOutputRegion;
+
+ImageType::Pointer
+MakeNoiseImage(const ImageType::SizeType & size, unsigned int seed)
+{
+  auto image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  auto generator = itk::Statistics::MersenneTwisterRandomVariateGenerator::New();
+  generator->Initialize(seed);
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    it.Set(static_cast<float>(generator->GetUniformVariate(0.0, 1.0)));
+  }
+  return image;
+}
+
+struct Parameters
+{
+  bool                                    blockConvolution{ false };
+  ImageType::SizeType                     blockSize{ { 0 } };
+  FilterType::SizeValueType               blockMemorySize{ 32 * 1024 * 1024 };
+  bool                                    normalize{ false };
+  OutputRegionModeEnum                    outputRegionMode{ OutputRegionModeEnum::SAME };
+  itk::ImageBoundaryCondition<ImageType> * boundaryCondition{ nullptr };
+  unsigned int                            numberOfStreamDivisions{ 1 };
+};
+
+ImageType::Pointer
+Convolve(const ImageType * image, const ImageType * kernel, const Parameters & parameters)
+{
+  auto filter = FilterType::New();
+  filter->SetInput(image);
+  filter->SetKernelImage(kernel);
+  filter->SetBlockConvolution(parameters.blockConvolution);
+  filter->SetBlockSize(parameters.blockSize);
+  filter->SetBlockMemorySize(parameters.blockMemorySize);
+  filter->SetNormalize(parameters.normalize);
+  filter->SetOutputRegionMode(parameters.outputRegionMode);
+  if (parameters.boundaryCondition)
+  {
+    filter->SetBoundaryCondition(parameters.boundaryCondition);
+  }
+  auto streamer = itk::StreamingImageFilter<ImageType, ImageType>::New();
+  streamer->SetInput(filter->GetOutput());
+  streamer->SetNumberOfStreamDivisions(parameters.numberOfStreamDivisions);
+  streamer->Update();
+  return streamer->GetOutput();
+}
+
+// Convolves block by block and at once, and compares the outputs.
+bool
+ConvolvesAsAtOnce(const std::string & name,
+                  const ImageType *   image,
+                  const ImageType *   kernel,
+                  Parameters          parameters)
+{
+  parameters.blockConvolution = false;
+  const auto reference = Convolve(image, kernel, parameters);
+  parameters.blockConvolution = true;
+  const auto output = Convolve(image, kernel, parameters);
+
+  if (output->GetBufferedRegion() != reference->GetBufferedRegion())
+  {
+    std::cerr << name << ": the output region is " << output->GetBufferedRegion() << " instead of "
+              << reference->GetBufferedRegion() << std::endl;
+    return false;
+  }
+  double                                   maximumValue = 0.0;
+  double                                   maximumDifference = 0.0;
+  itk::ImageRegionConstIterator<ImageType> outputIt(output, output->GetBufferedRegion());
+  for (itk::ImageRegionConstIterator<ImageType> it(reference, reference->GetBufferedRegion()); !it.IsAtEnd();
+       ++it, ++outputIt)
+  {
+    maximumValue = std::max(maximumValue, std::abs(static_cast<double>(it.Get())));
+    maximumDifference = std::max(maximumDifference, std::abs(static_cast<double>(outputIt.Get() - it.Get())));
+  }
+  std::cout << name << ": largest difference " << maximumDifference << " for values up to " << maximumValue
+            << std::endl;
+  if (maximumDifference > 1e-5 * maximumValue)
+  {
+    std::cerr << name << ": the block convolution differs from the convolution at once" << std::endl;
+    return false;
+  }
+  return true;
+}
+} // namespace
+
+int
+itkFFTConvolutionImageFilterBlockTest(int, char *[])
+{
+  auto filter = FilterType::New();
+  ITK_TEST_SET_GET_BOOLEAN(filter, BlockConvolution, false);
+  const auto blockSize = itk::MakeSize(16, 0, 8);
+  filter->SetBlockSize(blockSize);
+  ITK_TEST_SET_GET_VALUE(blockSize, filter->GetBlockSize());
+  ITK_TEST_SET_GET_VALUE(32 * 1024 * 1024, filter->GetBlockMemorySize());
+  filter->SetBlockMemorySize(1024 * 1024);
+  ITK_TEST_SET_GET_VALUE(1024 * 1024, filter->GetBlockMemorySize());
+
+  const auto image = MakeNoiseImage(itk::MakeSize(45, 38, 27), 20240701);
+  const auto oddKernel = MakeNoiseImage(itk::MakeSize(5, 7, 3), 20240702);
+  const auto evenKernel = MakeNoiseImage(itk::MakeSize(4, 6, 2), 20240703);
+
+  // Given sizes along some dimensions are kept; the others grow within the
+  // memory budget, or are the smallest ones if the budget is too small.
+  filter->SetKernelImage(oddKernel);
+  filter->SetBlockSize(itk::MakeSize(10, 0, 0));
+  const auto region = image->GetLargestPossibleRegion();
+  auto       fftSize = filter->ComputeBlockFFTSize(region);
+  std::cout << "Block Fourier transform size for 1 MiB: " << fftSize << std::endl;
+  ITK_TEST_EXPECT_TRUE(fftSize[0] >= 10 + 4 && fftSize[0] <= 16);
+  ITK_TEST_EXPECT_TRUE(4.0 * sizeof(double) * fftSize[0] * fftSize[1] * fftSize[2] <= 1024.0 * 1024.0);
+  for (unsigned int dim = 0; dim < Dimension; ++dim)
+  {
+    ITK_TEST_EXPECT_TRUE(itk::Math::GreatestPrimeFactor(fftSize[dim]) <= filter->GetSizeGreatestPrimeFactor());
+  }
+  filter->SetBlockMemorySize(1);
+  fftSize = filter->ComputeBlockFFTSize(region);
+  std::cout << "Block Fourier transform size for 1 byte: " << fftSize << std::endl;
+  ITK_TEST_EXPECT_EQUAL(fftSize[1], 12);
+  ITK_TEST_EXPECT_EQUAL(fftSize[2], 4);
+  filter->SetBlockSize(itk::MakeSize(0, 0, 0));
+  filter->SetBlockMemorySize(1024 * 1024 * 1024);
+  fftSize = filter->ComputeBlockFFTSize(region);
+  std::cout << "Block Fourier transform size for 1 GiB: " << fftSize << std::endl;
+  for (unsigned int dim = 0; dim < Dimension; ++dim)
+  {
+    ITK_TEST_EXPECT_TRUE(fftSize[dim] - 2 * (oddKernel->GetLargestPossibleRegion().GetSize(dim) / 2) >=
+                         region.GetSize(dim));
+  }
+
+  bool       success = true;
+  Parameters parameters;
+
+  parameters.blockSize = itk::MakeSize(8, 8, 8);
+  success &= ConvolvesAsAtOnce("Odd kernel, 8^3 blocks", image, oddKernel, parameters);
+  success &= ConvolvesAsAtOnce("Even kernel, 8^3 blocks", image, evenKernel, parameters);
+
+  parameters.normalize = true;
+  parameters.blockSize = itk::MakeSize(7, 0, 11);
+  parameters.blockMemorySize = 256 * 1024;
+  success &= ConvolvesAsAtOnce("Normalized, partly automatic blocks", image, oddKernel, parameters);
+
+  parameters = Parameters();
+  parameters.blockMemorySize = 1;
+  success &= ConvolvesAsAtOnce("Smallest blocks", image, evenKernel, parameters);
+
+  itk::ConstantBoundaryCondition<ImageType> constantBoundaryCondition;
+  constantBoundaryCondition.SetConstant(2.0f);
+  itk::PeriodicBoundaryCondition<ImageType> periodicBoundaryCondition;
+  parameters = Parameters();
+  parameters.blockSize = itk::MakeSize(12, 9, 5);
+  parameters.boundaryCondition = &constantBoundaryCondition;
+  success &= ConvolvesAsAtOnce("Constant boundary condition", image, oddKernel, parameters);
+  parameters.boundaryCondition = &periodicBoundaryCondition;
+  success &= ConvolvesAsAtOnce("Periodic boundary condition", image, evenKernel, parameters);
+
+  parameters = Parameters();
+  parameters.blockSize = itk::MakeSize(10, 10, 10);
+  parameters.numberOfStreamDivisions = 4;
+  success &= ConvolvesAsAtOnce("Streamed", image, oddKernel, parameters);
+  parameters.outputRegionMode = OutputRegionModeEnum::VALID;
+  success &= ConvolvesAsAtOnce("Valid region, streamed", image, evenKernel, parameters);
+
+  if (!success)
+  {
+    std::cout << "Test FAILED!" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -46,6 +46,9 @@ namespace itk
  * KernelZeroMagnitudeThreshold in this filter) that determines when
  * the magnitude of a complex number is considered zero.
  *
+ * The block convolution mode of the FFTConvolutionImageFilter is not
+ * supported, because inverting the kernel spectrum is not a local operation.
+ *
  * \author Gaetan Lehmann, Biologie du Developpement et de la Reproduction, INRA de Jouy-en-Josas, France
  * \author Cory Quammen, The University of North Carolina at Chapel Hill
  *
@@ -21,6 +21,8 @@
 #include "itkFFTConvolutionImageFilter.h"
 #include "itkProgressAccumulator.h"
 
+#include <memory>
+
 namespace itk
 {
 /**
@@ -40,6 +42,15 @@ namespace itk
  * resume iterating, you must call SetStopIteration( bool ) with the
  * argument set to false before calling Update() a second time.
  *
+ * In block mode (see FFTConvolutionImageFilter::SetBlockConvolution()),
+ * the estimate is not padded: each iteration convolves it with the
+ * kernel, and the correction with the kernel flipped along all axes,
+ * block by block with the overlap-save method. The pixels around the
+ * image come from the boundary condition, which must then be a
+ * ConstantBoundaryCondition, a PeriodicBoundaryCondition or a
+ * ZeroFluxNeumannBoundaryCondition. The two modes extend the estimate
+ * differently, so their results differ, mostly near the image boundary.
+ *
  * This code was adapted from the Insight Journal contribution:
  *
  * "Deconvolution: infrastructure and reference algorithms"
@@ -75,6 +86,13 @@ public:
   using typename Superclass::InternalComplexType;
   using typename Superclass::InternalComplexImageType;
   using typename Superclass::InternalComplexImagePointerType;
+  using typename Superclass::InternalRegionType;
+  using typename Superclass::InternalSizeType;
+  using typename Superclass::InternalIndexType;
+
+  using typename Superclass::BoundaryConditionType;
+
+  static constexpr unsigned int ImageDimension = Superclass::ImageDimension;
 
   /** \see LightObject::GetNameOfClass() */
   itkOverrideGetNameOfClassMacro(IterativeDeconvolutionImageFilter);
@@ -115,6 +133,13 @@ protected:
   virtual void
   Finish(ProgressAccumulator * progress, float progressWeight);
 
+  /** Convert the input to the internal pixel type without padding it. */
+  void
+  CastInput(const InputImageType *     input,
+            InternalImagePointerType & castInput,
+            ProgressAccumulator *      progress,
+            float                      progressWeight);
+
   /** This filter needs the entire image kernel, which in general is
    * going to be a different size then the output requested region. As
    * such, this filter needs to provide an implementation for
@@ -139,10 +164,27 @@ protected:
   using typename Superclass::FFTFilterType;
   using typename Superclass::IFFTFilterType;
 
+  /** In block mode, convolve an internal image with the kernel, and with
+   * the kernel flipped along all axes for the adjoint of the
+   * convolution, block by block. Set up by Initialize(); the subclasses
+   * connect them in their minipipelines. */
+  using BlockConvolutionFilterType =
+    FFTConvolutionImageFilter<InternalImageType, InternalImageType, InternalImageType, TInternalPrecision>;
+  typename BlockConvolutionFilterType::Pointer m_BlockConvolutionFilter{};
+  typename BlockConvolutionFilterType::Pointer m_BlockAdjointConvolutionFilter{};
+
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
 private:
+  /** Set up the block convolution filters. */
+  void
+  PrepareBlockConvolutions(ProgressAccumulator * progress, float progressWeight, float iterationProgressWeight);
+
+  /** The boundary condition of the block convolutions, for the internal
+   * pixel type. */
+  std::unique_ptr<ImageBoundaryCondition<InternalImageType>> m_BlockBoundaryCondition{};
+
   /** Number of iterations to run. */
   unsigned int m_NumberOfIterations{};
 
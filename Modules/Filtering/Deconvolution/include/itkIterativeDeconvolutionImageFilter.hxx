@@ -19,6 +19,9 @@
 #define itkIterativeDeconvolutionImageFilter_hxx
 
 #include "itkCastImageFilter.h"
+#include "itkConstantBoundaryCondition.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkPeriodicBoundaryCondition.h"
 
 namespace itk
 {
@@ -49,8 +52,17 @@ void
 IterativeDeconvolutionImageFilter<TInputImage, TKernelImage, TOutputImage, TInternalPrecision>::Initialize(
   ProgressAccumulator * progress,
   float                 progressWeight,
-  float                 itkNotUsed(iterationProgressWeight))
+  float                 iterationProgressWeight)
 {
+  if (this->GetBlockConvolution())
+  {
+    // The estimate covers the input only; the convolutions take the pixels
+    // around it from the boundary condition.
+    this->CastInput(this->GetInput(), m_CurrentEstimate, progress, 0.5f * progressWeight);
+    this->PrepareBlockConvolutions(progress, 0.5f * progressWeight, iterationProgressWeight);
+    return;
+  }
+
   // Generate an estimate if there is none or if the input has changed.
   if (!this->m_CurrentEstimate || m_InputMTime != this->GetInput()->GetMTime())
   {
@@ -77,10 +89,128 @@ IterativeDeconvolutionImageFilter<TInputImage, TKernelImage, TOutputImage, TInte
   ProgressAccumulator * progress,
   float                 progressWeight)
 {
-  this->CropOutput(m_CurrentEstimate, progress, progressWeight);
+  if (this->GetBlockConvolution())
+  {
+    using OutputCastFilterType = CastImageFilter<InternalImageType, OutputImageType>;
+    auto outputCaster = OutputCastFilterType::New();
+    outputCaster->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+    outputCaster->SetInput(m_CurrentEstimate);
+    progress->RegisterInternalFilter(outputCaster, progressWeight);
+    outputCaster->Update();
+    this->GraftOutput(outputCaster->GetOutput());
+  }
+  else
+  {
+    this->CropOutput(m_CurrentEstimate, progress, progressWeight);
+  }
 
   m_CurrentEstimate = nullptr;
   m_TransferFunction = nullptr;
+  m_BlockConvolutionFilter = nullptr;
+  m_BlockAdjointConvolutionFilter = nullptr;
+  m_BlockBoundaryCondition = nullptr;
+}
+
+template <typename TInputImage, typename TKernelImage, typename TOutputImage, typename TInternalPrecision>
+void
+IterativeDeconvolutionImageFilter<TInputImage, TKernelImage, TOutputImage, TInternalPrecision>::CastInput(
+  const InputImageType *     input,
+  InternalImagePointerType & castInput,
+  ProgressAccumulator *      progress,
+  float                      progressWeight)
+{
+  using InputCastFilterType = CastImageFilter<InputImageType, InternalImageType>;
+  auto inputCaster = InputCastFilterType::New();
+  // Running in place would release the input of this filter.
+  inputCaster->InPlaceOff();
+  inputCaster->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+  inputCaster->SetInput(input);
+  progress->RegisterInternalFilter(inputCaster, progressWeight);
+  inputCaster->Update();
+
+  castInput = inputCaster->GetOutput();
+  castInput->DisconnectPipeline();
+}
+
+template <typename TInputImage, typename TKernelImage, typename TOutputImage, typename TInternalPrecision>
+void
+IterativeDeconvolutionImageFilter<TInputImage, TKernelImage, TOutputImage, TInternalPrecision>::
+  PrepareBlockConvolutions(ProgressAccumulator * progress, float progressWeight, float iterationProgressWeight)
+{
+  // Extend the internal images as the input is extended.
+  const BoundaryConditionType * boundaryCondition = this->GetBoundaryCondition();
+  if (const auto * constantBoundaryCondition =
+        dynamic_cast<const ConstantBoundaryCondition<InputImageType> *>(boundaryCondition))
+  {
+    auto internalBoundaryCondition = std::make_unique<ConstantBoundaryCondition<InternalImageType>>();
+    internalBoundaryCondition->SetConstant(
+      static_cast<typename InternalImageType::PixelType>(constantBoundaryCondition->GetConstant()));
+    m_BlockBoundaryCondition = std::move(internalBoundaryCondition);
+  }
+  else if (dynamic_cast<const PeriodicBoundaryCondition<InputImageType> *>(boundaryCondition))
+  {
+    m_BlockBoundaryCondition = std::make_unique<PeriodicBoundaryCondition<InternalImageType>>();
+  }
+  else if (dynamic_cast<const ZeroFluxNeumannBoundaryCondition<InputImageType> *>(boundaryCondition))
+  {
+    m_BlockBoundaryCondition = std::make_unique<ZeroFluxNeumannBoundaryCondition<InternalImageType>>();
+  }
+  else
+  {
+    itkExceptionMacro("Block convolution supports the constant, periodic and zero flux Neumann boundary conditions "
+                      "only, not "
+                      << boundaryCondition->GetNameOfClass() << '.');
+  }
+
+  using KernelCastFilterType = CastImageFilter<KernelImageType, InternalImageType>;
+  auto kernelCaster = KernelCastFilterType::New();
+  kernelCaster->InPlaceOff();
+  kernelCaster->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+  kernelCaster->SetInput(this->GetKernelImage());
+  progress->RegisterInternalFilter(kernelCaster, progressWeight);
+  kernelCaster->Update();
+  const InternalImagePointerType kernel = kernelCaster->GetOutput();
+  kernel->DisconnectPipeline();
+
+  // The center of a kernel is at the middle of its size, rounded up, so an
+  // even size is made odd with a zero in front of the flipped kernel to keep
+  // its center on the flipped center of the kernel.
+  const InternalRegionType kernelRegion = kernel->GetLargestPossibleRegion();
+  InternalSizeType         flippedKernelSize;
+  for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+  {
+    flippedKernelSize[dim] = kernelRegion.GetSize(dim) + 1 - kernelRegion.GetSize(dim) % 2;
+  }
+  auto flippedKernel = InternalImageType::New();
+  flippedKernel->SetRegions(InternalRegionType(flippedKernelSize));
+  flippedKernel->AllocateInitialized();
+  for (ImageRegionConstIteratorWithIndex<InternalImageType> it(kernel, kernelRegion); !it.IsAtEnd(); ++it)
+  {
+    InternalIndexType flippedIndex;
+    for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+    {
+      flippedIndex[dim] = static_cast<IndexValueType>(flippedKernelSize[dim]) - 1 -
+                          (it.GetIndex()[dim] - kernelRegion.GetIndex(dim));
+    }
+    flippedKernel->SetPixel(flippedIndex, it.Get());
+  }
+
+  const auto createConvolutionFilter = [this, progress, iterationProgressWeight](const InternalImageType * kernelImage) {
+    auto convolutionFilter = BlockConvolutionFilterType::New();
+    convolutionFilter->SetKernelImage(kernelImage);
+    convolutionFilter->SetNormalize(this->GetNormalize());
+    convolutionFilter->SetBoundaryCondition(m_BlockBoundaryCondition.get());
+    convolutionFilter->BlockConvolutionOn();
+    convolutionFilter->SetBlockSize(this->GetBlockSize());
+    convolutionFilter->SetBlockMemorySize(this->GetBlockMemorySize());
+    convolutionFilter->SetSizeGreatestPrimeFactor(this->GetSizeGreatestPrimeFactor());
+    convolutionFilter->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+    convolutionFilter->ReleaseDataFlagOn();
+    progress->RegisterInternalFilter(convolutionFilter, 0.4f * iterationProgressWeight);
+    return convolutionFilter;
+  };
+  m_BlockConvolutionFilter = createConvolutionFilter(kernel);
+  m_BlockAdjointConvolutionFilter = createConvolutionFilter(flippedKernel);
 }
 
 template <typename TInputImage, typename TKernelImage, typename TOutputImage, typename TInternalPrecision>
@@ -151,6 +281,8 @@ IterativeDeconvolutionImageFilter<TInputImage, TKernelImage, TOutputImage, TInte
   os << indent << "StopIteration: " << m_StopIteration << std::endl;
   os << indent << "InputMTime: " << m_InputMTime << std::endl;
   os << indent << "KernelMTime: " << m_KernelMTime << std::endl;
+  itkPrintSelfObjectMacro(BlockConvolutionFilter);
+  itkPrintSelfObjectMacro(BlockAdjointConvolutionFilter);
 }
 
 } // end namespace itk
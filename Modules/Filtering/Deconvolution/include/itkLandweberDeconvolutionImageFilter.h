@@ -20,7 +20,9 @@
 
 #include "itkIterativeDeconvolutionImageFilter.h"
 
+#include "itkBinaryGeneratorImageFilter.h"
 #include "itkComplexConjugateImageAdaptor.h"
+#include "itkSubtractImageFilter.h"
 #include "itkTernaryGeneratorImageFilter.h"
 
 namespace itk
@@ -162,6 +164,16 @@ private:
 
   typename LandweberFilterType::Pointer m_LandweberFilter{};
   typename IFFTFilterType::Pointer      m_IFFTFilter{};
+
+  /** The input and the filters that compute the same update in the
+   * spatial domain in block mode. */
+  using SubtractFilterType = SubtractImageFilter<InternalImageType>;
+  using UpdateFilterType = BinaryGeneratorImageFilter<InternalImageType, InternalImageType, InternalImageType>;
+
+  InternalImagePointerType m_Input{};
+
+  typename SubtractFilterType::Pointer m_SubtractFilter{};
+  typename UpdateFilterType::Pointer   m_UpdateFilter{};
 };
 
 } // end namespace itk
@@ -46,6 +46,38 @@ LandweberDeconvolutionImageFilter<TInputImage, TKernelImage, TOutputImage, TInte
 {
   this->Superclass::Initialize(progress, 0.5f * progressWeight, iterationProgressWeight);
 
+  if (this->GetBlockConvolution())
+  {
+    this->CastInput(this->GetInput(), m_Input, progress, 0.5f * progressWeight);
+
+    // Set up minipipeline to compute estimate + alpha * adjoint(input - convolution(estimate)) at each
+    // iteration; the estimate will be set as the input of the convolution and as input 1 of the update in
+    // Iteration()
+    m_SubtractFilter = SubtractFilterType::New();
+    m_SubtractFilter->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+    m_SubtractFilter->SetInput1(m_Input);
+    m_SubtractFilter->SetInput2(this->m_BlockConvolutionFilter->GetOutput());
+    m_SubtractFilter->InPlaceOff();
+    m_SubtractFilter->ReleaseDataFlagOn();
+    progress->RegisterInternalFilter(m_SubtractFilter, 0.1f * iterationProgressWeight);
+
+    this->m_BlockAdjointConvolutionFilter->SetInput(m_SubtractFilter->GetOutput());
+
+    using PixelType = typename InternalImageType::PixelType;
+    const auto alpha = static_cast<PixelType>(m_Alpha);
+    m_UpdateFilter = UpdateFilterType::New();
+    m_UpdateFilter->SetFunctor(
+      [alpha](const PixelType & estimate, const PixelType & correction) -> PixelType {
+        return estimate + alpha * correction;
+      });
+    m_UpdateFilter->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+    m_UpdateFilter->SetInput2(this->m_BlockAdjointConvolutionFilter->GetOutput());
+    m_UpdateFilter->InPlaceOn();
+    m_UpdateFilter->ReleaseDataFlagOn();
+    progress->RegisterInternalFilter(m_UpdateFilter, 0.1f * iterationProgressWeight);
+    return;
+  }
+
   this->PrepareInput(this->GetInput(), m_TransformedInput, progress, 0.5f * progressWeight);
 
   // Set up minipipeline to compute estimate at each iteration
@@ -75,6 +107,17 @@ LandweberDeconvolutionImageFilter<TInputImage, TKernelImage, TOutputImage, TInte
   ProgressAccumulator * progress,
   float                 iterationProgressWeight)
 {
+  if (this->GetBlockConvolution())
+  {
+    this->m_BlockConvolutionFilter->SetInput(this->m_CurrentEstimate);
+    m_UpdateFilter->SetInput1(this->m_CurrentEstimate);
+    m_UpdateFilter->UpdateLargestPossibleRegion();
+
+    this->m_CurrentEstimate = m_UpdateFilter->GetOutput();
+    this->m_CurrentEstimate->DisconnectPipeline();
+    return;
+  }
+
   // Set up minipipeline to compute the new estimate
   InternalComplexImagePointerType transformedEstimate;
   this->TransformPaddedInput(this->m_CurrentEstimate, transformedEstimate, progress, 0.1f * iterationProgressWeight);
@@ -100,6 +143,9 @@ LandweberDeconvolutionImageFilter<TInputImage, TKernelImage, TOutputImage, TInte
 
   m_LandweberFilter = nullptr;
   m_IFFTFilter = nullptr;
+  m_Input = nullptr;
+  m_SubtractFilter = nullptr;
+  m_UpdateFilter = nullptr;
 }
 
 template <typename TInputImage, typename TKernelImage, typename TOutputImage, typename TInternalPrecision>
@@ -51,6 +51,10 @@ namespace itk
  * not use the static kernel image set through this method. Instead,
  * it uses the output of the parametric kernel source you specify.
  *
+ * The block convolution mode of the FFTConvolutionImageFilter is not
+ * supported, because the kernel parameters are fit to the spectrum of
+ * the whole input.
+ *
  * \author Cory Quammen, The University of North Carolina at Chapel Hill
  *
  * \ingroup ITKDeconvolution
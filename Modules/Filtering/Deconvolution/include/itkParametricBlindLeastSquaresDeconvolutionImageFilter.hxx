@@ -60,6 +60,12 @@ ParametricBlindLeastSquaresDeconvolutionImageFilter<TInputImage, TKernelImage, T
   float                 progressWeight,
   float                 iterationProgressWeight)
 {
+  if (this->GetBlockConvolution())
+  {
+    itkExceptionMacro("Block convolution is not supported: the kernel parameters are fit to the spectrum of the "
+                      "whole input.");
+  }
+
   // Set the kernel, needed by the class to pad the input properly
   m_KernelSource->Update();
   this->SetKernelImage(m_KernelSource->GetOutput());
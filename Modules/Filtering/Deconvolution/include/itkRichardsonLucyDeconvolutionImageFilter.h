@@ -117,6 +117,7 @@ private:
   using ComplexConjugateMultiplyType =
     MultiplyImageFilter<InternalComplexImageType, ConjugateAdaptorType, InternalComplexImageType>;
 
+  /** The input, not padded in block mode. */
   InternalImagePointerType m_PaddedInput{};
 
   typename ComplexMultiplyType::Pointer          m_ComplexMultiplyFilter1{};
@@ -45,6 +45,31 @@ RichardsonLucyDeconvolutionImageFilter<TInputImage, TKernelImage, TOutputImage,
 {
   this->Superclass::Initialize(progress, 0.5f * progressWeight, iterationProgressWeight);
 
+  if (this->GetBlockConvolution())
+  {
+    this->CastInput(this->GetInput(), m_PaddedInput, progress, 0.5f * progressWeight);
+
+    // Set up minipipeline to compute estimate at each iteration; the
+    // estimate will be set as the input of the convolution and as input 1
+    // of the multiplication in Iteration()
+    m_DivideFilter = DivideFilterType::New();
+    m_DivideFilter->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+    m_DivideFilter->SetInput1(m_PaddedInput);
+    m_DivideFilter->SetInput2(this->m_BlockConvolutionFilter->GetOutput());
+    m_DivideFilter->InPlaceOff();
+    progress->RegisterInternalFilter(m_DivideFilter, 0.1f * iterationProgressWeight);
+
+    this->m_BlockAdjointConvolutionFilter->SetInput(m_DivideFilter->GetOutput());
+
+    m_MultiplyFilter = MultiplyFilterType::New();
+    m_MultiplyFilter->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+    m_MultiplyFilter->SetInput2(this->m_BlockAdjointConvolutionFilter->GetOutput());
+    m_MultiplyFilter->InPlaceOn();
+    m_MultiplyFilter->ReleaseDataFlagOn();
+    progress->RegisterInternalFilter(m_MultiplyFilter, 0.1f * iterationProgressWeight);
+    return;
+  }
+
   this->PadInput(this->GetInput(), m_PaddedInput, progress, 0.5f * progressWeight);
 
   // Set up minipipeline to compute estimate at each iteration
@@ -112,6 +137,17 @@ RichardsonLucyDeconvolutionImageFilter<TInputImage, TKernelImage, TOutputImage,
   ProgressAccumulator * progress,
   float                 iterationProgressWeight)
 {
+  if (this->GetBlockConvolution())
+  {
+    this->m_BlockConvolutionFilter->SetInput(this->m_CurrentEstimate);
+    m_MultiplyFilter->SetInput1(this->m_CurrentEstimate);
+    m_MultiplyFilter->UpdateLargestPossibleRegion();
+
+    this->m_CurrentEstimate = m_MultiplyFilter->GetOutput();
+    this->m_CurrentEstimate->DisconnectPipeline();
+    return;
+  }
+
   // Set up minipipeline to compute the new estimate
   InternalComplexImagePointerType transformedEstimate;
   this->TransformPaddedInput(this->m_CurrentEstimate, transformedEstimate, progress, 0.1f * iterationProgressWeight);
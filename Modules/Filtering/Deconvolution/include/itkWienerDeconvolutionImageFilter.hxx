@@ -35,6 +35,11 @@ template <typename TInputImage, typename TKernelImage, typename TOutputImage, ty
 void
 WienerDeconvolutionImageFilter<TInputImage, TKernelImage, TOutputImage, TInternalPrecision>::GenerateData()
 {
+  if (this->GetBlockConvolution())
+  {
+    itkExceptionMacro("Block convolution is not supported: inverting the kernel spectrum is not a local operation.");
+  }
+
   // Create a process accumulator for tracking the progress of this
   // minipipeline
   auto progress = ProgressAccumulator::New();
@@ -100,6 +100,11 @@ itkInverseDeconvolutionImageFilterTest(int argc, char * argv[])
 
   deconvolutionFilter->Print(std::cout);
 
+  // Inverting the kernel spectrum does not apply block by block
+  deconvolutionFilter->BlockConvolutionOn();
+  ITK_TRY_EXPECT_EXCEPTION(deconvolutionFilter->Update());
+  deconvolutionFilter->BlockConvolutionOff();
+
   // Instantiate types with non-default template parameters
   using FloatImageType = itk::Image<float, ImageDimension>;
   using DoubleImageType = itk::Image<double, ImageDimension>;
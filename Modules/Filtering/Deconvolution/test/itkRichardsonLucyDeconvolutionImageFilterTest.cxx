@@ -19,6 +19,7 @@
 #include "itkFFTConvolutionImageFilter.h"
 #include "itkImageFileReader.h"
 #include "itkImageFileWriter.h"
+#include "itkImageRegionConstIterator.h"
 #include "itkRichardsonLucyDeconvolutionImageFilter.h"
 #include "itkDeconvolutionIterationCommand.h"
 #include "itkSimpleFilterWatcher.h"
@@ -139,6 +140,32 @@ itkRichardsonLucyDeconvolutionImageFilterTest(int argc, char * argv[])
 
   std::cout << deconvolutionFilter->DeconvolutionFilterType::Superclass::GetNameOfClass() << std::endl;
 
+  // In block mode, the estimate does not depend on the size of the blocks
+  deconvolutionFilter->SetStopIteration(false);
+  deconvolutionFilter->BlockConvolutionOn();
+  ITK_TRY_EXPECT_NO_EXCEPTION(deconvolutionFilter->Update());
+  const ImageType::Pointer blockOutput = deconvolutionFilter->GetOutput();
+  blockOutput->DisconnectPipeline();
+
+  const auto blockSize = DeconvolutionFilterType::OutputSizeType::Filled(8);
+  deconvolutionFilter->SetBlockSize(blockSize);
+  ITK_TRY_EXPECT_NO_EXCEPTION(deconvolutionFilter->Update());
+  ITK_TEST_EXPECT_EQUAL(deconvolutionFilter->GetOutput()->GetLargestPossibleRegion(),
+                        blockOutput->GetLargestPossibleRegion());
+  itk::ImageRegionConstIterator<ImageType> smallBlockIt(deconvolutionFilter->GetOutput(),
+                                                        blockOutput->GetLargestPossibleRegion());
+  itk::ImageRegionConstIterator<ImageType> blockIt(blockOutput, blockOutput->GetLargestPossibleRegion());
+  for (; !blockIt.IsAtEnd(); ++smallBlockIt, ++blockIt)
+  {
+    if (std::abs(smallBlockIt.Get() - blockIt.Get()) > 1e-4f * std::max(1.0f, std::abs(blockIt.Get())))
+    {
+      std::cerr << "Block size changed the estimate at " << blockIt.GetIndex() << ": " << smallBlockIt.Get()
+                << " instead of " << blockIt.Get() << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  deconvolutionFilter->BlockConvolutionOff();
+
   // Instantiate types with non-default template parameters
   using FloatImageType = itk::Image<float, Dimension>;
   using DoubleImageType = itk::Image<double, Dimension>;
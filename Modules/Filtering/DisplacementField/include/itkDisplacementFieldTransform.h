@@ -449,6 +449,20 @@ protected:
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
+  /** \see Transform::GetBatchedTransformClass() */
+  const std::type_info *
+  GetBatchedTransformClass() const override
+  {
+    return &typeid(Self);
+  }
+
+  /** Transform a batch of points, with the field and interpolator checked
+   * once for the whole batch. */
+  void
+  BatchedTransformPoints(const InputPointType * inputPoints,
+                         OutputPointType *      outputPoints,
+                         SizeValueType          numberOfPoints) const override;
+
   /** The displacement field and its inverse (if it exists). */
   typename DisplacementFieldType::Pointer m_DisplacementField{};
   typename DisplacementFieldType::Pointer m_InverseDisplacementField{};
@@ -101,6 +101,48 @@ DisplacementFieldTransform<TParametersValueType, VDimension>::TransformPoint(con
   return outputPoint;
 }
 
+template <typename TParametersValueType, unsigned int VDimension>
+void
+DisplacementFieldTransform<TParametersValueType, VDimension>::BatchedTransformPoints(
+  const InputPointType * inputPoints,
+  OutputPointType *      outputPoints,
+  SizeValueType          numberOfPoints) const
+{
+  if (!this->m_DisplacementField)
+  {
+    itkExceptionMacro("No displacement field is specified.");
+  }
+  if (!this->m_Interpolator)
+  {
+    itkExceptionMacro("No interpolator is specified.");
+  }
+
+  const DisplacementFieldType * field = this->m_DisplacementField;
+  const InterpolatorType *      interpolator = this->m_Interpolator;
+  using ContinuousIndexType = typename InterpolatorType::ContinuousIndexType;
+
+  for (SizeValueType i = 0; i < numberOfPoints; ++i)
+  {
+    typename InterpolatorType::PointType point;
+    point.CastFrom(inputPoints[i]);
+
+    if (interpolator->IsInsideBuffer(point))
+    {
+      const ContinuousIndexType cidx =
+        field->template TransformPhysicalPointToContinuousIndex<typename ContinuousIndexType::ValueType>(point);
+      const typename InterpolatorType::OutputType displacement = interpolator->EvaluateAtContinuousIndex(cidx);
+      for (unsigned int ii = 0; ii < VDimension; ++ii)
+      {
+        outputPoints[i][ii] = inputPoints[i][ii] + displacement[ii];
+      }
+    }
+    else
+    {
+      outputPoints[i] = inputPoints[i];
+    }
+  }
+}
+
 template <typename TParametersValueType, unsigned int VDimension>
 bool
 DisplacementFieldTransform<TParametersValueType, VDimension>::GetInverse(Self * inverse) const
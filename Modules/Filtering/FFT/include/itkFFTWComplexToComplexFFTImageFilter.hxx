@@ -18,6 +18,7 @@
 #ifndef itkFFTWComplexToComplexFFTImageFilter_hxx
 #define itkFFTWComplexToComplexFFTImageFilter_hxx
 
+#include "itkFFTWPlanCache.h"
 #include "itkIndent.h"
 #include "itkMetaDataObject.h"
 #include "itkImageRegionIterator.h"
@@ -93,8 +94,16 @@ FFTWComplexToComplexFFTImageFilter<TInputImage, TOutputImage>::BeforeThreadedGen
     sizes[(ImageDimension - 1) - i] = inputSize[i];
   }
 
-  plan =
-    FFTWProxyType::Plan_dft(ImageDimension, sizes, in, out, transformDirection, flags, this->GetNumberOfWorkUnits());
+  const int threads = this->GetNumberOfWorkUnits();
+
+#ifndef ITK_USE_CUFFTW
+  if (FFTWPlanCache::Execute_dft(ImageDimension, sizes, in, out, transformDirection, flags, threads))
+  {
+    return;
+  }
+#endif
+
+  plan = FFTWProxyType::Plan_dft(ImageDimension, sizes, in, out, transformDirection, flags, threads);
 
   FFTWProxyType::Execute(plan);
   FFTWProxyType::DestroyPlan(plan);
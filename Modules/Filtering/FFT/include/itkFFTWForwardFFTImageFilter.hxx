@@ -18,6 +18,7 @@
 #ifndef itkFFTWForwardFFTImageFilter_hxx
 #define itkFFTWForwardFFTImageFilter_hxx
 
+#include "itkFFTWPlanCache.h"
 #include "itkHalfToFullHermitianImageFilter.h"
 #include "itkIndent.h"
 #include "itkMetaDataObject.h"
@@ -107,14 +108,20 @@ FFTWForwardFFTImageFilter<TInputImage, TOutputImage>::GenerateData()
     sizes[(ImageDimension - 1) - i] = inputSize[i];
   }
 
-  plan = FFTWProxyType::Plan_dft_r2c(ImageDimension,
-                                     sizes,
-                                     in,
-                                     (typename FFTWProxyType::ComplexType *)fftwOutput->GetBufferPointer(),
-                                     flags,
-                                     MultiThreaderBase::GetGlobalDefaultNumberOfThreads());
-  FFTWProxyType::Execute(plan);
-  FFTWProxyType::DestroyPlan(plan);
+  auto *    out = (typename FFTWProxyType::ComplexType *)fftwOutput->GetBufferPointer();
+  const int threads = MultiThreaderBase::GetGlobalDefaultNumberOfThreads();
+
+#ifndef ITK_USE_CUFFTW
+  const bool cached = FFTWPlanCache::Execute_dft_r2c(ImageDimension, sizes, in, out, flags, threads);
+#else
+  constexpr bool cached = false;
+#endif
+  if (!cached)
+  {
+    plan = FFTWProxyType::Plan_dft_r2c(ImageDimension, sizes, in, out, flags, threads);
+    FFTWProxyType::Execute(plan);
+    FFTWProxyType::DestroyPlan(plan);
+  }
 
   // Expand the half image to the full image size
   using HalfToFullFilterType = HalfToFullHermitianImageFilter<OutputImageType>;
@@ -348,6 +348,14 @@ public:
   static bool
   ExportDefaultWisdomFile();
 
+  /** Merge the new wisdom into the cache files, as the destructor does when
+   * the process exits, if WriteWisdomCache is set and new wisdom is
+   * available. FFTWPlanCache calls it after planning, so that the wisdom of a
+   * process that does not exit normally is not lost. Returns whether the
+   * files were written. */
+  static bool
+  WriteNewWisdomToCache();
+
 private:
   FFTWGlobalConfiguration();           // This will process env variables
   ~FFTWGlobalConfiguration() override; // This will write cache file if requested.
@@ -356,6 +364,11 @@ private:
   static Pointer
   GetInstance();
 
+  /** Import the cache files again, to keep the wisdom saved by other
+   * processes, and export the merged wisdom to them. */
+  void
+  WriteWisdomCacheFiles();
+
   itkGetGlobalDeclarationMacro(FFTWGlobalConfigurationGlobals, PimplGlobals);
 
 
@@ -18,6 +18,7 @@
 #ifndef itkFFTWHalfHermitianToRealInverseFFTImageFilter_hxx
 #define itkFFTWHalfHermitianToRealInverseFFTImageFilter_hxx
 
+#include "itkFFTWPlanCache.h"
 #include "itkImageRegionIterator.h"
 #include "itkProgressReporter.h"
 #include "itkMultiThreaderBase.h"
@@ -71,6 +72,29 @@ FFTWHalfHermitianToRealInverseFFTImageFilter<TInputImage, TOutputImage>::BeforeT
     totalInputSize *= inputSize[i];
   }
 
+  int sizes[ImageDimension];
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+  {
+    sizes[(ImageDimension - 1) - i] = outputSize[i];
+  }
+  const int threads = MultiThreaderBase::GetGlobalDefaultNumberOfThreads();
+
+#ifndef ITK_USE_CUFFTW
+  // The plan cache copies the input when it must not be destroyed.
+  if (FFTWPlanCache::Execute_dft_c2r(ImageDimension,
+                                     sizes,
+                                     const_cast<typename FFTWProxyType::ComplexType *>(
+                                       reinterpret_cast<const typename FFTWProxyType::ComplexType *>(
+                                         inputPtr->GetBufferPointer())),
+                                     outputPtr->GetBufferPointer(),
+                                     m_PlanRigor,
+                                     threads,
+                                     m_CanUseDestructiveAlgorithm))
+  {
+    return;
+  }
+#endif
+
   // The complex-to-real transform doesn't support the
   // FFTW_PRESERVE_INPUT flag at this time. So if the input can't be
   // destroyed, we have to copy the input data to a buffer before
@@ -91,18 +115,8 @@ FFTWHalfHermitianToRealInverseFFTImageFilter<TInputImage, TOutputImage>::BeforeT
   OutputPixelType *                out = outputPtr->GetBufferPointer();
   typename FFTWProxyType::PlanType plan;
 
-  int sizes[ImageDimension];
-  for (unsigned int i = 0; i < ImageDimension; ++i)
-  {
-    sizes[(ImageDimension - 1) - i] = outputSize[i];
-  }
-  plan = FFTWProxyType::Plan_dft_c2r(ImageDimension,
-                                     sizes,
-                                     in,
-                                     out,
-                                     m_PlanRigor,
-                                     MultiThreaderBase::GetGlobalDefaultNumberOfThreads(),
-                                     !m_CanUseDestructiveAlgorithm);
+  plan =
+    FFTWProxyType::Plan_dft_c2r(ImageDimension, sizes, in, out, m_PlanRigor, threads, !m_CanUseDestructiveAlgorithm);
   if (!m_CanUseDestructiveAlgorithm)
   {
     // complex<double> and double[2] types are compatible memory layouts.
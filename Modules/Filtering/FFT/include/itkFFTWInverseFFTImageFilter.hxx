@@ -18,6 +18,7 @@
 #ifndef itkFFTWInverseFFTImageFilter_hxx
 #define itkFFTWInverseFFTImageFilter_hxx
 
+#include "itkFFTWPlanCache.h"
 #include "itkFullToHalfHermitianImageFilter.h"
 
 #include "itkImageRegionIterator.h"
@@ -91,8 +92,17 @@ FFTWInverseFFTImageFilter<TInputImage, TOutputImage>::BeforeThreadedGenerateData
     sizes[(ImageDimension - 1) - i] = outputSize[i];
   }
 
-  plan = FFTWProxyType::Plan_dft_c2r(
-    ImageDimension, sizes, in, out, m_PlanRigor, MultiThreaderBase::GetGlobalDefaultNumberOfThreads(), false);
+  const int threads = MultiThreaderBase::GetGlobalDefaultNumberOfThreads();
+
+#ifndef ITK_USE_CUFFTW
+  // The half image is a temporary, which the transform may destroy.
+  if (FFTWPlanCache::Execute_dft_c2r(ImageDimension, sizes, in, out, m_PlanRigor, threads, true))
+  {
+    return;
+  }
+#endif
+
+  plan = FFTWProxyType::Plan_dft_c2r(ImageDimension, sizes, in, out, m_PlanRigor, threads, false);
   FFTWProxyType::Execute(plan);
 
   // Some cleanup.
@@ -0,0 +1,186 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkFFTWPlanCache_h
+#define itkFFTWPlanCache_h
+
+#include "itkFFTWGlobalConfiguration.h"
+// NOTE: the plan cache relies on FFTWGlobalConfiguration, which is not
+// available with cuFFTW.
+#if (defined(ITK_USE_FFTWF) || defined(ITK_USE_FFTWD)) && !defined(ITK_USE_CUFFTW)
+
+#  include "itkIntTypes.h"
+
+#  include <iosfwd>
+
+namespace itk
+{
+struct FFTWPlanCacheGlobals;
+
+/** \class FFTWPlanCache
+ * \brief Process wide cache of FFTW plans and of the buffers they were
+ * planned on.
+ *
+ * Planning a transform with FFTW, and allocating the arrays it is planned on,
+ * may take longer than the transform itself, especially with a planner rigor
+ * above FFTW_ESTIMATE. The FFTW image filters run their transforms through
+ * this cache, which keeps a plan for each precision, kind of transform,
+ * size, number of threads and planner flags. Transforming again with the same
+ * parameters, in any filter instance, skips planning (a hit). The SIMD
+ * aligned buffers a plan is planned on are freed right after planning; the
+ * plan runs directly on the arrays of the caller when they have the
+ * alignment of those buffers and differ, and through input and output
+ * buffers, allocated when first needed, otherwise.
+ *
+ * A cached plan runs one transform at a time; concurrent transforms of the
+ * same parameters plan their own, which are cached too. Idle plans are
+ * always kept. The buffers they hold are kept, most recently used first,
+ * while they fit in MaximumIdleBufferBytes, 64 MiB by default, and freed
+ * beyond it, to be allocated again when a transform needs them.
+ * ReleaseBuffers() frees the buffers of all the idle plans but keeps the
+ * plans; Clear() destroys the plans as well.
+ *
+ * The wisdom of new plans is written to the wisdom cache file right after
+ * planning, see FFTWGlobalConfiguration::WriteNewWisdomToCache(), rather
+ * than only when the process exits, so that later processes plan from it.
+ *
+ * The cache may be disabled by SetEnabled(false), or by setting the
+ * environment variable ITK_FFTW_PLAN_CACHE to OFF. GetNumberOfHits(),
+ * GetNumberOfMisses() and GetPlanningTime() report its effect. All members
+ * are thread safe.
+ *
+ * \sa FFTWGlobalConfiguration
+ * \ingroup ITKFFT
+ */
+class ITKFFT_EXPORT FFTWPlanCache
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(FFTWPlanCache);
+  FFTWPlanCache() = default;
+  virtual ~FFTWPlanCache() = default;
+
+  /** Set/Get whether the transforms are cached. Disabling the cache keeps
+   * the plans already cached until Clear(). */
+  static void
+  SetEnabled(bool enabled);
+  static bool
+  GetEnabled();
+
+  /** Set/Get the largest memory, in bytes, taken by the buffers held by the
+   * idle plans. The buffers of the least recently used plans are freed beyond
+   * it, and their plans kept. Defaults to 64 MiB. */
+  static void
+  SetMaximumIdleBufferBytes(SizeValueType maximumIdleBufferBytes);
+  static SizeValueType
+  GetMaximumIdleBufferBytes();
+
+  /** Transform in to out with a plan of rank and sizes n, in row-major order,
+   * the given planner flags and number of threads, as planning with
+   * fftw::Proxy and executing the plan would. The real to complex and complex
+   * to complex transforms preserve their input unless flags allow otherwise;
+   * the complex to real transform preserves it unless canDestroyInput.
+   * Return false, without transforming, when the cache is disabled. */
+#  if defined(ITK_USE_FFTWF)
+  static bool
+  Execute_dft_r2c(int rank, const int * n, float * in, fftwf_complex * out, unsigned int flags, int threads);
+  static bool
+  Execute_dft_c2r(int             rank,
+                  const int *     n,
+                  fftwf_complex * in,
+                  float *         out,
+                  unsigned int    flags,
+                  int             threads,
+                  bool            canDestroyInput);
+  static bool
+  Execute_dft(int             rank,
+              const int *     n,
+              fftwf_complex * in,
+              fftwf_complex * out,
+              int             sign,
+              unsigned int    flags,
+              int             threads);
+#  endif
+#  if defined(ITK_USE_FFTWD)
+  static bool
+  Execute_dft_r2c(int rank, const int * n, double * in, fftw_complex * out, unsigned int flags, int threads);
+  static bool
+  Execute_dft_c2r(int            rank,
+                  const int *    n,
+                  fftw_complex * in,
+                  double *       out,
+                  unsigned int   flags,
+                  int            threads,
+                  bool           canDestroyInput);
+  static bool
+  Execute_dft(int            rank,
+              const int *    n,
+              fftw_complex * in,
+              fftw_complex * out,
+              int            sign,
+              unsigned int   flags,
+              int            threads);
+#  endif
+
+  /** Number of transforms that found a cached plan, and that were planned,
+   * since the process started or ResetStatistics(). */
+  static SizeValueType
+  GetNumberOfHits();
+  static SizeValueType
+  GetNumberOfMisses();
+
+  /** Wall clock time, in seconds, spent planning the misses. */
+  static double
+  GetPlanningTime();
+
+  /** Reset the hits, misses and planning time to zero. */
+  static void
+  ResetStatistics();
+
+  /** Number of idle plans, and memory, in bytes, taken by the buffers they
+   * hold. */
+  static SizeValueType
+  GetNumberOfCachedPlans();
+  static SizeValueType
+  GetIdleBufferBytes();
+
+  /** Free the buffers of the idle plans, and keep the plans. */
+  static void
+  ReleaseBuffers();
+
+  /** Destroy the idle plans. */
+  static void
+  Clear();
+
+  /** Print the hits, misses, planning time and cached plans. */
+  static void
+  PrintStatistics(std::ostream & os);
+
+private:
+  friend class FFTWGlobalConfiguration;
+
+  /** Destroy the idle plans without the FFTW lock, before
+   * FFTWGlobalConfiguration cleans FFTW up at exit. */
+  static void
+  ReleasePlansAtExit();
+
+  itkGetGlobalDeclarationMacro(FFTWPlanCacheGlobals, PimplGlobals);
+  static FFTWPlanCacheGlobals * m_PimplGlobals;
+};
+} // end namespace itk
+
+#endif
+#endif
@@ -18,6 +18,7 @@
 #ifndef itkFFTWRealToHalfHermitianForwardFFTImageFilter_hxx
 #define itkFFTWRealToHalfHermitianForwardFFTImageFilter_hxx
 
+#include "itkFFTWPlanCache.h"
 #include "itkProgressReporter.h"
 #include "itkMultiThreaderBase.h"
 
@@ -90,8 +91,16 @@ FFTWRealToHalfHermitianForwardFFTImageFilter<TInputImage, TOutputImage>::Generat
     sizes[(ImageDimension - 1) - i] = inputSize[i];
   }
 
-  plan = FFTWProxyType::Plan_dft_r2c(
-    ImageDimension, sizes, in, out, flags, MultiThreaderBase::GetGlobalDefaultNumberOfThreads());
+  const int threads = MultiThreaderBase::GetGlobalDefaultNumberOfThreads();
+
+#ifndef ITK_USE_CUFFTW
+  if (FFTWPlanCache::Execute_dft_r2c(ImageDimension, sizes, in, out, flags, threads))
+  {
+    return;
+  }
+#endif
+
+  plan = FFTWProxyType::Plan_dft_r2c(ImageDimension, sizes, in, out, flags, threads);
   FFTWProxyType::Execute(plan);
   FFTWProxyType::DestroyPlan(plan);
 }
@@ -20,6 +20,7 @@
 #if defined(ITK_USE_FFTWF) || defined(ITK_USE_FFTWD)
 
 #  include "itkSingleton.h"
+#  include "itkFFTWPlanCache.h"
 
 
 #  include "itksys/SystemTools.hxx"
@@ -485,23 +486,11 @@ FFTWGlobalConfiguration::FFTWGlobalConfiguration()
 
 FFTWGlobalConfiguration::~FFTWGlobalConfiguration()
 {
+  // The cached plans must be destroyed before FFTW is cleaned up.
+  FFTWPlanCache::ReleasePlansAtExit();
   if (this->m_WriteWisdomCache && this->m_NewWisdomAvailable)
   {
-    const std::string cachePath = m_WisdomFilenameGenerator->GenerateWisdomFilename(m_WisdomCacheBase);
-#  if defined(ITK_USE_FFTWF)
-    {
-      // import the wisdom files again to be sure to not erase the wisdom saved in another process
-      ImportWisdomFileFloat(cachePath + "f");
-      ExportWisdomFileFloat(cachePath + "f");
-    }
-#  endif
-#  if defined(ITK_USE_FFTWD)
-    {
-      // import the wisdom files again to be sure to not erase the wisdom saved in another process
-      ImportWisdomFileDouble(cachePath);
-      ExportWisdomFileDouble(cachePath);
-    }
-#  endif
+    this->WriteWisdomCacheFiles();
   }
 #  if defined(ITK_USE_FFTWF)
 #    if !defined(_WIN32) || defined(ITK_STATIC)
@@ -521,6 +510,41 @@ FFTWGlobalConfiguration::~FFTWGlobalConfiguration()
   delete this->m_WisdomFilenameGenerator;
 }
 
+void
+FFTWGlobalConfiguration::WriteWisdomCacheFiles()
+{
+  const std::string cachePath = m_WisdomFilenameGenerator->GenerateWisdomFilename(m_WisdomCacheBase);
+#  if defined(ITK_USE_FFTWF)
+  {
+    // import the wisdom files again to be sure to not erase the wisdom saved in another process
+    ImportWisdomFileFloat(cachePath + "f");
+    ExportWisdomFileFloat(cachePath + "f");
+  }
+#  endif
+#  if defined(ITK_USE_FFTWD)
+  {
+    // import the wisdom files again to be sure to not erase the wisdom saved in another process
+    ImportWisdomFileDouble(cachePath);
+    ExportWisdomFileDouble(cachePath);
+  }
+#  endif
+  m_NewWisdomAvailable = false;
+}
+
+bool
+FFTWGlobalConfiguration::WriteNewWisdomToCache()
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  const Pointer                    instance = GetInstance();
+  const std::lock_guard<MutexType> lockGuard(instance->m_Mutex);
+  if (!instance->m_WriteWisdomCache || !instance->m_NewWisdomAvailable)
+  {
+    return false;
+  }
+  instance->WriteWisdomCacheFiles();
+  return true;
+}
+
 void
 FFTWGlobalConfiguration::SetWisdomFilenameGenerator(WisdomFilenameGeneratorBase * wfg)
 {
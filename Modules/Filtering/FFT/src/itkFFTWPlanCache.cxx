@@ -0,0 +1,689 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkFFTWPlanCache.h"
+
+#if (defined(ITK_USE_FFTWF) || defined(ITK_USE_FFTWD)) && !defined(ITK_USE_CUFFTW)
+
+#  include "itkFFTWCommon.h"
+#  include "itkSingleton.h"
+#  include "itksys/SystemTools.hxx"
+
+#  include <chrono>
+#  include <cstring>
+#  include <list>
+#  include <memory>
+#  include <mutex>
+#  include <ostream>
+#  include <string>
+#  include <tuple>
+#  include <vector>
+
+namespace itk
+{
+
+namespace
+{
+enum class TransformKind : uint8_t
+{
+  RealToComplex = 0,
+  ComplexToReal,
+  ComplexToComplex
+};
+
+// Precision, as the size of the real type, kind, sign, sizes, number of
+// threads and planner flags.
+using PlanKeyType = std::tuple<size_t, TransformKind, int, std::vector<int>, int, unsigned int>;
+
+bool
+IsOff(std::string value)
+{
+  value = itksys::SystemTools::UpperCase(value);
+  return value.empty() || value == "0" || value == "NO" || value == "OFF" || value == "FALSE";
+}
+
+// The FFTW functions that fftw::Proxy does not wrap.
+template <typename TReal>
+struct FFTWFunctions;
+
+#  if defined(ITK_USE_FFTWF)
+template <>
+struct FFTWFunctions<float>
+{
+  using PlanType = fftwf_plan;
+  using ComplexType = fftwf_complex;
+
+  static void *
+  Malloc(size_t size)
+  {
+    return fftwf_malloc(size);
+  }
+  static void
+  Free(void * p)
+  {
+    fftwf_free(p);
+  }
+  static int
+  AlignmentOf(void * p)
+  {
+    return fftwf_alignment_of(static_cast<float *>(p));
+  }
+  static void
+  Execute(TransformKind kind, PlanType plan, void * in, void * out)
+  {
+    switch (kind)
+    {
+      case TransformKind::RealToComplex:
+        fftwf_execute_dft_r2c(plan, static_cast<float *>(in), static_cast<ComplexType *>(out));
+        break;
+      case TransformKind::ComplexToReal:
+        fftwf_execute_dft_c2r(plan, static_cast<ComplexType *>(in), static_cast<float *>(out));
+        break;
+      case TransformKind::ComplexToComplex:
+        fftwf_execute_dft(plan, static_cast<ComplexType *>(in), static_cast<ComplexType *>(out));
+        break;
+    }
+  }
+  static void
+  DestroyPlan(PlanType plan)
+  {
+    fftwf_destroy_plan(plan);
+  }
+};
+#  endif
+
+#  if defined(ITK_USE_FFTWD)
+template <>
+struct FFTWFunctions<double>
+{
+  using PlanType = fftw_plan;
+  using ComplexType = fftw_complex;
+
+  static void *
+  Malloc(size_t size)
+  {
+    return fftw_malloc(size);
+  }
+  static void
+  Free(void * p)
+  {
+    fftw_free(p);
+  }
+  static int
+  AlignmentOf(void * p)
+  {
+    return fftw_alignment_of(static_cast<double *>(p));
+  }
+  static void
+  Execute(TransformKind kind, PlanType plan, void * in, void * out)
+  {
+    switch (kind)
+    {
+      case TransformKind::RealToComplex:
+        fftw_execute_dft_r2c(plan, static_cast<double *>(in), static_cast<ComplexType *>(out));
+        break;
+      case TransformKind::ComplexToReal:
+        fftw_execute_dft_c2r(plan, static_cast<ComplexType *>(in), static_cast<double *>(out));
+        break;
+      case TransformKind::ComplexToComplex:
+        fftw_execute_dft(plan, static_cast<ComplexType *>(in), static_cast<ComplexType *>(out));
+        break;
+    }
+  }
+  static void
+  DestroyPlan(PlanType plan)
+  {
+    fftw_destroy_plan(plan);
+  }
+};
+#  endif
+
+// A plan and the buffers it runs through when the arrays of the caller do not
+// suit it. The buffers it was planned on are freed right after planning, and
+// allocated again, with the alignment the plan was planned for, when a
+// transform needs them. They are freed with the entry; the plan must be
+// destroyed explicitly, since FFTW may already be cleaned up when the entry
+// is deleted at exit.
+struct PlanCacheEntry
+{
+  virtual ~PlanCacheEntry() = default;
+
+  virtual void
+  DestroyPlan(bool lock) = 0;
+
+  virtual void
+  ReleaseBuffers() = 0;
+
+  // Memory taken by the allocated buffers.
+  SizeValueType
+  GetBufferSize() const
+  {
+    return (m_Input != nullptr ? m_InputSize : 0) + (m_Output != nullptr ? m_OutputSize : 0);
+  }
+
+  PlanKeyType   m_Key;
+  SizeValueType m_InputSize{ 0 };
+  SizeValueType m_OutputSize{ 0 };
+  void *        m_Input{ nullptr };
+  void *        m_Output{ nullptr };
+  int           m_InputAlignment{ 0 };
+  int           m_OutputAlignment{ 0 };
+};
+
+template <typename TReal>
+struct TypedPlanCacheEntry : public PlanCacheEntry
+{
+  using FunctionsType = FFTWFunctions<TReal>;
+
+  ~TypedPlanCacheEntry() override { this->ReleaseBuffers(); }
+
+  void
+  ReleaseBuffers() override
+  {
+    FunctionsType::Free(m_Input);
+    FunctionsType::Free(m_Output);
+    m_Input = nullptr;
+    m_Output = nullptr;
+  }
+
+  // The buffers, allocated when first needed after a release. FFTW allocates
+  // them with the same SIMD alignment as those the plan was planned on.
+  void *
+  GetInput()
+  {
+    return AllocateIfNeeded(m_Input, m_InputSize);
+  }
+  void *
+  GetOutput()
+  {
+    return AllocateIfNeeded(m_Output, m_OutputSize);
+  }
+
+  void
+  DestroyPlan(bool lock) override
+  {
+    if (m_Plan != nullptr)
+    {
+      if (lock)
+      {
+        fftw::Proxy<TReal>::DestroyPlan(m_Plan);
+      }
+      else
+      {
+        FunctionsType::DestroyPlan(m_Plan);
+      }
+      m_Plan = nullptr;
+    }
+  }
+
+  typename FunctionsType::PlanType m_Plan{ nullptr };
+
+private:
+  static void *
+  AllocateIfNeeded(void *& buffer, SizeValueType size)
+  {
+    if (buffer == nullptr)
+    {
+      buffer = FunctionsType::Malloc(size);
+      if (buffer == nullptr)
+      {
+        itkGenericExceptionMacro("Cannot allocate " << size << " bytes for the buffer of a Fourier transform");
+      }
+    }
+    return buffer;
+  }
+};
+
+using PlanCacheEntryListType = std::list<std::unique_ptr<PlanCacheEntry>>;
+
+// Destroys the plans of entries, which are no longer cached.
+void
+DestroyEntries(PlanCacheEntryListType & entries)
+{
+  for (auto & entry : entries)
+  {
+    entry->DestroyPlan(true);
+  }
+  entries.clear();
+}
+} // namespace
+
+struct FFTWPlanCacheGlobals
+{
+  FFTWPlanCacheGlobals()
+  {
+    std::string envVar;
+    if (itksys::SystemTools::GetEnv("ITK_FFTW_PLAN_CACHE", envVar) && IsOff(envVar))
+    {
+      m_Enabled = false;
+    }
+  }
+
+  std::mutex    m_Mutex;
+  bool          m_Enabled{ true };
+  SizeValueType m_MaximumIdleBufferBytes{ SizeValueType{ 64 } * 1024 * 1024 };
+
+  // Idle entries, most recently used first. There are few of them, so they
+  // are searched linearly.
+  PlanCacheEntryListType m_IdleEntries;
+  SizeValueType          m_IdleBufferBytes{ 0 };
+
+  SizeValueType m_NumberOfHits{ 0 };
+  SizeValueType m_NumberOfMisses{ 0 };
+  double        m_PlanningTime{ 0.0 };
+
+  // Must be called with m_Mutex held. Frees the buffers of the least recently
+  // used idle entries while they exceed the maximum idle buffer bytes, and
+  // keeps their plans.
+  void
+  ReleaseBuffersToFit()
+  {
+    for (auto it = m_IdleEntries.rbegin(); it != m_IdleEntries.rend() && m_IdleBufferBytes > m_MaximumIdleBufferBytes;
+         ++it)
+    {
+      m_IdleBufferBytes -= (*it)->GetBufferSize();
+      (*it)->ReleaseBuffers();
+    }
+  }
+
+  // Plans key on newly allocated buffers, which are freed once planned.
+  template <typename TReal>
+  std::unique_ptr<PlanCacheEntry>
+  PlanEntry(const PlanKeyType & key, SizeValueType inputSize, SizeValueType outputSize)
+  {
+    using ProxyType = fftw::Proxy<TReal>;
+    using ComplexType = typename ProxyType::ComplexType;
+
+    auto entry = std::make_unique<TypedPlanCacheEntry<TReal>>();
+    entry->m_Key = key;
+    entry->m_InputSize = inputSize;
+    entry->m_OutputSize = outputSize;
+    entry->m_InputAlignment = FFTWFunctions<TReal>::AlignmentOf(entry->GetInput());
+    entry->m_OutputAlignment = FFTWFunctions<TReal>::AlignmentOf(entry->GetOutput());
+
+    const auto &       sizes = std::get<3>(key);
+    const int          rank = static_cast<int>(sizes.size());
+    const int          sign = std::get<2>(key);
+    const int          threads = std::get<4>(key);
+    const unsigned int flags = std::get<5>(key);
+    const auto         start = std::chrono::steady_clock::now();
+    // The buffers are only meant for planning, which may overwrite them.
+    switch (std::get<1>(key))
+    {
+      case TransformKind::RealToComplex:
+        entry->m_Plan = ProxyType::Plan_dft_r2c(rank,
+                                                sizes.data(),
+                                                static_cast<TReal *>(entry->m_Input),
+                                                static_cast<ComplexType *>(entry->m_Output),
+                                                flags,
+                                                threads,
+                                                true);
+        break;
+      case TransformKind::ComplexToReal:
+        entry->m_Plan = ProxyType::Plan_dft_c2r(rank,
+                                                sizes.data(),
+                                                static_cast<ComplexType *>(entry->m_Input),
+                                                static_cast<TReal *>(entry->m_Output),
+                                                flags,
+                                                threads,
+                                                true);
+        break;
+      case TransformKind::ComplexToComplex:
+        entry->m_Plan = ProxyType::Plan_dft(rank,
+                                            sizes.data(),
+                                            static_cast<ComplexType *>(entry->m_Input),
+                                            static_cast<ComplexType *>(entry->m_Output),
+                                            sign,
+                                            flags,
+                                            threads,
+                                            true);
+        break;
+    }
+    const std::chrono::duration<double> planningTime = std::chrono::steady_clock::now() - start;
+    {
+      const std::lock_guard<std::mutex> lockGuard(m_Mutex);
+      m_PlanningTime += planningTime.count();
+    }
+
+    entry->ReleaseBuffers();
+
+    FFTWGlobalConfiguration::WriteNewWisdomToCache();
+    return entry;
+  }
+
+  template <typename TReal>
+  bool
+  Execute(TransformKind kind,
+          int           rank,
+          const int *   n,
+          void *        in,
+          void *        out,
+          int           sign,
+          unsigned int  flags,
+          int           threads,
+          bool          canDestroyInput)
+  {
+    using FunctionsType = FFTWFunctions<TReal>;
+    using ComplexType = typename FunctionsType::ComplexType;
+
+    SizeValueType numberOfPixels = 1;
+    for (int i = 0; i < rank; ++i)
+    {
+      numberOfPixels *= n[i];
+    }
+    // The complex half of a real transform.
+    const SizeValueType numberOfHalfPixels = numberOfPixels / n[rank - 1] * (n[rank - 1] / 2 + 1);
+    SizeValueType       inputSize = numberOfPixels * sizeof(ComplexType);
+    SizeValueType       outputSize = inputSize;
+    if (kind == TransformKind::RealToComplex)
+    {
+      inputSize = numberOfPixels * sizeof(TReal);
+      outputSize = numberOfHalfPixels * sizeof(ComplexType);
+    }
+    else if (kind == TransformKind::ComplexToReal)
+    {
+      inputSize = numberOfHalfPixels * sizeof(ComplexType);
+      outputSize = numberOfPixels * sizeof(TReal);
+    }
+    const PlanKeyType key(sizeof(TReal), kind, sign, std::vector<int>(n, n + rank), threads, flags);
+
+    std::unique_ptr<PlanCacheEntry> entry;
+    {
+      const std::lock_guard<std::mutex> lockGuard(m_Mutex);
+      if (!m_Enabled)
+      {
+        return false;
+      }
+      for (auto it = m_IdleEntries.begin(); it != m_IdleEntries.end(); ++it)
+      {
+        if ((*it)->m_Key == key)
+        {
+          entry = std::move(*it);
+          m_IdleEntries.erase(it);
+          m_IdleBufferBytes -= entry->GetBufferSize();
+          break;
+        }
+      }
+      if (entry)
+      {
+        ++m_NumberOfHits;
+      }
+      else
+      {
+        ++m_NumberOfMisses;
+      }
+    }
+    if (!entry)
+    {
+      // Planned without m_Mutex, so that transforms of other keys do not wait.
+      entry = this->PlanEntry<TReal>(key, inputSize, outputSize);
+    }
+
+    // The plan runs on arrays of the same alignment as the buffers it was
+    // planned on, and out of place.
+    auto & typedEntry = static_cast<TypedPlanCacheEntry<TReal> &>(*entry);
+    void * executeInput = in;
+    if (in == out || (kind == TransformKind::ComplexToReal && !canDestroyInput) ||
+        FunctionsType::AlignmentOf(in) != typedEntry.m_InputAlignment)
+    {
+      executeInput = typedEntry.GetInput();
+      std::memcpy(executeInput, in, inputSize);
+    }
+    void * executeOutput = out;
+    if (in == out || FunctionsType::AlignmentOf(out) != typedEntry.m_OutputAlignment)
+    {
+      executeOutput = typedEntry.GetOutput();
+    }
+    FunctionsType::Execute(kind, typedEntry.m_Plan, executeInput, executeOutput);
+    if (executeOutput != out)
+    {
+      std::memcpy(out, executeOutput, outputSize);
+    }
+
+    const std::lock_guard<std::mutex> lockGuard(m_Mutex);
+    m_IdleBufferBytes += entry->GetBufferSize();
+    m_IdleEntries.push_front(std::move(entry));
+    this->ReleaseBuffersToFit();
+    return true;
+  }
+};
+
+itkGetGlobalSimpleMacro(FFTWPlanCache, FFTWPlanCacheGlobals, PimplGlobals);
+
+FFTWPlanCacheGlobals * FFTWPlanCache::m_PimplGlobals;
+
+void
+FFTWPlanCache::SetEnabled(bool enabled)
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
+  m_PimplGlobals->m_Enabled = enabled;
+}
+
+bool
+FFTWPlanCache::GetEnabled()
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
+  return m_PimplGlobals->m_Enabled;
+}
+
+void
+FFTWPlanCache::SetMaximumIdleBufferBytes(SizeValueType maximumIdleBufferBytes)
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
+  m_PimplGlobals->m_MaximumIdleBufferBytes = maximumIdleBufferBytes;
+  m_PimplGlobals->ReleaseBuffersToFit();
+}
+
+SizeValueType
+FFTWPlanCache::GetMaximumIdleBufferBytes()
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
+  return m_PimplGlobals->m_MaximumIdleBufferBytes;
+}
+
+#  if defined(ITK_USE_FFTWF)
+bool
+FFTWPlanCache::Execute_dft_r2c(int             rank,
+                               const int *     n,
+                               float *         in,
+                               fftwf_complex * out,
+                               unsigned int    flags,
+                               int             threads)
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  return m_PimplGlobals->Execute<float>(TransformKind::RealToComplex, rank, n, in, out, 0, flags, threads, false);
+}
+
+bool
+FFTWPlanCache::Execute_dft_c2r(int             rank,
+                               const int *     n,
+                               fftwf_complex * in,
+                               float *         out,
+                               unsigned int    flags,
+                               int             threads,
+                               bool            canDestroyInput)
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  return m_PimplGlobals->Execute<float>(
+    TransformKind::ComplexToReal, rank, n, in, out, 0, flags, threads, canDestroyInput);
+}
+
+bool
+FFTWPlanCache::Execute_dft(int             rank,
+                           const int *     n,
+                           fftwf_complex * in,
+                           fftwf_complex * out,
+                           int             sign,
+                           unsigned int    flags,
+                           int             threads)
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  return m_PimplGlobals->Execute<float>(TransformKind::ComplexToComplex, rank, n, in, out, sign, flags, threads, false);
+}
+#  endif
+
+#  if defined(ITK_USE_FFTWD)
+bool
+FFTWPlanCache::Execute_dft_r2c(int            rank,
+                               const int *    n,
+                               double *       in,
+                               fftw_complex * out,
+                               unsigned int   flags,
+                               int            threads)
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  return m_PimplGlobals->Execute<double>(TransformKind::RealToComplex, rank, n, in, out, 0, flags, threads, false);
+}
+
+bool
+FFTWPlanCache::Execute_dft_c2r(int            rank,
+                               const int *    n,
+                               fftw_complex * in,
+                               double *       out,
+                               unsigned int   flags,
+                               int            threads,
+                               bool           canDestroyInput)
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  return m_PimplGlobals->Execute<double>(
+    TransformKind::ComplexToReal, rank, n, in, out, 0, flags, threads, canDestroyInput);
+}
+
+bool
+FFTWPlanCache::Execute_dft(int            rank,
+                           const int *    n,
+                           fftw_complex * in,
+                           fftw_complex * out,
+                           int            sign,
+                           unsigned int   flags,
+                           int            threads)
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  return m_PimplGlobals->Execute<double>(
+    TransformKind::ComplexToComplex, rank, n, in, out, sign, flags, threads, false);
+}
+#  endif
+
+SizeValueType
+FFTWPlanCache::GetNumberOfHits()
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
+  return m_PimplGlobals->m_NumberOfHits;
+}
+
+SizeValueType
+FFTWPlanCache::GetNumberOfMisses()
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
+  return m_PimplGlobals->m_NumberOfMisses;
+}
+
+double
+FFTWPlanCache::GetPlanningTime()
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
+  return m_PimplGlobals->m_PlanningTime;
+}
+
+void
+FFTWPlanCache::ResetStatistics()
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
+  m_PimplGlobals->m_NumberOfHits = 0;
+  m_PimplGlobals->m_NumberOfMisses = 0;
+  m_PimplGlobals->m_PlanningTime = 0.0;
+}
+
+SizeValueType
+FFTWPlanCache::GetNumberOfCachedPlans()
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
+  return static_cast<SizeValueType>(m_PimplGlobals->m_IdleEntries.size());
+}
+
+SizeValueType
+FFTWPlanCache::GetIdleBufferBytes()
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
+  return m_PimplGlobals->m_IdleBufferBytes;
+}
+
+void
+FFTWPlanCache::ReleaseBuffers()
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
+  for (auto & entry : m_PimplGlobals->m_IdleEntries)
+  {
+    entry->ReleaseBuffers();
+  }
+  m_PimplGlobals->m_IdleBufferBytes = 0;
+}
+
+void
+FFTWPlanCache::Clear()
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  PlanCacheEntryListType evicted;
+  {
+    const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
+    evicted.swap(m_PimplGlobals->m_IdleEntries);
+    m_PimplGlobals->m_IdleBufferBytes = 0;
+  }
+  DestroyEntries(evicted);
+}
+
+void
+FFTWPlanCache::PrintStatistics(std::ostream & os)
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
+  os << "FFTW plan cache: " << m_PimplGlobals->m_NumberOfHits << " hits, " << m_PimplGlobals->m_NumberOfMisses
+     << " misses, " << m_PimplGlobals->m_PlanningTime << " s of planning, " << m_PimplGlobals->m_IdleEntries.size()
+     << " cached plans with " << m_PimplGlobals->m_IdleBufferBytes << " bytes of buffers" << std::endl;
+}
+
+void
+FFTWPlanCache::ReleasePlansAtExit()
+{
+  // Nothing was cached if the globals were never initialized.
+  if (m_PimplGlobals == nullptr)
+  {
+    return;
+  }
+  const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
+  for (auto & entry : m_PimplGlobals->m_IdleEntries)
+  {
+    entry->DestroyPlan(false);
+  }
+  m_PimplGlobals->m_IdleEntries.clear();
+  m_PimplGlobals->m_IdleBufferBytes = 0;
+}
+
+} // end namespace itk
+
+#endif
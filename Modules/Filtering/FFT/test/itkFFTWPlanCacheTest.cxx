@@ -0,0 +1,238 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkFFTWPlanCache.h"
+#include "itkFFTWComplexToComplexFFTImageFilter.h"
+#include "itkFFTWForwardFFTImageFilter.h"
+#include "itkFFTWHalfHermitianToRealInverseFFTImageFilter.h"
+#include "itkFFTWInverseFFTImageFilter.h"
+#include "itkFFTWRealToHalfHermitianForwardFFTImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIterator.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkTestingMacros.h"
+#include "itksys/SystemTools.hxx"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+/*
+ * Transforms a 3D image back and forth with the FFTW filters, and checks that
+ * the plans are cached across filter instances and filter classes, that the
+ * cached transforms compute what the uncached ones do, that the wisdom is
+ * written to the cache file after planning, and that the cache may be used
+ * from several threads, limited in memory, disabled, have its buffers
+ * released and be cleared.
+ */
+
+namespace
+{
+#if defined(ITK_USE_FFTWD)
+using RealType = double;
+#else
+using RealType = float;
+#endif
+constexpr unsigned int Dimension = 3;
+using ImageType = itk::Image<RealType, Dimension>;
+using ComplexImageType = itk::Image<std::complex<RealType>, Dimension>;
+using SizeValueType = itk::SizeValueType;
+
+ImageType::Pointer
+MakeNoiseImage()
+{
+  auto image = ImageType::New();
+  image->SetRegions(itk::MakeSize(21, 16, 9));
+  image->Allocate();
+  auto generator = itk::Statistics::MersenneTwisterRandomVariateGenerator::New();
+  generator->Initialize(20240722);
+  for (itk::ImageRegionIterator<ImageType> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    it.Set(static_cast<RealType>(generator->GetUniformVariate(0.0, 1.0)));
+  }
+  return image;
+}
+
+// Transforms image to the half spectrum and back.
+ImageType::Pointer
+HalfRoundTrip(const ImageType * image)
+{
+  auto forward = itk::FFTWRealToHalfHermitianForwardFFTImageFilter<ImageType, ComplexImageType>::New();
+  forward->SetInput(image);
+  auto inverse = itk::FFTWHalfHermitianToRealInverseFFTImageFilter<ComplexImageType, ImageType>::New();
+  inverse->SetInput(forward->GetOutput());
+  inverse->SetActualXDimensionIsOdd(image->GetLargestPossibleRegion().GetSize(0) % 2 != 0);
+  inverse->Update();
+  return inverse->GetOutput();
+}
+
+// Transforms image to the full spectrum, forward and backward again through
+// the complex to complex transform, and back.
+ImageType::Pointer
+FullRoundTrip(const ImageType * image)
+{
+  using ComplexFilterType = itk::FFTWComplexToComplexFFTImageFilter<ComplexImageType>;
+  auto forward = itk::FFTWForwardFFTImageFilter<ImageType, ComplexImageType>::New();
+  forward->SetInput(image);
+  auto complexInverse = ComplexFilterType::New();
+  complexInverse->SetInput(forward->GetOutput());
+  complexInverse->SetTransformDirection(ComplexFilterType::TransformDirectionEnum::INVERSE);
+  auto complexForward = ComplexFilterType::New();
+  complexForward->SetInput(complexInverse->GetOutput());
+  complexForward->SetTransformDirection(ComplexFilterType::TransformDirectionEnum::FORWARD);
+  auto inverse = itk::FFTWInverseFFTImageFilter<ComplexImageType, ImageType>::New();
+  inverse->SetInput(complexForward->GetOutput());
+  inverse->Update();
+  return inverse->GetOutput();
+}
+
+double
+MaximumDifference(const ImageType * output, const ImageType * reference)
+{
+  double                                   maximumDifference = 0.0;
+  itk::ImageRegionConstIterator<ImageType> outputIt(output, output->GetBufferedRegion());
+  for (itk::ImageRegionConstIterator<ImageType> it(reference, reference->GetBufferedRegion()); !it.IsAtEnd();
+       ++it, ++outputIt)
+  {
+    maximumDifference = std::max(maximumDifference, std::abs(static_cast<double>(outputIt.Get() - it.Get())));
+  }
+  return maximumDifference;
+}
+} // namespace
+
+int
+itkFFTWPlanCacheTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " wisdomCacheFile" << std::endl;
+    return EXIT_FAILURE;
+  }
+#if defined(ITK_USE_FFTWD)
+  const std::string wisdomFile = argv[1];
+#else
+  const std::string wisdomFile = std::string(argv[1]) + "f";
+#endif
+  itksys::SystemTools::RemoveFile(wisdomFile);
+
+  using PlanCache = itk::FFTWPlanCache;
+  ITK_TEST_EXPECT_TRUE(PlanCache::GetEnabled());
+  ITK_TEST_SET_GET_VALUE(SizeValueType{ 64 } * 1024 * 1024, PlanCache::GetMaximumIdleBufferBytes());
+  PlanCache::Clear();
+  PlanCache::ResetStatistics();
+  constexpr double tolerance = 1e-5;
+
+  // The first round trip plans both transforms; the wisdom of the planner
+  // rigor set by the test environment is written at once.
+  const auto image = MakeNoiseImage();
+  const auto halfRoundTrip = HalfRoundTrip(image);
+  PlanCache::PrintStatistics(std::cout);
+  ITK_TEST_EXPECT_EQUAL(PlanCache::GetNumberOfHits(), 0);
+  ITK_TEST_EXPECT_EQUAL(PlanCache::GetNumberOfMisses(), 2);
+  ITK_TEST_EXPECT_EQUAL(PlanCache::GetNumberOfCachedPlans(), 2);
+  ITK_TEST_EXPECT_TRUE(PlanCache::GetIdleBufferBytes() <= PlanCache::GetMaximumIdleBufferBytes());
+  ITK_TEST_EXPECT_TRUE(PlanCache::GetPlanningTime() >= 0.0);
+  ITK_TEST_EXPECT_TRUE(MaximumDifference(halfRoundTrip, image) < tolerance);
+  ITK_TEST_EXPECT_TRUE(itksys::SystemTools::FileExists(wisdomFile));
+  ITK_TEST_EXPECT_TRUE(!itk::FFTWGlobalConfiguration::GetNewWisdomAvailable());
+
+  // New filter instances, and the full spectrum filters, reuse the plans.
+  ITK_TEST_EXPECT_TRUE(MaximumDifference(HalfRoundTrip(image), halfRoundTrip) < tolerance);
+  ITK_TEST_EXPECT_EQUAL(PlanCache::GetNumberOfHits(), 2);
+  ITK_TEST_EXPECT_EQUAL(PlanCache::GetNumberOfMisses(), 2);
+  const auto fullRoundTrip = FullRoundTrip(image);
+  PlanCache::PrintStatistics(std::cout);
+  ITK_TEST_EXPECT_EQUAL(PlanCache::GetNumberOfHits(), 4);
+  ITK_TEST_EXPECT_EQUAL(PlanCache::GetNumberOfMisses(), 4);
+  ITK_TEST_EXPECT_EQUAL(PlanCache::GetNumberOfCachedPlans(), 4);
+  ITK_TEST_EXPECT_TRUE(MaximumDifference(fullRoundTrip, image) < tolerance);
+
+  // Concurrent transforms plan their own when the cached ones are in use.
+  // Each thread has its own input, since pipelines must not share one.
+  constexpr unsigned int          numberOfThreads = 4;
+  std::vector<ImageType::Pointer> threadOutputs(numberOfThreads);
+  std::vector<std::thread>        threads;
+  for (unsigned int i = 0; i < numberOfThreads; ++i)
+  {
+    threads.emplace_back([&threadOutputs, i] {
+      const auto threadImage = MakeNoiseImage();
+      for (unsigned int j = 0; j < 5; ++j)
+      {
+        threadOutputs[i] = HalfRoundTrip(threadImage);
+      }
+    });
+  }
+  for (auto & thread : threads)
+  {
+    thread.join();
+  }
+  PlanCache::PrintStatistics(std::cout);
+  for (const auto & output : threadOutputs)
+  {
+    ITK_TEST_EXPECT_TRUE(MaximumDifference(output, halfRoundTrip) < tolerance);
+  }
+  ITK_TEST_EXPECT_EQUAL(PlanCache::GetNumberOfHits() + PlanCache::GetNumberOfMisses(), 8 + 2 * 5 * numberOfThreads);
+  ITK_TEST_EXPECT_TRUE(PlanCache::GetNumberOfCachedPlans() <= 4 + 2 * numberOfThreads);
+
+  // Transforms whose buffers do not fit in the maximum memory size are still
+  // cached, with their buffers freed.
+  PlanCache::ResetStatistics();
+  const SizeValueType numberOfCachedPlans = PlanCache::GetNumberOfCachedPlans();
+  PlanCache::SetMaximumIdleBufferBytes(0);
+  ITK_TEST_SET_GET_VALUE(0, PlanCache::GetMaximumIdleBufferBytes());
+  ITK_TEST_EXPECT_EQUAL(PlanCache::GetNumberOfCachedPlans(), numberOfCachedPlans);
+  ITK_TEST_EXPECT_EQUAL(PlanCache::GetIdleBufferBytes(), 0);
+  ITK_TEST_EXPECT_TRUE(MaximumDifference(HalfRoundTrip(image), halfRoundTrip) < tolerance);
+  ITK_TEST_EXPECT_EQUAL(PlanCache::GetNumberOfHits(), 2);
+  ITK_TEST_EXPECT_EQUAL(PlanCache::GetNumberOfMisses(), 0);
+  ITK_TEST_EXPECT_EQUAL(PlanCache::GetNumberOfCachedPlans(), numberOfCachedPlans);
+  ITK_TEST_EXPECT_EQUAL(PlanCache::GetIdleBufferBytes(), 0);
+  PlanCache::SetMaximumIdleBufferBytes(SizeValueType{ 64 } * 1024 * 1024);
+
+  // With the cache disabled, the transforms are computed by the filters as
+  // before.
+  PlanCache::Clear();
+  PlanCache::ResetStatistics();
+  PlanCache::SetEnabled(false);
+  ITK_TEST_EXPECT_TRUE(!PlanCache::GetEnabled());
+  ITK_TEST_EXPECT_TRUE(MaximumDifference(FullRoundTrip(image), fullRoundTrip) < tolerance);
+  ITK_TEST_EXPECT_EQUAL(PlanCache::GetNumberOfHits(), 0);
+  ITK_TEST_EXPECT_EQUAL(PlanCache::GetNumberOfMisses(), 0);
+  ITK_TEST_EXPECT_EQUAL(PlanCache::GetNumberOfCachedPlans(), 0);
+
+  PlanCache::SetEnabled(true);
+  HalfRoundTrip(image);
+  ITK_TEST_EXPECT_EQUAL(PlanCache::GetNumberOfCachedPlans(), 2);
+
+  // Released buffers are allocated again when the plans need them.
+  PlanCache::ReleaseBuffers();
+  ITK_TEST_EXPECT_EQUAL(PlanCache::GetNumberOfCachedPlans(), 2);
+  ITK_TEST_EXPECT_EQUAL(PlanCache::GetIdleBufferBytes(), 0);
+  ITK_TEST_EXPECT_TRUE(MaximumDifference(HalfRoundTrip(image), halfRoundTrip) < tolerance);
+  ITK_TEST_EXPECT_EQUAL(PlanCache::GetNumberOfHits(), 2);
+  ITK_TEST_EXPECT_EQUAL(PlanCache::GetNumberOfMisses(), 2);
+
+  PlanCache::Clear();
+  ITK_TEST_EXPECT_EQUAL(PlanCache::GetNumberOfCachedPlans(), 0);
+  ITK_TEST_EXPECT_EQUAL(PlanCache::GetIdleBufferBytes(), 0);
+  PlanCache::PrintStatistics(std::cout);
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
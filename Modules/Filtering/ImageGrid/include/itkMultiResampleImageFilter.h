@@ -0,0 +1,189 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkMultiResampleImageFilter_h
+#define itkMultiResampleImageFilter_h
+
+#include "itkTransform.h"
+#include "itkImageToImageFilter.h"
+#include "itkLinearInterpolateImageFunction.h"
+#include "itkDataObjectDecorator.h"
+
+#include <vector>
+
+namespace itk
+{
+/**
+ * \class MultiResampleImageFilter
+ * \brief Resample several images through the same coordinate transform in
+ * one pass
+ *
+ * MultiResampleImageFilter resamples each of its inputs onto the grid of the
+ * reference image, as a ResampleImageFilter per input would, and produces
+ * output i from input i. The transform maps each output point once, and the
+ * mapped point is then interpolated in every input. This saves evaluating an
+ * expensive transform, such as a CompositeTransform holding a displacement
+ * field, once per input.
+ *
+ * Each input has its own interpolator, set with SetInterpolator(i, ...). The
+ * default is LinearInterpolateImageFunction. NearestNeighbor or
+ * LabelImageGaussian interpolators suit masks and label maps. Each input
+ * needs a distinct interpolator object.
+ *
+ * The inputs may have different grids, but must be of scalar pixel type.
+ * Output pixels that map outside an input get the DefaultPixelValue. The
+ * whole of each input is requested.
+ *
+ * \warning For multithreading, the TransformPoints method of the
+ * transform must be threadsafe.
+ *
+ * \sa ResampleImageFilter
+ *
+ * \ingroup GeometricTransform
+ * \ingroup ITKImageGrid
+ */
+template <typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType = double,
+          typename TTransformPrecisionType = TInterpolatorPrecisionType>
+class ITK_TEMPLATE_EXPORT MultiResampleImageFilter : public ImageToImageFilter<TInputImage, TOutputImage>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(MultiResampleImageFilter);
+
+  /** Standard class type aliases. */
+  using Self = MultiResampleImageFilter;
+  using Superclass = ImageToImageFilter<TInputImage, TOutputImage>;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  using InputImageType = TInputImage;
+  using OutputImageType = TOutputImage;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** \see LightObject::GetNameOfClass() */
+  itkOverrideGetNameOfClassMacro(MultiResampleImageFilter);
+
+  /** Number of dimensions of the output image. */
+  static constexpr unsigned int OutputImageDimension = TOutputImage::ImageDimension;
+
+  /** Number of dimensions of the input image. */
+  static constexpr unsigned int InputImageDimension = TInputImage::ImageDimension;
+
+  /** Transform type alias. */
+  using TransformType = Transform<TTransformPrecisionType, Self::OutputImageDimension, Self::InputImageDimension>;
+
+  /** Interpolator type alias. */
+  using InterpolatorType = InterpolateImageFunction<InputImageType, TInterpolatorPrecisionType>;
+  using InterpolatorPointerType = typename InterpolatorType::Pointer;
+  using InterpolatorOutputType = typename InterpolatorType::OutputType;
+  using LinearInterpolatorType = LinearInterpolateImageFunction<InputImageType, TInterpolatorPrecisionType>;
+
+  /** Image index, point and pixel type alias. */
+  using IndexType = typename TOutputImage::IndexType;
+  using IndexValueType = typename TOutputImage::IndexValueType;
+  using InputPointType = typename InterpolatorType::PointType;
+  using OutputPointType = typename TOutputImage::PointType;
+  using PixelType = typename TOutputImage::PixelType;
+  using ContinuousInputIndexType = ContinuousIndex<TInterpolatorPrecisionType, InputImageDimension>;
+  using OutputImageRegionType = typename TOutputImage::RegionType;
+
+  /** The reference image defines the output grid. */
+  using ReferenceImageBaseType = ImageBase<OutputImageDimension>;
+
+  /** Get/Set the coordinate transformation. As for ResampleImageFilter, it
+   * maps output points to input points. The default is the identity. */
+  itkSetGetDecoratedObjectInputMacro(Transform, TransformType);
+
+  /** Set the input image at index, and create the output at index, along
+   * with a linear interpolator if the input has none yet. */
+  using Superclass::SetInput;
+  void
+  SetInput(unsigned int index, const InputImageType * image) override;
+
+  /** Get/Set the interpolator of the input at index. */
+  void
+  SetInterpolator(unsigned int index, InterpolatorType * interpolator);
+  InterpolatorType *
+  GetInterpolator(unsigned int index) const;
+
+  /** Get/Set the pixel value when a transformed pixel is outside of an
+   * input. The default is 0. */
+  itkSetMacro(DefaultPixelValue, PixelType);
+  itkGetConstReferenceMacro(DefaultPixelValue, PixelType);
+
+  /** Set/Get the image whose largest possible region, spacing, origin and
+   * direction define the outputs. */
+  itkSetInputMacro(ReferenceImage, ReferenceImageBaseType);
+  itkGetInputMacro(ReferenceImage, ReferenceImageBaseType);
+
+  /** The inputs must have scalar pixels. */
+  itkConceptMacro(InputPixelIsScalarCheck, (Concept::IsFloatingPoint<InterpolatorOutputType>));
+
+  /** The modified time includes that of the interpolators. */
+  ModifiedTimeType
+  GetMTime() const override;
+
+protected:
+  MultiResampleImageFilter();
+  ~MultiResampleImageFilter() override = default;
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+  /** The inputs do not need to occupy the same physical space. */
+  void
+  VerifyInputInformation() const override
+  {}
+
+  /** Checks that each input has its own interpolator. */
+  void
+  VerifyPreconditions() const override;
+
+  /** The outputs have the grid of the reference image. */
+  void
+  GenerateOutputInformation() override;
+
+  /** The whole of each input is requested, and connected to its
+   * interpolator. */
+  void
+  GenerateInputRequestedRegion() override;
+
+  /** Disconnects the interpolators from the inputs. */
+  void
+  AfterThreadedGenerateData() override;
+
+  /** Maps the points of each scanline through the transform once, and
+   * interpolates all the inputs at the mapped points. */
+  void
+  DynamicThreadedGenerateData(const OutputImageRegionType & outputRegionForThread) override;
+
+private:
+  static PixelType
+  CastWithBoundsChecking(const InterpolatorOutputType value);
+
+  std::vector<InterpolatorPointerType> m_Interpolators{};
+  PixelType                            m_DefaultPixelValue{};
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkMultiResampleImageFilter.hxx"
+#endif
+
+#endif
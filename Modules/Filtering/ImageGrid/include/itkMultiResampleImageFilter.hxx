@@ -0,0 +1,423 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkMultiResampleImageFilter_hxx
+#define itkMultiResampleImageFilter_hxx
+
+#include "itkIdentityTransform.h"
+#include "itkTotalProgressReporter.h"
+#include "itkImageScanlineIterator.h"
+
+#include <algorithm>   // For max.
+#include <memory>      // For unique_ptr.
+#include <type_traits> // For is_same.
+#include <vector>
+
+namespace itk
+{
+
+template <typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType,
+          typename TTransformPrecisionType>
+MultiResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType>::
+  MultiResampleImageFilter()
+{
+  // Pipeline input configuration
+
+  // implicit:
+  // #0 "Primary" required
+  // #1..#n further images, each with its own output
+
+  // "ReferenceImage" required ( not numbered )
+  Self::AddRequiredInputName("ReferenceImage");
+
+  // "Transform" required ( not numbered )
+  Self::AddRequiredInputName("Transform");
+  if constexpr (InputImageDimension == OutputImageDimension)
+  {
+    using DecoratorType = DataObjectDecorator<TransformType>;
+    auto decoratedInput = DecoratorType::New();
+    decoratedInput->Set(IdentityTransform<TTransformPrecisionType, OutputImageDimension>::New());
+    this->ProcessObject::SetInput("Transform", decoratedInput);
+  }
+
+  m_Interpolators.push_back(LinearInterpolatorType::New().GetPointer());
+
+  this->DynamicMultiThreadingOn();
+}
+
+template <typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType,
+          typename TTransformPrecisionType>
+void
+MultiResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType>::SetInput(
+  unsigned int           index,
+  const InputImageType * image)
+{
+  Superclass::SetInput(index, image);
+
+  while (m_Interpolators.size() <= index)
+  {
+    m_Interpolators.push_back(LinearInterpolatorType::New().GetPointer());
+  }
+
+  // Each input has an output of its own.
+  if (this->GetNumberOfRequiredOutputs() <= index)
+  {
+    this->SetNumberOfRequiredOutputs(index + 1);
+  }
+  for (auto i = this->GetNumberOfIndexedOutputs(); i <= index; ++i)
+  {
+    this->SetNthOutput(i, this->MakeOutput(i));
+  }
+}
+
+template <typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType,
+          typename TTransformPrecisionType>
+void
+MultiResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType>::
+  SetInterpolator(unsigned int index, InterpolatorType * interpolator)
+{
+  if (m_Interpolators.size() <= index)
+  {
+    m_Interpolators.resize(index + 1);
+  }
+  if (m_Interpolators[index] != interpolator)
+  {
+    m_Interpolators[index] = interpolator;
+    this->Modified();
+  }
+}
+
+template <typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType,
+          typename TTransformPrecisionType>
+auto
+MultiResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType>::
+  GetInterpolator(unsigned int index) const -> InterpolatorType *
+{
+  return (index < m_Interpolators.size()) ? m_Interpolators[index].GetPointer() : nullptr;
+}
+
+template <typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType,
+          typename TTransformPrecisionType>
+auto
+MultiResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType>::
+  CastWithBoundsChecking(const InterpolatorOutputType value) -> PixelType
+{
+  if constexpr (std::is_same_v<PixelType, InterpolatorOutputType>)
+  {
+    return value;
+  }
+  else
+  {
+    // Clamp the value between the minimum and maximum of the pixel type, as
+    // ResampleImageFilter does.
+    constexpr auto minPixelValue = NumericTraits<PixelType>::NonpositiveMin();
+    constexpr auto maxPixelValue = NumericTraits<PixelType>::max();
+    constexpr auto minValue = static_cast<InterpolatorOutputType>(minPixelValue);
+    constexpr auto maxValue = static_cast<InterpolatorOutputType>(maxPixelValue);
+
+    return (value <= minValue) ? minPixelValue : (value >= maxValue) ? maxPixelValue : static_cast<PixelType>(value);
+  }
+}
+
+template <typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType,
+          typename TTransformPrecisionType>
+void
+MultiResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType>::
+  VerifyPreconditions() const
+{
+  Superclass::VerifyPreconditions();
+
+  const unsigned int numberOfImages = this->GetNumberOfIndexedInputs();
+  for (unsigned int k = 0; k < numberOfImages; ++k)
+  {
+    if (this->GetInput(k) == nullptr)
+    {
+      itkExceptionMacro("Input " << k << " is required but not set.");
+    }
+    const InterpolatorType * interpolator = this->GetInterpolator(k);
+    if (interpolator == nullptr)
+    {
+      itkExceptionMacro("Interpolator " << k << " not set");
+    }
+    for (unsigned int j = 0; j < k; ++j)
+    {
+      if (m_Interpolators[j] == interpolator)
+      {
+        itkExceptionMacro("Inputs " << j << " and " << k << " share the same interpolator");
+      }
+    }
+  }
+}
+
+template <typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType,
+          typename TTransformPrecisionType>
+void
+MultiResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType>::
+  GenerateOutputInformation()
+{
+  // Call the superclass' implementation of this method
+  Superclass::GenerateOutputInformation();
+
+  const ReferenceImageBaseType * referenceImage = this->GetReferenceImage();
+
+  const unsigned int numberOfOutputs = this->GetNumberOfIndexedOutputs();
+  for (unsigned int k = 0; k < numberOfOutputs; ++k)
+  {
+    OutputImageType * output = this->GetOutput(k);
+    if (output == nullptr)
+    {
+      continue;
+    }
+    output->SetLargestPossibleRegion(referenceImage->GetLargestPossibleRegion());
+    output->SetSpacing(referenceImage->GetSpacing());
+    output->SetOrigin(referenceImage->GetOrigin());
+    output->SetDirection(referenceImage->GetDirection());
+  }
+}
+
+template <typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType,
+          typename TTransformPrecisionType>
+void
+MultiResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType>::
+  GenerateInputRequestedRegion()
+{
+  // The requested region of the reference image is left alone, as only its
+  // information is used.
+  const unsigned int numberOfImages = this->GetNumberOfIndexedInputs();
+  for (unsigned int k = 0; k < numberOfImages; ++k)
+  {
+    auto * input = const_cast<InputImageType *>(this->GetInput(k));
+    input->SetRequestedRegionToLargestPossibleRegion();
+
+    // Some interpolators need to look at their images in GetRadius()
+    m_Interpolators[k]->SetInputImage(input);
+  }
+}
+
+template <typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType,
+          typename TTransformPrecisionType>
+void
+MultiResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType>::
+  AfterThreadedGenerateData()
+{
+  // Disconnect input images from the interpolators
+  for (const auto & interpolator : m_Interpolators)
+  {
+    if (interpolator)
+    {
+      interpolator->SetInputImage(nullptr);
+    }
+  }
+}
+
+template <typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType,
+          typename TTransformPrecisionType>
+void
+MultiResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType>::
+  DynamicThreadedGenerateData(const OutputImageRegionType & outputRegionForThread)
+{
+  using TransformOutputPointType = typename TransformType::OutputPointType;
+
+  const OutputImageType * firstOutput = this->GetOutput(0);
+  const TransformType *   transformPtr = this->GetTransform();
+  const unsigned int      numberOfImages = this->GetNumberOfIndexedInputs();
+
+  TotalProgressReporter progress(this, firstOutput->GetRequestedRegion().GetNumberOfPixels());
+
+  // A linear transform maps each scanline to a line in every input, which is
+  // traced from its mapped end points as in ResampleImageFilter, so that the
+  // outputs match the outputs of ResampleImageFilter.
+  const bool isLinear = (transformPtr->GetTransformCategory() == TransformType::TransformCategoryEnum::Linear);
+
+  const OutputImageRegionType & largestPossibleRegion = firstOutput->GetLargestPossibleRegion();
+  const auto firstIndexValueOfLargestPossibleRegion = largestPossibleRegion.GetIndex(0);
+  const auto firstSizeValueOfLargestPossibleRegion = static_cast<double>(largestPossibleRegion.GetSize(0));
+
+  // The outputs have the same grid, so that their scanlines are walked in
+  // lockstep.
+  std::vector<ImageScanlineIterator<TOutputImage>> outputIterators;
+  outputIterators.reserve(numberOfImages);
+  for (unsigned int k = 0; k < numberOfImages; ++k)
+  {
+    outputIterators.emplace_back(this->GetOutput(k), outputRegionForThread);
+  }
+
+  const SizeValueType                                 lineLength = outputRegionForThread.GetSize(0);
+  std::vector<typename TransformType::InputPointType> outputPoints(lineLength);
+  std::vector<TransformOutputPointType>               transformedPoints(lineLength);
+  std::vector<ContinuousInputIndexType>               inputIndices(lineLength);
+  std::vector<InterpolatorOutputType>                 values(lineLength);
+  const auto                                          isInside = std::make_unique<bool[]>(lineLength);
+
+  while (!outputIterators[0].IsAtEnd())
+  {
+    // Map the scanline through the transform once, for all the inputs.
+    IndexType                index = outputIterators[0].GetIndex();
+    TransformOutputPointType lineStartPoint;
+    TransformOutputPointType lineEndPoint;
+    if (isLinear)
+    {
+      index[0] = firstIndexValueOfLargestPossibleRegion;
+      lineStartPoint = transformPtr->TransformPoint(firstOutput->template TransformIndexToPhysicalPoint<double>(index));
+      index[0] += firstSizeValueOfLargestPossibleRegion;
+      lineEndPoint = transformPtr->TransformPoint(firstOutput->template TransformIndexToPhysicalPoint<double>(index));
+    }
+    else
+    {
+      for (SizeValueType i = 0; i < lineLength; ++i, ++index[0])
+      {
+        OutputPointType outputPoint;
+        firstOutput->TransformIndexToPhysicalPoint(index, outputPoint);
+        outputPoints[i] = outputPoint;
+      }
+      transformPtr->TransformPoints(outputPoints.data(), transformedPoints.data(), lineLength);
+    }
+
+    for (unsigned int k = 0; k < numberOfImages; ++k)
+    {
+      const InputImageType *   inputPtr = this->GetInput(k);
+      const InterpolatorType * interpolator = m_Interpolators[k];
+
+      if (isLinear)
+      {
+        const ContinuousInputIndexType startIndex =
+          inputPtr->template TransformPhysicalPointToContinuousIndex<TInterpolatorPrecisionType>(lineStartPoint);
+        const auto vectorFromStartIndex =
+          inputPtr->template TransformPhysicalPointToContinuousIndex<TInterpolatorPrecisionType>(lineEndPoint) -
+          startIndex;
+
+        IndexValueType scanlineIndex = outputIterators[k].GetIndex()[0];
+        for (SizeValueType i = 0; i < lineLength; ++i, ++scanlineIndex)
+        {
+          const double alpha =
+            (scanlineIndex - firstIndexValueOfLargestPossibleRegion) / firstSizeValueOfLargestPossibleRegion;
+
+          ContinuousInputIndexType & inputIndex = inputIndices[i];
+          inputIndex = startIndex;
+          for (unsigned int d = 0; d < InputImageDimension; ++d)
+          {
+            inputIndex[d] += alpha * vectorFromStartIndex[d];
+          }
+          isInside[i] = interpolator->IsInsideBuffer(inputIndex);
+        }
+      }
+      else
+      {
+        for (SizeValueType i = 0; i < lineLength; ++i)
+        {
+          const InputPointType inputPoint = transformedPoints[i];
+          inputIndices[i] =
+            inputPtr->template TransformPhysicalPointToContinuousIndex<TInterpolatorPrecisionType>(inputPoint);
+          isInside[i] = interpolator->IsInsideBuffer(inputIndices[i]);
+        }
+      }
+
+      // Evaluate the runs of indices inside the input together.
+      auto &        outIt = outputIterators[k];
+      SizeValueType i = 0;
+      while (i < lineLength)
+      {
+        if (isInside[i])
+        {
+          SizeValueType endOfRun = i + 1;
+          while (endOfRun < lineLength && isInside[endOfRun])
+          {
+            ++endOfRun;
+          }
+          interpolator->EvaluateAtContinuousIndices(inputIndices.data() + i, values.data() + i, endOfRun - i);
+          for (; i < endOfRun; ++i, ++outIt)
+          {
+            outIt.Set(Self::CastWithBoundsChecking(values[i]));
+          }
+        }
+        else
+        {
+          outIt.Set(m_DefaultPixelValue);
+          ++i;
+          ++outIt;
+        }
+      }
+      outIt.NextLine();
+    }
+    progress.Completed(lineLength);
+  }
+}
+
+template <typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType,
+          typename TTransformPrecisionType>
+ModifiedTimeType
+MultiResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType>::GetMTime()
+  const
+{
+  ModifiedTimeType latestTime = Object::GetMTime();
+
+  for (const auto & interpolator : m_Interpolators)
+  {
+    if (interpolator)
+    {
+      latestTime = std::max(latestTime, interpolator->GetMTime());
+    }
+  }
+
+  return latestTime;
+}
+
+template <typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType,
+          typename TTransformPrecisionType>
+void
+MultiResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType>::PrintSelf(
+  std::ostream & os,
+  Indent         indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent
+     << "DefaultPixelValue: " << static_cast<typename NumericTraits<PixelType>::PrintType>(m_DefaultPixelValue)
+     << std::endl;
+  os << indent << "Transform: " << this->GetTransform() << std::endl;
+  for (unsigned int k = 0; k < m_Interpolators.size(); ++k)
+  {
+    os << indent << "Interpolator " << k << ": " << m_Interpolators[k].GetPointer() << std::endl;
+  }
+}
+} // end namespace itk
+
+#endif
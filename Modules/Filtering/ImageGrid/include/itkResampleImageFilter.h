@@ -362,6 +362,25 @@ private:
   static PixelType
   CastPixelWithBoundsChecking(const TPixel value);
 
+  /** Casts value into outputValue, which keeps its memory when it already has
+   * the number of components of value. Used for VariableLengthVector output
+   * pixels, so that they are not allocated for each pixel. */
+  template <typename TPixel>
+  static void
+  CastPixelWithBoundsChecking(const TPixel & value, PixelType & outputValue);
+
+  /** Sets the lineLength output pixels of a scanline, from the continuous
+   * indices in the input to which they are mapped. Each run of indices inside
+   * the buffer is evaluated by a single call to the interpolator, which lets
+   * it share work between neighboring indices. */
+  template <typename TOutputIterator>
+  void
+  SetScanlineFromContinuousIndices(TOutputIterator &                outIt,
+                                   const ContinuousInputIndexType * inputIndices,
+                                   const bool *                     isInside,
+                                   InterpolatorOutputType *         values,
+                                   SizeValueType                    lineLength) const;
+
   void
   InitializeTransform();
 
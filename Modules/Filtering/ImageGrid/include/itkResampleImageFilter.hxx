@@ -28,7 +28,9 @@
 #include "itkImageAlgorithm.h"
 
 #include <algorithm>   // For max.
+#include <memory>      // For unique_ptr.
 #include <type_traits> // For is_same.
+#include <vector>
 
 namespace itk
 {
@@ -362,6 +364,29 @@ ResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTran
 }
 
 
+template <typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType,
+          typename TTransformPrecisionType>
+template <typename TPixel>
+void
+ResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType>::
+  CastPixelWithBoundsChecking(const TPixel & value, PixelType & outputValue)
+{
+  const unsigned int nComponents = InterpolatorConvertType::GetNumberOfComponents(value);
+  if (NumericTraits<PixelType>::GetLength(outputValue) != nComponents)
+  {
+    NumericTraits<PixelType>::SetLength(outputValue, nComponents);
+  }
+
+  for (unsigned int n = 0; n < nComponents; ++n)
+  {
+    const ComponentType component = InterpolatorConvertType::GetNthComponent(n, value);
+    PixelConvertType::SetNthComponent(n, outputValue, Self::CastComponentWithBoundsChecking(component));
+  }
+}
+
+
 template <typename TInputImage,
           typename TOutputImage,
           typename TInterpolatorPrecisionType,
@@ -383,44 +408,42 @@ ResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTran
 
 
   // Create an iterator that will walk the output region for this thread.
-  using OutputIterator = ImageRegionIteratorWithIndex<TOutputImage>;
+  using OutputIterator = ImageScanlineIterator<TOutputImage>;
 
-  using OutputType = typename InterpolatorType::OutputType;
+  // The points of a whole scanline are mapped by a single call to the transform.
+  const SizeValueType                                  lineLength = outputRegionForThread.GetSize(0);
+  std::vector<typename TransformType::InputPointType>  outputPoints(lineLength);
+  std::vector<typename TransformType::OutputPointType> transformedPoints(lineLength);
+  std::vector<ContinuousInputIndexType>                inputIndices(lineLength);
+  std::vector<InterpolatorOutputType>                  values(lineLength);
+  const auto                                           isInside = std::make_unique<bool[]>(lineLength);
 
   // Walk the output region
-  for (OutputIterator outIt(outputPtr, outputRegionForThread); !outIt.IsAtEnd(); ++outIt)
+  for (OutputIterator outIt(outputPtr, outputRegionForThread); !outIt.IsAtEnd(); outIt.NextLine())
   {
-    // Determine the index of the current output pixel
-
-    OutputPointType outputPoint; // Coordinates of current output pixel
-    outputPtr->TransformIndexToPhysicalPoint(outIt.GetIndex(), outputPoint);
-
-    // Compute corresponding input pixel position
-    const InputPointType inputPoint = transformPtr->TransformPoint(outputPoint);
+    // Determine the coordinates of the output pixels of the line
+    IndexType index = outIt.GetIndex();
+    for (SizeValueType i = 0; i < lineLength; ++i, ++index[0])
+    {
+      OutputPointType outputPoint; // Coordinates of current output pixel
+      outputPtr->TransformIndexToPhysicalPoint(index, outputPoint);
+      outputPoints[i] = outputPoint;
+    }
 
-    ContinuousInputIndexType inputIndex;
-    const bool               isInsideInput = inputPtr->TransformPhysicalPointToContinuousIndex(inputPoint, inputIndex);
+    // Compute corresponding input pixel positions
+    transformPtr->TransformPoints(outputPoints.data(), transformedPoints.data(), lineLength);
 
-    OutputType value;
-    // Evaluate input at right position and copy to the output
-    if (m_Interpolator->IsInsideBuffer(inputIndex) && (!isSpecialCoordinatesImage || isInsideInput))
+    for (SizeValueType i = 0; i < lineLength; ++i)
     {
-      value = m_Interpolator->EvaluateAtContinuousIndex(inputIndex);
-      outIt.Set(Self::CastPixelWithBoundsChecking(value));
+      const InputPointType inputPoint = transformedPoints[i];
+      const bool isInsideInput = inputPtr->TransformPhysicalPointToContinuousIndex(inputPoint, inputIndices[i]);
+      isInside[i] =
+        m_Interpolator->IsInsideBuffer(inputIndices[i]) && (!isSpecialCoordinatesImage || isInsideInput);
     }
-    else
-    {
-      if (m_Extrapolator.IsNull())
-      {
-        outIt.Set(m_DefaultPixelValue); // default background value
-      }
-      else
-      {
-        value = m_Extrapolator->EvaluateAtContinuousIndex(inputIndex);
-        outIt.Set(Self::CastPixelWithBoundsChecking(value));
-      }
-    }
-    progress.CompletedPixel();
+
+    // Evaluate input at right positions and copy to the output
+    this->SetScanlineFromContinuousIndices(outIt, inputIndices.data(), isInside.get(), values.data(), lineLength);
+    progress.Completed(lineLength);
   }
 }
 
@@ -443,9 +466,6 @@ ResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTran
   const auto firstIndexValueOfLargestPossibleRegion = largestPossibleRegion.GetIndex(0);
   const auto firstSizeValueOfLargestPossibleRegion = static_cast<double>(largestPossibleRegion.GetSize(0));
 
-  // Cache information from the superclass
-  const PixelType defaultValue = this->GetDefaultPixelValue();
-
   // As we walk across a scan line in the output image, we trace
   // an oriented/scaled/translated line in the input image. Each scan
   // line has a starting and ending point. Since all transforms
@@ -464,6 +484,12 @@ ResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTran
       transformPtr->TransformPoint(outputPtr->template TransformIndexToPhysicalPoint<double>(index)));
   };
 
+  // The continuous input indices of a scanline are evaluated together.
+  const SizeValueType                   lineLength = outputRegionForThread.GetSize(0);
+  std::vector<ContinuousInputIndexType> inputIndices(lineLength);
+  std::vector<InterpolatorOutputType>   values(lineLength);
+  const auto                            isInside = std::make_unique<bool[]>(lineLength);
+
   // Create an iterator that will walk the output region for this thread.
   for (ImageScanlineIterator outIt(outputPtr, outputRegionForThread); !outIt.IsAtEnd(); outIt.NextLine())
   {
@@ -478,42 +504,82 @@ ResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTran
     const auto vectorFromStartIndex = transformIndex(index) - startIndex;
 
     IndexValueType scanlineIndex = outIt.GetIndex()[0];
-
-
-    while (!outIt.IsAtEndOfLine())
+    for (SizeValueType i = 0; i < lineLength; ++i, ++scanlineIndex)
     {
-
       // Perform linear interpolation from startIndex, along vectorFromStartIndex
       const double alpha =
         (scanlineIndex - firstIndexValueOfLargestPossibleRegion) / firstSizeValueOfLargestPossibleRegion;
 
-      ContinuousInputIndexType inputIndex(startIndex);
-      for (unsigned int i = 0; i < InputImageDimension; ++i)
+      ContinuousInputIndexType & inputIndex = inputIndices[i];
+      inputIndex = startIndex;
+      for (unsigned int d = 0; d < InputImageDimension; ++d)
       {
-        inputIndex[i] += alpha * vectorFromStartIndex[i];
+        inputIndex[d] += alpha * vectorFromStartIndex[d];
       }
+      isInside[i] = m_Interpolator->IsInsideBuffer(inputIndex);
+    }
 
-      // Evaluate input at right position and copy to the output
-      if (m_Interpolator->IsInsideBuffer(inputIndex))
+    // Evaluate input at right positions and copy to the output
+    this->SetScanlineFromContinuousIndices(outIt, inputIndices.data(), isInside.get(), values.data(), lineLength);
+    progress.Completed(lineLength);
+  }
+}
+
+template <typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType,
+          typename TTransformPrecisionType>
+template <typename TOutputIterator>
+void
+ResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType>::
+  SetScanlineFromContinuousIndices(TOutputIterator &                outIt,
+                                   const ContinuousInputIndexType * inputIndices,
+                                   const bool *                     isInside,
+                                   InterpolatorOutputType *         values,
+                                   SizeValueType                    lineLength) const
+{
+  // VariableLengthVector output pixels are cast into the same pixel, which is
+  // only allocated once per scanline.
+  constexpr bool isVariableLengthPixel = std::is_same_v<PixelType, VariableLengthVector<PixelComponentType>>;
+  PixelType      outputValue{};
+
+  SizeValueType i = 0;
+  while (i < lineLength)
+  {
+    if (isInside[i])
+    {
+      SizeValueType endOfRun = i + 1;
+      while (endOfRun < lineLength && isInside[endOfRun])
       {
-        outIt.Set(Self::CastPixelWithBoundsChecking(m_Interpolator->EvaluateAtContinuousIndex(inputIndex)));
+        ++endOfRun;
       }
-      else
+      m_Interpolator->EvaluateAtContinuousIndices(inputIndices + i, values + i, endOfRun - i);
+      for (; i < endOfRun; ++i, ++outIt)
       {
-        if (m_Extrapolator.IsNull())
+        if constexpr (isVariableLengthPixel)
         {
-          outIt.Set(defaultValue); // default background value
+          Self::CastPixelWithBoundsChecking(values[i], outputValue);
+          outIt.Set(outputValue);
         }
         else
         {
-          outIt.Set(Self::CastPixelWithBoundsChecking(m_Extrapolator->EvaluateAtContinuousIndex(inputIndex)));
+          outIt.Set(Self::CastPixelWithBoundsChecking(values[i]));
         }
       }
-
+    }
+    else
+    {
+      if (m_Extrapolator.IsNull())
+      {
+        outIt.Set(m_DefaultPixelValue); // default background value
+      }
+      else
+      {
+        outIt.Set(Self::CastPixelWithBoundsChecking(m_Extrapolator->EvaluateAtContinuousIndex(inputIndices[i])));
+      }
+      ++i;
       ++outIt;
-      ++scanlineIndex;
     }
-    progress.Completed(outputRegionForThread.GetSize()[0]);
   }
 }
 
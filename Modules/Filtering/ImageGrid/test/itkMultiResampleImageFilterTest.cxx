@@ -0,0 +1,236 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkMultiResampleImageFilter.h"
+#include "itkResampleImageFilter.h"
+#include "itkAffineTransform.h"
+#include "itkBSplineTransform.h"
+#include "itkCompositeTransform.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkLabelImageGaussianInterpolateImageFunction.h"
+#include "itkNearestNeighborInterpolateImageFunction.h"
+#include "itkTimeProbe.h"
+#include "itkTestingMacros.h"
+
+#include <cmath>
+
+/*
+ * Resamples a T1 and a T2 like image, a label map and a mask through one
+ * transform with MultiResampleImageFilter, compares the outputs to those of a
+ * ResampleImageFilter per image, and reports the speedup.
+ */
+
+namespace
+{
+constexpr unsigned int Dimension = 3;
+constexpr unsigned int NumberOfImages = 4;
+using ImageType = itk::Image<float, Dimension>;
+using InterpolatorType = itk::InterpolateImageFunction<ImageType, double>;
+using TransformType = itk::Transform<double, Dimension, Dimension>;
+using FilterType = itk::MultiResampleImageFilter<ImageType, ImageType>;
+
+InterpolatorType::Pointer
+MakeInterpolator(unsigned int k)
+{
+  switch (k)
+  {
+    case 2:
+      return itk::LabelImageGaussianInterpolateImageFunction<ImageType, double>::New().GetPointer();
+    case 3:
+      return itk::NearestNeighborInterpolateImageFunction<ImageType, double>::New().GetPointer();
+    default:
+      return itk::LinearInterpolateImageFunction<ImageType, double>::New().GetPointer();
+  }
+}
+
+bool
+CompareToSequential(const char *             name,
+                    const ImageType::Pointer images[],
+                    const TransformType *    transform,
+                    const ImageType *        referenceImage,
+                    const itk::SizeValueType numberOfReps)
+{
+  ImageType::Pointer expectedOutputs[NumberOfImages];
+  itk::TimeProbe     sequentialProbe;
+  for (unsigned int k = 0; k < NumberOfImages; ++k)
+  {
+    auto resample = itk::ResampleImageFilter<ImageType, ImageType>::New();
+    resample->SetInput(images[k]);
+    resample->SetTransform(transform);
+    resample->SetInterpolator(MakeInterpolator(k));
+    resample->UseReferenceImageOn();
+    resample->SetReferenceImage(referenceImage);
+    resample->SetDefaultPixelValue(-1.0f);
+    for (itk::SizeValueType r = 0; r < numberOfReps; ++r)
+    {
+      resample->Modified();
+      sequentialProbe.Start();
+      resample->Update();
+      sequentialProbe.Stop();
+    }
+    expectedOutputs[k] = resample->GetOutput();
+  }
+
+  auto filter = FilterType::New();
+  for (unsigned int k = 0; k < NumberOfImages; ++k)
+  {
+    filter->SetInput(k, images[k]);
+    filter->SetInterpolator(k, MakeInterpolator(k));
+  }
+  filter->SetTransform(transform);
+  filter->SetReferenceImage(referenceImage);
+  filter->SetDefaultPixelValue(-1.0f);
+  itk::TimeProbe fusedProbe;
+  for (itk::SizeValueType r = 0; r < numberOfReps; ++r)
+  {
+    filter->Modified();
+    fusedProbe.Start();
+    filter->Update();
+    fusedProbe.Stop();
+  }
+
+  const double sequentialTime = sequentialProbe.GetTotal() / numberOfReps;
+  const double fusedTime = fusedProbe.GetMean();
+  std::cout << name << ": " << sequentialTime << " s sequential, " << fusedTime << " s fused, speedup "
+            << sequentialTime / fusedTime << std::endl;
+
+  for (unsigned int k = 0; k < NumberOfImages; ++k)
+  {
+    const ImageType * output = filter->GetOutput(k);
+    if (output->GetLargestPossibleRegion() != referenceImage->GetLargestPossibleRegion() ||
+        output->GetSpacing() != referenceImage->GetSpacing() || output->GetOrigin() != referenceImage->GetOrigin())
+    {
+      std::cerr << name << ": output " << k << " is not on the grid of the reference image" << std::endl;
+      return false;
+    }
+
+    itk::SizeValueType                       numberOfInsidePixels = 0;
+    itk::ImageRegionConstIterator<ImageType> expectedIt(expectedOutputs[k], expectedOutputs[k]->GetBufferedRegion());
+    for (itk::ImageRegionConstIterator<ImageType> it(output, output->GetBufferedRegion()); !it.IsAtEnd();
+         ++it, ++expectedIt)
+    {
+      if (it.Get() != expectedIt.Get())
+      {
+        std::cerr << name << ": output " << k << " has value " << it.Get() << " at " << it.GetIndex() << " instead of "
+                  << expectedIt.Get() << std::endl;
+        return false;
+      }
+      numberOfInsidePixels += (expectedIt.Get() != -1.0f);
+    }
+    if (numberOfInsidePixels == 0)
+    {
+      std::cerr << name << ": no pixel of output " << k << " maps inside its input" << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
+
+int
+itkMultiResampleImageFilterTest(int argc, char * argv[])
+{
+  const unsigned int       imageSize = (argc > 1) ? std::stoi(argv[1]) : 32;
+  const itk::SizeValueType numberOfReps = (argc > 2) ? std::stoul(argv[2]) : 1;
+
+  auto filter = FilterType::New();
+  ITK_EXERCISE_BASIC_OBJECT_METHODS(filter, MultiResampleImageFilter, ImageToImageFilter);
+
+  // A T1 and a T2 like image, a label map and a mask. The T2 like image and
+  // the mask have grids of their own.
+  ImageType::Pointer images[NumberOfImages];
+  for (unsigned int k = 0; k < NumberOfImages; ++k)
+  {
+    const bool ownGrid = (k % 2 == 1);
+    images[k] = ImageType::New();
+    images[k]->SetRegions(ImageType::SizeType::Filled(ownGrid ? imageSize / 2 : imageSize));
+    images[k]->SetSpacing(itk::MakeFilled<ImageType::SpacingType>(ownGrid ? 2.0 : 1.0));
+    images[k]->SetOrigin(itk::MakeFilled<ImageType::PointType>(ownGrid ? 0.5 : 0.0));
+    images[k]->Allocate();
+    for (itk::ImageRegionIteratorWithIndex<ImageType> it(images[k], images[k]->GetBufferedRegion()); !it.IsAtEnd();
+         ++it)
+    {
+      ImageType::PointType point;
+      images[k]->TransformIndexToPhysicalPoint(it.GetIndex(), point);
+      const double radius = point.EuclideanDistanceTo(itk::MakeFilled<ImageType::PointType>(0.5 * imageSize));
+      switch (k)
+      {
+        case 0:
+          it.Set(static_cast<float>(100.0 + 50.0 * std::sin(0.3 * point[0]) * std::cos(0.2 * point[1]) + point[2]));
+          break;
+        case 1:
+          it.Set(static_cast<float>(300.0 - 2.0 * radius + 20.0 * std::cos(0.25 * point[2])));
+          break;
+        case 2:
+          it.Set(static_cast<float>(static_cast<int>(radius / 3.0) % 5));
+          break;
+        default:
+          it.Set(radius < 0.4 * imageSize ? 1.0f : 0.0f);
+      }
+    }
+  }
+
+  // The output grid is finer, and extends past the inputs.
+  auto referenceImage = ImageType::New();
+  referenceImage->SetRegions(ImageType::SizeType::Filled(imageSize + imageSize / 2));
+  referenceImage->SetSpacing(itk::MakeFilled<ImageType::SpacingType>(0.75));
+  referenceImage->SetOrigin(itk::MakeFilled<ImageType::PointType>(-2.0));
+
+  auto affine = itk::AffineTransform<double, Dimension>::New();
+  affine->SetCenter(itk::MakeFilled<itk::Point<double, Dimension>>(0.5 * imageSize));
+  affine->Rotate(0, 1, 0.15);
+  affine->Shear(2, 0, 0.05);
+
+  using BSplineTransformType = itk::BSplineTransform<double, Dimension, 3>;
+  auto bsplineTransform = BSplineTransformType::New();
+  bsplineTransform->SetTransformDomainOrigin(images[0]->GetOrigin());
+  bsplineTransform->SetTransformDomainPhysicalDimensions(
+    itk::MakeFilled<BSplineTransformType::PhysicalDimensionsType>(imageSize - 1.0));
+  bsplineTransform->SetTransformDomainMeshSize(itk::MakeFilled<BSplineTransformType::MeshSizeType>(4));
+  BSplineTransformType::ParametersType bsplineParameters(bsplineTransform->GetNumberOfParameters());
+  for (unsigned int p = 0; p < bsplineParameters.Size(); ++p)
+  {
+    bsplineParameters[p] = 1.5 * std::sin(0.7 * p);
+  }
+  bsplineTransform->SetParametersByValue(bsplineParameters);
+
+  auto composite = itk::CompositeTransform<double, Dimension>::New();
+  composite->AddTransform(affine);
+  composite->AddTransform(bsplineTransform);
+
+  // Inputs that share an interpolator are rejected.
+  auto interpolator = itk::LinearInterpolateImageFunction<ImageType, double>::New();
+  filter->SetInput(0, images[0]);
+  filter->SetInput(1, images[1]);
+  filter->SetInterpolator(0, interpolator);
+  filter->SetInterpolator(1, interpolator);
+  filter->SetReferenceImage(referenceImage);
+  ITK_TRY_EXPECT_EXCEPTION(filter->Update());
+
+  bool success = true;
+  success &= CompareToSequential("affine", images, affine, referenceImage, numberOfReps);
+  success &= CompareToSequential("affine and BSpline transform", images, composite, referenceImage, numberOfReps);
+
+  if (!success)
+  {
+    std::cout << "Test FAILED!" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
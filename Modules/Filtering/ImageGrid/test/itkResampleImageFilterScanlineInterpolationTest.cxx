@@ -0,0 +1,259 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkResampleImageFilter.h"
+#include "itkAffineTransform.h"
+#include "itkBSplineInterpolateImageFunction.h"
+#include "itkBSplineTransform.h"
+#include "itkEuler3DTransform.h"
+#include "itkIdentityTransform.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkNearestNeighborExtrapolateImageFunction.h"
+#include "itkTimeProbe.h"
+#include "itkWindowedSincInterpolateImageFunction.h"
+#include "itkTestingMacros.h"
+
+#include <cmath>
+#include <string>
+#include <utility>
+
+/*
+ * Compares the output of ResampleImageFilter, which evaluates the
+ * interpolator one scanline at a time, to the output with an interpolator
+ * that evaluates each index on its own, for axis aligned, rotated, affine and
+ * nonlinear transforms, and reports the speedup.
+ */
+
+namespace
+{
+constexpr unsigned int Dimension = 3;
+using InputImageType = itk::Image<float, Dimension>;
+using OutputImageType = itk::Image<double, Dimension>;
+using InterpolatorType = itk::InterpolateImageFunction<InputImageType, double>;
+using TransformType = itk::Transform<double, Dimension, Dimension>;
+
+/** Evaluates the indices of a scanline one at a time, with the wrapped
+ * interpolator. */
+class PerIndexInterpolator : public InterpolatorType
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(PerIndexInterpolator);
+
+  using Self = PerIndexInterpolator;
+  using Superclass = InterpolatorType;
+  using Pointer = itk::SmartPointer<Self>;
+
+  itkOverrideGetNameOfClassMacro(PerIndexInterpolator);
+  itkNewMacro(Self);
+
+  void
+  SetInterpolator(InterpolatorType * interpolator)
+  {
+    m_Interpolator = interpolator;
+  }
+
+  void
+  SetInputImage(const InputImageType * image) override
+  {
+    Superclass::SetInputImage(image);
+    m_Interpolator->SetInputImage(image);
+  }
+
+  OutputType
+  EvaluateAtContinuousIndex(const ContinuousIndexType & index) const override
+  {
+    return m_Interpolator->EvaluateAtContinuousIndex(index);
+  }
+
+  SizeType
+  GetRadius() const override
+  {
+    return m_Interpolator->GetRadius();
+  }
+
+protected:
+  PerIndexInterpolator() = default;
+
+private:
+  InterpolatorType::Pointer m_Interpolator{};
+};
+
+bool
+CompareToPerIndex(const char *             name,
+                  const InputImageType *   image,
+                  const TransformType *    transform,
+                  InterpolatorType *       interpolator,
+                  const OutputImageType *  referenceImage,
+                  const bool               useExtrapolator,
+                  const itk::SizeValueType numberOfReps)
+{
+  auto perIndexInterpolator = PerIndexInterpolator::New();
+  perIndexInterpolator->SetInterpolator(interpolator);
+
+  OutputImageType::Pointer outputs[2];
+  double                   times[2];
+  for (unsigned int m = 0; m < 2; ++m)
+  {
+    auto resample = itk::ResampleImageFilter<InputImageType, OutputImageType>::New();
+    resample->SetInput(image);
+    resample->SetTransform(transform);
+    resample->UseReferenceImageOn();
+    resample->SetReferenceImage(referenceImage);
+    resample->SetDefaultPixelValue(-1000.0);
+    if (m == 0)
+    {
+      resample->SetInterpolator(perIndexInterpolator);
+    }
+    else
+    {
+      resample->SetInterpolator(interpolator);
+    }
+    if (useExtrapolator)
+    {
+      resample->SetExtrapolator(itk::NearestNeighborExtrapolateImageFunction<InputImageType, double>::New());
+    }
+
+    itk::TimeProbe probe;
+    for (itk::SizeValueType r = 0; r < numberOfReps; ++r)
+    {
+      resample->Modified();
+      probe.Start();
+      resample->Update();
+      probe.Stop();
+    }
+    outputs[m] = resample->GetOutput();
+    times[m] = probe.GetMean();
+  }
+  std::cout << name << ": " << times[0] << " s per index, " << times[1] << " s per scanline, speedup "
+            << times[0] / times[1] << std::endl;
+
+  itk::SizeValueType numberOfInsidePixels = 0;
+  itk::ImageRegionConstIterator<OutputImageType> expectedIt(outputs[0], outputs[0]->GetBufferedRegion());
+  for (itk::ImageRegionConstIterator<OutputImageType> it(outputs[1], outputs[1]->GetBufferedRegion()); !it.IsAtEnd();
+       ++it, ++expectedIt)
+  {
+    const double expected = expectedIt.Get();
+    if (std::abs(it.Get() - expected) > 1e-9 * (1.0 + std::abs(expected)))
+    {
+      std::cerr << name << ": value " << it.Get() << " at " << it.GetIndex() << " instead of " << expected
+                << std::endl;
+      return false;
+    }
+    numberOfInsidePixels += (expected != -1000.0);
+  }
+  if (numberOfInsidePixels == 0)
+  {
+    std::cerr << name << ": no pixel maps inside the input" << std::endl;
+    return false;
+  }
+  return true;
+}
+} // namespace
+
+int
+itkResampleImageFilterScanlineInterpolationTest(int argc, char * argv[])
+{
+  const unsigned int       imageSize = (argc > 1) ? std::stoi(argv[1]) : 32;
+  const itk::SizeValueType numberOfReps = (argc > 2) ? std::stoul(argv[2]) : 1;
+
+  auto image = InputImageType::New();
+  image->SetRegions(InputImageType::SizeType::Filled(imageSize));
+  image->SetSpacing(itk::MakeFilled<InputImageType::SpacingType>(1.5));
+  image->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<InputImageType> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    const auto & index = it.GetIndex();
+    it.Set(static_cast<float>(100.0 * std::sin(0.3 * index[0]) * std::cos(0.2 * index[1]) + 3.0 * index[2] +
+                              ((index[0] * 7 + index[1] * 13 + index[2] * 5) % 11)));
+  }
+
+  // Twice as many pixels along each axis, over a domain that extends past
+  // the input.
+  auto referenceImage = OutputImageType::New();
+  referenceImage->SetRegions(OutputImageType::SizeType::Filled(2 * imageSize));
+  referenceImage->SetSpacing(itk::MakeFilled<OutputImageType::SpacingType>(0.8));
+  referenceImage->SetOrigin(itk::MakeFilled<OutputImageType::PointType>(-3.0));
+
+  auto identity = itk::IdentityTransform<double, Dimension>::New();
+
+  const auto center = itk::MakeFilled<itk::Point<double, Dimension>>(0.75 * imageSize);
+  auto       rotation = itk::Euler3DTransform<double>::New();
+  rotation->SetCenter(center);
+  rotation->SetRotation(0.0, 0.0, 0.3);
+
+  auto affine = itk::AffineTransform<double, Dimension>::New();
+  affine->SetCenter(center);
+  affine->Rotate(0, 2, 0.2);
+  affine->Shear(1, 0, 0.1);
+  affine->Scale(itk::MakeVector(1.1, 0.9, 1.05));
+
+  using BSplineTransformType = itk::BSplineTransform<double, Dimension, 3>;
+  auto bsplineTransform = BSplineTransformType::New();
+  bsplineTransform->SetTransformDomainOrigin(image->GetOrigin());
+  bsplineTransform->SetTransformDomainPhysicalDimensions(
+    itk::MakeFilled<BSplineTransformType::PhysicalDimensionsType>(1.5 * (imageSize - 1)));
+  bsplineTransform->SetTransformDomainMeshSize(itk::MakeFilled<BSplineTransformType::MeshSizeType>(4));
+  BSplineTransformType::ParametersType bsplineParameters(bsplineTransform->GetNumberOfParameters());
+  for (unsigned int p = 0; p < bsplineParameters.Size(); ++p)
+  {
+    bsplineParameters[p] = 2.0 * std::sin(0.7 * p);
+  }
+  bsplineTransform->SetParametersByValue(bsplineParameters);
+
+  auto linearBSpline = itk::BSplineInterpolateImageFunction<InputImageType, double>::New();
+  linearBSpline->SetSplineOrder(1);
+  auto cubicBSpline = itk::BSplineInterpolateImageFunction<InputImageType, double>::New();
+  cubicBSpline->SetSplineOrder(3);
+  auto windowedSinc = itk::WindowedSincInterpolateImageFunction<InputImageType, 3>::New();
+
+  const std::pair<const char *, InterpolatorType *> interpolators[] = { { "BSpline order 1", linearBSpline },
+                                                                        { "BSpline order 3", cubicBSpline },
+                                                                        { "WindowedSinc radius 3", windowedSinc } };
+  const std::pair<const char *, const TransformType *> transforms[] = {
+    { "upsampling", identity },
+    { "rotation", rotation },
+    { "affine", affine },
+    { "BSpline transform", bsplineTransform }
+  };
+
+  // Every other case fills the pixels that map outside with an extrapolator.
+  bool         success = true;
+  unsigned int caseNumber = 0;
+  for (const auto & interpolator : interpolators)
+  {
+    for (const auto & transform : transforms)
+    {
+      const std::string name = std::string(interpolator.first) + ", " + transform.first;
+      success &= CompareToPerIndex(name.c_str(),
+                                   image,
+                                   transform.second,
+                                   interpolator.second,
+                                   referenceImage,
+                                   caseNumber++ % 2 == 1,
+                                   numberOfReps);
+    }
+  }
+
+  if (!success)
+  {
+    std::cout << "Test FAILED!" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,210 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkResampleImageFilter.h"
+#include "itkAffineTransform.h"
+#include "itkBSplineTransform.h"
+#include "itkIdentityTransform.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkNearestNeighborExtrapolateImageFunction.h"
+#include "itkTimeProbe.h"
+#include "itkVectorImage.h"
+#include "itkTestingMacros.h"
+
+#include <cmath>
+
+/*
+ * Resamples a VectorImage with many components with the linear interpolator,
+ * compares the output to that of an interpolator that evaluates each index on
+ * its own, returning a newly allocated VariableLengthVector, and reports the
+ * speedup.
+ */
+
+namespace
+{
+constexpr unsigned int Dimension = 3;
+using ImageType = itk::VectorImage<float, Dimension>;
+using InterpolatorType = itk::InterpolateImageFunction<ImageType, double>;
+using LinearInterpolatorType = itk::LinearInterpolateImageFunction<ImageType, double>;
+using TransformType = itk::Transform<double, Dimension, Dimension>;
+
+/** Evaluates the indices of a scanline one at a time, with the linear
+ * interpolator. */
+class PerIndexInterpolator : public InterpolatorType
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(PerIndexInterpolator);
+
+  using Self = PerIndexInterpolator;
+  using Superclass = InterpolatorType;
+  using Pointer = itk::SmartPointer<Self>;
+
+  itkOverrideGetNameOfClassMacro(PerIndexInterpolator);
+  itkNewMacro(Self);
+
+  void
+  SetInputImage(const ImageType * image) override
+  {
+    Superclass::SetInputImage(image);
+    m_Interpolator->SetInputImage(image);
+  }
+
+  OutputType
+  EvaluateAtContinuousIndex(const ContinuousIndexType & index) const override
+  {
+    return m_Interpolator->EvaluateAtContinuousIndex(index);
+  }
+
+  SizeType
+  GetRadius() const override
+  {
+    return m_Interpolator->GetRadius();
+  }
+
+protected:
+  PerIndexInterpolator() = default;
+
+private:
+  LinearInterpolatorType::Pointer m_Interpolator{ LinearInterpolatorType::New() };
+};
+
+bool
+CompareToPerIndex(const char *             name,
+                  const ImageType *        image,
+                  const TransformType *    transform,
+                  const ImageType *        referenceImage,
+                  const bool               useExtrapolator,
+                  const itk::SizeValueType numberOfReps)
+{
+  ImageType::Pointer outputs[2];
+  double             times[2];
+  for (unsigned int m = 0; m < 2; ++m)
+  {
+    auto resample = itk::ResampleImageFilter<ImageType, ImageType>::New();
+    resample->SetInput(image);
+    resample->SetTransform(transform);
+    resample->UseReferenceImageOn();
+    resample->SetReferenceImage(referenceImage);
+    ImageType::PixelType defaultValue(image->GetNumberOfComponentsPerPixel());
+    defaultValue.Fill(-1000.0f);
+    resample->SetDefaultPixelValue(defaultValue);
+    if (m == 0)
+    {
+      resample->SetInterpolator(PerIndexInterpolator::New());
+    }
+    else
+    {
+      resample->SetInterpolator(LinearInterpolatorType::New());
+    }
+    if (useExtrapolator)
+    {
+      resample->SetExtrapolator(itk::NearestNeighborExtrapolateImageFunction<ImageType, double>::New());
+    }
+
+    itk::TimeProbe probe;
+    for (itk::SizeValueType r = 0; r < numberOfReps; ++r)
+    {
+      resample->Modified();
+      probe.Start();
+      resample->Update();
+      probe.Stop();
+    }
+    outputs[m] = resample->GetOutput();
+    times[m] = probe.GetMean();
+  }
+  std::cout << name << ": " << times[0] << " s per index, " << times[1] << " s per scanline, speedup "
+            << times[0] / times[1] << std::endl;
+
+  itk::ImageRegionConstIterator<ImageType> expectedIt(outputs[0], outputs[0]->GetBufferedRegion());
+  for (itk::ImageRegionConstIterator<ImageType> it(outputs[1], outputs[1]->GetBufferedRegion()); !it.IsAtEnd();
+       ++it, ++expectedIt)
+  {
+    if (it.Get() != expectedIt.Get())
+    {
+      std::cerr << name << ": value " << it.Get() << " at " << it.GetIndex() << " instead of " << expectedIt.Get()
+                << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
+
+int
+itkResampleImageFilterVectorImageTest(int argc, char * argv[])
+{
+  const unsigned int       imageSize = (argc > 1) ? std::stoi(argv[1]) : 16;
+  const unsigned int       numberOfComponents = (argc > 2) ? std::stoi(argv[2]) : 64;
+  const itk::SizeValueType numberOfReps = (argc > 3) ? std::stoul(argv[3]) : 1;
+
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType::Filled(imageSize));
+  image->SetSpacing(itk::MakeFilled<ImageType::SpacingType>(2.0));
+  image->SetNumberOfComponentsPerPixel(numberOfComponents);
+  image->Allocate();
+  ImageType::PixelType pixel(numberOfComponents);
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    const auto & index = it.GetIndex();
+    for (unsigned int c = 0; c < numberOfComponents; ++c)
+    {
+      pixel[c] = static_cast<float>(std::sin(0.1 * (c + 1) * index[0]) + 0.5 * index[1] - 0.01 * c * index[2]);
+    }
+    it.Set(pixel);
+  }
+
+  // Twice as many pixels along each axis, over a domain that extends past
+  // the input.
+  auto referenceImage = ImageType::New();
+  referenceImage->SetRegions(ImageType::SizeType::Filled(2 * imageSize));
+  referenceImage->SetSpacing(itk::MakeFilled<ImageType::SpacingType>(1.1));
+  referenceImage->SetOrigin(itk::MakeFilled<ImageType::PointType>(-2.0));
+
+  auto identity = itk::IdentityTransform<double, Dimension>::New();
+
+  auto affine = itk::AffineTransform<double, Dimension>::New();
+  affine->SetCenter(itk::MakeFilled<itk::Point<double, Dimension>>(imageSize));
+  affine->Rotate(0, 1, 0.2);
+  affine->Shear(2, 0, 0.1);
+
+  using BSplineTransformType = itk::BSplineTransform<double, Dimension, 3>;
+  auto bsplineTransform = BSplineTransformType::New();
+  bsplineTransform->SetTransformDomainOrigin(image->GetOrigin());
+  bsplineTransform->SetTransformDomainPhysicalDimensions(
+    itk::MakeFilled<BSplineTransformType::PhysicalDimensionsType>(2.0 * (imageSize - 1)));
+  bsplineTransform->SetTransformDomainMeshSize(itk::MakeFilled<BSplineTransformType::MeshSizeType>(3));
+  BSplineTransformType::ParametersType bsplineParameters(bsplineTransform->GetNumberOfParameters());
+  for (unsigned int p = 0; p < bsplineParameters.Size(); ++p)
+  {
+    bsplineParameters[p] = 1.5 * std::sin(0.9 * p);
+  }
+  bsplineTransform->SetParametersByValue(bsplineParameters);
+
+  bool success = true;
+  success &= CompareToPerIndex("upsampling", image, identity, referenceImage, false, numberOfReps);
+  success &= CompareToPerIndex("affine", image, affine, referenceImage, true, numberOfReps);
+  success &= CompareToPerIndex("BSpline transform", image, bsplineTransform, referenceImage, false, numberOfReps);
+
+  if (!success)
+  {
+    std::cout << "Test FAILED!" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -172,7 +172,7 @@ PolylineMaskImageFilter<TInputImage, TPolyline, TVector, TOutputImage>::Generate
   outputImagePtr->SetRequestedRegion(inputImagePtr->GetRequestedRegion());
   outputImagePtr->SetBufferedRegion(inputImagePtr->GetBufferedRegion());
   outputImagePtr->SetLargestPossibleRegion(inputImagePtr->GetLargestPossibleRegion());
-  outputImagePtr->AllocateInitialized();
+  outputImagePtr->Allocate();
 
   InputImageConstIteratorType inputIt(inputImagePtr, inputImagePtr->GetLargestPossibleRegion());
   OutputImageIteratorType     outputIt(outputImagePtr, outputImagePtr->GetLargestPossibleRegion());
@@ -321,7 +321,7 @@ PolylineMaskImageFilter<TInputImage, TPolyline, TVector, TOutputImage>::Generate
   itkDebugMacro("Projection image origin:" << origin);
 
   projectionImagePtr->SetRegions(projectionRegion);
-  projectionImagePtr->AllocateInitialized();
+  projectionImagePtr->Allocate();
 
   using ProjectionImageIteratorType = ImageRegionIterator<ProjectionImageType>;
   const ProjectionImageIteratorType projectionIt(projectionImagePtr, projectionImagePtr->GetLargestPossibleRegion());
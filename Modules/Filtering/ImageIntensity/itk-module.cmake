@@ -18,8 +18,10 @@ itk_module(
   ITKTestKernel
   ITKDistanceMap
   ITKGoogleTest
+  ITKSmoothing
   DESCRIPTION
   "${DOCUMENTATION}")
 
 # Extra dependency of ITKSpatialObjects is introduced by itkPolylineMaskImageFilterTest.
 # Extra dependency of ITKSpatialObjects is introduced by itkModulusImageFilterTest.
+# Extra test dependency on ITKSmoothing is introduced by itkAddImageFilterNUMAPlacementTest.
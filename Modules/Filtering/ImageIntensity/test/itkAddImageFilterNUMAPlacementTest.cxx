@@ -0,0 +1,135 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// Times a streaming add -> Gaussian pipeline with the NUMA memory policies
+// of NUMASupport, with or without thread pinning, and verifies that they do
+// not change the result. Pinning is a separate test run, since it only
+// applies to pool threads started after it is enabled.
+
+#include "itkAddImageFilter.h"
+#include "itkDiscreteGaussianImageFilter.h"
+#include "itkNUMASupport.h"
+#include "itkRandomImageSource.h"
+#include "itkStreamingImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkTimeProbe.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+using ImageType = itk::Image<float, 3>;
+
+ImageType::Pointer
+RunPipeline(const ImageType * input, unsigned int numberOfStreamDivisions, itk::TimeProbe & probe)
+{
+  using AddFilterType = itk::AddImageFilter<ImageType, ImageType, ImageType>;
+  auto add = AddFilterType::New();
+  add->SetInput1(input);
+  add->SetInput2(input);
+
+  using GaussianFilterType = itk::DiscreteGaussianImageFilter<ImageType, ImageType>;
+  auto gaussian = GaussianFilterType::New();
+  gaussian->SetInput(add->GetOutput());
+  gaussian->SetVariance(2.0);
+  gaussian->SetMaximumKernelWidth(9);
+
+  using StreamingFilterType = itk::StreamingImageFilter<ImageType, ImageType>;
+  auto streamer = StreamingFilterType::New();
+  streamer->SetInput(gaussian->GetOutput());
+  streamer->SetNumberOfStreamDivisions(numberOfStreamDivisions);
+
+  probe.Start();
+  streamer->Update();
+  probe.Stop();
+
+  ImageType::Pointer output = streamer->GetOutput();
+  output->DisconnectPipeline();
+  return output;
+}
+} // namespace
+
+int
+itkAddImageFilterNUMAPlacementTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv);
+    std::cerr << " imageSize [numberOfStreamDivisions] [pinThreads]" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const auto         imageSize = static_cast<ImageType::SizeValueType>(std::stoi(argv[1]));
+  const unsigned int numberOfStreamDivisions = (argc > 2) ? static_cast<unsigned int>(std::stoi(argv[2])) : 4;
+  const bool         pinThreads = (argc > 3) && std::stoi(argv[3]) != 0;
+
+  // The pool threads are pinned when they start, so pinning must be enabled
+  // before the first pipeline runs.
+  itk::NUMASupport::SetGlobalThreadPinning(pinThreads);
+  std::cout << "NUMA nodes: " << itk::NUMASupport::GetNumberOfNodes() << std::endl;
+  std::cout << "CPU of the first worker: " << itk::NUMASupport::GetCPUForWorker(0) << std::endl;
+
+  using SourceType = itk::RandomImageSource<ImageType>;
+  auto source = SourceType::New();
+  source->SetSize(ImageType::SizeType::Filled(imageSize));
+  source->SetMin(0.0);
+  source->SetMax(100.0);
+  source->Update();
+  const ImageType::ConstPointer input = source->GetOutput();
+
+  using PolicyEnum = itk::NUMASupportEnums::MemoryPolicy;
+  ImageType::Pointer reference;
+  bool               success = true;
+  for (const auto policy : { PolicyEnum::Default, PolicyEnum::FirstTouch, PolicyEnum::Interleave })
+  {
+    itk::NUMASupport::SetGlobalMemoryPolicy(policy);
+
+    itk::TimeProbe     probe;
+    ImageType::Pointer output;
+    for (unsigned int repetition = 0; repetition < 3; ++repetition)
+    {
+      output = RunPipeline(input, numberOfStreamDivisions, probe);
+    }
+    std::cout << policy << (pinThreads ? ", pinned threads: " : ": ") << probe.GetMean() << " s" << std::endl;
+
+    if (reference.IsNull())
+    {
+      reference = output;
+      continue;
+    }
+    itk::ImageRegionConstIterator<ImageType> expected(reference, reference->GetBufferedRegion());
+    itk::ImageRegionConstIterator<ImageType> actual(output, output->GetBufferedRegion());
+    for (; !expected.IsAtEnd(); ++expected, ++actual)
+    {
+      if (expected.Get() != actual.Get())
+      {
+        std::cerr << "Result differs at " << expected.GetIndex() << " with " << policy << std::endl;
+        success = false;
+        break;
+      }
+    }
+  }
+  itk::NUMASupport::SetGlobalMemoryPolicy(PolicyEnum::Default);
+
+  if (!success)
+  {
+    std::cout << "Test FAILED!" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,146 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkAutomaticDiscreteGaussianImageFilter_h
+#define itkAutomaticDiscreteGaussianImageFilter_h
+
+#include "itkDiscreteGaussianImageFilter.h"
+#include "itkConvolutionCostModel.h"
+
+#include <type_traits>
+
+namespace itk
+{
+/**
+ * \class AutomaticDiscreteGaussianImageFilter
+ * \brief Blurs an image by convolution with a discrete Gaussian kernel,
+ * choosing the fastest way on this machine.
+ *
+ * Before each update, this filter estimates the time of computing the output
+ * requested region by separable convolution, as DiscreteGaussianImageFilter
+ * does, and in the Fourier domain, as FFTDiscreteGaussianImageFilter does,
+ * and delegates to the faster one. The separable convolution is usually
+ * faster for small variances, and the Fourier domain for large ones. The
+ * estimates are the amount of work, that is the number of multiply-adds or
+ * the size of the Fourier transforms, times the cost per unit of work for the
+ * number of work units of the filter, which ConvolutionCostModel measures
+ * once per machine.
+ *
+ * The Fourier domain requires the input and output to be the same Image type
+ * of floating point pixels, and the default input boundary condition; it
+ * generates the kernel as FFTDiscreteGaussianImageFilter does, so the outputs
+ * of the two methods agree up to the precision of the Fourier transforms.
+ * The method may also be set explicitly by SetConvolutionMethod(). Since the
+ * Gaussian kernel is separable, the SPATIAL method does not apply.
+ *
+ * \sa DiscreteGaussianImageFilter
+ * \sa FFTDiscreteGaussianImageFilter
+ * \sa ConvolutionCostModel
+ *
+ * \ingroup ImageEnhancement
+ * \ingroup ImageFeatureExtraction
+ * \ingroup ITKSmoothing
+ */
+template <typename TInputImage, typename TOutputImage = TInputImage>
+class ITK_TEMPLATE_EXPORT AutomaticDiscreteGaussianImageFilter
+  : public DiscreteGaussianImageFilter<TInputImage, TOutputImage>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(AutomaticDiscreteGaussianImageFilter);
+
+  /** Standard class type aliases. */
+  using Self = AutomaticDiscreteGaussianImageFilter;
+  using Superclass = DiscreteGaussianImageFilter<TInputImage, TOutputImage>;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** \see LightObject::GetNameOfClass() */
+  itkOverrideGetNameOfClassMacro(AutomaticDiscreteGaussianImageFilter);
+
+  static constexpr unsigned int ImageDimension = Superclass::ImageDimension;
+
+  using typename Superclass::InputImageType;
+  using typename Superclass::OutputImageType;
+  using typename Superclass::OutputPixelType;
+  using typename Superclass::RealOutputImageType;
+  using typename Superclass::InputDefaultBoundaryConditionType;
+  using OutputRegionType = typename OutputImageType::RegionType;
+
+  using ConvolutionMethodEnum = ConvolutionCostModelEnums::ConvolutionMethod;
+
+  /** Set/Get how the convolution is computed: AUTOMATIC, the default,
+   * SEPARABLE or FFT. */
+  itkSetEnumMacro(ConvolutionMethod, ConvolutionMethodEnum);
+  itkGetEnumMacro(ConvolutionMethod, ConvolutionMethodEnum);
+
+  /** Get the method that computed the output of the last update. */
+  itkGetEnumMacro(SelectedConvolutionMethod, ConvolutionMethodEnum);
+
+  /** Estimate the time, in seconds, that method takes to compute region of
+   * the output. Requires the output information to be up to date. Returns the
+   * largest double for a method that cannot compute the output. Measures the
+   * costs that ConvolutionCostModel does not know yet. */
+  double
+  EstimateTime(ConvolutionMethodEnum method, const OutputRegionType & region) const;
+
+  /** Measure the costs of the methods, in seconds per unit of work, with the
+   * given number of work units, for ConvolutionCostModel. */
+  static double
+  CalibrateSeparableConvolution(ThreadIdType numberOfWorkUnits);
+  static double
+  CalibrateFFTConvolution(ThreadIdType numberOfWorkUnits);
+
+protected:
+  AutomaticDiscreteGaussianImageFilter() = default;
+  ~AutomaticDiscreteGaussianImageFilter() override = default;
+
+  /** Selects the method, and convolves separably or runs an
+   * FFTDiscreteGaussianImageFilter. */
+  void
+  GenerateData() override;
+
+  /** FFTDiscreteGaussianImageFilter convolves the input as an image of
+   * output pixels. */
+  static constexpr bool FFTApplies =
+    std::is_same_v<TInputImage, RealOutputImageType> && std::is_floating_point_v<OutputPixelType>;
+
+  /** Returns whether the Fourier domain applies to the types and the
+   * parameters of this filter. */
+  bool
+  CanConvolveInFourierDomain() const;
+
+  /** Returns the method of the smallest estimated time for region. */
+  ConvolutionMethodEnum
+  SelectConvolutionMethod(const OutputRegionType & region) const;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  ConvolutionMethodEnum m_ConvolutionMethod{ ConvolutionMethodEnum::AUTOMATIC };
+  ConvolutionMethodEnum m_SelectedConvolutionMethod{ ConvolutionMethodEnum::AUTOMATIC };
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkAutomaticDiscreteGaussianImageFilter.hxx"
+#endif
+
+#endif
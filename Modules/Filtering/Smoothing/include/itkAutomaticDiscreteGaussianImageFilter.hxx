@@ -0,0 +1,222 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkAutomaticDiscreteGaussianImageFilter_hxx
+#define itkAutomaticDiscreteGaussianImageFilter_hxx
+
+#include "itkFFTDiscreteGaussianImageFilter.h"
+#include "itkProgressAccumulator.h"
+
+#include <algorithm>
+#include <type_traits>
+
+namespace itk
+{
+template <typename TInputImage, typename TOutputImage>
+double
+AutomaticDiscreteGaussianImageFilter<TInputImage, TOutputImage>::CalibrateSeparableConvolution(
+  ThreadIdType numberOfWorkUnits)
+{
+  using ImageType = Image<float, 3>;
+
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType::Filled(48));
+  image->AllocateInitialized();
+
+  auto filter = DiscreteGaussianImageFilter<ImageType>::New();
+  filter->SetInput(image);
+  filter->SetVariance(4.0);
+  filter->SetNumberOfWorkUnits(numberOfWorkUnits);
+  const double time = ConvolutionCostModel::MeasureShortestTime([&filter] {
+    filter->Modified();
+    filter->Update();
+  });
+  double sumOfKernelWidths = 0.0;
+  for (unsigned int dim = 0; dim < 3; ++dim)
+  {
+    sumOfKernelWidths += filter->GetKernelSize()[dim];
+  }
+  return time / (image->GetBufferedRegion().GetNumberOfPixels() * sumOfKernelWidths);
+}
+
+template <typename TInputImage, typename TOutputImage>
+double
+AutomaticDiscreteGaussianImageFilter<TInputImage, TOutputImage>::CalibrateFFTConvolution(
+  ThreadIdType numberOfWorkUnits)
+{
+  using ImageType = Image<float, 3>;
+
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType::Filled(48));
+  image->AllocateInitialized();
+
+  auto filter = FFTDiscreteGaussianImageFilter<ImageType>::New();
+  filter->SetInput(image);
+  filter->SetVariance(4.0);
+  filter->SetNumberOfWorkUnits(numberOfWorkUnits);
+  const double time = ConvolutionCostModel::MeasureShortestTime([&filter] {
+    filter->Modified();
+    filter->Update();
+  });
+  const SizeValueType greatestPrimeFactor =
+    FFTConvolutionImageFilter<ImageType, ImageType, ImageType>::New()->GetSizeGreatestPrimeFactor();
+  double paddedSize = 1.0;
+  for (unsigned int dim = 0; dim < 3; ++dim)
+  {
+    paddedSize *=
+      ConvolutionCostModel::GetFFTSize(48 + 2 * static_cast<SizeValueType>(filter->GetKernelRadius(dim)),
+                                       greatestPrimeFactor);
+  }
+  return time / ConvolutionCostModel::GetFFTWork(paddedSize);
+}
+
+template <typename TInputImage, typename TOutputImage>
+double
+AutomaticDiscreteGaussianImageFilter<TInputImage, TOutputImage>::EstimateTime(ConvolutionMethodEnum      method,
+                                                                              const OutputRegionType & region) const
+{
+  constexpr double notApplicable = NumericTraits<double>::max();
+
+  const unsigned int filterDimensionality = std::min(this->GetFilterDimensionality(), ImageDimension);
+  const double       numberOfPixels = region.GetNumberOfPixels();
+  const ThreadIdType numberOfWorkUnits = this->GetNumberOfWorkUnits();
+
+  switch (method)
+  {
+    case ConvolutionMethodEnum::SPATIAL:
+      return notApplicable;
+    case ConvolutionMethodEnum::SEPARABLE:
+    {
+      double sumOfKernelWidths = 0.0;
+      for (unsigned int dim = 0; dim < filterDimensionality; ++dim)
+      {
+        sumOfKernelWidths += 2 * this->GetKernelRadius(dim) + 1;
+      }
+      const double cost = ConvolutionCostModel::GetCost(
+        "DiscreteGaussianImageFilter", numberOfWorkUnits, &Self::CalibrateSeparableConvolution);
+      return cost * numberOfPixels * sumOfKernelWidths;
+    }
+    case ConvolutionMethodEnum::FFT:
+    {
+      if constexpr (FFTApplies)
+      {
+        if (!this->CanConvolveInFourierDomain())
+        {
+          return notApplicable;
+        }
+        // The requested region padded by the kernel radius, then to a size
+        // suitable for the Fourier transform.
+        const SizeValueType greatestPrimeFactor =
+          FFTConvolutionImageFilter<RealOutputImageType, RealOutputImageType, OutputImageType>::New()
+            ->GetSizeGreatestPrimeFactor();
+        double paddedSize = 1.0;
+        for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+        {
+          const SizeValueType radius = dim < filterDimensionality ? this->GetKernelRadius(dim) : 0;
+          paddedSize *= ConvolutionCostModel::GetFFTSize(region.GetSize(dim) + 2 * radius, greatestPrimeFactor);
+        }
+        const double cost = ConvolutionCostModel::GetCost(
+          "FFTDiscreteGaussianImageFilter", numberOfWorkUnits, &Self::CalibrateFFTConvolution);
+        return cost * ConvolutionCostModel::GetFFTWork(paddedSize);
+      }
+      return notApplicable;
+    }
+    default:
+      itkExceptionMacro("Cannot estimate the time of " << method);
+  }
+}
+
+template <typename TInputImage, typename TOutputImage>
+bool
+AutomaticDiscreteGaussianImageFilter<TInputImage, TOutputImage>::CanConvolveInFourierDomain() const
+{
+  return FFTApplies && this->GetFilterDimensionality() > 0 &&
+         dynamic_cast<const InputDefaultBoundaryConditionType *>(this->GetInputBoundaryCondition()) != nullptr;
+}
+
+template <typename TInputImage, typename TOutputImage>
+auto
+AutomaticDiscreteGaussianImageFilter<TInputImage, TOutputImage>::SelectConvolutionMethod(
+  const OutputRegionType & region) const -> ConvolutionMethodEnum
+{
+  const double separableTime = this->EstimateTime(ConvolutionMethodEnum::SEPARABLE, region);
+  const double fftTime = this->EstimateTime(ConvolutionMethodEnum::FFT, region);
+  itkDebugMacro("Estimated time of the separable convolution: " << separableTime << " s, in the Fourier domain: "
+                                                                 << fftTime << " s");
+  return fftTime < separableTime ? ConvolutionMethodEnum::FFT : ConvolutionMethodEnum::SEPARABLE;
+}
+
+template <typename TInputImage, typename TOutputImage>
+void
+AutomaticDiscreteGaussianImageFilter<TInputImage, TOutputImage>::GenerateData()
+{
+  m_SelectedConvolutionMethod = m_ConvolutionMethod;
+  if (m_SelectedConvolutionMethod == ConvolutionMethodEnum::AUTOMATIC)
+  {
+    m_SelectedConvolutionMethod = this->SelectConvolutionMethod(this->GetOutput()->GetRequestedRegion());
+  }
+  itkDebugMacro("Convolving with " << m_SelectedConvolutionMethod);
+
+  if (m_SelectedConvolutionMethod == ConvolutionMethodEnum::SEPARABLE || this->GetFilterDimensionality() == 0)
+  {
+    Superclass::GenerateData();
+    return;
+  }
+  if constexpr (FFTApplies)
+  {
+    if (m_SelectedConvolutionMethod == ConvolutionMethodEnum::FFT && this->CanConvolveInFourierDomain())
+    {
+      // Create a process accumulator for tracking the progress of this minipipeline
+      auto progress = ProgressAccumulator::New();
+      progress->SetMiniPipelineFilter(this);
+
+      // Protect the requested region of the input from the minipipeline.
+      auto localInput = InputImageType::New();
+      localInput->Graft(this->GetInput());
+
+      auto fftFilter = FFTDiscreteGaussianImageFilter<TInputImage, TOutputImage>::New();
+      fftFilter->SetInput(localInput);
+      fftFilter->SetVariance(this->GetVariance());
+      fftFilter->SetMaximumError(this->GetMaximumError());
+      fftFilter->SetMaximumKernelWidth(this->GetMaximumKernelWidth());
+      fftFilter->SetFilterDimensionality(this->GetFilterDimensionality());
+      fftFilter->SetUseImageSpacing(this->GetUseImageSpacing());
+      fftFilter->SetRealBoundaryCondition(this->GetRealBoundaryCondition());
+      fftFilter->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+      progress->RegisterInternalFilter(fftFilter, 1.0f);
+
+      fftFilter->GetOutput()->SetRequestedRegion(this->GetOutput()->GetRequestedRegion());
+      fftFilter->Update();
+      this->GraftOutput(fftFilter->GetOutput());
+      return;
+    }
+  }
+  itkExceptionMacro("Cannot convolve with " << m_SelectedConvolutionMethod);
+}
+
+template <typename TInputImage, typename TOutputImage>
+void
+AutomaticDiscreteGaussianImageFilter<TInputImage, TOutputImage>::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "ConvolutionMethod: " << m_ConvolutionMethod << std::endl;
+  os << indent << "SelectedConvolutionMethod: " << m_SelectedConvolutionMethod << std::endl;
+}
+} // end namespace itk
+
+#endif
@@ -22,6 +22,7 @@
 #include "itkImageToImageFilter.h"
 #include "itkImage.h"
 #include "itkZeroFluxNeumannBoundaryCondition.h"
+#include <vector>
 
 namespace itk
 {
@@ -43,6 +44,11 @@ namespace itk
  * When the Gaussian kernel is small, this filter tends to run faster than
  * itk::RecursiveGaussianImageFilter.
  *
+ * Images of scalar pixels are convolved by a fused separable engine, which
+ * filters tiles of the output through all the dimensions without
+ * intermediate images of the size of the output. See
+ * SetUseFusedSeparableEngine().
+ *
  * \sa GaussianOperator
  * \sa Image
  * \sa Neighborhood
@@ -284,6 +290,19 @@ public:
   itkGetConstMacro(UseImageSpacing, bool);
   itkBooleanMacro(UseImageSpacing);
 
+  /** Set/Get whether the filter convolves through its fused separable
+   * engine. The engine splits the output requested region into tiles of a
+   * few slices and filters each tile through all the dimensions, row by
+   * row, with buffers of the size of the tile. Otherwise the filter runs a
+   * pipeline of NeighborhoodOperatorImageFilter, one per dimension, which
+   * allocates an intermediate image per dimension. Both compute the same
+   * output. The engine applies to an Image of scalar pixels with the
+   * default ZeroFluxNeumannBoundaryCondition; other images and boundary
+   * conditions go through the pipeline. Default is On. */
+  itkSetMacro(UseFusedSeparableEngine, bool);
+  itkGetConstMacro(UseFusedSeparableEngine, bool);
+  itkBooleanMacro(UseFusedSeparableEngine);
+
 #if !defined(ITK_FUTURE_LEGACY_REMOVE)
   /** Use the image spacing information in calculations. Use this option if you
    *  want to specify Gaussian variance in real world units.  Default is
@@ -345,8 +364,9 @@ protected:
   GenerateInputRequestedRegion() override;
 
   /** Standard pipeline method. While this class does not implement a
-   * ThreadedGenerateData(), its GenerateData() delegates all
-   * calculations to an NeighborhoodOperatorImageFilter.  Since the
+   * ThreadedGenerateData(), its GenerateData() runs the fused separable
+   * engine on the multithreader, or delegates all calculations to an
+   * NeighborhoodOperatorImageFilter.  Since the
    * NeighborhoodOperatorImageFilter is multithreaded, this filter is
    * multithreaded by default. */
   void
@@ -361,6 +381,32 @@ protected:
   GetKernelVarianceArray() const;
 
 private:
+  using RegionType = typename TOutputImage::RegionType;
+  using IndexType = typename TOutputImage::IndexType;
+
+  /** Convolve the output requested region through the fused separable
+   * engine. */
+  void
+  FusedSeparableGenerateData(const unsigned int filterDimensionality);
+
+  /** Convolve the rows of region along dimension with kernel, from a
+   * buffer laid out over sourceRegion to a buffer laid out over
+   * destinationRegion. The index along dimension is clamped to
+   * [lowerBound, upperBound]. The sums follow the order and the types of
+   * NeighborhoodInnerProduct, so that they equal those of
+   * NeighborhoodOperatorImageFilter. */
+  template <typename TSourcePixel>
+  static void
+  ConvolveRowsAlongDimension(const TSourcePixel *                          source,
+                             const RegionType &                            sourceRegion,
+                             const IndexValueType                          lowerBound,
+                             const IndexValueType                          upperBound,
+                             const unsigned int                            dimension,
+                             const std::vector<RealOutputPixelValueType> & kernel,
+                             OutputPixelType *                             destination,
+                             const RegionType &                            destinationRegion,
+                             const RegionType &                            region);
+
   /** The variance of the gaussian blurring kernel in each dimensional
     direction. */
   ArrayType m_Variance{};
@@ -380,6 +426,9 @@ private:
   /** Flag to indicate whether to use image spacing */
   bool m_UseImageSpacing{};
 
+  /** Flag to indicate whether to use the fused separable engine */
+  bool m_UseFusedSeparableEngine{ true };
+
   /** Pointer to a persistent boundary condition object used
    ** for the image iterator. */
   BoundaryConditionType * m_InputBoundaryCondition{};
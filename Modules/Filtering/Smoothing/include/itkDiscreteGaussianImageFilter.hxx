@@ -23,6 +23,10 @@
 #include "itkImageRegionIterator.h"
 #include "itkProgressAccumulator.h"
 #include "itkImageAlgorithm.h"
+#include "itkMakeUniqueForOverwrite.h"
+
+#include <algorithm>
+#include <type_traits>
 
 namespace itk
 {
@@ -178,6 +182,20 @@ DiscreteGaussianImageFilter<TInputImage, TOutputImage>::GenerateData()
     return;
   }
 
+  if constexpr (std::is_arithmetic_v<InputPixelType> && std::is_arithmetic_v<OutputPixelType> &&
+                std::is_same_v<TInputImage, Image<InputPixelType, ImageDimension>> &&
+                std::is_same_v<TOutputImage, Image<OutputPixelType, ImageDimension>>)
+  {
+    if (m_UseFusedSeparableEngine &&
+        dynamic_cast<const InputDefaultBoundaryConditionType *>(m_InputBoundaryCondition) != nullptr &&
+        (filterDimensionality == 1 ||
+         dynamic_cast<const RealDefaultBoundaryConditionType *>(m_RealBoundaryCondition) != nullptr))
+    {
+      this->FusedSeparableGenerateData(filterDimensionality);
+      return;
+    }
+  }
+
   // Type definition for the internal neighborhood filter
   //
   // First filter convolves and changes type from input type to real type
@@ -313,6 +331,255 @@ DiscreteGaussianImageFilter<TInputImage, TOutputImage>::GenerateData()
   }
 }
 
+template <typename TInputImage, typename TOutputImage>
+template <typename TSourcePixel>
+void
+DiscreteGaussianImageFilter<TInputImage, TOutputImage>::ConvolveRowsAlongDimension(
+  const TSourcePixel *                          source,
+  const RegionType &                            sourceRegion,
+  const IndexValueType                          lowerBound,
+  const IndexValueType                          upperBound,
+  const unsigned int                            dimension,
+  const std::vector<RealOutputPixelValueType> & kernel,
+  OutputPixelType *                             destination,
+  const RegionType &                            destinationRegion,
+  const RegionType &                            region)
+{
+  // The types of NeighborhoodInnerProduct, as NeighborhoodOperatorImageFilter
+  // instantiates it, so that the sums are the same.
+  using SourceRealType = typename NumericTraits<TSourcePixel>::RealType;
+  using AccumulateType = typename NumericTraits<SourceRealType>::AccumulateType;
+
+  OffsetValueType sourceStrides[ImageDimension];
+  OffsetValueType destinationStrides[ImageDimension];
+  sourceStrides[0] = 1;
+  destinationStrides[0] = 1;
+  for (unsigned int d = 1; d < ImageDimension; ++d)
+  {
+    sourceStrides[d] = sourceStrides[d - 1] * static_cast<OffsetValueType>(sourceRegion.GetSize(d - 1));
+    destinationStrides[d] =
+      destinationStrides[d - 1] * static_cast<OffsetValueType>(destinationRegion.GetSize(d - 1));
+  }
+  const auto offsetOf = [](const OffsetValueType * strides, const RegionType & bufferRegion, const IndexType & index) {
+    OffsetValueType offset = 0;
+    for (unsigned int d = 0; d < ImageDimension; ++d)
+    {
+      offset += (index[d] - bufferRegion.GetIndex(d)) * strides[d];
+    }
+    return offset;
+  };
+
+  const auto          radius = static_cast<IndexValueType>(kernel.size() / 2);
+  const SizeValueType width = region.GetSize(0);
+  std::vector<AccumulateType> sums(width);
+  std::vector<SourceRealType> line(dimension == 0 ? width + 2 * radius : 0);
+
+  IndexType           index = region.GetIndex();
+  const SizeValueType numberOfRows = region.GetNumberOfPixels() / width;
+  for (SizeValueType row = 0; row < numberOfRows; ++row)
+  {
+    // The taps are added in the order of the kernel, for each pixel of the
+    // row, which lets the compiler vectorize over the pixels.
+    std::fill(sums.begin(), sums.end(), AccumulateType{});
+    AccumulateType * rowSums = sums.data();
+    if (dimension == 0)
+    {
+      IndexType rowIndex = index;
+      rowIndex[0] = sourceRegion.GetIndex(0);
+      const TSourcePixel * sourceRow = source + offsetOf(sourceStrides, sourceRegion, rowIndex);
+      for (SizeValueType j = 0; j < line.size(); ++j)
+      {
+        const IndexValueType x = std::clamp(index[0] - radius + static_cast<IndexValueType>(j), lowerBound, upperBound);
+        line[j] = static_cast<SourceRealType>(sourceRow[x - sourceRegion.GetIndex(0)]);
+      }
+      for (SizeValueType k = 0; k < kernel.size(); ++k)
+      {
+        const RealOutputPixelValueType coefficient = kernel[k];
+        const SourceRealType *         shifted = line.data() + k;
+        for (SizeValueType x = 0; x < width; ++x)
+        {
+          rowSums[x] += static_cast<AccumulateType>(coefficient * shifted[x]);
+        }
+      }
+    }
+    else if constexpr (ImageDimension > 1)
+    {
+      IndexType sourceIndex = index;
+      for (SizeValueType k = 0; k < kernel.size(); ++k)
+      {
+        sourceIndex[dimension] =
+          std::clamp(index[dimension] - radius + static_cast<IndexValueType>(k), lowerBound, upperBound);
+        const RealOutputPixelValueType coefficient = kernel[k];
+        const TSourcePixel *           sourceRow = source + offsetOf(sourceStrides, sourceRegion, sourceIndex);
+        for (SizeValueType x = 0; x < width; ++x)
+        {
+          rowSums[x] += static_cast<AccumulateType>(coefficient * static_cast<SourceRealType>(sourceRow[x]));
+        }
+      }
+    }
+
+    OutputPixelType * destinationRow = destination + offsetOf(destinationStrides, destinationRegion, index);
+    for (SizeValueType x = 0; x < width; ++x)
+    {
+      destinationRow[x] = static_cast<OutputPixelType>(static_cast<RealOutputPixelType>(rowSums[x]));
+    }
+
+    for (unsigned int d = 1; d < ImageDimension; ++d)
+    {
+      if (++index[d] < region.GetIndex(d) + static_cast<IndexValueType>(region.GetSize(d)))
+      {
+        break;
+      }
+      index[d] = region.GetIndex(d);
+    }
+  }
+}
+
+template <typename TInputImage, typename TOutputImage>
+void
+DiscreteGaussianImageFilter<TInputImage, TOutputImage>::FusedSeparableGenerateData(
+  const unsigned int filterDimensionality)
+{
+  const TInputImage * input = this->GetInput();
+  TOutputImage *      output = this->GetOutput();
+  const RegionType    outputRegion = output->GetRequestedRegion();
+  const RegionType    largestRegion = input->GetLargestPossibleRegion();
+  const RegionType    inputBufferedRegion = input->GetBufferedRegion();
+  if (outputRegion.GetNumberOfPixels() == 0)
+  {
+    return;
+  }
+
+  std::vector<std::vector<RealOutputPixelValueType>> kernels(filterDimensionality);
+  RadiusType                                         radius{};
+  for (unsigned int dim = 0; dim < filterDimensionality; ++dim)
+  {
+    KernelType oper;
+    this->GenerateKernel(dim, oper);
+    radius[dim] = oper.GetRadius(dim);
+    kernels[dim].assign(oper.Begin(), oper.End());
+  }
+
+  // As in the pipeline, the passes go from the last filtered dimension to
+  // the first. Each pass computes the part of the tile that the later
+  // passes read: the tile padded by their radii, within the image.
+  const auto passRegionOf = [&radius, &largestRegion](RegionType tile, const unsigned int dimension) {
+    RadiusType padding{};
+    for (unsigned int d = 0; d < dimension; ++d)
+    {
+      padding[d] = radius[d];
+    }
+    tile.PadByRadius(padding);
+    tile.Crop(largestRegion);
+    return tile;
+  };
+
+  // The tiles span the output requested region in the dimensions filtered
+  // by the later passes, so that no margin is computed twice, and are a few
+  // slices thick along the last filtered dimension.
+  const unsigned int lastDimension = filterDimensionality - 1;
+  const RegionType   firstPassRegion = passRegionOf(outputRegion, lastDimension);
+  SizeValueType      pixelsPerSlice = 1;
+  for (unsigned int d = 0; d < lastDimension; ++d)
+  {
+    pixelsPerSlice *= firstPassRegion.GetSize(d);
+  }
+  SizeValueType numberOfSlicesAbove = 1;
+  for (unsigned int d = filterDimensionality; d < ImageDimension; ++d)
+  {
+    numberOfSlicesAbove *= outputRegion.GetSize(d);
+  }
+
+  // About a MiB of float pixels per tile, and at least a tile per work unit.
+  constexpr SizeValueType tilePixels = SizeValueType{ 1 } << 18;
+  const SizeValueType     numberOfSlices = outputRegion.GetSize(lastDimension);
+  SizeValueType           thickness = std::clamp<SizeValueType>(tilePixels / pixelsPerSlice, 1, numberOfSlices);
+  thickness = std::min(
+    thickness, std::max<SizeValueType>(1, numberOfSlices * numberOfSlicesAbove / this->GetNumberOfWorkUnits()));
+  const SizeValueType numberOfChunks = (numberOfSlices + thickness - 1) / thickness;
+  const SizeValueType numberOfTiles = numberOfChunks * numberOfSlicesAbove;
+
+  this->GetMultiThreader()->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+  this->GetMultiThreader()->ParallelizeArray(
+    0,
+    numberOfTiles,
+    [&](SizeValueType tileNumber) {
+      RegionType          tile = outputRegion;
+      const SizeValueType chunk = tileNumber % numberOfChunks;
+      tile.SetIndex(lastDimension, outputRegion.GetIndex(lastDimension) + chunk * thickness);
+      tile.SetSize(lastDimension, std::min(thickness, numberOfSlices - chunk * thickness));
+      tileNumber /= numberOfChunks;
+      for (unsigned int d = filterDimensionality; d < ImageDimension; ++d)
+      {
+        tile.SetIndex(d, outputRegion.GetIndex(d) + tileNumber % outputRegion.GetSize(d));
+        tile.SetSize(d, 1);
+        tileNumber /= outputRegion.GetSize(d);
+      }
+
+      // Two buffers, for the passes to alternate between. The first pass
+      // computes the largest region.
+      const SizeValueType bufferSize = passRegionOf(tile, lastDimension).GetNumberOfPixels();
+      std::unique_ptr<OutputPixelType[]> buffers[2];
+      if (filterDimensionality > 1)
+      {
+        buffers[0] = make_unique_for_overwrite<OutputPixelType[]>(bufferSize);
+      }
+      if (filterDimensionality > 2)
+      {
+        buffers[1] = make_unique_for_overwrite<OutputPixelType[]>(bufferSize);
+      }
+
+      RegionType previousRegion;
+      for (unsigned int pass = 0; pass < filterDimensionality; ++pass)
+      {
+        const unsigned int dimension = lastDimension - pass;
+        const RegionType   region = passRegionOf(tile, dimension);
+        OutputPixelType *  destination = output->GetBufferPointer();
+        RegionType         destinationRegion = output->GetBufferedRegion();
+        if (dimension > 0)
+        {
+          destination = buffers[pass % 2].get();
+          destinationRegion = region;
+        }
+
+        if (pass == 0)
+        {
+          // The input is clamped at its buffered region, as by the boundary
+          // condition of the first filter of the pipeline.
+          const IndexValueType lowerBound = inputBufferedRegion.GetIndex(dimension);
+          const IndexValueType upperBound = inputBufferedRegion.GetUpperIndex()[dimension];
+          ConvolveRowsAlongDimension(input->GetBufferPointer(),
+                                     inputBufferedRegion,
+                                     lowerBound,
+                                     upperBound,
+                                     dimension,
+                                     kernels[dimension],
+                                     destination,
+                                     destinationRegion,
+                                     region);
+        }
+        else
+        {
+          // The intermediate images of the pipeline end at the largest
+          // possible region, where they are clamped.
+          const IndexValueType lowerBound = largestRegion.GetIndex(dimension);
+          const IndexValueType upperBound = largestRegion.GetUpperIndex()[dimension];
+          ConvolveRowsAlongDimension(static_cast<const OutputPixelType *>(buffers[(pass - 1) % 2].get()),
+                                     previousRegion,
+                                     lowerBound,
+                                     upperBound,
+                                     dimension,
+                                     kernels[dimension],
+                                     destination,
+                                     destinationRegion,
+                                     region);
+        }
+        previousRegion = region;
+      }
+    },
+    this);
+}
+
 #if !defined(ITK_LEGACY_REMOVE)
 template <typename TInputImage, typename TOutputImage>
 unsigned int
@@ -342,6 +609,7 @@ DiscreteGaussianImageFilter<TInputImage, TOutputImage>::PrintSelf(std::ostream &
   os << indent << "MaximumKernelWidth: " << m_MaximumKernelWidth << std::endl;
   os << indent << "FilterDimensionality: " << m_FilterDimensionality << std::endl;
   itkPrintSelfBooleanMacro(UseImageSpacing);
+  itkPrintSelfBooleanMacro(UseFusedSeparableEngine);
   os << indent << "RealBoundaryCondition: " << m_RealBoundaryCondition << std::endl;
 }
 } // end namespace itk
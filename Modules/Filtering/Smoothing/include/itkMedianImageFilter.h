@@ -21,6 +21,8 @@
 #include "itkBoxImageFilter.h"
 #include "itkImage.h"
 
+#include <type_traits>
+
 namespace itk
 {
 /**
@@ -36,6 +38,15 @@ namespace itk
  * This filter requires that the input pixel type provides an operator<()
  * (LessThan Comparable).
  *
+ * For integer pixel types of at most 16 bits, the filter slides a histogram
+ * of the neighborhood along each scanline, in the manner of Huang's
+ * algorithm: moving to the next pixel removes the pixels of one face of the
+ * neighborhood and adds those of the opposite face, and the median is tracked
+ * through a two-level histogram of coarse and fine bins. The cost per pixel
+ * grows with the area of a face rather than with the volume of the
+ * neighborhood. Other pixel types select the median of a copy of each
+ * neighborhood. Both give the same output.
+ *
  * \sa Image
  * \sa Neighborhood
  * \sa NeighborhoodOperator
@@ -88,6 +99,10 @@ public:
   itkConceptMacro(InputConvertibleToOutputCheck, (Concept::Convertible<InputPixelType, OutputPixelType>));
   itkConceptMacro(InputLessThanComparableCheck, (Concept::LessThanComparable<InputPixelType>));
 
+  /** Whether the median is found through a sliding histogram, which is the
+   * case for integer pixel types of at most 16 bits. */
+  static constexpr bool UsesHistogram = std::is_integral_v<InputPixelType> && sizeof(InputPixelType) <= 2;
+
 protected:
   MedianImageFilter();
   ~MedianImageFilter() override = default;
@@ -104,6 +119,12 @@ protected:
    *     ImageToImageFilter::GenerateData() */
   void
   DynamicThreadedGenerateData(const OutputImageRegionType & outputRegionForThread) override;
+
+private:
+  /** Computes the median of each pixel of the region with a histogram that
+   * slides along the scanlines. */
+  void
+  GenerateDataWithHistogram(const OutputImageRegionType & outputRegionForThread);
 };
 } // end namespace itk
 
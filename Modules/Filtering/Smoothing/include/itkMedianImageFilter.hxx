@@ -21,6 +21,7 @@
 #include "itkBufferedImageNeighborhoodPixelAccessPolicy.h"
 #include "itkImageNeighborhoodOffsets.h"
 #include "itkImageRegionRange.h"
+#include "itkImageScanlineIterator.h"
 #include "itkIndexRange.h"
 #include "itkNeighborhoodAlgorithm.h"
 #include "itkOffset.h"
@@ -29,6 +30,7 @@
 
 #include <vector>
 #include <algorithm>
+#include <limits>
 
 namespace itk
 {
@@ -44,6 +46,12 @@ void
 MedianImageFilter<TInputImage, TOutputImage>::DynamicThreadedGenerateData(
   const OutputImageRegionType & outputRegionForThread)
 {
+  if constexpr (UsesHistogram)
+  {
+    this->GenerateDataWithHistogram(outputRegionForThread);
+    return;
+  }
+
   // Allocate output
   OutputImageType *      output = this->GetOutput();
   const InputImageType * input = this->GetInput();
@@ -104,6 +112,162 @@ MedianImageFilter<TInputImage, TOutputImage>::DynamicThreadedGenerateData(
     }
   }
 }
+
+template <typename TInputImage, typename TOutputImage>
+void
+MedianImageFilter<TInputImage, TOutputImage>::GenerateDataWithHistogram(
+  const OutputImageRegionType & outputRegionForThread)
+{
+  OutputImageType *      output = this->GetOutput();
+  const InputImageType * input = this->GetInput();
+
+  const auto radius = this->GetRadius();
+
+  // The neighborhood extends past the buffered region of the input by
+  // repeating its border pixels, as ZeroFluxNeumannBoundaryCondition does.
+  const InputImageRegionType &  bufferedRegion = input->GetBufferedRegion();
+  const InputPixelType * const  buffer = input->GetBufferPointer();
+  const OffsetValueType * const offsetTable = input->GetOffsetTable();
+  const auto                    clampIndex = [&bufferedRegion](unsigned int d, IndexValueType index) {
+    const IndexValueType first = bufferedRegion.GetIndex(d);
+    return std::clamp(index, first, first + static_cast<IndexValueType>(bufferedRegion.GetSize(d)) - 1) - first;
+  };
+
+  // A histogram of fine bins, one per pixel value, and of coarse bins, each
+  // the sum of binsPerCoarseBin fine bins. The median is tracked as the
+  // bin that holds the rank-th smallest value of the neighborhood, along with
+  // the number of values below that bin.
+  constexpr unsigned int  bitsPerPixel = 8 * sizeof(InputPixelType);
+  constexpr SizeValueType numberOfBins = SizeValueType{ 1 } << bitsPerPixel;
+  constexpr SizeValueType binsPerCoarseBin = SizeValueType{ 1 } << (bitsPerPixel / 2);
+  const auto              minimumValue = static_cast<OffsetValueType>(std::numeric_limits<InputPixelType>::min());
+
+  std::vector<SizeValueType> fineBins(numberOfBins);
+  std::vector<SizeValueType> coarseBins(numberOfBins / binsPerCoarseBin);
+  SizeValueType              medianBin = 0;
+  SizeValueType              numberBelowMedianBin = 0;
+
+  const auto addPixel = [&](const InputPixelType value) {
+    const auto bin = static_cast<SizeValueType>(static_cast<OffsetValueType>(value) - minimumValue);
+    ++fineBins[bin];
+    ++coarseBins[bin / binsPerCoarseBin];
+    numberBelowMedianBin += (bin < medianBin);
+  };
+  const auto removePixel = [&](const InputPixelType value) {
+    const auto bin = static_cast<SizeValueType>(static_cast<OffsetValueType>(value) - minimumValue);
+    --fineBins[bin];
+    --coarseBins[bin / binsPerCoarseBin];
+    numberBelowMedianBin -= (bin < medianBin);
+  };
+
+  // The median moves from its previous bin, skipping whole coarse bins when
+  // it can.
+  const auto updateMedianBin = [&](const SizeValueType rank) {
+    while (numberBelowMedianBin > rank)
+    {
+      if (medianBin % binsPerCoarseBin == 0)
+      {
+        const SizeValueType coarseBinBelow = coarseBins[medianBin / binsPerCoarseBin - 1];
+        if (numberBelowMedianBin - coarseBinBelow > rank)
+        {
+          numberBelowMedianBin -= coarseBinBelow;
+          medianBin -= binsPerCoarseBin;
+          continue;
+        }
+      }
+      --medianBin;
+      numberBelowMedianBin -= fineBins[medianBin];
+    }
+    while (numberBelowMedianBin + fineBins[medianBin] <= rank)
+    {
+      if (medianBin % binsPerCoarseBin == 0)
+      {
+        const SizeValueType coarseBin = coarseBins[medianBin / binsPerCoarseBin];
+        if (numberBelowMedianBin + coarseBin <= rank)
+        {
+          numberBelowMedianBin += coarseBin;
+          medianBin += binsPerCoarseBin;
+          continue;
+        }
+      }
+      numberBelowMedianBin += fineBins[medianBin];
+      ++medianBin;
+    }
+  };
+
+  // The face of the neighborhood perpendicular to the scanlines. All of our
+  // neighborhoods have an odd number of pixels, so there is always a median.
+  SizeValueType faceSize = 1;
+  for (unsigned int d = 1; d < InputImageDimension; ++d)
+  {
+    faceSize *= 2 * radius[d] + 1;
+  }
+  const SizeValueType rank = faceSize * (2 * radius[0] + 1) / 2;
+  const auto          radius0 = static_cast<IndexValueType>(radius[0]);
+
+  std::vector<OffsetValueType> faceOffsets(faceSize);
+  const auto                   addColumn = [&](const IndexValueType x) {
+    const InputPixelType * const column = buffer + clampIndex(0, x);
+    for (const OffsetValueType offset : faceOffsets)
+    {
+      addPixel(column[offset]);
+    }
+  };
+  const auto removeColumn = [&](const IndexValueType x) {
+    const InputPixelType * const column = buffer + clampIndex(0, x);
+    for (const OffsetValueType offset : faceOffsets)
+    {
+      removePixel(column[offset]);
+    }
+  };
+
+  TotalProgressReporter progress(this, output->GetRequestedRegion().GetNumberOfPixels());
+
+  for (ImageScanlineIterator<OutputImageType> outputIt(output, outputRegionForThread); !outputIt.IsAtEnd();
+       outputIt.NextLine())
+  {
+    const auto lineIndex = outputIt.GetIndex();
+    for (SizeValueType f = 0; f < faceSize; ++f)
+    {
+      SizeValueType   remainder = f;
+      OffsetValueType offset = 0;
+      for (unsigned int d = 1; d < InputImageDimension; ++d)
+      {
+        const SizeValueType width = 2 * radius[d] + 1;
+        const auto          neighborOffset =
+          static_cast<IndexValueType>(remainder % width) - static_cast<IndexValueType>(radius[d]);
+        remainder /= width;
+        offset += clampIndex(d, lineIndex[d] + neighborOffset) * offsetTable[d];
+      }
+      faceOffsets[f] = offset;
+    }
+
+    // Slide the histogram along the line, and empty it at the end.
+    IndexValueType x = lineIndex[0];
+    for (IndexValueType column = x - radius0; column <= x + radius0; ++column)
+    {
+      addColumn(column);
+    }
+    for (; !outputIt.IsAtEndOfLine(); ++outputIt, ++x)
+    {
+      if (x > lineIndex[0])
+      {
+        removeColumn(x - radius0 - 1);
+        addColumn(x + radius0);
+      }
+      updateMedianBin(rank);
+      const auto median = static_cast<InputPixelType>(static_cast<OffsetValueType>(medianBin) + minimumValue);
+      outputIt.Set(static_cast<OutputPixelType>(median));
+      progress.CompletedPixel();
+    }
+    for (IndexValueType column = x - 1 - radius0; column <= x - 1 + radius0; ++column)
+    {
+      removeColumn(column);
+    }
+    medianBin = 0;
+    numberBelowMedianBin = 0;
+  }
+}
 } // end namespace itk
 
 #endif
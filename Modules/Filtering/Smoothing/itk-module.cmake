@@ -6,8 +6,9 @@ interesting to look at the \\\\ref ITKAnisotropicSmoothing group of filters.")
 itk_module(
   ITKSmoothing
   ENABLE_SHARED
-  COMPILE_DEPENDS
+  DEPENDS
   ITKConvolution
+  COMPILE_DEPENDS
   ITKFFT
   ITKImageFunction
   ITKImageSources
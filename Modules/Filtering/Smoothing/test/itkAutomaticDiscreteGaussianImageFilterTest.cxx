@@ -0,0 +1,212 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkAutomaticDiscreteGaussianImageFilter.h"
+#include "itkFFTDiscreteGaussianImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIterator.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkPeriodicBoundaryCondition.h"
+#include "itkStreamingImageFilter.h"
+#include "itkTimeProbe.h"
+#include "itkTestingMacros.h"
+#include "itksys/SystemTools.hxx"
+
+#include <algorithm>
+#include <cmath>
+
+/*
+ * Smooths a 3D image through each method of
+ * AutomaticDiscreteGaussianImageFilter, compares the outputs with
+ * DiscreteGaussianImageFilter and FFTDiscreteGaussianImageFilter, checks the
+ * methods chosen with given costs and with costs measured on this machine,
+ * and reports the estimated and measured times for increasing sigma.
+ */
+
+namespace
+{
+constexpr unsigned int Dimension = 3;
+using ImageType = itk::Image<float, Dimension>;
+using FilterType = itk::AutomaticDiscreteGaussianImageFilter<ImageType>;
+using ConvolutionMethodEnum = itk::ConvolutionCostModelEnums::ConvolutionMethod;
+
+template <typename TImage>
+typename TImage::Pointer
+MakeNoiseImage(unsigned int size)
+{
+  auto image = TImage::New();
+  image->SetRegions(TImage::SizeType::Filled(size));
+  image->Allocate();
+  auto generator = itk::Statistics::MersenneTwisterRandomVariateGenerator::New();
+  generator->Initialize(20240617);
+  for (itk::ImageRegionIterator<TImage> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    it.Set(static_cast<typename TImage::PixelType>(generator->GetUniformVariate(0.0, 1000.0)));
+  }
+  return image;
+}
+
+template <typename TFilter>
+ImageType::Pointer
+Smooth(TFilter * filter, const ImageType * image, double sigma, unsigned int numberOfStreamDivisions = 1)
+{
+  filter->SetInput(image);
+  filter->SetSigma(sigma);
+  filter->SetMaximumKernelWidth(128);
+  auto streamer = itk::StreamingImageFilter<ImageType, ImageType>::New();
+  streamer->SetInput(filter->GetOutput());
+  streamer->SetNumberOfStreamDivisions(numberOfStreamDivisions);
+  streamer->Update();
+  return streamer->GetOutput();
+}
+
+ImageType::Pointer
+SmoothWith(ConvolutionMethodEnum method,
+           const ImageType *     image,
+           double                sigma,
+           unsigned int          numberOfStreamDivisions = 1)
+{
+  auto filter = FilterType::New();
+  filter->SetConvolutionMethod(method);
+  return Smooth(filter.GetPointer(), image, sigma, numberOfStreamDivisions);
+}
+
+// Returns the largest difference relative to the largest value of reference.
+double
+RelativeDifference(const ImageType * output, const ImageType * reference)
+{
+  double                                   maximumValue = 0.0;
+  double                                   maximumDifference = 0.0;
+  itk::ImageRegionConstIterator<ImageType> outputIt(output, output->GetBufferedRegion());
+  for (itk::ImageRegionConstIterator<ImageType> it(reference, reference->GetBufferedRegion()); !it.IsAtEnd();
+       ++it, ++outputIt)
+  {
+    maximumValue = std::max(maximumValue, std::abs(static_cast<double>(it.Get())));
+    maximumDifference = std::max(maximumDifference, std::abs(static_cast<double>(outputIt.Get() - it.Get())));
+  }
+  return maximumDifference / maximumValue;
+}
+
+ConvolutionMethodEnum
+SelectedMethod(const ImageType * image, double sigma)
+{
+  auto filter = FilterType::New();
+  Smooth(filter.GetPointer(), image, sigma);
+  return filter->GetSelectedConvolutionMethod();
+}
+} // namespace
+
+int
+itkAutomaticDiscreteGaussianImageFilterTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " costModelCacheFile [imageSize]" << std::endl;
+    return EXIT_FAILURE;
+  }
+  itksys::SystemTools::RemoveFile(argv[1]);
+  itk::ConvolutionCostModel::SetGlobalCacheFileName(argv[1]);
+  const unsigned int imageSize = (argc > 2) ? std::stoi(argv[2]) : 40;
+
+  auto filter = FilterType::New();
+  ITK_EXERCISE_BASIC_OBJECT_METHODS(filter, AutomaticDiscreteGaussianImageFilter, DiscreteGaussianImageFilter);
+  ITK_TEST_SET_GET_VALUE(ConvolutionMethodEnum::AUTOMATIC, filter->GetConvolutionMethod());
+  filter->SetConvolutionMethod(ConvolutionMethodEnum::FFT);
+  ITK_TEST_SET_GET_VALUE(ConvolutionMethodEnum::FFT, filter->GetConvolutionMethod());
+
+  const auto image = MakeNoiseImage<ImageType>(imageSize);
+
+  // The methods compute the outputs of the filters they delegate to.
+  auto       discreteGaussian = itk::DiscreteGaussianImageFilter<ImageType>::New();
+  const auto separableReference = Smooth(discreteGaussian.GetPointer(), image, 2.0);
+  auto       fftDiscreteGaussian = itk::FFTDiscreteGaussianImageFilter<ImageType>::New();
+  const auto fftReference = Smooth(fftDiscreteGaussian.GetPointer(), image, 2.0);
+  const auto separable = SmoothWith(ConvolutionMethodEnum::SEPARABLE, image, 2.0);
+  const auto fft = SmoothWith(ConvolutionMethodEnum::FFT, image, 2.0);
+  const auto fftStreamed = SmoothWith(ConvolutionMethodEnum::FFT, image, 2.0, 3);
+  std::cout << "Separable: " << RelativeDifference(separable, separableReference) << std::endl;
+  std::cout << "FFT: " << RelativeDifference(fft, fftReference) << std::endl;
+  std::cout << "FFT, streamed: " << RelativeDifference(fftStreamed, fftReference) << std::endl;
+  std::cout << "FFT against separable: " << RelativeDifference(fft, separableReference) << std::endl;
+  ITK_TEST_EXPECT_EQUAL(RelativeDifference(separable, separableReference), 0.0);
+  ITK_TEST_EXPECT_EQUAL(RelativeDifference(fft, fftReference), 0.0);
+  ITK_TEST_EXPECT_TRUE(RelativeDifference(fftStreamed, fftReference) < 1e-5);
+  ITK_TEST_EXPECT_TRUE(RelativeDifference(fft, separableReference) < 1e-3);
+
+  // Given costs select the cheapest method, for the number of work units of
+  // the filter.
+  const itk::ThreadIdType numberOfWorkUnits = filter->GetNumberOfWorkUnits();
+  itk::ConvolutionCostModel::SetCost("DiscreteGaussianImageFilter", numberOfWorkUnits, 1e-9);
+  itk::ConvolutionCostModel::SetCost("FFTDiscreteGaussianImageFilter", numberOfWorkUnits, 1.0);
+  ITK_TEST_EXPECT_EQUAL(SelectedMethod(image, 2.0), ConvolutionMethodEnum::SEPARABLE);
+  itk::ConvolutionCostModel::SetCost("DiscreteGaussianImageFilter", numberOfWorkUnits, 1.0);
+  itk::ConvolutionCostModel::SetCost("FFTDiscreteGaussianImageFilter", numberOfWorkUnits, 1e-9);
+  ITK_TEST_EXPECT_EQUAL(SelectedMethod(image, 2.0), ConvolutionMethodEnum::FFT);
+
+  // The Fourier domain does not apply to other boundary conditions, or to
+  // input and output images of different types.
+  itk::PeriodicBoundaryCondition<ImageType> periodicBoundaryCondition;
+  filter = FilterType::New();
+  filter->SetInputBoundaryCondition(&periodicBoundaryCondition);
+  Smooth(filter.GetPointer(), image, 2.0);
+  ITK_TEST_EXPECT_EQUAL(filter->GetSelectedConvolutionMethod(), ConvolutionMethodEnum::SEPARABLE);
+  filter->SetConvolutionMethod(ConvolutionMethodEnum::FFT);
+  ITK_TRY_EXPECT_EXCEPTION(filter->Update());
+
+  using ShortImageType = itk::Image<short, Dimension>;
+  auto shortFilter = itk::AutomaticDiscreteGaussianImageFilter<ShortImageType, ImageType>::New();
+  shortFilter->SetInput(MakeNoiseImage<ShortImageType>(16));
+  shortFilter->Update();
+  ITK_TEST_EXPECT_EQUAL(shortFilter->GetSelectedConvolutionMethod(), ConvolutionMethodEnum::SEPARABLE);
+  ITK_TEST_EXPECT_EQUAL(shortFilter->EstimateTime(ConvolutionMethodEnum::FFT, image->GetLargestPossibleRegion()),
+                        itk::NumericTraits<double>::max());
+
+  // Measured costs, written to the cache file, select the separable
+  // convolution for a small sigma.
+  itk::ConvolutionCostModel::Clear();
+  ITK_TEST_EXPECT_EQUAL(SelectedMethod(image, 1.0), ConvolutionMethodEnum::SEPARABLE);
+  ITK_TEST_EXPECT_TRUE(itk::ConvolutionCostModel::HasCost("FFTDiscreteGaussianImageFilter", numberOfWorkUnits));
+  ITK_TEST_EXPECT_TRUE(itksys::SystemTools::FileExists(argv[1]));
+
+  for (const double sigma : { 1.0, 2.0, 4.0, 8.0, 16.0 })
+  {
+    filter = FilterType::New();
+    filter->SetInput(image);
+    filter->SetSigma(sigma);
+    filter->SetMaximumKernelWidth(128);
+    filter->UpdateOutputInformation();
+    const auto   region = image->GetLargestPossibleRegion();
+    const double separableEstimate = filter->EstimateTime(ConvolutionMethodEnum::SEPARABLE, region);
+    const double fftEstimate = filter->EstimateTime(ConvolutionMethodEnum::FFT, region);
+
+    itk::TimeProbe separableProbe;
+    separableProbe.Start();
+    SmoothWith(ConvolutionMethodEnum::SEPARABLE, image, sigma);
+    separableProbe.Stop();
+    itk::TimeProbe fftProbe;
+    fftProbe.Start();
+    SmoothWith(ConvolutionMethodEnum::FFT, image, sigma);
+    fftProbe.Stop();
+    std::cout << "Sigma " << sigma << ": separable " << separableProbe.GetTotal() << " s (estimated "
+              << separableEstimate << " s), FFT " << fftProbe.GetTotal() << " s (estimated " << fftEstimate
+              << " s), selects " << SelectedMethod(image, sigma) << std::endl;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
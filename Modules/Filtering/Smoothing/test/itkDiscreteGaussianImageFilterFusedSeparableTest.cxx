@@ -0,0 +1,168 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkDiscreteGaussianImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIterator.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkPeriodicBoundaryCondition.h"
+#include "itkStreamingImageFilter.h"
+#include "itkTimeProbe.h"
+#include "itkTestingMacros.h"
+
+#include <functional>
+#include <string>
+
+/*
+ * Smooths images through the fused separable engine of
+ * DiscreteGaussianImageFilter and through its pipeline of
+ * NeighborhoodOperatorImageFilter, checks that the outputs are equal, and
+ * reports the speedup for sigma from 1 to the given maximum.
+ */
+
+namespace
+{
+template <typename TImage>
+typename TImage::Pointer
+MakeNoiseImage(const typename TImage::SizeType & size, double minimum, double maximum)
+{
+  auto image = TImage::New();
+  image->SetRegions(size);
+  image->Allocate();
+  auto generator = itk::Statistics::MersenneTwisterRandomVariateGenerator::New();
+  generator->Initialize(20240613);
+  for (itk::ImageRegionIterator<TImage> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    it.Set(static_cast<typename TImage::PixelType>(generator->GetUniformVariate(minimum, maximum)));
+  }
+  return image;
+}
+
+template <typename TInputImage, typename TOutputImage>
+bool
+CompareEngines(const std::string &                                                                 name,
+               const TInputImage *                                                                 image,
+               const std::function<void(itk::DiscreteGaussianImageFilter<TInputImage, TOutputImage> *)> & configure,
+               unsigned int numberOfStreamDivisions = 1)
+{
+  using FilterType = itk::DiscreteGaussianImageFilter<TInputImage, TOutputImage>;
+
+  typename TOutputImage::Pointer outputs[2];
+  double                         times[2];
+  for (unsigned int fused = 0; fused < 2; ++fused)
+  {
+    auto filter = FilterType::New();
+    filter->SetInput(image);
+    configure(filter);
+    filter->SetUseFusedSeparableEngine(fused == 1);
+
+    // The fused engine runs on the output requested region of each piece.
+    auto streamer = itk::StreamingImageFilter<TOutputImage, TOutputImage>::New();
+    streamer->SetInput(filter->GetOutput());
+    streamer->SetNumberOfStreamDivisions(fused == 1 ? numberOfStreamDivisions : 1);
+
+    itk::TimeProbe probe;
+    probe.Start();
+    streamer->Update();
+    probe.Stop();
+    times[fused] = probe.GetTotal();
+    outputs[fused] = streamer->GetOutput();
+  }
+  std::cout << name << ": " << times[0] << " s through the pipeline, " << times[1] << " s fused, speedup "
+            << times[0] / times[1] << std::endl;
+
+  itk::ImageRegionConstIterator<TOutputImage> fusedIt(outputs[1], outputs[1]->GetBufferedRegion());
+  for (itk::ImageRegionConstIterator<TOutputImage> it(outputs[0], outputs[0]->GetBufferedRegion()); !it.IsAtEnd();
+       ++it, ++fusedIt)
+  {
+    if (it.Get() != fusedIt.Get())
+    {
+      std::cerr << name << ": the fused engine computes " << static_cast<double>(fusedIt.Get()) << " at "
+                << it.GetIndex() << " instead of " << static_cast<double>(it.Get()) << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
+
+int
+itkDiscreteGaussianImageFilterFusedSeparableTest(int argc, char * argv[])
+{
+  const unsigned int imageSize = (argc > 1) ? std::stoi(argv[1]) : 48;
+  const unsigned int maximumSigma = (argc > 2) ? std::stoi(argv[2]) : 8;
+
+  using FloatImageType = itk::Image<float, 3>;
+  using ShortImageType = itk::Image<short, 3>;
+  using UCharImageType = itk::Image<unsigned char, 2>;
+
+  auto filter = itk::DiscreteGaussianImageFilter<FloatImageType>::New();
+  ITK_TEST_SET_GET_BOOLEAN(filter, UseFusedSeparableEngine, false);
+  ITK_TEST_SET_GET_BOOLEAN(filter, UseFusedSeparableEngine, true);
+
+  bool success = true;
+
+  const auto floatImage = MakeNoiseImage<FloatImageType>(FloatImageType::SizeType::Filled(imageSize), 0.0, 1000.0);
+  for (unsigned int sigma = 1; sigma <= maximumSigma; ++sigma)
+  {
+    success &= CompareEngines<FloatImageType, FloatImageType>(
+      "float, sigma " + std::to_string(sigma), floatImage, [sigma](auto * discreteGaussian) {
+        discreteGaussian->SetSigma(sigma);
+        discreteGaussian->SetMaximumKernelWidth(8 * sigma + 1);
+      });
+  }
+
+  // Anisotropic spacing and sigma, and an integer input.
+  auto shortImage = MakeNoiseImage<ShortImageType>(itk::MakeSize(imageSize, imageSize / 2 + 3, 7), -1000.0, 3000.0);
+  shortImage->SetSpacing(itk::MakeVector(0.8, 1.0, 2.5));
+  success &= CompareEngines<ShortImageType, FloatImageType>(
+    "short to float, anisotropic", shortImage, [](auto * discreteGaussian) {
+      discreteGaussian->SetVariance(itk::MakeVector(2.0, 5.0, 9.0));
+      discreteGaussian->SetMaximumError(0.001);
+    });
+
+  // Smoothing the slices only, and streaming.
+  success &= CompareEngines<FloatImageType, FloatImageType>(
+    "float, slices only", floatImage, [](auto * discreteGaussian) {
+      discreteGaussian->SetSigma(2.0);
+      discreteGaussian->SetFilterDimensionality(2);
+    });
+  success &= CompareEngines<FloatImageType, FloatImageType>(
+    "float, 5 stream divisions", floatImage, [](auto * discreteGaussian) { discreteGaussian->SetSigma(3.0); }, 5);
+
+  // The intermediate images of the pipeline round to the output pixel type.
+  const auto ucharImage = MakeNoiseImage<UCharImageType>(itk::MakeSize(101, 67), 0.0, 255.0);
+  success &= CompareEngines<UCharImageType, UCharImageType>(
+    "unsigned char, 2D", ucharImage, [](auto * discreteGaussian) { discreteGaussian->SetSigma(1.5); });
+
+  // Other boundary conditions go through the pipeline.
+  itk::PeriodicBoundaryCondition<FloatImageType> periodicBoundaryCondition;
+  success &= CompareEngines<FloatImageType, FloatImageType>(
+    "float, periodic boundary", floatImage, [&periodicBoundaryCondition](auto * discreteGaussian) {
+      discreteGaussian->SetSigma(2.0);
+      discreteGaussian->SetInputBoundaryCondition(&periodicBoundaryCondition);
+      discreteGaussian->SetRealBoundaryCondition(&periodicBoundaryCondition);
+    });
+
+  if (!success)
+  {
+    std::cout << "Test FAILED!" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
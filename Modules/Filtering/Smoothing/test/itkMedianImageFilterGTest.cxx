@@ -122,3 +122,76 @@ TEST(MedianImageFilter, ExpectedOutputPixelValuesForSequenceOfNaturalNumbers)
   Expect_output_has_specified_pixel_values_when_input_has_sequence_of_natural_numbers<itk::Image<int, 3>>(
     itk::Size<3>{ { 2, 2, 2 } }, { 3, 3, 3, 4, 5, 6, 6, 6 });
 }
+
+
+namespace
+{
+// Expects the median of an integer image, found through the sliding histogram, to equal the median of the same
+// values as float pixels, found by selection.
+template <typename TPixel, unsigned int VDimension>
+void
+Expect_histogram_median_equal_to_selected_median(const itk::Size<VDimension> & imageSize,
+                                                 const itk::Size<VDimension> & radius,
+                                                 const int                     minimumValue,
+                                                 const int                     maximumValue)
+{
+  using ImageType = itk::Image<TPixel, VDimension>;
+  using FloatImageType = itk::Image<float, VDimension>;
+  static_assert(itk::MedianImageFilter<ImageType, ImageType>::UsesHistogram);
+  static_assert(!itk::MedianImageFilter<FloatImageType, FloatImageType>::UsesHistogram);
+
+  const auto image = ImageType::New();
+  image->SetRegions(imageSize);
+  image->Allocate();
+  const auto floatImage = FloatImageType::New();
+  floatImage->SetRegions(imageSize);
+  floatImage->Allocate();
+
+  // A linear congruential sequence, over a few distinct values so that the
+  // neighborhoods have ties.
+  unsigned int state = 12345;
+  auto         floatPixelIt = itk::MakeImageBufferRange(floatImage.GetPointer()).begin();
+  for (TPixel & pixel : itk::MakeImageBufferRange(image.GetPointer()))
+  {
+    state = 1103515245u * state + 12345u;
+    pixel = static_cast<TPixel>(minimumValue + static_cast<int>((state >> 8) % (maximumValue - minimumValue + 1)));
+    *floatPixelIt++ = static_cast<float>(pixel);
+  }
+
+  const auto filter = itk::MedianImageFilter<ImageType, ImageType>::New();
+  filter->SetInput(image);
+  filter->SetRadius(radius);
+  filter->Update();
+  const auto floatFilter = itk::MedianImageFilter<FloatImageType, FloatImageType>::New();
+  floatFilter->SetInput(floatImage);
+  floatFilter->SetRadius(radius);
+  floatFilter->Update();
+
+  const auto outputRange = itk::MakeImageBufferRange(filter->GetOutput());
+  const auto floatOutputRange = itk::MakeImageBufferRange(floatFilter->GetOutput());
+  ASSERT_EQ(outputRange.size(), floatOutputRange.size());
+  for (size_t i = 0; i < outputRange.size(); ++i)
+  {
+    ASSERT_EQ(static_cast<float>(outputRange[i]), floatOutputRange[i]) << "at pixel " << i;
+  }
+}
+} // namespace
+
+
+// Tests that the median of 8 and 16 bit integer images, found through the sliding histogram, equals the median found
+// by selection, including at the border of the image and for radii larger than the image.
+TEST(MedianImageFilter, HistogramMedianEqualsSelectedMedian)
+{
+  Expect_histogram_median_equal_to_selected_median<unsigned char, 2>(
+    itk::Size<2>{ { 37, 23 } }, itk::Size<2>{ { 3, 1 } }, 0, 255);
+  Expect_histogram_median_equal_to_selected_median<signed char, 2>(
+    itk::Size<2>{ { 17, 19 } }, itk::Size<2>{ { 2, 4 } }, -128, 127);
+  Expect_histogram_median_equal_to_selected_median<unsigned char, 3>(
+    itk::Size<3>{ { 5, 4, 3 } }, itk::Size<3>{ { 4, 3, 5 } }, 10, 13);
+  Expect_histogram_median_equal_to_selected_median<short, 3>(
+    itk::Size<3>{ { 21, 14, 9 } }, itk::Size<3>{ { 2, 1, 3 } }, -1024, 3071);
+  Expect_histogram_median_equal_to_selected_median<unsigned short, 3>(
+    itk::Size<3>{ { 16, 15, 13 } }, itk::Size<3>{ { 1, 2, 2 } }, 0, 65535);
+  Expect_histogram_median_equal_to_selected_median<unsigned short, 3>(
+    itk::Size<3>{ { 12, 11, 10 } }, itk::Size<3>{ { 0, 3, 1 } }, 1000, 1007);
+}
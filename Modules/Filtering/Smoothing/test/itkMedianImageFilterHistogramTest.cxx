@@ -0,0 +1,125 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkMedianImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkTimeProbe.h"
+#include "itkTestingMacros.h"
+
+#include <algorithm>
+#include <cmath>
+
+/*
+ * Filters a CT like 3D image of short pixels, through the sliding histogram,
+ * and the same image of float pixels, through selection, for increasing
+ * radii. Checks that the outputs are equal and reports the speedup.
+ */
+
+namespace
+{
+constexpr unsigned int Dimension = 3;
+using ShortImageType = itk::Image<short, Dimension>;
+using FloatImageType = itk::Image<float, Dimension>;
+
+template <typename TImage>
+double
+TimeMedian(const TImage * image, unsigned int radius, typename TImage::Pointer & output)
+{
+  auto filter = itk::MedianImageFilter<TImage, TImage>::New();
+  filter->SetInput(image);
+  filter->SetRadius(radius);
+  itk::TimeProbe probe;
+  probe.Start();
+  filter->Update();
+  probe.Stop();
+  output = filter->GetOutput();
+  return probe.GetTotal();
+}
+} // namespace
+
+int
+itkMedianImageFilterHistogramTest(int argc, char * argv[])
+{
+  const unsigned int imageSize = (argc > 1) ? std::stoi(argv[1]) : 48;
+  const unsigned int maximumRadius = (argc > 2) ? std::stoi(argv[2]) : 4;
+
+  // A body of soft tissue around a bone, in air, with noise.
+  auto shortImage = ShortImageType::New();
+  shortImage->SetRegions(ShortImageType::SizeType::Filled(imageSize));
+  shortImage->Allocate();
+  auto floatImage = FloatImageType::New();
+  floatImage->SetRegions(shortImage->GetBufferedRegion());
+  floatImage->Allocate();
+
+  auto generator = itk::Statistics::MersenneTwisterRandomVariateGenerator::New();
+  generator->Initialize(20240612);
+  const double                                        center = 0.5 * imageSize;
+  itk::ImageRegionIteratorWithIndex<FloatImageType> floatIt(floatImage, floatImage->GetBufferedRegion());
+  for (itk::ImageRegionIteratorWithIndex<ShortImageType> it(shortImage, shortImage->GetBufferedRegion()); !it.IsAtEnd();
+       ++it, ++floatIt)
+  {
+    const auto & index = it.GetIndex();
+    const double distance = std::hypot(index[0] - center, index[1] - center);
+    double       value = -1000.0;
+    if (distance < 0.15 * imageSize)
+    {
+      value = 1200.0;
+    }
+    else if (distance < 0.45 * imageSize)
+    {
+      value = 40.0;
+    }
+    value += generator->GetNormalVariate(0.0, 400.0);
+    it.Set(static_cast<short>(std::clamp(value, -1024.0, 3071.0)));
+    floatIt.Set(it.Get());
+  }
+
+  bool success = true;
+  for (unsigned int radius = 1; radius <= maximumRadius; ++radius)
+  {
+    ShortImageType::Pointer shortOutput;
+    FloatImageType::Pointer floatOutput;
+    const double            histogramTime = TimeMedian(shortImage.GetPointer(), radius, shortOutput);
+    const double            selectionTime = TimeMedian(floatImage.GetPointer(), radius, floatOutput);
+    std::cout << "Radius " << radius << ": " << selectionTime << " s by selection, " << histogramTime
+              << " s by sliding histogram, speedup " << selectionTime / histogramTime << std::endl;
+
+    itk::ImageRegionConstIterator<FloatImageType> floatOutputIt(floatOutput, floatOutput->GetBufferedRegion());
+    for (itk::ImageRegionConstIterator<ShortImageType> it(shortOutput, shortOutput->GetBufferedRegion());
+         !it.IsAtEnd();
+         ++it, ++floatOutputIt)
+    {
+      if (static_cast<float>(it.Get()) != floatOutputIt.Get())
+      {
+        std::cerr << "Radius " << radius << ": median " << it.Get() << " at " << it.GetIndex() << " instead of "
+                  << floatOutputIt.Get() << std::endl;
+        success = false;
+        break;
+      }
+    }
+  }
+
+  if (!success)
+  {
+    std::cout << "Test FAILED!" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
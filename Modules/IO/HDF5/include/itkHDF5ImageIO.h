@@ -80,7 +80,25 @@ namespace itk
  *                             in the MetaDataDictionary
  * re-arrangement.
  *
+ * Voxel data is deflated with the compression level of the ImageIOBase. The
+ * compressor may be set to
+ * \li "" or "GZIP": deflate (the default).
+ * \li "SHUFFLEGZIP": byte shuffle followed by deflate. Grouping the bytes of
+ *     multi-byte components by significance makes 16-bit and floating point
+ *     data compress better and faster, especially at low levels.
+ * \li "NOCOMPRESSION": chunked but unfiltered, for scratch files where
+ *     writing should be bound by the disk rather than the CPU.
  *
+ * All of these use filters built into HDF5, so any HDF5 reader can open the
+ * files.
+ *
+ * By default the voxel data is stored in chunks of one N-1 dimensional slab,
+ * which suits reading slab by slab. Reading small regions along other axes
+ * decompresses whole slabs, so for region of interest access set a chunk size
+ * such as cubic bricks with SetChunkSize(), and turn on streamed reading. Only
+ * the chunks that overlap the requested region are read. SetChunkCacheSize()
+ * sizes the HDF5 chunk cache for reading and writing, which keeps chunks
+ * shared by consecutive requests from being decompressed again.
  */
 
 class ITKIOHDF5_EXPORT HDF5ImageIO : public StreamingImageIOBase
@@ -138,6 +156,20 @@ public:
   void
   Write(const void * buffer) override;
 
+  /** Set/Get the chunk dimensions used when writing, fastest moving
+   * dimension first. A single value gives cubic chunks. Zero or values larger
+   * than the image take the image size along that dimension. Empty, the
+   * default, chunks by N-1 dimensional slab. */
+  virtual void
+  SetChunkSize(const std::vector<SizeValueType> & chunkSize);
+  itkGetConstReferenceMacro(ChunkSize, std::vector<SizeValueType>);
+
+  /** Set/Get the size of the chunk cache in bytes. Zero, the default, keeps
+   * the HDF5 default of 1 MiB. The cache should hold the chunks that one
+   * request touches. */
+  itkSetMacro(ChunkCacheSize, SizeValueType);
+  itkGetConstMacro(ChunkCacheSize, SizeValueType);
+
 protected:
   HDF5ImageIO();
   ~HDF5ImageIO() override;
@@ -148,6 +180,9 @@ protected:
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
+  void
+  InternalSetCompressor(const std::string & _compressor) override;
+
 private:
   void
   WriteString(const std::string & path, const std::string & value);
@@ -217,6 +252,10 @@ private:
   std::unique_ptr<H5::H5File>  m_H5File;
   std::unique_ptr<H5::DataSet> m_VoxelDataSet;
   bool                         m_ImageInformationWritten{ false };
+  bool                         m_UseDeflate{ true };
+  bool                         m_UseShuffle{ false };
+  std::vector<SizeValueType>   m_ChunkSize{};
+  SizeValueType                m_ChunkCacheSize{ 0 };
 };
 } // end namespace itk
 
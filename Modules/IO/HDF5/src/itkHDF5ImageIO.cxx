@@ -24,6 +24,8 @@
 #include "itkMakeUniqueForOverwrite.h"
 
 #include <algorithm>
+#include <functional>
+#include <numeric>
 
 namespace itk
 {
@@ -52,6 +54,49 @@ HDF5ImageIO::PrintSelf(std::ostream & os, Indent indent) const
   Superclass::PrintSelf(os, indent);
   // just prints out the pointer value.
   os << indent << "H5File: " << m_H5File.get() << std::endl;
+  os << indent << "UseDeflate: " << (m_UseDeflate ? "On" : "Off") << std::endl;
+  os << indent << "UseShuffle: " << (m_UseShuffle ? "On" : "Off") << std::endl;
+  os << indent << "ChunkSize:";
+  for (const auto chunk : m_ChunkSize)
+  {
+    os << ' ' << chunk;
+  }
+  os << std::endl;
+  os << indent << "ChunkCacheSize: " << m_ChunkCacheSize << std::endl;
+}
+
+void
+HDF5ImageIO::SetChunkSize(const std::vector<SizeValueType> & chunkSize)
+{
+  if (m_ChunkSize != chunkSize)
+  {
+    m_ChunkSize = chunkSize;
+    this->Modified();
+  }
+}
+
+void
+HDF5ImageIO::InternalSetCompressor(const std::string & _compressor)
+{
+  if (_compressor.empty() || _compressor == "GZIP")
+  {
+    m_UseDeflate = true;
+    m_UseShuffle = false;
+  }
+  else if (_compressor == "SHUFFLEGZIP")
+  {
+    m_UseDeflate = true;
+    m_UseShuffle = true;
+  }
+  else if (_compressor == "NOCOMPRESSION")
+  {
+    m_UseDeflate = false;
+    m_UseShuffle = false;
+  }
+  else
+  {
+    this->Superclass::InternalSetCompressor(_compressor);
+  }
 }
 
 //
@@ -255,6 +300,55 @@ doesAttrExist(const H5::H5Object & object, const char * const name)
   return (H5Aexists(object.getId(), name) > 0 ? true : false);
 }
 
+// Size in bytes of one chunk of a chunked dataset, or of the whole dataset otherwise.
+size_t
+ChunkBytes(const H5::DataSet & dataSet)
+{
+  const H5::DataSpace  space = dataSet.getSpace();
+  const int            rank = space.getSimpleExtentNdims();
+  std::vector<hsize_t> dims(rank);
+  const H5::DSetCreatPropList plist = dataSet.getCreatePlist();
+  if (plist.getLayout() == H5D_CHUNKED)
+  {
+    plist.getChunk(rank, dims.data());
+  }
+  else
+  {
+    space.getSimpleExtentDims(dims.data());
+  }
+  return std::accumulate(dims.begin(), dims.end(), dataSet.getDataType().getSize(), std::multiplies<>());
+}
+
+// Dataset access properties with a chunk cache of cacheSize bytes, or the
+// HDF5 defaults when cacheSize is zero. HDF5 advises a prime number of hash
+// slots around 100 times the number of chunks that fit in the cache.
+H5::DSetAccPropList
+MakeChunkCacheAccessList(size_t chunkBytes, size_t cacheSize)
+{
+  H5::DSetAccPropList dapl;
+  if (cacheSize > 0)
+  {
+    size_t slots = std::clamp<size_t>(100 * (cacheSize / std::max<size_t>(chunkBytes, 1)), 521, size_t{ 1 } << 24);
+    const auto isPrime = [](size_t n) {
+      for (size_t d = 3; d * d <= n; d += 2)
+      {
+        if (n % d == 0)
+        {
+          return false;
+        }
+      }
+      return true;
+    };
+    slots |= 1;
+    while (!isPrime(slots))
+    {
+      slots += 2;
+    }
+    dapl.setChunkCache(slots, cacheSize, H5D_CHUNK_CACHE_W0_DEFAULT);
+  }
+  return dapl;
+}
+
 } // namespace
 
 void
@@ -708,6 +802,11 @@ HDF5ImageIO::ReadImageInformation()
     std::string VoxelDataName(groupName);
     VoxelDataName += VoxelData;
     *(m_VoxelDataSet) = m_H5File->openDataSet(VoxelDataName);
+    if (m_ChunkCacheSize > 0)
+    {
+      *(m_VoxelDataSet) =
+        m_H5File->openDataSet(VoxelDataName, MakeChunkCacheAccessList(ChunkBytes(*m_VoxelDataSet), m_ChunkCacheSize));
+    }
     H5::DataSet         imageSet = *(m_VoxelDataSet);
     const H5::DataSpace imageSpace = imageSet.getSpace();
     //
@@ -1072,21 +1171,47 @@ HDF5ImageIO::WriteImageInformation()
     const H5::PredType  dataType = ComponentToPredType(this->GetComponentType());
 
     // set up properties for chunked, compressed writes.
-    // in this case, set the chunk size to be the N-1 dimension
+    // by default, set the chunk size to be the N-1 dimension
     // region
     const H5::DSetCreatPropList plist;
 
-    // we have implicit compression enabled here?
-    plist.setDeflate(this->GetCompressionLevel());
+    // The shuffle filter has to come first in the pipeline. It does nothing
+    // for single byte components.
+    if (m_UseShuffle && this->GetComponentSize() > 1)
+    {
+      plist.setShuffle();
+    }
+    if (m_UseDeflate)
+    {
+      plist.setDeflate(this->GetCompressionLevel());
+    }
 
-    dims[0] = 1;
+    const int imageDims = this->GetNumberOfDimensions();
+    if (m_ChunkSize.empty())
+    {
+      dims[0] = 1;
+    }
+    else
+    {
+      for (int i = 0; i < imageDims; ++i)
+      {
+        const SizeValueType chunk = m_ChunkSize[std::min<size_t>(i, m_ChunkSize.size() - 1)];
+        if (chunk > 0 && chunk < dims[imageDims - 1 - i])
+        {
+          dims[imageDims - 1 - i] = chunk;
+        }
+      }
+    }
     plist.setChunk(numDims, dims.get());
+    const size_t chunkBytes =
+      std::accumulate(dims.get(), dims.get() + numDims, size_t{ this->GetComponentSize() }, std::multiplies<>());
     dims.reset();
 
     std::string VoxelDataName(ImageGroup);
     VoxelDataName += "/0";
     VoxelDataName += VoxelData;
-    *(m_VoxelDataSet) = m_H5File->createDataSet(VoxelDataName, dataType, imageSpace, plist);
+    *(m_VoxelDataSet) = m_H5File->createDataSet(
+      VoxelDataName, dataType, imageSpace, plist, MakeChunkCacheAccessList(chunkBytes, m_ChunkCacheSize));
     std::string MetaDataGroupName(groupName);
     MetaDataGroupName += MetaDataName;
     m_H5File->createGroup(MetaDataGroupName);
@@ -0,0 +1,188 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// Writes volumes with different chunk shapes, in one piece and streamed, and
+// reads regions of interest back. Also times a column shaped region read from
+// slab and brick chunked files.
+
+#include "itkHDF5ImageIO.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkVector.h"
+#include "itkTimeProbe.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+template <typename TImage>
+typename TImage::Pointer
+MakeImage(const typename TImage::SizeType & size)
+{
+  auto image = TImage::New();
+  image->SetRegions(size);
+  image->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<TImage> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    const auto index = it.GetIndex();
+    it.Set(typename TImage::PixelType(index[0] + 7 * index[1] + 31 * index[2]));
+  }
+  return image;
+}
+
+template <typename TImage>
+typename TImage::Pointer
+ReadRegion(const std::string & fileName, const typename TImage::RegionType & region, itk::SizeValueType cacheSize)
+{
+  auto io = itk::HDF5ImageIO::New();
+  io->SetUseStreamedReading(true);
+  io->SetChunkCacheSize(cacheSize);
+  auto reader = itk::ImageFileReader<TImage>::New();
+  reader->SetFileName(fileName);
+  reader->SetImageIO(io);
+  reader->GetOutput()->SetRequestedRegion(region);
+  reader->Update();
+  return reader->GetOutput();
+}
+
+template <typename TImage>
+bool
+RegionMatches(const TImage * expected, const TImage * actual, const typename TImage::RegionType & region)
+{
+  if (actual->GetBufferedRegion() != region)
+  {
+    std::cerr << "Buffered region " << actual->GetBufferedRegion() << " is not " << region << std::endl;
+    return false;
+  }
+  itk::ImageRegionConstIterator<TImage> expectedIt(expected, region);
+  itk::ImageRegionConstIterator<TImage> actualIt(actual, region);
+  for (; !expectedIt.IsAtEnd(); ++expectedIt, ++actualIt)
+  {
+    if (expectedIt.Get() != actualIt.Get())
+    {
+      std::cerr << "Pixel " << expectedIt.GetIndex() << " is " << actualIt.Get() << " instead of " << expectedIt.Get()
+                << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename TImage>
+bool
+WriteAndReadRegions(const TImage *                          image,
+                    const std::string &                     fileName,
+                    const std::vector<itk::SizeValueType> & chunkSize,
+                    unsigned int                            numberOfStreamDivisions)
+{
+  auto io = itk::HDF5ImageIO::New();
+  io->SetChunkSize(chunkSize);
+  io->SetChunkCacheSize(4 << 20);
+  auto writer = itk::ImageFileWriter<TImage>::New();
+  writer->SetInput(image);
+  writer->SetFileName(fileName);
+  writer->SetImageIO(io);
+  writer->SetNumberOfStreamDivisions(numberOfStreamDivisions);
+  writer->Update();
+
+  bool success = true;
+  for (const itk::SizeValueType cacheSize : { 0, 1 << 20 })
+  {
+    typename TImage::RegionType roi({ { 5, 3, 2 } }, { { 20, 11, 9 } });
+    success &= RegionMatches<TImage>(image, ReadRegion<TImage>(fileName, roi, cacheSize), roi);
+  }
+  const typename TImage::RegionType whole = image->GetLargestPossibleRegion();
+  success &= RegionMatches<TImage>(image, ReadRegion<TImage>(fileName, whole, 0), whole);
+  return success;
+}
+
+// Writes a float volume with the given chunks and returns the time to read a
+// small column through all of its slices.
+double
+TimeColumnRead(const std::string & fileName, itk::SizeValueType size, const std::vector<itk::SizeValueType> & chunkSize)
+{
+  using ImageType = itk::Image<float, 3>;
+  const auto image = MakeImage<ImageType>(ImageType::SizeType::Filled(size));
+  auto       io = itk::HDF5ImageIO::New();
+  io->SetChunkSize(chunkSize);
+  io->SetCompressionLevel(1);
+  auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetInput(image);
+  writer->SetFileName(fileName);
+  writer->SetImageIO(io);
+  writer->Update();
+
+  const ImageType::RegionType column({ { 0, 0, 0 } }, { { 16, 16, size } });
+  itk::TimeProbe              probe;
+  probe.Start();
+  ReadRegion<ImageType>(fileName, column, 0);
+  probe.Stop();
+  return probe.GetTotal();
+}
+} // namespace
+
+int
+itkHDF5ImageIOChunkTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory [size]" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string        directory = argv[1];
+  const itk::SizeValueType size = (argc > 2) ? static_cast<itk::SizeValueType>(std::stoi(argv[2])) : 128;
+
+  auto io = itk::HDF5ImageIO::New();
+  ITK_TEST_EXPECT_TRUE(io->GetChunkSize().empty());
+  ITK_TEST_EXPECT_EQUAL(io->GetChunkCacheSize(), 0);
+  io->SetChunkSize({ 32 });
+  ITK_TEST_EXPECT_EQUAL(io->GetChunkSize().size(), 1);
+  io->SetChunkCacheSize(1 << 20);
+  ITK_TEST_EXPECT_EQUAL(io->GetChunkCacheSize(), 1 << 20);
+
+  using ScalarImageType = itk::Image<short, 3>;
+  using VectorImageType = itk::Image<itk::Vector<float, 2>, 3>;
+  const auto scalarImage = MakeImage<ScalarImageType>({ { 48, 40, 36 } });
+  const auto vectorImage = MakeImage<VectorImageType>({ { 30, 20, 16 } });
+
+  bool success = true;
+  const std::string fileName = directory + "/itkHDF5ImageIOChunkTest.hdf5";
+  // Slabs, cubic bricks, anisotropic bricks with a full extent, and chunks
+  // larger than the image.
+  for (const auto & chunkSize : std::vector<std::vector<itk::SizeValueType>>{ {}, { 16 }, { 16, 8, 0 }, { 100 } })
+  {
+    success &= WriteAndReadRegions<ScalarImageType>(scalarImage, fileName, chunkSize, 1);
+    success &= WriteAndReadRegions<ScalarImageType>(scalarImage, fileName, chunkSize, 5);
+  }
+  success &= WriteAndReadRegions<VectorImageType>(vectorImage, fileName, { 8 }, 1);
+  success &= WriteAndReadRegions<VectorImageType>(vectorImage, fileName, { 8 }, 4);
+
+  std::cout << "Reading a 16x16x" << size << " column of a " << size << "^3 float volume" << std::endl;
+  std::cout << "  slab chunks:  " << TimeColumnRead(fileName, size, {}) << " s" << std::endl;
+  std::cout << "  32^3 bricks:  " << TimeColumnRead(fileName, size, { 32 }) << " s" << std::endl;
+
+  if (!success)
+  {
+    std::cout << "Test FAILED!" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,200 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// Round trips CT and MR like volumes through every HDF5 compressor, and
+// reports the write and read bandwidth and the compression ratio of each.
+// Checks that every compressor reads back the same pixels, that
+// NOCOMPRESSION files hold about the raw pixel data, and that SHUFFLEGZIP
+// files are smaller than those.
+
+#include "itkHDF5ImageIO.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkTimeProbe.h"
+#include "itkTestingMacros.h"
+#include "itksys/SystemTools.hxx"
+
+#include <cmath>
+
+namespace
+{
+// A noisy ellipsoid: air around soft tissue with a denser core.
+template <typename TImage>
+typename TImage::Pointer
+MakePhantom(itk::SizeValueType size, double air, double tissue, double core, double noise)
+{
+  auto image = TImage::New();
+  image->SetRegions(typename TImage::SizeType{ { size, size, size / 2 } });
+  image->Allocate();
+  auto         random = itk::Statistics::MersenneTwisterRandomVariateGenerator::New();
+  random->Initialize(2024);
+  const double center = 0.5 * size;
+  for (itk::ImageRegionIteratorWithIndex<TImage> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    const auto   index = it.GetIndex();
+    const double x = (index[0] - center) / (0.45 * size);
+    const double y = (index[1] - center) / (0.35 * size);
+    const double z = (2.0 * index[2] - center) / (0.45 * size);
+    const double r = x * x + y * y + z * z;
+    double       value = (r > 1.0) ? air : (r > 0.2 ? tissue : core);
+    value += noise * random->GetNormalVariate();
+    it.Set(static_cast<typename TImage::PixelType>(value));
+  }
+  return image;
+}
+
+// Size in bytes of the pixel data of image.
+template <typename TImage>
+itk::SizeValueType
+PayloadSize(const TImage * image)
+{
+  return image->GetBufferedRegion().GetNumberOfPixels() * sizeof(typename TImage::PixelType);
+}
+
+template <typename TImage>
+bool
+WriteAndRead(const TImage *       image,
+             const std::string &  fileName,
+             const std::string &  compressor,
+             int                  level,
+             itk::SizeValueType & fileSize)
+{
+  // The image IO keeps the file open until it is destroyed, so the write is
+  // timed, and the file read, once the writer is gone.
+  itk::TimeProbe writeProbe;
+  writeProbe.Start();
+  {
+    auto io = itk::HDF5ImageIO::New();
+    io->SetCompressor(compressor);
+    io->SetCompressionLevel(level);
+
+    auto writer = itk::ImageFileWriter<TImage>::New();
+    writer->SetInput(image);
+    writer->SetFileName(fileName);
+    writer->SetImageIO(io);
+    writer->Update();
+  }
+  writeProbe.Stop();
+
+  auto reader = itk::ImageFileReader<TImage>::New();
+  reader->SetFileName(fileName);
+  reader->SetImageIO(itk::HDF5ImageIO::New());
+  itk::TimeProbe readProbe;
+  readProbe.Start();
+  reader->Update();
+  readProbe.Stop();
+
+  fileSize = itksys::SystemTools::FileLength(fileName);
+  const double megabytes = PayloadSize(image) / double{ 1 << 20 };
+  std::cout << "  " << (compressor.empty() ? std::string("GZIP") : compressor) << " level " << level
+            << ": write " << megabytes / writeProbe.GetTotal() << " MB/s, read " << megabytes / readProbe.GetTotal()
+            << " MB/s, ratio " << megabytes / (fileSize / double{ 1 << 20 }) << std::endl;
+
+  itk::ImageRegionConstIterator<TImage> expected(image, image->GetBufferedRegion());
+  itk::ImageRegionConstIterator<TImage> actual(reader->GetOutput(), image->GetBufferedRegion());
+  for (; !expected.IsAtEnd(); ++expected, ++actual)
+  {
+    if (expected.Get() != actual.Get())
+    {
+      std::cerr << "Pixel " << expected.GetIndex() << " of " << fileName << " is " << actual.Get() << " instead of "
+                << expected.Get() << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename TImage>
+bool
+CompareCompressors(const TImage * image, const std::string & fileName)
+{
+  bool               success = true;
+  itk::SizeValueType uncompressedSize = 0;
+  success &= WriteAndRead(image, fileName, "NOCOMPRESSION", 0, uncompressedSize);
+
+  // The raw pixel data, plus the file structure and the metadata.
+  const itk::SizeValueType payloadSize = PayloadSize(image);
+  if (uncompressedSize < payloadSize || uncompressedSize > payloadSize + payloadSize / 100 + 65536)
+  {
+    std::cerr << "The NOCOMPRESSION file has " << uncompressedSize << " bytes for " << payloadSize
+              << " bytes of pixel data" << std::endl;
+    success = false;
+  }
+
+  for (const int level : { 1, 5 })
+  {
+    itk::SizeValueType fileSize = 0;
+    success &= WriteAndRead(image, fileName, "", level, fileSize);
+    success &= WriteAndRead(image, fileName, "SHUFFLEGZIP", level, fileSize);
+    if (fileSize >= uncompressedSize)
+    {
+      std::cerr << "The SHUFFLEGZIP level " << level << " file has " << fileSize << " bytes, not fewer than the "
+                << uncompressedSize << " bytes of the NOCOMPRESSION file" << std::endl;
+      success = false;
+    }
+  }
+  return success;
+}
+} // namespace
+
+int
+itkHDF5ImageIOCompressionTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory [size]" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string        directory = argv[1];
+  const itk::SizeValueType size = (argc > 2) ? static_cast<itk::SizeValueType>(std::stoi(argv[2])) : 96;
+
+  auto io = itk::HDF5ImageIO::New();
+  io->SetCompressor("ShuffleGzip");
+  ITK_TEST_EXPECT_EQUAL(io->GetCompressor(), "ShuffleGzip");
+  io->SetCompressor("NoCompression");
+  ITK_TEST_EXPECT_EQUAL(io->GetCompressor(), "NoCompression");
+
+  bool success = true;
+
+  using CTImageType = itk::Image<short, 3>;
+  const auto ct = MakePhantom<CTImageType>(size, -1000.0, 40.0, 700.0, 20.0);
+  std::cout << "CT, short" << std::endl;
+  success &= CompareCompressors<CTImageType>(ct, directory + "/itkHDF5ImageIOCompressionCT.hdf5");
+
+  using MRImageType = itk::Image<float, 3>;
+  const auto mr = MakePhantom<MRImageType>(size, 0.0, 300.0, 800.0, 15.0);
+  std::cout << "MR, float" << std::endl;
+  success &= CompareCompressors<MRImageType>(mr, directory + "/itkHDF5ImageIOCompressionMR.hdf5");
+
+  using MaskImageType = itk::Image<unsigned char, 3>;
+  const auto mask = MakePhantom<MaskImageType>(size / 2, 0.0, 1.0, 2.0, 0.0);
+  std::cout << "Mask, unsigned char" << std::endl;
+  success &= CompareCompressors<MaskImageType>(mask, directory + "/itkHDF5ImageIOCompressionMask.hdf5");
+
+  if (!success)
+  {
+    std::cout << "Test FAILED!" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
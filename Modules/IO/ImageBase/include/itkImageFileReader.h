@@ -118,6 +118,19 @@ public:
   itkGetConstReferenceMacro(UseStreaming, bool);
   itkBooleanMacro(UseStreaming);
 
+  /** Set/Get whether the output may map the file into memory instead of
+   * reading it. Off by default. Mapping is used when the whole image is
+   * requested, no pixel conversion is needed, and the ImageIO reports that
+   * the pixels are stored uncompressed and contiguously in the native byte
+   * order, see ImageIOBase::GetMappableDataLocation(). Otherwise the file is
+   * read as usual. With mapping, reading returns almost immediately and the
+   * operating system loads the pages as the pixels are first touched. The
+   * mapping is copy-on-write: modifying the output never changes the file,
+   * but the file must not be modified while the output exists. */
+  itkSetMacro(UseMemoryMapping, bool);
+  itkGetConstMacro(UseMemoryMapping, bool);
+  itkBooleanMacro(UseMemoryMapping);
+
 protected:
   ImageFileReader();
   ~ImageFileReader() override = default;
@@ -153,6 +166,11 @@ protected:
   void
   GenerateData() override;
 
+  /** Maps the file into the output buffer when memory mapping applies.
+   * Returns false when the file has to be read. */
+  bool
+  MapOutputBuffer();
+
   ImageIOBase::Pointer m_ImageIO{};
 
   bool m_UserSpecifiedImageIO{}; // keep track whether the
@@ -160,6 +178,8 @@ protected:
 
   bool m_UseStreaming{};
 
+  bool m_UseMemoryMapping{ false };
+
 private:
   std::string m_ExceptionMessage{};
 
@@ -24,6 +24,7 @@
 #include "itkPixelTraits.h"
 #include "itkVectorImage.h"
 #include "itkMetaDataObject.h"
+#include "itkMemoryMappedImageContainer.h"
 
 #include "itksys/SystemTools.hxx"
 #include "itkMakeUniqueForOverwrite.h"
@@ -50,6 +51,7 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>::PrintSelf(std::ostream & os,
 
   itkPrintSelfBooleanMacro(UserSpecifiedImageIO);
   itkPrintSelfBooleanMacro(UseStreaming);
+  itkPrintSelfBooleanMacro(UseMemoryMapping);
 
   os << indent << "ExceptionMessage: " << m_ExceptionMessage << std::endl;
   os << indent << "ActualIORegion: " << m_ActualIORegion << std::endl;
@@ -355,6 +357,12 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>::GenerateData()
 
   const typename TOutputImage::Pointer output = this->GetOutput();
 
+  if (m_UseMemoryMapping && this->MapOutputBuffer())
+  {
+    this->UpdateProgress(1.0f);
+    return;
+  }
+
   itkDebugMacro("ImageFileReader::GenerateData() \n"
                 << "Allocating the buffer with the EnlargedRequestedRegion \n"
                 << output->GetRequestedRegion() << '\n');
@@ -440,6 +448,51 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>::GenerateData()
   this->UpdateProgress(1.0f);
 }
 
+template <typename TOutputImage, typename ConvertPixelTraits>
+bool
+ImageFileReader<TOutputImage, ConvertPixelTraits>::MapOutputBuffer()
+{
+  using PixelContainerType = typename TOutputImage::PixelContainer;
+  using ElementType = typename PixelContainerType::Element;
+  using MappedContainerType =
+    MemoryMappedImageContainer<typename PixelContainerType::ElementIdentifier, typename PixelContainerType::Element>;
+
+  TOutputImage * const    output = this->GetOutput();
+  const ImageRegionType & region = output->GetRequestedRegion();
+
+  // Only the whole file, without any conversion, is mapped.
+  const IOComponentEnum ioType = ImageIOBase::MapPixelType<typename ConvertPixelTraits::ComponentType>::CType;
+  if (m_ImageIO->GetComponentType() != ioType ||
+      m_ImageIO->GetNumberOfComponents() != output->GetNumberOfComponentsPerPixel() ||
+      region != output->GetLargestPossibleRegion() ||
+      m_ActualIORegion.GetNumberOfPixels() != region.GetNumberOfPixels() ||
+      m_ActualIORegion.GetNumberOfPixels() != static_cast<SizeValueType>(m_ImageIO->GetImageSizeInPixels()))
+  {
+    return false;
+  }
+  const SizeValueType numberOfBytes = m_ImageIO->GetImageSizeInBytes();
+  if (numberOfBytes == 0 || numberOfBytes % sizeof(ElementType) != 0)
+  {
+    return false;
+  }
+
+  m_ImageIO->SetIORegion(m_ActualIORegion);
+  std::string           dataFileName;
+  ImageIOBase::SizeType dataOffset = 0;
+  if (!m_ImageIO->GetMappableDataLocation(dataFileName, dataOffset) || dataOffset < 0 ||
+      dataOffset % alignof(ElementType) != 0)
+  {
+    return false;
+  }
+
+  itkDebugMacro("Mapping " << numberOfBytes << " bytes at offset " << dataOffset << " of " << dataFileName);
+  const auto container = MappedContainerType::New();
+  container->MapFile(dataFileName, static_cast<uint64_t>(dataOffset), numberOfBytes / sizeof(ElementType));
+  output->SetBufferedRegion(region);
+  output->SetPixelContainer(container);
+  return true;
+}
+
 template <typename TOutputImage, typename ConvertPixelTraits>
 void
 ImageFileReader<TOutputImage, ConvertPixelTraits>::DoConvertBuffer(const void * inputData, size_t numberOfPixels)
@@ -440,6 +440,19 @@ public:
   virtual void
   Read(void * buffer) = 0;
 
+  /** Determine if the pixel data of the whole image can be mapped into
+   * memory instead of read. Returns true, with the name of the file holding
+   * the data and the byte offset of the first pixel, when all pixels are
+   * stored uncompressed, contiguously, in the byte order of this machine and
+   * in the layout Read() would produce. Default is false. Valid after
+   * ReadImageInformation().
+   * \sa ImageFileReader::SetUseMemoryMapping() */
+  virtual bool
+  GetMappableDataLocation(std::string & itkNotUsed(dataFileName), SizeType & itkNotUsed(dataOffset)) const
+  {
+    return false;
+  }
+
   /*-------- This part of the interfaces deals with writing data ----- */
 
   /** Determine the file type. Returns true if this ImageIO can read the
@@ -0,0 +1,73 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkMemoryMappedFile_h
+#define itkMemoryMappedFile_h
+#include "ITKIOImageBaseExport.h"
+
+#include "itkMacro.h"
+#include "itkIntTypes.h"
+#include <string>
+
+namespace itk
+{
+/** \class MemoryMappedFile
+ * \brief A copy-on-write memory mapping of a byte range of a file.
+ *
+ * The pages are loaded lazily by the operating system as they are touched.
+ * Writing to the mapped memory gives the process a private copy of the page;
+ * the file itself is never modified. The mapping is released on destruction.
+ *
+ * \sa MemoryMappedImageContainer
+ * \ingroup ITKIOImageBase
+ */
+class ITKIOImageBase_EXPORT MemoryMappedFile
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(MemoryMappedFile);
+
+  /** Maps numberOfBytes bytes of the file, starting offset bytes in. Throws
+   * an ExceptionObject if the file cannot be opened, is too short, or cannot
+   * be mapped. */
+  MemoryMappedFile(const std::string & fileName, uint64_t offset, size_t numberOfBytes);
+
+  ~MemoryMappedFile();
+
+  /** The first mapped byte, at the requested offset of the file. */
+  void *
+  GetData() const
+  {
+    return m_Data;
+  }
+
+  size_t
+  GetNumberOfBytes() const
+  {
+    return m_NumberOfBytes;
+  }
+
+private:
+  void * m_Data{};
+  size_t m_NumberOfBytes{};
+
+  // The mapping starts at an offset aligned to the allocation granularity.
+  void * m_MappedAddress{};
+  size_t m_MappedLength{};
+};
+} // end namespace itk
+
+#endif // itkMemoryMappedFile_h
@@ -0,0 +1,95 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkMemoryMappedImageContainer_h
+#define itkMemoryMappedImageContainer_h
+
+#include "itkImportImageContainer.h"
+#include "itkMemoryMappedFile.h"
+#include <memory>
+
+namespace itk
+{
+/** \class MemoryMappedImageContainer
+ * \brief An ImportImageContainer whose elements are a copy-on-write memory
+ * mapping of a file.
+ *
+ * The container does not manage the mapped memory as an allocation; the
+ * mapping is released when the container is destroyed, initialized, or
+ * reallocated by Reserve() or Squeeze(), in which case the elements are
+ * copied to ordinary memory first.
+ *
+ * \sa ImageFileReader::SetUseMemoryMapping()
+ * \ingroup ITKIOImageBase
+ */
+template <typename TElementIdentifier, typename TElement>
+class ITK_TEMPLATE_EXPORT MemoryMappedImageContainer : public ImportImageContainer<TElementIdentifier, TElement>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(MemoryMappedImageContainer);
+
+  /** Standard class type aliases. */
+  using Self = MemoryMappedImageContainer;
+  using Superclass = ImportImageContainer<TElementIdentifier, TElement>;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** \see LightObject::GetNameOfClass() */
+  itkOverrideGetNameOfClassMacro(MemoryMappedImageContainer);
+
+  /** Maps numberOfElements elements of the file, starting offset bytes in,
+   * replacing the current elements. The offset must be a multiple of the
+   * alignment of TElement. Throws an ExceptionObject on failure. */
+  void
+  MapFile(const std::string & fileName, uint64_t offset, TElementIdentifier numberOfElements)
+  {
+    if (offset % alignof(TElement) != 0)
+    {
+      itkExceptionMacro("Offset " << offset << " of " << fileName << " is not aligned for the element type");
+    }
+    auto mappedFile = std::make_unique<MemoryMappedFile>(fileName, offset, numberOfElements * sizeof(TElement));
+    this->SetImportPointer(static_cast<TElement *>(mappedFile->GetData()), numberOfElements, false);
+    m_MappedFile = std::move(mappedFile);
+  }
+
+  /** Whether the elements are currently mapped from a file. */
+  bool
+  IsMapped() const
+  {
+    return m_MappedFile != nullptr;
+  }
+
+protected:
+  MemoryMappedImageContainer() = default;
+  ~MemoryMappedImageContainer() override = default;
+
+  void
+  DeallocateManagedMemory() override
+  {
+    Superclass::DeallocateManagedMemory();
+    m_MappedFile.reset();
+  }
+
+private:
+  std::unique_ptr<MemoryMappedFile> m_MappedFile;
+};
+} // end namespace itk
+
+#endif // itkMemoryMappedImageContainer_h
@@ -0,0 +1,68 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkParallelZlibCompressor_h
+#define itkParallelZlibCompressor_h
+#include "ITKIOImageBaseExport.h"
+
+#include "itkIntTypes.h"
+#include <vector>
+
+namespace itk
+{
+/** \class ParallelZlibCompressor
+ * \brief Deflates a buffer on all threads into a single zlib or gzip stream.
+ *
+ * The data is cut into blocks that are compressed independently by the
+ * threads of the default MultiThreaderBase, like pigz does. Every block but
+ * the last ends with a sync flush, so that the concatenated blocks form one
+ * valid deflate stream, and is primed with the last 32 KiB of the previous
+ * block, so that the compression ratio is close to that of a single
+ * deflate. The checksums of the blocks are combined. Any zlib or gzip reader
+ * can decompress the result.
+ *
+ * Used by the "PARALLELGZIP" compressor of MetaImageIO and NrrdImageIO.
+ *
+ * \ingroup ITKIOImageBase
+ */
+class ITKIOImageBase_EXPORT ParallelZlibCompressor
+{
+public:
+  /** The header and checksum wrapping the deflate stream. */
+  enum class Format : uint8_t
+  {
+    Zlib,
+    Gzip
+  };
+
+  /** The default number of input bytes per block. */
+  static constexpr size_t DefaultBlockSize = size_t{ 1 } << 20;
+
+  /** Compresses numberOfBytes bytes of data with the given level, 0 to 9,
+   * replacing the contents of output. Throws an ExceptionObject if zlib
+   * reports an error. */
+  static void
+  Compress(const void *                 data,
+           size_t                       numberOfBytes,
+           int                          compressionLevel,
+           Format                       format,
+           std::vector<unsigned char> & output,
+           size_t                       blockSize = DefaultBlockSize);
+};
+} // end namespace itk
+
+#endif // itkParallelZlibCompressor_h
@@ -13,6 +13,8 @@ itk_module(
   ENABLE_SHARED
   DEPENDS
   ITKCommon
+  PRIVATE_DEPENDS
+  ITKZLIB
   TEST_DEPENDS
   ITKTestKernel
   ITKIOGDCM
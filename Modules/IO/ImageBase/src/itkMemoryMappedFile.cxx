@@ -0,0 +1,109 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkMemoryMappedFile.h"
+#include "itksys/SystemTools.hxx"
+
+#if defined(WIN32) || defined(_WIN32)
+#  include "itksys/Encoding.hxx"
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <unistd.h>
+#endif
+
+namespace itk
+{
+
+MemoryMappedFile::MemoryMappedFile(const std::string & fileName, uint64_t offset, size_t numberOfBytes)
+{
+  if (numberOfBytes == 0)
+  {
+    itkGenericExceptionMacro("Cannot map zero bytes of " << fileName);
+  }
+  const uint64_t fileLength = itksys::SystemTools::FileLength(fileName);
+  if (fileLength < offset || fileLength - offset < numberOfBytes)
+  {
+    itkGenericExceptionMacro("Cannot map " << numberOfBytes << " bytes at offset " << offset << " of " << fileName
+                                           << ", which has only " << fileLength << " bytes");
+  }
+
+#if defined(WIN32) || defined(_WIN32)
+  SYSTEM_INFO systemInfo;
+  GetSystemInfo(&systemInfo);
+  const uint64_t alignedOffset = offset - offset % systemInfo.dwAllocationGranularity;
+  m_MappedLength = static_cast<size_t>(offset - alignedOffset) + numberOfBytes;
+
+  const std::wstring wideFileName = itksys::Encoding::ToWindowsExtendedPath(fileName);
+  const HANDLE       file = CreateFileW(
+    wideFileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+  {
+    itkGenericExceptionMacro("Cannot open " << fileName << " for mapping");
+  }
+  // The view keeps the file mapping, and the mapping the file, alive.
+  const HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+  CloseHandle(file);
+  if (mapping == nullptr)
+  {
+    itkGenericExceptionMacro("Cannot create a file mapping of " << fileName);
+  }
+  m_MappedAddress = MapViewOfFile(mapping,
+                                  FILE_MAP_COPY,
+                                  static_cast<DWORD>(alignedOffset >> 32),
+                                  static_cast<DWORD>(alignedOffset & 0xFFFFFFFF),
+                                  m_MappedLength);
+  CloseHandle(mapping);
+  if (m_MappedAddress == nullptr)
+  {
+    itkGenericExceptionMacro("Cannot map " << fileName << " into memory");
+  }
+#else
+  const auto     pageSize = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+  const uint64_t alignedOffset = offset - offset % pageSize;
+  m_MappedLength = static_cast<size_t>(offset - alignedOffset) + numberOfBytes;
+
+  const int file = open(fileName.c_str(), O_RDONLY);
+  if (file < 0)
+  {
+    itkGenericExceptionMacro("Cannot open " << fileName << " for mapping");
+  }
+  void * address =
+    mmap(nullptr, m_MappedLength, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, static_cast<off_t>(alignedOffset));
+  close(file);
+  if (address == MAP_FAILED)
+  {
+    itkGenericExceptionMacro("Cannot map " << fileName << " into memory");
+  }
+  m_MappedAddress = address;
+#endif
+
+  m_Data = static_cast<char *>(m_MappedAddress) + (offset - alignedOffset);
+  m_NumberOfBytes = numberOfBytes;
+}
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+#if defined(WIN32) || defined(_WIN32)
+  UnmapViewOfFile(m_MappedAddress);
+#else
+  munmap(m_MappedAddress, m_MappedLength);
+#endif
+}
+
+} // end namespace itk
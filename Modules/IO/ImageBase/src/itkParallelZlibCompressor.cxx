@@ -0,0 +1,198 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkParallelZlibCompressor.h"
+#include "itkMacro.h"
+#include "itkMultiThreaderBase.h"
+#include "itk_zlib.h"
+
+#include <algorithm>
+#include <atomic>
+
+namespace itk
+{
+
+namespace
+{
+constexpr size_t DictionarySize = size_t{ 1 } << 15;
+
+struct CompressedBlock
+{
+  std::vector<unsigned char> data;
+  uLong                      checksum;
+  size_t                     numberOfBytes;
+};
+
+// Compresses one block into a raw deflate stream, primed with the data preceding it.
+bool
+DeflateBlock(const unsigned char * block,
+             size_t                numberOfBytes,
+             const unsigned char * dictionary,
+             size_t                dictionarySize,
+             int                   compressionLevel,
+             bool                  isLast,
+             CompressedBlock &     compressed)
+{
+  z_stream stream{};
+  if (deflateInit2(&stream, compressionLevel, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+  {
+    return false;
+  }
+  if (dictionarySize > 0 && deflateSetDictionary(&stream, dictionary, static_cast<uInt>(dictionarySize)) != Z_OK)
+  {
+    deflateEnd(&stream);
+    return false;
+  }
+
+  // A sync flush adds an empty stored block of at most 10 bytes.
+  compressed.data.resize(deflateBound(&stream, static_cast<uLong>(numberOfBytes)) + 16);
+  stream.next_in = const_cast<unsigned char *>(block);
+  stream.avail_in = static_cast<uInt>(numberOfBytes);
+  stream.next_out = compressed.data.data();
+  stream.avail_out = static_cast<uInt>(compressed.data.size());
+  const int result = deflate(&stream, isLast ? Z_FINISH : Z_SYNC_FLUSH);
+  const bool success = (result == (isLast ? Z_STREAM_END : Z_OK)) && stream.avail_in == 0;
+  compressed.data.resize(compressed.data.size() - stream.avail_out);
+  deflateEnd(&stream);
+  return success;
+}
+
+void
+AppendBigEndian32(std::vector<unsigned char> & output, uLong value)
+{
+  for (int shift = 24; shift >= 0; shift -= 8)
+  {
+    output.push_back(static_cast<unsigned char>((value >> shift) & 0xFF));
+  }
+}
+
+void
+AppendLittleEndian32(std::vector<unsigned char> & output, uLong value)
+{
+  for (int shift = 0; shift < 32; shift += 8)
+  {
+    output.push_back(static_cast<unsigned char>((value >> shift) & 0xFF));
+  }
+}
+} // namespace
+
+void
+ParallelZlibCompressor::Compress(const void *                 data,
+                                 size_t                       numberOfBytes,
+                                 int                          compressionLevel,
+                                 Format                       format,
+                                 std::vector<unsigned char> & output,
+                                 size_t                       blockSize)
+{
+  if (compressionLevel < 0 || compressionLevel > 9)
+  {
+    itkGenericExceptionMacro("Invalid zlib compression level: " << compressionLevel);
+  }
+  // Blocks are passed to zlib at once, and must be larger than the dictionary.
+  blockSize = std::clamp(blockSize, 2 * DictionarySize, size_t{ 1 } << 30);
+
+  const auto * bytes = static_cast<const unsigned char *>(data);
+  const size_t numberOfBlocks = std::max<size_t>(1, (numberOfBytes + blockSize - 1) / blockSize);
+
+  std::vector<CompressedBlock> blocks(numberOfBlocks);
+  std::atomic<bool>            failed{ false };
+  MultiThreaderBase::New()->ParallelizeArray(
+    0,
+    numberOfBlocks,
+    [&](SizeValueType b) {
+      const size_t      begin = b * blockSize;
+      const size_t      blockBytes = std::min(blockSize, numberOfBytes - begin);
+      const size_t      dictionarySize = std::min(begin, DictionarySize);
+      CompressedBlock & block = blocks[b];
+      block.numberOfBytes = blockBytes;
+      if (format == Format::Gzip)
+      {
+        block.checksum = crc32(crc32(0, nullptr, 0), bytes + begin, static_cast<uInt>(blockBytes));
+      }
+      else
+      {
+        block.checksum = adler32(adler32(0, nullptr, 0), bytes + begin, static_cast<uInt>(blockBytes));
+      }
+      if (!DeflateBlock(bytes + begin,
+                        blockBytes,
+                        bytes + begin - dictionarySize,
+                        dictionarySize,
+                        compressionLevel,
+                        b + 1 == numberOfBlocks,
+                        block))
+      {
+        failed = true;
+      }
+    },
+    nullptr);
+  if (failed)
+  {
+    itkGenericExceptionMacro("zlib failed to compress the data.");
+  }
+
+  size_t compressedSize = 0;
+  for (const auto & block : blocks)
+  {
+    compressedSize += block.data.size();
+  }
+  output.clear();
+  output.reserve(compressedSize + 18);
+
+  // RFC 1950 and RFC 1952 headers
+  if (format == Format::Gzip)
+  {
+    // no file name or modification time; unknown operating system
+    const unsigned char header[10] = { 0x1f, 0x8b, 8, 0, 0, 0, 0, 0, 0, 255 };
+    output.insert(output.end(), header, header + 10);
+  }
+  else
+  {
+    const unsigned int compressionMethodAndFlags = 0x78;
+    const unsigned int levelFlags =
+      compressionLevel < 2 ? 0 : (compressionLevel < 6 ? 1 : (compressionLevel == 6 ? 2 : 3));
+    unsigned int       flags = levelFlags << 6;
+    flags += 31 - ((compressionMethodAndFlags << 8) + flags) % 31;
+    output.push_back(static_cast<unsigned char>(compressionMethodAndFlags));
+    output.push_back(static_cast<unsigned char>(flags));
+  }
+
+  uLong checksum = blocks[0].checksum;
+  for (size_t b = 0; b < numberOfBlocks; ++b)
+  {
+    output.insert(output.end(), blocks[b].data.begin(), blocks[b].data.end());
+    if (b > 0)
+    {
+      const auto length = static_cast<z_off_t>(blocks[b].numberOfBytes);
+      checksum = (format == Format::Gzip) ? crc32_combine(checksum, blocks[b].checksum, length)
+                                          : adler32_combine(checksum, blocks[b].checksum, length);
+    }
+    // release the memory of each block once it is copied
+    std::vector<unsigned char>().swap(blocks[b].data);
+  }
+
+  if (format == Format::Gzip)
+  {
+    AppendLittleEndian32(output, checksum);
+    AppendLittleEndian32(output, static_cast<uLong>(numberOfBytes & 0xFFFFFFFF));
+  }
+  else
+  {
+    AppendBigEndian32(output, checksum);
+  }
+}
+
+} // end namespace itk
@@ -37,6 +37,12 @@ namespace itk
  *  For a detailed description of using this format, please see
  *  https://www.itk.org/Wiki/ITK/MetaIO/Documentation
  *
+ *  Compressed data is written with zlib. The "PARALLELGZIP" compressor
+ *  deflates blocks of the image on all threads instead, see
+ *  ParallelZlibCompressor; the files are read as usual. It writes the
+ *  whole image at once, and does not support data file names with a '%'
+ *  pattern, which write the image slice by slice.
+ *
  *  \ingroup IOFilters
  * \ingroup ITKIOMeta
  */
@@ -82,6 +88,11 @@ public:
   void
   Read(void * buffer) override;
 
+  /** Uncompressed binary data in the native byte order can be mapped, unless
+   * it is split over a list of files or subsampled. */
+  bool
+  GetMappableDataLocation(std::string & dataFileName, SizeType & dataOffset) const override;
+
   MetaImage *
   GetMetaImagePointer();
 
@@ -187,6 +198,14 @@ protected:
   ~MetaImageIO() override;
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
+
+  void
+  InternalSetCompressor(const std::string & _compressor) override;
+
+  /** Writes the image compressed with ParallelZlibCompressor. */
+  void
+  WriteParallelCompressed(const void * buffer);
+
   template <unsigned int VNRows, unsigned int VNColumns = VNRows>
   bool
   WriteMatrixInMetaData(std::ostringstream &       strs,
@@ -197,10 +216,35 @@ private:
   /** Only used to synchronize the global variable across static libraries.*/
   itkGetGlobalDeclarationMacro(unsigned int, DefaultDoublePrecision);
 
-  MetaImage m_MetaImage{};
+  /** MetaImage that can write a header for element data compressed by the
+   * caller. MetaImage compresses the elements itself whenever its
+   * CompressedData flag is on, so WriteParallelCompressed() turns the flag off
+   * and the header fields of the compressed data are set up here. */
+  class PrecompressedMetaImage : public MetaImage
+  {
+  public:
+    /** The size of the compressed data to write in the header, or a negative
+     * value when MetaImage compresses the elements. */
+    void
+    SetPrecompressedDataSize(std::streamoff size)
+    {
+      m_PrecompressedDataSize = size;
+    }
+
+  protected:
+    void
+    M_SetupWriteFields() override;
+
+  private:
+    std::streamoff m_PrecompressedDataSize{ -1 };
+  };
+
+  PrecompressedMetaImage m_MetaImage{};
 
   unsigned int m_SubSamplingFactor{};
 
+  bool m_UseParallelCompression{ false };
+
   static unsigned int * m_DefaultDoublePrecision;
 };
 
@@ -23,8 +23,11 @@
 #include "itkMath.h"
 #include "itkSingleton.h"
 #include "itkMakeUniqueForOverwrite.h"
+#include "itkParallelZlibCompressor.h"
 #include "metaImageUtils.h"
 
+#include <fstream>
+
 // Function to join strings with a delimiter similar to python's ' '.join([1, 2, 3 ])
 template <typename ContainerType, typename DelimiterType, typename StreamType>
 static auto
@@ -83,6 +86,95 @@ MetaImageIO::PrintSelf(std::ostream & os, Indent indent) const
   Superclass::PrintSelf(os, indent);
   m_MetaImage.PrintInfo();
   os << indent << "SubSamplingFactor: " << m_SubSamplingFactor << '\n';
+  os << indent << "UseParallelCompression: " << (m_UseParallelCompression ? "On" : "Off") << '\n';
+}
+
+void
+MetaImageIO::InternalSetCompressor(const std::string & _compressor)
+{
+  m_UseParallelCompression = false;
+  if (_compressor.empty())
+  {
+    return;
+  }
+  if (_compressor == "PARALLELGZIP")
+  {
+    m_UseParallelCompression = true;
+    return;
+  }
+  this->Superclass::InternalSetCompressor(_compressor);
+}
+
+void
+MetaImageIO::PrecompressedMetaImage::M_SetupWriteFields()
+{
+  if (m_PrecompressedDataSize < 0)
+  {
+    MetaImage::M_SetupWriteFields();
+    return;
+  }
+  m_CompressedData = true;
+  m_CompressedDataSize = m_PrecompressedDataSize;
+  MetaImage::M_SetupWriteFields();
+  m_CompressedData = false;
+  m_CompressedDataSize = 0;
+}
+
+void
+MetaImageIO::WriteParallelCompressed(const void * buffer)
+{
+  const std::string userDataFileName = m_MetaImage.ElementDataFileName();
+  if (userDataFileName.find('%') != std::string::npos)
+  {
+    itkExceptionMacro("The PARALLELGZIP compressor cannot write the data slice by slice to " << userDataFileName);
+  }
+
+  std::vector<unsigned char> compressedData;
+  ParallelZlibCompressor::Compress(buffer,
+                                   static_cast<size_t>(this->GetImageSizeInBytes()),
+                                   this->GetCompressionLevel(),
+                                   ParallelZlibCompressor::Format::Zlib,
+                                   compressedData);
+
+  // Name the data file as MetaImage::Write does for compressed data.
+  std::string dataFileName = userDataFileName;
+  if (dataFileName.empty())
+  {
+    dataFileName = (itksys::SystemTools::GetFilenameLastExtension(m_FileName) == ".mha")
+                     ? std::string("LOCAL")
+                     : itksys::SystemTools::GetFilenameWithoutLastExtension(m_FileName) + ".zraw";
+  }
+
+  // Only the header is written by MetaImage, the data is appended below.
+  m_MetaImage.ElementDataFileName(dataFileName.c_str());
+  m_MetaImage.CompressedData(false);
+  m_MetaImage.SetPrecompressedDataSize(static_cast<std::streamoff>(compressedData.size()));
+  const bool headerWritten = m_MetaImage.Write(m_FileName.c_str(), nullptr, false);
+  m_MetaImage.SetPrecompressedDataSize(-1);
+  m_MetaImage.CompressedData(true);
+  m_MetaImage.ElementDataFileName(userDataFileName.c_str());
+  if (!headerWritten)
+  {
+    itkExceptionMacro("File cannot be written: " << this->GetFileName() << std::endl
+                                                 << "Reason: " << itksys::SystemTools::GetLastSystemError());
+  }
+
+  // the data follows the header, or is in the data file next to it
+  std::string             dataFilePath = m_FileName;
+  std::ios_base::openmode mode = std::ios::binary | std::ios::app;
+  if (itksys::SystemTools::UpperCase(dataFileName) != "LOCAL")
+  {
+    dataFilePath =
+      itksys::SystemTools::CollapseFullPath(dataFileName, itksys::SystemTools::GetFilenamePath(m_FileName));
+    mode = std::ios::binary | std::ios::trunc;
+  }
+  std::ofstream dataFile(dataFilePath.c_str(), mode);
+  dataFile.write(reinterpret_cast<const char *>(compressedData.data()),
+                 static_cast<std::streamsize>(compressedData.size()));
+  if (!dataFile)
+  {
+    itkExceptionMacro("Error writing the data of " << this->GetFileName() << " to " << dataFilePath);
+  }
 }
 
 void
@@ -511,6 +603,56 @@ MetaImageIO::Read(void * buffer)
   }
 }
 
+bool
+MetaImageIO::GetMappableDataLocation(std::string & dataFileName, SizeType & dataOffset) const
+{
+  int elementSize = 0;
+  MET_SizeOfType(m_MetaImage.ElementType(), &elementSize);
+  if (!m_MetaImage.BinaryData() || m_MetaImage.CompressedData() || m_SubSamplingFactor != 1 ||
+      static_cast<unsigned int>(elementSize) != this->GetComponentSize() ||
+      (elementSize > 1 && m_MetaImage.BinaryDataByteOrderMSB() != MET_SystemByteOrderMSB()))
+  {
+    return false;
+  }
+
+  const std::string elementDataFileName = m_MetaImage.ElementDataFileName();
+  if (elementDataFileName.compare(0, 4, "LIST") == 0 || elementDataFileName.find('%') != std::string::npos)
+  {
+    return false;
+  }
+  const bool local = itksys::SystemTools::UpperCase(elementDataFileName) == "LOCAL";
+  dataFileName = local ? m_FileName
+                       : itksys::SystemTools::CollapseFullPath(elementDataFileName,
+                                                               itksys::SystemTools::GetFilenamePath(m_FileName));
+
+  if (m_MetaImage.HeaderSize() > 0)
+  {
+    dataOffset = m_MetaImage.HeaderSize();
+  }
+  else if (m_MetaImage.HeaderSize() == -1)
+  {
+    // The data is at the end of the file.
+    dataOffset = static_cast<SizeType>(itksys::SystemTools::FileLength(dataFileName)) -
+                 static_cast<SizeType>(this->GetImageSizeInBytes());
+  }
+  else if (local)
+  {
+    // The data follows the header, which ends with the ElementDataFile line.
+    std::ifstream stream(m_FileName.c_str(), std::ios::in | std::ios::binary);
+    MetaImage     header;
+    if (!stream.is_open() || !header.ReadStream(0, &stream, false))
+    {
+      return false;
+    }
+    dataOffset = static_cast<SizeType>(stream.tellg());
+  }
+  else
+  {
+    dataOffset = 0;
+  }
+  return dataOffset >= 0;
+}
+
 MetaImage *
 MetaImageIO::GetMetaImagePointer()
 {
@@ -895,7 +1037,11 @@ MetaImageIO::Write(const void * buffer)
   }
   else
   {
-    if (!m_MetaImage.Write(m_FileName.c_str()))
+    if (m_UseCompression && m_UseParallelCompression && binaryData)
+    {
+      this->WriteParallelCompressed(buffer);
+    }
+    else if (!m_MetaImage.Write(m_FileName.c_str()))
     {
       itkExceptionMacro("File cannot be written: " << this->GetFileName() << std::endl
                                                    << "Reason: " << itksys::SystemTools::GetLastSystemError());
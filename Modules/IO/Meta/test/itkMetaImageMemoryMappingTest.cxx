@@ -0,0 +1,181 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// Reads MetaImage files with memory mapping enabled, checking which files are
+// mapped, that the pixels are right either way, and that the mapping is copy
+// on write. Also compares the time to open a volume with and without mapping.
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMemoryMappedImageContainer.h"
+#include "itkMetaImageIO.h"
+#include "itkVectorImage.h"
+#include "itkTimeProbe.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+template <typename TImage>
+typename TImage::Pointer
+MakeImage(const typename TImage::SizeType & size)
+{
+  auto image = TImage::New();
+  image->SetRegions(size);
+  image->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<TImage> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    const auto index = it.GetIndex();
+    it.Set(static_cast<typename TImage::PixelType>(index[0] + 3 * index[1] + 5 * index[2]));
+  }
+  return image;
+}
+
+template <typename TImage>
+bool
+IsMapped(const TImage * image)
+{
+  using ContainerType = typename TImage::PixelContainer;
+  using MappedContainerType =
+    itk::MemoryMappedImageContainer<typename ContainerType::ElementIdentifier, typename ContainerType::Element>;
+  const auto * mapped = dynamic_cast<const MappedContainerType *>(image->GetPixelContainer());
+  return mapped != nullptr && mapped->IsMapped();
+}
+
+template <typename TImage>
+typename TImage::Pointer
+ReadImage(const std::string & fileName, bool useMemoryMapping)
+{
+  auto reader = itk::ImageFileReader<TImage>::New();
+  reader->SetFileName(fileName);
+  reader->SetUseMemoryMapping(useMemoryMapping);
+  reader->Update();
+  return reader->GetOutput();
+}
+
+template <typename TInputImage, typename TOutputImage = TInputImage>
+bool
+CheckMapping(const std::string & fileName, bool useCompression, bool expectMapped)
+{
+  const auto image = MakeImage<TInputImage>({ { 30, 20, 10 } });
+  itk::WriteImage(image, fileName, useCompression);
+
+  const auto mapped = ReadImage<TOutputImage>(fileName, true);
+  if (IsMapped(mapped.GetPointer()) != expectMapped)
+  {
+    std::cerr << fileName << (expectMapped ? " was not mapped" : " was mapped") << std::endl;
+    return false;
+  }
+  itk::ImageRegionConstIterator<TInputImage>  expectedIt(image, image->GetBufferedRegion());
+  itk::ImageRegionConstIterator<TOutputImage> actualIt(mapped, mapped->GetBufferedRegion());
+  for (; !expectedIt.IsAtEnd(); ++expectedIt, ++actualIt)
+  {
+    if (static_cast<typename TOutputImage::PixelType>(expectedIt.Get()) != actualIt.Get())
+    {
+      std::cerr << "Pixel " << expectedIt.GetIndex() << " of " << fileName << " is " << actualIt.Get()
+                << " instead of " << expectedIt.Get() << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
+
+int
+itkMetaImageMemoryMappingTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory [size]" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string        directory = argv[1];
+  const itk::SizeValueType size = (argc > 2) ? static_cast<itk::SizeValueType>(std::stoi(argv[2])) : 128;
+
+  using FloatImageType = itk::Image<float, 3>;
+  using ByteImageType = itk::Image<unsigned char, 3>;
+  using DoubleImageType = itk::Image<double, 3>;
+
+  bool success = true;
+  // Detached data starts at offset zero, attached data after the header.
+  success &= CheckMapping<FloatImageType>(directory + "/itkMetaImageMemoryMapping.mhd", false, true);
+  success &= CheckMapping<ByteImageType>(directory + "/itkMetaImageMemoryMapping.mha", false, true);
+  // Compressed data and pixel conversions are read as usual.
+  success &= CheckMapping<FloatImageType>(directory + "/itkMetaImageMemoryMappingCompressed.mha", true, false);
+  success &= CheckMapping<FloatImageType, DoubleImageType>(directory + "/itkMetaImageMemoryMapping.mhd", false, false);
+
+  // Vector images map their components.
+  using VectorImageType = itk::VectorImage<short, 3>;
+  auto vectorImage = VectorImageType::New();
+  vectorImage->SetRegions(VectorImageType::SizeType{ { 8, 6, 4 } });
+  vectorImage->SetVectorLength(3);
+  vectorImage->Allocate();
+  for (itk::SizeValueType i = 0; i < 8 * 6 * 4 * 3; ++i)
+  {
+    vectorImage->GetBufferPointer()[i] = static_cast<short>(i);
+  }
+  const std::string vectorFileName = directory + "/itkMetaImageMemoryMappingVector.mhd";
+  itk::WriteImage(vectorImage, vectorFileName);
+  const auto mappedVectorImage = ReadImage<VectorImageType>(vectorFileName, true);
+  ITK_TEST_EXPECT_TRUE(IsMapped(mappedVectorImage.GetPointer()));
+  ITK_TEST_EXPECT_EQUAL(mappedVectorImage->GetNumberOfComponentsPerPixel(), 3);
+  ITK_TEST_EXPECT_EQUAL(mappedVectorImage->GetBufferPointer()[8 * 6 * 4 * 3 - 1], 8 * 6 * 4 * 3 - 1);
+
+  // Modifying the mapped image leaves the file unchanged.
+  const std::string fileName = directory + "/itkMetaImageMemoryMapping.mhd";
+  const auto        mapped = ReadImage<FloatImageType>(fileName, true);
+  ITK_TEST_EXPECT_TRUE(IsMapped(mapped.GetPointer()));
+  mapped->FillBuffer(-1.0f);
+  const auto reread = ReadImage<FloatImageType>(fileName, false);
+  ITK_TEST_EXPECT_EQUAL(reread->GetPixel({ { 1, 1, 1 } }), 9.0f);
+
+  // A requested region smaller than the image is streamed instead.
+  auto reader = itk::ImageFileReader<FloatImageType>::New();
+  reader->SetFileName(fileName);
+  reader->SetUseMemoryMapping(true);
+  reader->UpdateOutputInformation();
+  FloatImageType::RegionType region({ { 2, 3, 4 } }, { { 5, 5, 5 } });
+  reader->GetOutput()->SetRequestedRegion(region);
+  reader->Update();
+  ITK_TEST_EXPECT_TRUE(!IsMapped(reader->GetOutput()));
+  ITK_TEST_EXPECT_EQUAL(reader->GetOutput()->GetPixel({ { 3, 4, 5 } }), 3.0f + 12.0f + 25.0f);
+
+  // Opening a mapped volume does not touch its pixels.
+  const std::string largeFileName = directory + "/itkMetaImageMemoryMappingLarge.mhd";
+  itk::WriteImage(MakeImage<FloatImageType>(FloatImageType::SizeType::Filled(size)), largeFileName);
+  for (const bool useMemoryMapping : { false, true })
+  {
+    itk::TimeProbe probe;
+    probe.Start();
+    const auto large = ReadImage<FloatImageType>(largeFileName, useMemoryMapping);
+    probe.Stop();
+    std::cout << "Opening a " << size << "^3 float volume " << (useMemoryMapping ? "with" : "without")
+              << " mapping: " << probe.GetTotal() << " s" << std::endl;
+    ITK_TEST_EXPECT_EQUAL(large->GetPixel({ { 1, 2, 3 } }), 22.0f);
+  }
+
+  if (!success)
+  {
+    std::cout << "Test FAILED!" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,159 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// Writes MetaImages with the parallel gzip compressor, reads them back, and
+// compares the write throughput and file size with those of the regular
+// compressor for several compression levels.
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMetaImageIO.h"
+#include "itkTimeProbe.h"
+#include "itkTestingMacros.h"
+#include "itksys/SystemTools.hxx"
+
+#include <cmath>
+
+namespace
+{
+using ImageType = itk::Image<short, 3>;
+
+// A smooth image with some noise, which compresses like CT data.
+ImageType::Pointer
+MakeImage(itk::SizeValueType size)
+{
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType::Filled(size));
+  image->Allocate();
+  unsigned int noise = 1;
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    const ImageType::IndexType index = it.GetIndex();
+    noise = noise * 1103515245u + 12345u;
+    const double value = 1000.0 * std::sin(0.05 * index[0]) * std::cos(0.03 * index[1]) + 10.0 * index[2];
+    it.Set(static_cast<short>(value + ((noise >> 16) % 16)));
+  }
+  return image;
+}
+
+// Writes the image and returns the time it took.
+double
+WriteImage(const ImageType * image, const std::string & fileName, const std::string & compressor, int level)
+{
+  auto metaIO = itk::MetaImageIO::New();
+  metaIO->SetCompressor(compressor);
+  metaIO->SetCompressionLevel(level);
+  auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetInput(image);
+  writer->SetFileName(fileName);
+  writer->SetImageIO(metaIO);
+  writer->UseCompressionOn();
+  itk::TimeProbe probe;
+  probe.Start();
+  writer->Update();
+  probe.Stop();
+  return probe.GetTotal();
+}
+
+bool
+ReadsBack(const ImageType * image, const std::string & fileName)
+{
+  const auto   readImage = itk::ReadImage<ImageType>(fileName);
+  const auto * expected = image->GetBufferPointer();
+  const auto * actual = readImage->GetBufferPointer();
+  if (!std::equal(expected, expected + image->GetPixelContainer()->Size(), actual))
+  {
+    std::cerr << fileName << " does not read back the written image." << std::endl;
+    return false;
+  }
+  return true;
+}
+} // namespace
+
+int
+itkMetaImageParallelCompressionTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory [imageSize]" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string        directory = argv[1];
+  const itk::SizeValueType imageSize = (argc > 2) ? static_cast<itk::SizeValueType>(std::stoi(argv[2])) : 128;
+
+  auto metaIO = itk::MetaImageIO::New();
+  metaIO->SetCompressor("parallelgzip");
+  ITK_TEST_EXPECT_EQUAL(metaIO->GetCompressor(), "parallelgzip");
+  metaIO->Print(std::cout);
+
+  bool success = true;
+
+  // Images smaller than the dictionary are compressed in a single block.
+  for (const itk::SizeValueType size : { 1, 3 })
+  {
+    const auto        smallImage = MakeImage(size);
+    const std::string fileName = directory + "/itkMetaImageParallelCompressionSmall.mha";
+    WriteImage(smallImage, fileName, "PARALLELGZIP", 2);
+    success &= ReadsBack(smallImage, fileName);
+  }
+
+  const auto        image = MakeImage(imageSize);
+  const double      megabytes = image->GetPixelContainer()->Size() * sizeof(short) / 1e6;
+  const std::string headerFileName = directory + "/itkMetaImageParallelCompression.mhd";
+  WriteImage(image, headerFileName, "PARALLELGZIP", 2);
+  success &= ReadsBack(image, headerFileName);
+
+  // Data files written slice by slice are rejected.
+  {
+    auto sliceIO = itk::MetaImageIO::New();
+    sliceIO->SetCompressor("PARALLELGZIP");
+    sliceIO->SetDataFileName("itkMetaImageParallelCompressionSlice%03d.zraw");
+    auto writer = itk::ImageFileWriter<ImageType>::New();
+    writer->SetInput(image);
+    writer->SetFileName(directory + "/itkMetaImageParallelCompressionSlices.mhd");
+    writer->SetImageIO(sliceIO);
+    writer->UseCompressionOn();
+    ITK_TRY_EXPECT_EXCEPTION(writer->Update());
+  }
+
+  std::cout << "Writing a " << megabytes << " MB image" << std::endl;
+  std::cout << "level  compressor  MB/s  ratio" << std::endl;
+  for (const int level : { 1, 2, 6, 9 })
+  {
+    for (const std::string compressor : { "", "PARALLELGZIP" })
+    {
+      const std::string fileName = directory + "/itkMetaImageParallelCompression" + compressor + ".mha";
+      const double      seconds = WriteImage(image, fileName, compressor, level);
+      const double      ratio =
+        megabytes * 1e6 / static_cast<double>(itksys::SystemTools::FileLength(fileName.c_str()));
+      std::cout << level << "  " << (compressor.empty() ? "zlib" : compressor) << "  " << megabytes / seconds << "  "
+                << ratio << std::endl;
+      success &= ReadsBack(image, fileName);
+    }
+  }
+
+  if (!success)
+  {
+    std::cout << "Test FAILED!" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -177,6 +177,34 @@ public:
   ImageIORegion
   GenerateStreamableReadRegionFromRequestedRegion(const ImageIORegion & requestedRegion) const override;
 
+  /** Determine if the ImageIO can stream reading from this file.
+   *  Uncompressed files are read by seeking to each row of the requested
+   *  region; for compressed files the data before each row is decompressed
+   *  and skipped, so only the requested region is held in memory. */
+  bool
+  CanStreamRead() override
+  {
+    return true;
+  }
+
+  /** Determine if the ImageIO can stream writing to this file. Only
+   *  uncompressed files can be written in pieces. */
+  bool
+  CanStreamWrite() override;
+
+  /** Verifies that a file being pasted into matches the image to be
+   *  written, and removes an existing file before streaming. */
+  unsigned int
+  GetActualNumberOfSplitsForWriting(unsigned int          numberOfRequestedSplits,
+                                    const ImageIORegion & pasteRegion,
+                                    const ImageIORegion & largestPossibleRegion) override;
+
+  ImageIORegion
+  GetSplitRegionForWriting(unsigned int          ithPiece,
+                           unsigned int          numberOfActualSplits,
+                           const ImageIORegion & pasteRegion,
+                           const ImageIORegion & largestPossibleRegion) override;
+
   /** Set the slope and intercept for voxel value rescaling. */
   itkSetMacro(RescaleSlope, double);
   itkSetMacro(RescaleIntercept, double);
@@ -261,6 +289,12 @@ private:
   void
   SetImageIOMetadataFromNIfTI();
 
+  // Writes a buffer in NIfTI layout, holding the IORegion of each of numberOfPlanes
+  // component planes, into the data file. Writes the header first if the file
+  // does not exist yet.
+  void
+  WriteIORegionToFile(const void * niftiBuffer, unsigned int numberOfPlanes);
+
   // This proxy class provides a nifti_image pointer interface to the internal implementation
   // of itk::NiftiImageIO, while hiding the niftilib interface from the external ITK interface.
   class NiftiImageProxy;
@@ -24,6 +24,8 @@
 #include "itkMakeUniqueForOverwrite.h"
 #include "itksys/SystemTools.hxx"
 #include "itksys/SystemInformation.hxx"
+#include <fstream>
+#include <vector>
 
 namespace itk
 {
@@ -387,7 +389,128 @@ SymMatDim(int count)
 ImageIORegion
 NiftiImageIO::GenerateStreamableReadRegionFromRequestedRegion(const ImageIORegion & requestedRegion) const
 {
-  return requestedRegion;
+  if (this->m_UseStreamedReading)
+  {
+    return requestedRegion;
+  }
+  ImageIORegion streamableRegion(this->m_NumberOfDimensions);
+  for (unsigned int i = 0; i < this->m_NumberOfDimensions; ++i)
+  {
+    streamableRegion.SetSize(i, this->m_Dimensions[i]);
+    streamableRegion.SetIndex(i, 0);
+  }
+  return streamableRegion;
+}
+
+bool
+NiftiImageIO::CanStreamWrite()
+{
+  // The nifti library writes compressed files as a single gzip stream, and
+  // ASCII files as text.
+  const char * extension = nifti_find_file_extension(this->GetFileName());
+  if (extension == nullptr)
+  {
+    return false;
+  }
+  const std::string extensionName(extension);
+  return extensionName.rfind(".gz") == std::string::npos && extensionName != ".nia";
+}
+
+unsigned int
+NiftiImageIO::GetActualNumberOfSplitsForWriting(unsigned int          numberOfRequestedSplits,
+                                                const ImageIORegion & pasteRegion,
+                                                const ImageIORegion & largestPossibleRegion)
+{
+  if (!this->CanStreamWrite())
+  {
+    if (pasteRegion != largestPossibleRegion)
+    {
+      itkExceptionMacro("Pasting into a compressed or ASCII NIfTI file is not supported! Can't write: "
+                        << this->GetFileName());
+    }
+    return 1;
+  }
+
+  if (!itksys::SystemTools::FileExists(m_FileName.c_str()))
+  {
+    // file doesn't exist so we don't have potential problems
+  }
+  else if (pasteRegion != largestPossibleRegion)
+  {
+    // we are going to be pasting (may be streaming too), so the raw voxels of
+    // the existing file must be laid out as those of the image being written
+    std::string   errorMessage;
+    const Pointer headerImageIOReader = Self::New();
+    try
+    {
+      headerImageIOReader->SetFileName(m_FileName.c_str());
+      headerImageIOReader->ReadImageInformation();
+    }
+    catch (...)
+    {
+      errorMessage = "Unable to read information from file: " + m_FileName;
+    }
+
+    if (!errorMessage.empty())
+    {
+      // Can't read file
+    }
+    else if (headerImageIOReader->GetNumberOfComponents() != this->GetNumberOfComponents() ||
+             headerImageIOReader->m_OnDiskComponentType != this->GetComponentType() ||
+             headerImageIOReader->MustRescale())
+    {
+      errorMessage = "Component type does not match in file: " + m_FileName;
+    }
+    else
+    {
+      for (unsigned int i = 0; i < this->GetNumberOfDimensions(); ++i)
+      {
+        const SizeValueType fileDimension =
+          (i < headerImageIOReader->GetNumberOfDimensions()) ? headerImageIOReader->GetDimensions(i) : 1;
+        if (fileDimension != this->GetDimensions(i))
+        {
+          errorMessage = "Size does not match in file: " + m_FileName;
+          break;
+        }
+      }
+    }
+
+    if (!errorMessage.empty())
+    {
+      itkExceptionMacro("Unable to paste because pasting file exists and is different. " << errorMessage);
+    }
+  }
+  else if (numberOfRequestedSplits != 1)
+  {
+    // we are going to be streaming; remove the existing file, whose header
+    // would otherwise be kept
+    std::vector<std::string> fileNames{ m_FileName };
+    const std::string        extension(nifti_find_file_extension(m_FileName.c_str()));
+    if (extension == ".hdr" || extension == ".img")
+    {
+      char * const baseName = nifti_makebasename(m_FileName.c_str());
+      fileNames = { std::string(baseName) + ".hdr", std::string(baseName) + ".img" };
+      free(baseName);
+    }
+    for (const auto & fileName : fileNames)
+    {
+      if (itksys::SystemTools::FileExists(fileName) && !itksys::SystemTools::RemoveFile(fileName))
+      {
+        itkExceptionMacro("Unable to remove file for streaming: " << fileName);
+      }
+    }
+  }
+
+  return GetActualNumberOfSplitsForWritingCanStreamWrite(numberOfRequestedSplits, pasteRegion);
+}
+
+ImageIORegion
+NiftiImageIO::GetSplitRegionForWriting(unsigned int          ithPiece,
+                                       unsigned int          numberOfActualSplits,
+                                       const ImageIORegion & pasteRegion,
+                                       const ImageIORegion & itkNotUsed(largestPossibleRegion))
+{
+  return GetSplitRegionForWritingCanStreamWrite(ithPiece, numberOfActualSplits, pasteRegion);
 }
 
 
@@ -697,10 +820,11 @@ NiftiImageIO::Read(void * buffer)
     // vec x y z t l m o
     const auto * niftibuf = (const char *)data;
     auto *       itkbuf = (char *)buffer;
-    const size_t rowdist = this->m_NiftiImage->dim[1];
-    const size_t slicedist = rowdist * this->m_NiftiImage->dim[2];
-    const size_t volumedist = slicedist * this->m_NiftiImage->dim[3];
-    const size_t seriesdist = volumedist * this->m_NiftiImage->dim[4];
+    // the strides are those of the region that was read, not of the file
+    const size_t rowdist = _size[0];
+    const size_t slicedist = rowdist * _size[1];
+    const size_t volumedist = slicedist * _size[2];
+    const size_t seriesdist = volumedist * _size[3];
     //
     // as per ITK bug 0007485
     // NIfTI is lower triangular, ITK is upper triangular.
@@ -718,13 +842,13 @@ NiftiImageIO::Read(void * buffer)
         vecOrder[i] = i;
       }
     }
-    for (int t = 0; t < this->m_NiftiImage->dim[4]; ++t)
+    for (int t = 0; t < _size[3]; ++t)
     {
-      for (int z = 0; z < this->m_NiftiImage->dim[3]; ++z)
+      for (int z = 0; z < _size[2]; ++z)
       {
-        for (int y = 0; y < this->m_NiftiImage->dim[2]; ++y)
+        for (int y = 0; y < _size[1]; ++y)
         {
-          for (int x = 0; x < this->m_NiftiImage->dim[1]; ++x)
+          for (int x = 0; x < _size[0]; ++x)
           {
             for (unsigned int c = 0; c < numComponents; ++c)
             {
@@ -2383,13 +2507,31 @@ NiftiImageIO::SetNIfTIOrientationFromImageIO(unsigned short origdims, unsigned s
 void
 NiftiImageIO::Write(const void * buffer)
 {
-  // Write the image Information before writing data
+  // When streaming, only a piece of the image is written by each call.
+  bool isStreamedPiece = false;
+  for (unsigned int i = 0; i < this->GetNumberOfDimensions(); ++i)
+  {
+    if (m_IORegion.GetIndex(i) != 0 || m_IORegion.GetSize(i) != this->GetDimensions(i))
+    {
+      isStreamedPiece = true;
+    }
+  }
+
+  // Write the image Information before writing data; start from a new header,
+  // as this is called for every piece when streaming
+  nifti_image_free(this->m_NiftiImage);
+  this->m_NiftiImage = nullptr;
   this->WriteImageInformation();
   const unsigned int numComponents = this->GetNumberOfComponents();
   if (numComponents == 1 || (numComponents == 2 && this->GetPixelType() == IOPixelEnum::COMPLEX) ||
       (numComponents == 3 && this->GetPixelType() == IOPixelEnum::RGB) ||
       (numComponents == 4 && this->GetPixelType() == IOPixelEnum::RGBA))
   {
+    if (isStreamedPiece)
+    {
+      this->WriteIORegionToFile(buffer, 1);
+      return;
+    }
     // Need a const cast here so that we don't have to copy the memory
     // for writing.
     this->m_NiftiImage->data = const_cast<void *>(buffer);
@@ -2413,8 +2555,14 @@ NiftiImageIO::Write(const void * buffer)
         this->m_NiftiImage->dim[i] = 1;
       }
     }
-    const size_t numVoxels = size_t(this->m_NiftiImage->dim[1]) * size_t(this->m_NiftiImage->dim[2]) *
-                             size_t(this->m_NiftiImage->dim[3]) * size_t(this->m_NiftiImage->dim[4]);
+    // The size of the region being written, which is the whole image unless streaming.
+    int regionSize[4] = { 1, 1, 1, 1 };
+    for (unsigned int i = 0; i < this->GetNumberOfDimensions() && i < 4; ++i)
+    {
+      regionSize[i] = static_cast<int>(m_IORegion.GetSize(i));
+    }
+    const size_t numVoxels =
+      size_t(regionSize[0]) * size_t(regionSize[1]) * size_t(regionSize[2]) * size_t(regionSize[3]);
     const size_t buffer_size = numVoxels * numComponents // Number of components
                                * this->m_NiftiImage->nbyper;
 
@@ -2422,10 +2570,10 @@ NiftiImageIO::Write(const void * buffer)
     const auto * const itkbuf = (const char *)buffer;
     // Data must be rearranged to meet nifti organzation.
     // nifti_layout[vec][t][z][y][x] = itk_layout[t][z][y][z][vec]
-    const size_t rowdist = m_NiftiImage->dim[1];
-    const size_t slicedist = rowdist * m_NiftiImage->dim[2];
-    const size_t volumedist = slicedist * m_NiftiImage->dim[3];
-    const size_t seriesdist = volumedist * m_NiftiImage->dim[4];
+    const size_t rowdist = regionSize[0];
+    const size_t slicedist = rowdist * regionSize[1];
+    const size_t volumedist = slicedist * regionSize[2];
+    const size_t seriesdist = volumedist * regionSize[3];
     //
     // as per ITK bug 0007485
     // NIfTI is lower triangular, ITK is upper triangular.
@@ -2450,13 +2598,13 @@ NiftiImageIO::Write(const void * buffer)
         vecOrder[i] = i;
       }
     }
-    for (int t = 0; t < this->m_NiftiImage->dim[4]; ++t)
+    for (int t = 0; t < regionSize[3]; ++t)
     {
-      for (int z = 0; z < this->m_NiftiImage->dim[3]; ++z)
+      for (int z = 0; z < regionSize[2]; ++z)
       {
-        for (int y = 0; y < this->m_NiftiImage->dim[2]; ++y)
+        for (int y = 0; y < regionSize[1]; ++y)
         {
-          for (int x = 0; x < this->m_NiftiImage->dim[1]; ++x)
+          for (int x = 0; x < regionSize[0]; ++x)
           {
             for (unsigned int c = 0; c < numComponents; ++c)
             {
@@ -2499,6 +2647,11 @@ NiftiImageIO::Write(const void * buffer)
 
     delete[] vecOrder;
     dumpdata(buffer);
+    if (isStreamedPiece)
+    {
+      this->WriteIORegionToFile(nifti_buf.get(), numComponents);
+      return;
+    }
     // Need a const cast here so that we don't have to copy the memory for
     // writing.
     this->m_NiftiImage->data = static_cast<void *>(nifti_buf.get());
@@ -2511,6 +2664,108 @@ NiftiImageIO::Write(const void * buffer)
   }
 }
 
+void
+NiftiImageIO::WriteIORegionToFile(const void * niftiBuffer, unsigned int numberOfPlanes)
+{
+  // The nifti library only writes whole images, so the header is written on
+  // its own, and the rows of the region are written at their file offsets.
+  std::streamoff dataPosition = 0;
+  if (!itksys::SystemTools::FileExists(this->m_NiftiImage->fname))
+  {
+    nifti_image_write_hdr_img(this->m_NiftiImage, 0, "wb");
+    if (!itksys::SystemTools::FileExists(this->m_NiftiImage->fname))
+    {
+      itkExceptionMacro("ERROR: nifti library failed to write header: " << this->m_NiftiImage->fname);
+    }
+    dataPosition = this->m_NiftiImage->iname_offset;
+  }
+  else
+  {
+    // pasting into an existing file, which may have a different data offset
+    nifti_image * header = nifti_image_read(this->m_NiftiImage->fname, false);
+    if (header == nullptr)
+    {
+      itkExceptionMacro("nifti_image_read (just header) failed for file: " << this->m_NiftiImage->fname);
+    }
+    dataPosition = header->iname_offset;
+    nifti_image_free(header);
+  }
+
+  const std::string dataFileName(this->m_NiftiImage->iname);
+  if (!itksys::SystemTools::FileExists(dataFileName))
+  {
+    std::ofstream(dataFileName.c_str(), std::ios::binary);
+  }
+  std::fstream file(dataFileName.c_str(), std::ios::in | std::ios::out | std::ios::binary);
+  if (!file.is_open())
+  {
+    itkExceptionMacro("Unable to open file for streamed writing: " << dataFileName);
+  }
+
+  const unsigned int   dimension = m_IORegion.GetImageDimension();
+  const std::streamoff voxelSize = this->m_NiftiImage->nbyper;
+
+  // compute the number of continuous voxels to be written
+  std::streamoff sizeOfChunk = 1;
+  unsigned int   movingDirection = 0;
+  do
+  {
+    sizeOfChunk *= m_IORegion.GetSize(movingDirection);
+    ++movingDirection;
+  } while (movingDirection < dimension &&
+           m_IORegion.GetSize(movingDirection - 1) == this->GetDimensions(movingDirection - 1));
+
+  std::streamoff planeSize = 1;
+  for (unsigned int i = 0; i < dimension; ++i)
+  {
+    planeSize *= this->GetDimensions(i);
+  }
+
+  // vector images are stored as one plane per component
+  const auto * niftiBuf = static_cast<const char *>(niftiBuffer);
+  for (unsigned int plane = 0; plane < numberOfPlanes; ++plane)
+  {
+    ImageIORegion::IndexType currentIndex = m_IORegion.GetIndex();
+    while (m_IORegion.IsInside(currentIndex))
+    {
+      std::streamoff voxelOffset = plane * planeSize;
+      std::streamoff subDimensionQuantity = 1;
+      for (unsigned int i = 0; i < dimension; ++i)
+      {
+        voxelOffset += subDimensionQuantity * currentIndex[i];
+        subDimensionQuantity *= this->GetDimensions(i);
+      }
+
+      file.seekp(dataPosition + voxelOffset * voxelSize, std::ios::beg);
+      file.write(niftiBuf, sizeOfChunk * voxelSize);
+      if (file.fail())
+      {
+        itkExceptionMacro("Fail writing to file: " << dataFileName);
+      }
+      niftiBuf += sizeOfChunk * voxelSize;
+
+      if (movingDirection == dimension)
+      {
+        break;
+      }
+
+      // increment index to next chunk
+      ++currentIndex[movingDirection];
+      for (unsigned int i = movingDirection; i < dimension - 1; ++i)
+      {
+        // when reaching the end of the moving index dimension carry to
+        // higher dimensions
+        const auto offsetInRegion = static_cast<ImageIORegion::SizeValueType>(currentIndex[i] - m_IORegion.GetIndex(i));
+        if (offsetInRegion >= m_IORegion.GetSize(i))
+        {
+          currentIndex[i] = m_IORegion.GetIndex(i);
+          ++currentIndex[i + 1];
+        }
+      }
+    }
+  }
+}
+
 std::ostream &
 operator<<(std::ostream & out, const NiftiImageIOEnums::Analyze75Flavor value)
 {
@@ -0,0 +1,192 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// Writes 4D series in pieces and reads them back volume by volume.
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkNiftiImageIO.h"
+#include "itkVector.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+template <typename TImage>
+typename TImage::Pointer
+MakeSeries()
+{
+  auto image = TImage::New();
+  image->SetRegions(typename TImage::SizeType{ { 9, 7, 5, 6 } });
+  image->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<TImage> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    const typename TImage::IndexType index = it.GetIndex();
+    typename TImage::PixelType       pixel;
+    const double value = index[0] + 10.0 * index[1] + 100.0 * index[2] + 1000.0 * index[3];
+    if constexpr (std::is_arithmetic_v<typename TImage::PixelType>)
+    {
+      pixel = static_cast<typename TImage::PixelType>(value);
+    }
+    else
+    {
+      for (unsigned int c = 0; c < pixel.Size(); ++c)
+      {
+        pixel[c] = static_cast<typename TImage::PixelType::ValueType>(value + 0.25 * c);
+      }
+    }
+    it.Set(pixel);
+  }
+  return image;
+}
+
+template <typename TImage>
+bool
+RegionMatches(const TImage * expected, const TImage * actual, const typename TImage::RegionType & region)
+{
+  itk::ImageRegionConstIterator<TImage> expectedIt(expected, region);
+  itk::ImageRegionConstIterator<TImage> actualIt(actual, region);
+  for (; !expectedIt.IsAtEnd(); ++expectedIt, ++actualIt)
+  {
+    if (expectedIt.Get() != actualIt.Get())
+    {
+      std::cerr << "Pixel " << expectedIt.GetIndex() << " is " << actualIt.Get() << " instead of " << expectedIt.Get()
+                << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// Writes the series in pieces, then reads every volume, and the whole series, back.
+template <typename TImage>
+bool
+StreamSeries(const std::string & fileName, bool expectStreamedWriting)
+{
+  const auto series = MakeSeries<TImage>();
+
+  auto writer = itk::ImageFileWriter<TImage>::New();
+  writer->SetInput(series);
+  writer->SetFileName(fileName);
+  writer->SetImageIO(itk::NiftiImageIO::New());
+  writer->SetNumberOfStreamDivisions(3);
+  writer->Update();
+  if (writer->GetImageIO()->CanStreamWrite() != expectStreamedWriting)
+  {
+    std::cerr << "Unexpected CanStreamWrite() for " << fileName << std::endl;
+    return false;
+  }
+
+  bool success = true;
+  for (itk::IndexValueType t = 0; t < 6; ++t)
+  {
+    auto reader = itk::ImageFileReader<TImage>::New();
+    reader->SetFileName(fileName);
+    typename TImage::RegionType volume = series->GetLargestPossibleRegion();
+    volume.SetIndex(3, t);
+    volume.SetSize(3, 1);
+    reader->GetOutput()->SetRequestedRegion(volume);
+    reader->Update();
+    if (reader->GetOutput()->GetBufferedRegion() != volume)
+    {
+      std::cerr << "Reading volume " << t << " of " << fileName << " buffered "
+                << reader->GetOutput()->GetBufferedRegion() << std::endl;
+      success = false;
+    }
+    success &= RegionMatches<TImage>(series, reader->GetOutput(), volume);
+  }
+
+  const auto whole = itk::ReadImage<TImage>(fileName);
+  success &= RegionMatches<TImage>(series, whole, series->GetLargestPossibleRegion());
+  return success;
+}
+} // namespace
+
+int
+itkNiftiStreamingImageIOTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string directory = argv[1];
+
+  using ScalarImageType = itk::Image<short, 4>;
+  using VectorImageType = itk::Image<itk::Vector<float, 3>, 4>;
+
+  bool success = true;
+  success &= StreamSeries<ScalarImageType>(directory + "/itkNiftiStreamingScalar.nii", true);
+  success &= StreamSeries<ScalarImageType>(directory + "/itkNiftiStreamingScalar.hdr", true);
+  success &= StreamSeries<VectorImageType>(directory + "/itkNiftiStreamingVector.nii", true);
+  // Compressed files are written at once, but still read volume by volume.
+  success &= StreamSeries<ScalarImageType>(directory + "/itkNiftiStreamingScalar.nii.gz", false);
+  success &= StreamSeries<VectorImageType>(directory + "/itkNiftiStreamingVector.nii.gz", false);
+
+  // Paste one volume into an existing file. The input only buffers that
+  // volume, otherwise the writer would write the whole image.
+  const std::string pasteFileName = directory + "/itkNiftiStreamingScalar.nii";
+  const auto        original = MakeSeries<ScalarImageType>();
+  ScalarImageType::RegionType pasteRegion = original->GetLargestPossibleRegion();
+  pasteRegion.SetIndex(3, 2);
+  pasteRegion.SetSize(3, 1);
+  auto replacement = ScalarImageType::New();
+  replacement->SetLargestPossibleRegion(original->GetLargestPossibleRegion());
+  replacement->SetBufferedRegion(pasteRegion);
+  replacement->SetRequestedRegion(pasteRegion);
+  replacement->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<ScalarImageType> it(replacement, pasteRegion); !it.IsAtEnd(); ++it)
+  {
+    it.Set(static_cast<short>(-original->GetPixel(it.GetIndex())));
+  }
+  itk::ImageIORegion pasteIORegion(4);
+  for (unsigned int i = 0; i < 4; ++i)
+  {
+    pasteIORegion.SetIndex(i, pasteRegion.GetIndex(i));
+    pasteIORegion.SetSize(i, pasteRegion.GetSize(i));
+  }
+  auto writer = itk::ImageFileWriter<ScalarImageType>::New();
+  writer->SetInput(replacement);
+  writer->SetFileName(pasteFileName);
+  writer->SetIORegion(pasteIORegion);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+
+  const auto pasted = itk::ReadImage<ScalarImageType>(pasteFileName);
+  success &= RegionMatches<ScalarImageType>(replacement, pasted, pasteRegion);
+  ScalarImageType::RegionType untouched = pasteRegion;
+  untouched.SetIndex(3, 0);
+  untouched.SetSize(3, 2);
+  success &= RegionMatches<ScalarImageType>(original, pasted, untouched);
+  untouched.SetIndex(3, 3);
+  untouched.SetSize(3, 3);
+  success &= RegionMatches<ScalarImageType>(original, pasted, untouched);
+
+  // Pasting into a compressed file is not supported.
+  writer->SetFileName(directory + "/itkNiftiStreamingScalar.nii.gz");
+  ITK_TRY_EXPECT_EXCEPTION(writer->Update());
+
+  if (!success)
+  {
+    std::cout << "Test FAILED!" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -36,7 +36,9 @@ namespace itk
  *
  * The compressor supported may include "gzip" (default) and
  * "bzip2".  Only the "gzip" compressor support the compression level
- * in the range 0-9.
+ * in the range 0-9. The "parallelgzip" compressor writes gzip data that
+ * is deflated in blocks on all threads, see ParallelZlibCompressor; the
+ * files are read as usual.
  *
  *  \ingroup IOFilters
  * \ingroup ITKIONRRD
@@ -78,6 +80,11 @@ public:
   void
   Read(void * buffer) override;
 
+  /** Raw encoded data in a single file, in the native byte order and with
+   * any non-scalar axis fastest, can be mapped. */
+  bool
+  GetMappableDataLocation(std::string & dataFileName, SizeType & dataOffset) const override;
+
   /** Determine the file type. Returns true if this ImageIO can write the
    * file specified. */
   bool
@@ -110,6 +117,8 @@ protected:
   NrrdToITKComponentType(const int) const;
 
   const NrrdEncoding_t * m_NrrdCompressionEncoding{ nullptr };
+
+  bool m_UseParallelCompression{ false };
 };
 } // end namespace itk
 
@@ -22,7 +22,10 @@
 #include "itkMetaDataObject.h"
 #include "itkIOCommon.h"
 #include "itkFloatingPointExceptions.h"
+#include "itkParallelZlibCompressor.h"
+#include "itksys/SystemTools.hxx"
 
+#include <fstream>
 #include <sstream>
 
 namespace itk
@@ -65,16 +68,19 @@ NrrdImageIO::PrintSelf(std::ostream & os, Indent indent) const
   Superclass::PrintSelf(os, indent);
 
   os << indent << "NrrdCompressionEncoding: " << m_NrrdCompressionEncoding << std::endl;
+  os << indent << "UseParallelCompression: " << (m_UseParallelCompression ? "On" : "Off") << std::endl;
 }
 
 void
 NrrdImageIO::InternalSetCompressor(const std::string & _compressor)
 {
   this->m_NrrdCompressionEncoding = nullptr;
+  this->m_UseParallelCompression = false;
 
   // set default to gzip
-  if (_compressor.empty())
+  if (_compressor.empty() || _compressor == "PARALLELGZIP")
   {
+    this->m_UseParallelCompression = !_compressor.empty();
     if (nrrdEncodingGzip->available())
     {
       this->m_NrrdCompressionEncoding = nrrdEncodingGzip;
@@ -852,6 +858,66 @@ NrrdImageIO::Read(void * buffer)
   }
 }
 
+bool
+NrrdImageIO::GetMappableDataLocation(std::string & dataFileName, SizeType & dataOffset) const
+{
+  Nrrd *        nrrd = nrrdNew();
+  NrrdIoState * nio = nrrdIoStateNew();
+
+  // Read the header again, keeping the data file open at the first byte of
+  // the data, after any line and byte skips.
+  nrrdIoStateSet(nio, nrrdIoStateSkipData, 1);
+  nrrdIoStateSet(nio, nrrdIoStateKeepNrrdDataFileOpen, 1);
+  bool saveFPEState(false);
+  if (FloatingPointExceptions::HasFloatingPointExceptionsSupport())
+  {
+    saveFPEState = FloatingPointExceptions::GetEnabled();
+    FloatingPointExceptions::Disable();
+  }
+  const bool loaded = nrrdLoad(nrrd, this->GetFileName(), nio) == 0;
+  if (FloatingPointExceptions::HasFloatingPointExceptionsSupport())
+  {
+    FloatingPointExceptions::SetEnabled(saveFPEState);
+  }
+
+  bool mappable = false;
+  if (loaded)
+  {
+    unsigned int       rangeAxisIdx[NRRD_DIM_MAX];
+    const unsigned int rangeAxisNum = nrrdRangeAxesGet(nrrd, rangeAxisIdx);
+    mappable = nio->format == nrrdFormatNRRD && nio->encoding == nrrdEncodingRaw && nio->dataFile != nullptr &&
+               nio->dataFNFormat == nullptr && nio->dataFNArr->len <= 1 &&
+               nrrdElementSize(nrrd) == this->GetComponentSize() &&
+               (nrrdElementSize(nrrd) == 1 || nio->endian == airMyEndian()) &&
+               (rangeAxisNum == 0 || (rangeAxisNum == 1 && rangeAxisIdx[0] == 0)) &&
+               nrrd->axis[0].kind != nrrdKind3DMaskedSymMatrix;
+    if (mappable)
+    {
+#if defined(_WIN32)
+      dataOffset = _ftelli64(nio->dataFile);
+#else
+      dataOffset = ftello(nio->dataFile);
+#endif
+      dataFileName = nio->dataFNArr->len == 0
+                       ? this->GetFileName()
+                       : itksys::SystemTools::CollapseFullPath(nio->dataFN[0], nio->path ? nio->path : "");
+      mappable = dataOffset >= 0;
+    }
+  }
+  else
+  {
+    free(biffGetDone(NRRD));
+  }
+
+  if (nio->dataFile != nullptr)
+  {
+    nio->dataFile = airFclose(nio->dataFile);
+  }
+  nrrdNuke(nrrd);
+  nrrdIoStateNix(nio);
+  return mappable;
+}
+
 bool
 NrrdImageIO::CanWriteFile(const char * name)
 {
@@ -1108,6 +1174,11 @@ NrrdImageIO::Write(const void * buffer)
     nio->encoding = this->m_NrrdCompressionEncoding;
     nio->zlibLevel = this->GetCompressionLevel();
     // nio->zlibStrategy = default
+    if (this->m_UseParallelCompression && nio->encoding == nrrdEncodingGzip)
+    {
+      // only the header is written by nrrdSave, the data is appended below
+      nio->skipData = AIR_TRUE;
+    }
   }
   else
   {
@@ -1148,6 +1219,38 @@ NrrdImageIO::Write(const void * buffer)
     itkExceptionMacro("Write: Error writing " << this->GetFileName() << ":\n" << err);
   }
 
+  if (nio->skipData)
+  {
+    std::vector<unsigned char> compressedData;
+    ParallelZlibCompressor::Compress(buffer,
+                                     nrrdElementSize(nrrd) * nrrdElementNumber(nrrd),
+                                     this->GetCompressionLevel(),
+                                     ParallelZlibCompressor::Format::Gzip,
+                                     compressedData);
+
+    // the data follows the header, or is in the file named by a detached header
+    std::string             dataFileName = this->GetFileName();
+    std::ios_base::openmode mode = std::ios::binary | std::ios::app;
+    if (nio->detachedHeader)
+    {
+      dataFileName = nio->dataFN[0];
+      if (airStrlen(nio->path) > 0)
+      {
+        dataFileName = std::string(nio->path) + '/' + dataFileName;
+      }
+      mode = std::ios::binary | std::ios::trunc;
+    }
+    std::ofstream dataFile(dataFileName.c_str(), mode);
+    dataFile.write(reinterpret_cast<const char *>(compressedData.data()),
+                   static_cast<std::streamsize>(compressedData.size()));
+    if (!dataFile)
+    {
+      nrrdNix(nrrd);
+      nrrdIoStateNix(nio);
+      itkExceptionMacro("Write: Error writing the data of " << this->GetFileName() << " to " << dataFileName);
+    }
+  }
+
   // Free the nrrd struct but don't touch nrrd->data
   nrrdNix(nrrd);
   nrrdIoStateNix(nio);
@@ -0,0 +1,122 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMemoryMappedImageContainer.h"
+#include "itkNrrdImageIO.h"
+#include "itkVector.h"
+#include "itkTestingMacros.h"
+#include "itksys/SystemTools.hxx"
+
+// Reports where NrrdImageIO finds mappable data, and reads attached and
+// detached NRRD files with memory mapping enabled.
+
+namespace
+{
+template <typename TImage>
+typename TImage::Pointer
+MakeImage()
+{
+  auto image = TImage::New();
+  image->SetRegions(typename TImage::SizeType{ { 24, 20, 12 } });
+  image->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<TImage> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    const auto index = it.GetIndex();
+    it.Set(typename TImage::PixelType(index[0] + 0.5 * index[1] + 7.0 * index[2]));
+  }
+  return image;
+}
+
+// Writes the image, then reads it with mapping enabled and returns whether it was mapped.
+template <typename TImage>
+bool
+WriteAndMap(const std::string & fileName, bool useCompression, bool & mapped)
+{
+  const auto image = MakeImage<TImage>();
+  itk::WriteImage(image, fileName, useCompression);
+
+  auto reader = itk::ImageFileReader<TImage>::New();
+  reader->SetFileName(fileName);
+  reader->SetUseMemoryMapping(true);
+  reader->Update();
+  const TImage * output = reader->GetOutput();
+
+  using ContainerType = typename TImage::PixelContainer;
+  using MappedContainerType =
+    itk::MemoryMappedImageContainer<typename ContainerType::ElementIdentifier, typename ContainerType::Element>;
+  const auto * container = dynamic_cast<const MappedContainerType *>(output->GetPixelContainer());
+  mapped = container != nullptr && container->IsMapped();
+  return std::equal(image->GetBufferPointer(),
+                    image->GetBufferPointer() + image->GetPixelContainer()->Size(),
+                    output->GetBufferPointer());
+}
+} // namespace
+
+int
+itkNrrdImageIOMemoryMappingTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing Parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string directory = argv[1];
+
+  using FloatImageType = itk::Image<float, 3>;
+  using VectorImageType = itk::Image<itk::Vector<float, 3>, 3>;
+  using ByteImageType = itk::Image<unsigned char, 3>;
+
+  // Attached data directly follows the header.
+  const std::string attachedFileName = directory + "/itkNrrdImageIOMemoryMapping.nrrd";
+  itk::WriteImage(MakeImage<FloatImageType>(), attachedFileName);
+  auto nrrdIO = itk::NrrdImageIO::New();
+  nrrdIO->SetFileName(attachedFileName);
+  nrrdIO->ReadImageInformation();
+  std::string                dataFileName;
+  itk::ImageIOBase::SizeType dataOffset = 0;
+  ITK_TEST_EXPECT_TRUE(nrrdIO->GetMappableDataLocation(dataFileName, dataOffset));
+  ITK_TEST_EXPECT_EQUAL(dataFileName, attachedFileName);
+  ITK_TEST_EXPECT_EQUAL(dataOffset,
+                        static_cast<itk::ImageIOBase::SizeType>(itksys::SystemTools::FileLength(attachedFileName) -
+                                                                nrrdIO->GetImageSizeInBytes()));
+
+  // Detached data is in the .raw file next to the header.
+  const std::string detachedFileName = directory + "/itkNrrdImageIOMemoryMapping.nhdr";
+  itk::WriteImage(MakeImage<FloatImageType>(), detachedFileName);
+  nrrdIO->SetFileName(detachedFileName);
+  nrrdIO->ReadImageInformation();
+  ITK_TEST_EXPECT_TRUE(nrrdIO->GetMappableDataLocation(dataFileName, dataOffset));
+  ITK_TEST_EXPECT_EQUAL(dataFileName, directory + "/itkNrrdImageIOMemoryMapping.raw");
+  ITK_TEST_EXPECT_EQUAL(dataOffset, 0);
+
+  bool mapped = false;
+  ITK_TEST_EXPECT_TRUE(WriteAndMap<FloatImageType>(detachedFileName, false, mapped));
+  ITK_TEST_EXPECT_TRUE(mapped);
+  ITK_TEST_EXPECT_TRUE(WriteAndMap<VectorImageType>(detachedFileName, false, mapped));
+  ITK_TEST_EXPECT_TRUE(mapped);
+  ITK_TEST_EXPECT_TRUE(WriteAndMap<ByteImageType>(attachedFileName, false, mapped));
+  ITK_TEST_EXPECT_TRUE(mapped);
+  ITK_TEST_EXPECT_TRUE(WriteAndMap<FloatImageType>(attachedFileName, true, mapped));
+  ITK_TEST_EXPECT_TRUE(!mapped);
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,75 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkNrrdImageIO.h"
+#include "itkTestingMacros.h"
+
+// Writes attached and detached NRRD files with the parallel gzip compressor
+// and reads them back.
+
+int
+itkNrrdImageIOParallelCompressionTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing Parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string directory = argv[1];
+
+  using ImageType = itk::Image<float, 3>;
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType{ { 120, 100, 40 } });
+  image->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    const ImageType::IndexType index = it.GetIndex();
+    it.Set(static_cast<float>(index[0] * 0.5 + index[1] * index[2]));
+  }
+
+  auto nrrdIO = itk::NrrdImageIO::New();
+  nrrdIO->SetCompressor("ParallelGzip");
+  ITK_TEST_EXPECT_EQUAL(nrrdIO->GetCompressor(), "ParallelGzip");
+  nrrdIO->Print(std::cout);
+
+  for (const char * fileName : { "/itkNrrdImageIOParallelCompression.nrrd", "/itkNrrdImageIOParallelCompression.nhdr" })
+  {
+    auto writer = itk::ImageFileWriter<ImageType>::New();
+    writer->SetInput(image);
+    writer->SetFileName(directory + fileName);
+    writer->SetImageIO(nrrdIO);
+    writer->UseCompressionOn();
+    ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+
+    const auto readImage = itk::ReadImage<ImageType>(directory + fileName);
+    if (!std::equal(image->GetBufferPointer(),
+                    image->GetBufferPointer() + image->GetPixelContainer()->Size(),
+                    readImage->GetBufferPointer()))
+    {
+      std::cerr << fileName << " does not read back the written image." << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -123,6 +123,10 @@ public:
   void
   Read(void * buffer) override;
 
+  /** Binary files in the native byte order can be mapped. */
+  bool
+  GetMappableDataLocation(std::string & dataFileName, SizeType & dataOffset) const override;
+
   /** Set/Get the Data mask. */
   itkGetConstReferenceMacro(ImageMask, unsigned short);
   void
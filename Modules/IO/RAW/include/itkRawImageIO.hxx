@@ -19,6 +19,7 @@
 #define itkRawImageIO_hxx
 
 #include "itkIntTypes.h"
+#include "itksys/SystemTools.hxx"
 
 
 namespace itk
@@ -161,6 +162,24 @@ RawImageIO<TPixel, VImageDimension>::Read(void * buffer)
   ReadRawBytesAfterSwapping(componentType, buffer, m_ByteOrder, numberOfComponents);
 }
 
+template <typename TPixel, unsigned int VImageDimension>
+bool
+RawImageIO<TPixel, VImageDimension>::GetMappableDataLocation(std::string & dataFileName, SizeType & dataOffset) const
+{
+  const bool nativeByteOrder =
+    (m_ByteOrder == IOByteOrderEnum::BigEndian) == ByteSwapper<int>::SystemIsBigEndian() || sizeof(ComponentType) == 1;
+  if (m_FileType != IOFileEnum::Binary || !nativeByteOrder || m_FileName.empty())
+  {
+    return false;
+  }
+  dataFileName = m_FileName;
+  // Without a header size, the data is at the end of the file.
+  dataOffset = m_ManualHeaderSize ? static_cast<SizeType>(m_HeaderSize)
+                                  : static_cast<SizeType>(itksys::SystemTools::FileLength(m_FileName)) -
+                                      static_cast<SizeType>(this->GetImageSizeInBytes());
+  return dataOffset >= 0;
+}
+
 template <typename TPixel, unsigned int VImageDimension>
 bool
 RawImageIO<TPixel, VImageDimension>::CanWriteFile(const char * fname)
@@ -83,6 +83,22 @@ public:
   virtual void
   ReadVolume(void * buffer);
 
+  /** Determine if the ImageIO can stream reading from this file. Grayscale
+   * and RGB(A) files, stripped or tiled, are read by decoding only the strips
+   * or tiles that overlap the requested region, and only the requested pages
+   * of a multi-page file. Palette and other images are read completely.
+   * ReadImageInformation must be called prior to this function. */
+  bool
+  CanStreamRead() override
+  {
+    return m_CanReadRegion;
+  }
+
+  /** Calculate the region of the image that can be efficiently read
+   *  in response to a given requested region. */
+  ImageIORegion
+  GenerateStreamableReadRegionFromRequestedRegion(const ImageIORegion & requestedRegion) const override;
+
   /*-------- This part of the interfaces deals with writing data. ----- */
 
   /** Determine the file type. Returns true if this ImageIO can read the
@@ -172,6 +188,14 @@ public:
   }
 
 
+  /** Set/Get the size of the tiles in which images are written. Both must be
+   * multiples of 16. When either is 0, the default, images are written in
+   * strips. Tiled files can be read efficiently in small regions. */
+  itkSetMacro(TileWidth, unsigned int);
+  itkGetConstMacro(TileWidth, unsigned int);
+  itkSetMacro(TileHeight, unsigned int);
+  itkGetConstMacro(TileHeight, unsigned int);
+
   /** Get a const ref to the palette of the image. In the case of non palette
    * image or ExpandRGBPalette set to true, a vector of size
    * 0 is returned.
@@ -255,6 +279,11 @@ private:
   void
   ReadCurrentPage(void * buffer, size_t pixelOffset);
 
+  /** Reads the IORegion by decoding the overlapping strips or tiles of the
+   * requested pages, in parallel. */
+  void
+  ReadRegion(void * buffer);
+
   template <typename TComponent>
   void
   ReadGenericImage(void * _out, unsigned int width, unsigned int height);
@@ -309,6 +338,9 @@ private:
   uint16_t *   m_ColorBlue{};
   uint64_t     m_TotalColors{ 0 };
   unsigned int m_ImageFormat{ TIFFImageIO::NOFORMAT };
+  bool         m_CanReadRegion{ false };
+  unsigned int m_TileWidth{ 0 };
+  unsigned int m_TileHeight{ 0 };
 };
 } // end namespace itk
 
@@ -21,9 +21,13 @@
 #include "itksys/SystemTools.hxx"
 #include "itkMetaDataObject.h"
 #include "itkMakeUniqueForOverwrite.h"
+#include "itkMultiThreaderBase.h"
 
 #include "itk_tiff.h"
 
+#include <atomic>
+#include <vector>
+
 namespace itk
 {
 
@@ -188,9 +192,13 @@ TIFFImageIO::Read(void * buffer)
     }
   }
 
+  if (m_CanReadRegion)
+  {
+    this->ReadRegion(buffer);
+  }
   // The IO region should be of dimensions 3 otherwise we read only the first
   // page
-  if (m_InternalImage->m_NumberOfPages > 0 && this->GetIORegion().GetImageDimension() > 2)
+  else if (m_InternalImage->m_NumberOfPages > 0 && this->GetIORegion().GetImageDimension() > 2)
   {
     this->ReadVolume(buffer);
   }
@@ -202,6 +210,204 @@ TIFFImageIO::Read(void * buffer)
   m_InternalImage->Clean();
 }
 
+namespace
+{
+// A strip or tile of one directory, and the part of it inside the region.
+struct TIFFBlock
+{
+  tdir_t   directory;
+  uint32_t index;
+  uint32_t x;
+  uint32_t y;
+  uint32_t width;
+  uint32_t height;
+  size_t   page;
+};
+} // namespace
+
+ImageIORegion
+TIFFImageIO::GenerateStreamableReadRegionFromRequestedRegion(const ImageIORegion & requestedRegion) const
+{
+  if (!m_UseStreamedReading || !m_CanReadRegion)
+  {
+    return Superclass::GenerateStreamableReadRegionFromRequestedRegion(requestedRegion);
+  }
+  return requestedRegion;
+}
+
+void
+TIFFImageIO::ReadRegion(void * buffer)
+{
+  const ImageIORegion & region = this->GetIORegion();
+  const uint32_t        width = m_InternalImage->m_Width;
+  const uint32_t        height = m_InternalImage->m_Height;
+  const auto            x0 = static_cast<uint32_t>(region.GetIndex(0));
+  const auto            x1 = static_cast<uint32_t>(x0 + region.GetSize(0));
+  const auto            y0 = static_cast<uint32_t>(region.GetIndex(1));
+  const auto            y1 = static_cast<uint32_t>(y0 + region.GetSize(1));
+  size_t                firstPage = 0;
+  size_t                numberOfPages = 1;
+  if (region.GetImageDimension() > 2)
+  {
+    firstPage = static_cast<size_t>(region.GetIndex(2));
+    numberOfPages = static_cast<size_t>(region.GetSize(2));
+  }
+  const bool   bottomLeft = m_InternalImage->m_Orientation == ORIENTATION_BOTLEFT;
+  const size_t pixelSize = this->GetComponentSize() * this->GetNumberOfComponents();
+
+  // The rows of the file holding the region.
+  const uint32_t fileRow0 = bottomLeft ? height - y1 : y0;
+  const uint32_t fileRow1 = bottomLeft ? height - y0 : y1;
+
+  // Find the directories of the requested pages, skipping reduced images and
+  // masks like ReadVolume, and the strips or tiles overlapping the region.
+  TIFF *                 tif = m_InternalImage->m_Image;
+  std::vector<TIFFBlock> blocks;
+  tmsize_t               maximumBlockSize = 0;
+  size_t                 page = 0;
+  for (tdir_t directory = 0; page < firstPage + numberOfPages && directory < m_InternalImage->m_NumberOfPages;
+       ++directory)
+  {
+    if (!TIFFSetDirectory(tif, directory))
+    {
+      itkExceptionMacro("Cannot read directory " << directory << " of " << m_FileName);
+    }
+    if (m_InternalImage->m_IgnoredSubFiles > 0)
+    {
+      int32_t subfiletype = 6;
+      if (TIFFGetField(tif, TIFFTAG_SUBFILETYPE, &subfiletype) &&
+          (subfiletype & FILETYPE_REDUCEDIMAGE || subfiletype & FILETYPE_MASK))
+      {
+        continue;
+      }
+    }
+    if (page++ < firstPage)
+    {
+      continue;
+    }
+
+    uint32_t pageWidth = 0;
+    uint32_t pageHeight = 0;
+    uint16_t samplesPerPixel = 0;
+    uint16_t bitsPerSample = 0;
+    TIFFGetField(tif, TIFFTAG_IMAGEWIDTH, &pageWidth);
+    TIFFGetField(tif, TIFFTAG_IMAGELENGTH, &pageHeight);
+    TIFFGetFieldDefaulted(tif, TIFFTAG_SAMPLESPERPIXEL, &samplesPerPixel);
+    TIFFGetFieldDefaulted(tif, TIFFTAG_BITSPERSAMPLE, &bitsPerSample);
+    if (pageWidth != width || pageHeight != height || samplesPerPixel != m_InternalImage->m_SamplesPerPixel ||
+        bitsPerSample != m_InternalImage->m_BitsPerSample)
+    {
+      itkExceptionMacro("Page " << page - 1 << " of " << m_FileName << " differs from the first page.");
+    }
+
+    uint32_t blockWidth = width;
+    uint32_t blockHeight = height;
+    if (TIFFIsTiled(tif))
+    {
+      TIFFGetField(tif, TIFFTAG_TILEWIDTH, &blockWidth);
+      TIFFGetField(tif, TIFFTAG_TILELENGTH, &blockHeight);
+      maximumBlockSize = std::max(maximumBlockSize, TIFFTileSize(tif));
+    }
+    else
+    {
+      TIFFGetFieldDefaulted(tif, TIFFTAG_ROWSPERSTRIP, &blockHeight);
+      blockHeight = std::min(blockHeight, height);
+      maximumBlockSize = std::max(maximumBlockSize, TIFFStripSize(tif));
+    }
+    if (blockWidth == 0 || blockHeight == 0)
+    {
+      itkExceptionMacro("Invalid tile or strip size in " << m_FileName);
+    }
+
+    const bool isTiled = TIFFIsTiled(tif);
+    for (uint32_t y = fileRow0 - fileRow0 % blockHeight; y < fileRow1; y += blockHeight)
+    {
+      for (uint32_t x = isTiled ? x0 - x0 % blockWidth : 0; x < (isTiled ? x1 : 1); x += blockWidth)
+      {
+        const uint32_t index = isTiled ? TIFFComputeTile(tif, x, y, 0, 0) : TIFFComputeStrip(tif, y, 0);
+        blocks.push_back({ directory, index, x, y, blockWidth, blockHeight, page - 1 - firstPage });
+      }
+    }
+  }
+  if (page < firstPage + numberOfPages)
+  {
+    itkExceptionMacro("Page " << firstPage + numberOfPages - 1 << " is not in " << m_FileName);
+  }
+
+  // Decode the blocks in parallel, each chunk of blocks with its own handle to
+  // the file, since a TIFF handle can only decode one block at a time.
+  const auto   multiThreader = MultiThreaderBase::New();
+  const size_t numberOfChunks =
+    std::min(blocks.size(), static_cast<size_t>(multiThreader->GetNumberOfWorkUnits()));
+  const size_t      rowLength = static_cast<size_t>(x1 - x0) * pixelSize;
+  const size_t      sliceLength = rowLength * (y1 - y0);
+  std::atomic<bool> failed{ false };
+  auto * const      out = static_cast<char *>(buffer);
+
+  const auto decodeChunk = [&](SizeValueType chunk) {
+    TIFF * chunkTIFF = tif;
+    if (numberOfChunks > 1)
+    {
+      chunkTIFF = TIFFOpen(m_FileName.c_str(), "r");
+      if (chunkTIFF == nullptr)
+      {
+        failed = true;
+        return;
+      }
+    }
+    const auto scratch = make_unique_for_overwrite<char[]>(static_cast<size_t>(maximumBlockSize));
+    tdir_t     currentDirectory = TIFFCurrentDirectory(chunkTIFF);
+    const auto first = chunk * blocks.size() / numberOfChunks;
+    const auto last = (chunk + 1) * blocks.size() / numberOfChunks;
+    for (size_t b = first; b < last && !failed; ++b)
+    {
+      const TIFFBlock & block = blocks[b];
+      if (block.directory != currentDirectory)
+      {
+        if (!TIFFSetDirectory(chunkTIFF, block.directory))
+        {
+          failed = true;
+          break;
+        }
+        currentDirectory = block.directory;
+      }
+      const bool     isTiled = TIFFIsTiled(chunkTIFF);
+      const tmsize_t decoded = isTiled ? TIFFReadEncodedTile(chunkTIFF, block.index, scratch.get(), maximumBlockSize)
+                                       : TIFFReadEncodedStrip(chunkTIFF, block.index, scratch.get(), maximumBlockSize);
+      if (decoded < 0)
+      {
+        failed = true;
+        break;
+      }
+
+      // Copy the rows of the block that are inside the region.
+      const size_t   blockRowLength = static_cast<size_t>(isTiled ? block.width : width) * pixelSize;
+      const uint32_t columnBegin = std::max(x0, block.x);
+      const uint32_t columnEnd = std::min(x1, std::min(block.x + block.width, width));
+      const uint32_t rowBegin = std::max(fileRow0, block.y);
+      const uint32_t rowEnd = std::min(fileRow1, std::min(block.y + block.height, height));
+      const size_t   copyLength = static_cast<size_t>(columnEnd - columnBegin) * pixelSize;
+      for (uint32_t row = rowBegin; row < rowEnd; ++row)
+      {
+        const uint32_t imageRow = bottomLeft ? height - 1 - row : row;
+        const char *   from = scratch.get() + (row - block.y) * blockRowLength + (columnBegin - block.x) * pixelSize;
+        char * to = out + block.page * sliceLength + (imageRow - y0) * rowLength + (columnBegin - x0) * pixelSize;
+        std::copy_n(from, copyLength, to);
+      }
+    }
+    if (chunkTIFF != tif)
+    {
+      TIFFClose(chunkTIFF);
+    }
+  };
+  multiThreader->ParallelizeArray(0, numberOfChunks, decodeChunk, nullptr);
+
+  if (failed)
+  {
+    itkExceptionMacro("Cannot decode the region " << region << " of " << m_FileName);
+  }
+}
+
 TIFFImageIO::TIFFImageIO()
   : m_ColorPalette(0)
 
@@ -247,6 +453,8 @@ TIFFImageIO::PrintSelf(std::ostream & os, Indent indent) const
 
   os << indent << "Compression: " << m_Compression << std::endl;
   os << indent << "JPEGQuality: " << this->GetJPEGQuality() << std::endl;
+  os << indent << "TileWidth: " << m_TileWidth << std::endl;
+  os << indent << "TileHeight: " << m_TileHeight << std::endl;
   if (!m_ColorPalette.empty())
   {
     os << indent << "Image RGB palette:" << '\n';
@@ -343,6 +551,7 @@ TIFFImageIO::ReadImageInformation()
     }
   }
 
+  m_CanReadRegion = false;
   ReadTIFFTags();
 
   // if the tiff file is multi-pages
@@ -534,6 +743,10 @@ TIFFImageIO::ReadImageInformation()
     // make sure the palette is empty
     m_ColorPalette.resize(0);
   }
+
+  m_CanReadRegion = m_InternalImage->CanReadRegion() &&
+                    (this->GetFormat() == TIFFImageIO::GRAYSCALE || this->GetFormat() == TIFFImageIO::RGB_) &&
+                    this->GetComponentSize() * 8 == m_InternalImage->m_BitsPerSample;
 }
 
 bool
@@ -611,6 +824,13 @@ TIFFImageIO::InternalWrite(const void * buffer)
 
   uint16_t predictor;
 
+  const bool isTiled = m_TileWidth > 0 && m_TileHeight > 0;
+  if (isTiled && (m_TileWidth % 16 != 0 || m_TileHeight % 16 != 0))
+  {
+    itkExceptionMacro("TileWidth and TileHeight must be multiples of 16, not " << m_TileWidth << " and "
+                                                                                << m_TileHeight);
+  }
+
   const char * mode = "w";
 
   // If the size of the image is greater than 2 GiB then use big tiff
@@ -750,6 +970,12 @@ TIFFImageIO::InternalWrite(const void * buffer)
     }
 
 
+    if (isTiled)
+    {
+      TIFFSetField(tif, TIFFTAG_TILEWIDTH, static_cast<uint32_t>(m_TileWidth));
+      TIFFSetField(tif, TIFFTAG_TILELENGTH, static_cast<uint32_t>(m_TileHeight));
+    }
+
     // Previously, rowsperstrip was set to a default value so that it would be calculated using
     // the STRIP_SIZE_DEFAULT defined to be 8 kB in tiffiop.h.
     // However, this a very conservative small number, and it leads to very small strips resulting
@@ -766,22 +992,25 @@ TIFFImageIO::InternalWrite(const void * buffer)
     // Using 1 MB per strip leads to 256 rows per strip, which takes only 4 seconds to write over sshfs.
     // Rather than change that value in the third party libtiff library, we instead compute the
     // rowsperstrip here to lead to this same value.
+    if (!isTiled)
+    {
 #ifdef TIFF_INT64_T // detect if libtiff4
-    uint64_t const scanlinesize = TIFFScanlineSize64(tif);
+      uint64_t const scanlinesize = TIFFScanlineSize64(tif);
 #else
-    tsize_t scanlinesize = TIFFScanlineSize(tif);
+      tsize_t scanlinesize = TIFFScanlineSize(tif);
 #endif
-    if (scanlinesize == 0)
-    {
-      itkExceptionMacro("TIFFScanlineSize returned 0");
-    }
-    rowsperstrip = static_cast<uint32_t>(1024 * 1024 / scanlinesize);
-    if (rowsperstrip < 1)
-    {
-      rowsperstrip = 1;
-    }
+      if (scanlinesize == 0)
+      {
+        itkExceptionMacro("TIFFScanlineSize returned 0");
+      }
+      rowsperstrip = static_cast<uint32_t>(1024 * 1024 / scanlinesize);
+      if (rowsperstrip < 1)
+      {
+        rowsperstrip = 1;
+      }
 
-    TIFFSetField(tif, TIFFTAG_ROWSPERSTRIP, TIFFDefaultStripSize(tif, rowsperstrip));
+      TIFFSetField(tif, TIFFTAG_ROWSPERSTRIP, TIFFDefaultStripSize(tif, rowsperstrip));
+    }
 
     if (resolution_x > 0 && resolution_y > 0)
     {
@@ -823,15 +1052,47 @@ TIFFImageIO::InternalWrite(const void * buffer)
     rowLength *= this->GetNumberOfComponents();
     rowLength *= width;
 
-    uint32_t row = 0;
-    for (unsigned int idx2 = 0; idx2 < height; ++idx2)
+    if (isTiled)
     {
-      if (TIFFWriteScanline(tif, const_cast<char *>(outPtr), row, 0) < 0)
+      // Tiles extending past the image are padded with zeros.
+      const size_t tileRowLength = rowLength / width * m_TileWidth;
+      const auto   tileBuffer = make_unique_for_overwrite<char[]>(tileRowLength * m_TileHeight);
+      for (uint32_t y = 0; y < h; y += m_TileHeight)
       {
-        itkExceptionMacro("TIFFImageIO: error out of disk space");
+        for (uint32_t x = 0; x < w; x += m_TileWidth)
+        {
+          const uint32_t rows = std::min(h - y, static_cast<uint32_t>(m_TileHeight));
+          const size_t   copyLength = rowLength / width * std::min(w - x, static_cast<uint32_t>(m_TileWidth));
+          std::fill_n(tileBuffer.get(), tileRowLength * m_TileHeight, char{ 0 });
+          for (uint32_t row = 0; row < rows; ++row)
+          {
+            std::copy_n(outPtr + (y + row) * rowLength + x * (rowLength / width),
+                        copyLength,
+                        tileBuffer.get() + row * tileRowLength);
+          }
+          if (TIFFWriteEncodedTile(tif,
+                                   TIFFComputeTile(tif, x, y, 0, 0),
+                                   tileBuffer.get(),
+                                   static_cast<tmsize_t>(tileRowLength * m_TileHeight)) < 0)
+          {
+            itkExceptionMacro("TIFFImageIO: error out of disk space");
+          }
+        }
+      }
+      outPtr += rowLength * height;
+    }
+    else
+    {
+      uint32_t row = 0;
+      for (unsigned int idx2 = 0; idx2 < height; ++idx2)
+      {
+        if (TIFFWriteScanline(tif, const_cast<char *>(outPtr), row, 0) < 0)
+        {
+          itkExceptionMacro("TIFFImageIO: error out of disk space");
+        }
+        outPtr += rowLength;
+        ++row;
       }
-      outPtr += rowLength;
-      ++row;
     }
 
     if (m_NumberOfDimensions == 3)
@@ -286,11 +286,14 @@ TIFFReaderInternal::Initialize()
 int
 TIFFReaderInternal::CanRead()
 {
+  if (m_NumberOfTiles > 0)
+  {
+    // tiles are only read by TIFFImageIO::ReadRegion, otherwise use TIFFReadRGBAImage
+    return this->CanReadRegion();
+  }
   const bool compressionSupported = (TIFFIsCODECConfigured(this->m_Compression) == 1);
   return (this->m_Image && (this->m_Width > 0) && (this->m_Height > 0) && (this->m_SamplesPerPixel > 0) &&
-          compressionSupported && (m_NumberOfTiles == 0) // just use TIFFReadRGBAImage, an
-                                                         // native optimized version would be nice
-          && (this->m_HasValidPhotometricInterpretation) &&
+          compressionSupported && (this->m_HasValidPhotometricInterpretation) &&
           (this->m_Photometrics == PHOTOMETRIC_RGB || this->m_Photometrics == PHOTOMETRIC_MINISWHITE ||
            this->m_Photometrics == PHOTOMETRIC_MINISBLACK ||
            (this->m_Photometrics == PHOTOMETRIC_PALETTE && this->m_BitsPerSample != 32)) &&
@@ -299,4 +302,18 @@ TIFFReaderInternal::CanRead()
           (this->m_BitsPerSample == 8 || this->m_BitsPerSample == 16 || this->m_BitsPerSample == 32));
 }
 
+int
+TIFFReaderInternal::CanReadRegion()
+{
+  const bool compressionSupported = (TIFFIsCODECConfigured(this->m_Compression) == 1);
+  return (this->m_Image && (this->m_Width > 0) && (this->m_Height > 0) && (this->m_SamplesPerPixel > 0) &&
+          compressionSupported && (this->m_HasValidPhotometricInterpretation) &&
+          (this->m_Photometrics == PHOTOMETRIC_RGB ||
+           ((this->m_Photometrics == PHOTOMETRIC_MINISWHITE || this->m_Photometrics == PHOTOMETRIC_MINISBLACK) &&
+            this->m_SamplesPerPixel == 1)) &&
+          (this->m_PlanarConfig == PLANARCONFIG_CONTIG || this->m_SamplesPerPixel == 1) &&
+          (this->m_Orientation == ORIENTATION_TOPLEFT || this->m_Orientation == ORIENTATION_BOTLEFT) &&
+          (this->m_BitsPerSample == 8 || this->m_BitsPerSample == 16 || this->m_BitsPerSample == 32));
+}
+
 } // namespace itk
@@ -39,6 +39,11 @@ public:
   int
   CanRead();
 
+  // Whether the pixels can be copied from the decoded strips or tiles as
+  // they are, so that any region can be read.
+  int
+  CanReadRegion();
+
   int
   Open(const char * filename, bool silent = false);
 
@@ -0,0 +1,181 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// Writes stripped and tiled images and reads regions of them back.
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkRGBPixel.h"
+#include "itkTIFFImageIO.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+template <typename TImage>
+typename TImage::Pointer
+MakeImage(const typename TImage::SizeType & size)
+{
+  auto image = TImage::New();
+  image->SetRegions(size);
+  image->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<TImage> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    unsigned int value = 0;
+    for (unsigned int i = 0; i < TImage::ImageDimension; ++i)
+    {
+      value = 7 * value + static_cast<unsigned int>(it.GetIndex()[i]) * (i + 3);
+    }
+    typename TImage::PixelType pixel;
+    if constexpr (std::is_arithmetic_v<typename TImage::PixelType>)
+    {
+      pixel = static_cast<typename TImage::PixelType>(value);
+    }
+    else
+    {
+      for (unsigned int c = 0; c < 3; ++c)
+      {
+        pixel[c] = static_cast<typename TImage::PixelType::ValueType>(value + 50 * c);
+      }
+    }
+    it.Set(pixel);
+  }
+  return image;
+}
+
+template <typename TImage>
+bool
+RegionMatches(const TImage * expected, const TImage * actual, const typename TImage::RegionType & region)
+{
+  itk::ImageRegionConstIterator<TImage> expectedIt(expected, region);
+  itk::ImageRegionConstIterator<TImage> actualIt(actual, region);
+  for (; !expectedIt.IsAtEnd(); ++expectedIt, ++actualIt)
+  {
+    if (expectedIt.Get() != actualIt.Get())
+    {
+      std::cerr << "Pixel " << expectedIt.GetIndex() << " is " << actualIt.Get() << " instead of " << expectedIt.Get()
+                << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// Writes the image with the given tile size, then reads the region, and the whole image, back.
+template <typename TImage>
+bool
+WriteAndReadRegion(const std::string &                fileName,
+                   const TImage *                     image,
+                   unsigned int                       tileSize,
+                   const std::string &                compressor,
+                   const typename TImage::RegionType & region)
+{
+  auto tiffIO = itk::TIFFImageIO::New();
+  tiffIO->SetTileWidth(tileSize);
+  tiffIO->SetTileHeight(tileSize);
+  tiffIO->SetCompressor(compressor);
+  tiffIO->SetUseCompression(!compressor.empty());
+  auto writer = itk::ImageFileWriter<TImage>::New();
+  writer->SetInput(image);
+  writer->SetFileName(fileName);
+  writer->SetImageIO(tiffIO);
+  writer->Update();
+
+  auto readerIO = itk::TIFFImageIO::New();
+  auto reader = itk::ImageFileReader<TImage>::New();
+  reader->SetFileName(fileName);
+  reader->SetImageIO(readerIO);
+  reader->GetOutput()->SetRequestedRegion(region);
+  reader->Update();
+
+  bool success = true;
+  if (!readerIO->CanStreamRead())
+  {
+    std::cerr << fileName << " is not read by region" << std::endl;
+    success = false;
+  }
+  if (reader->GetOutput()->GetBufferedRegion() != region)
+  {
+    std::cerr << "Reading " << region << " of " << fileName << " buffered " << reader->GetOutput()->GetBufferedRegion()
+              << std::endl;
+    success = false;
+  }
+  success &= RegionMatches<TImage>(image, reader->GetOutput(), region);
+
+  const auto whole = itk::ReadImage<TImage>(fileName);
+  success &= RegionMatches<TImage>(image, whole, image->GetLargestPossibleRegion());
+  return success;
+}
+} // namespace
+
+int
+itkTIFFImageIOStreamingTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string directory = argv[1];
+
+  using StackType = itk::Image<unsigned short, 3>;
+  using RGBImageType = itk::Image<itk::RGBPixel<unsigned char>, 2>;
+
+  const auto stack = MakeImage<StackType>({ { 100, 70, 4 } });
+  const auto rgbImage = MakeImage<RGBImageType>({ { 90, 65 } });
+
+  StackType::RegionType stackRegion({ { 17, 9, 1 } }, { { 44, 42, 2 } });
+  RGBImageType::RegionType rgbRegion({ { 33, 20 } }, { { 57, 40 } });
+
+  bool success = true;
+  success &= WriteAndReadRegion<StackType>(directory + "/itkTIFFImageIOStreamingStrips.tif", stack, 0, "", stackRegion);
+  success &= WriteAndReadRegion<StackType>(
+    directory + "/itkTIFFImageIOStreamingTiles.tif", stack, 32, "DEFLATE", stackRegion);
+  success &= WriteAndReadRegion<StackType>(
+    directory + "/itkTIFFImageIOStreamingTiles.tif", stack, 16, "LZW", { { { 96, 66, 3 } }, { { 4, 4, 1 } } });
+  success &=
+    WriteAndReadRegion<RGBImageType>(directory + "/itkTIFFImageIOStreamingRGBTiles.tif", rgbImage, 48, "", rgbRegion);
+
+  // Reading the first page of a stack into a 2D image.
+  using SliceType = itk::Image<unsigned short, 2>;
+  const auto slice = itk::ReadImage<SliceType>(directory + "/itkTIFFImageIOStreamingTiles.tif");
+  ITK_TEST_EXPECT_EQUAL(slice->GetPixel({ { 5, 6 } }), stack->GetPixel({ { 5, 6, 0 } }));
+
+  // Tile sizes must be multiples of 16.
+  auto tiffIO = itk::TIFFImageIO::New();
+  ITK_TEST_SET_GET_VALUE(0u, tiffIO->GetTileWidth());
+  tiffIO->SetTileWidth(20);
+  tiffIO->SetTileHeight(16);
+  ITK_TEST_SET_GET_VALUE(20u, tiffIO->GetTileWidth());
+  ITK_TEST_SET_GET_VALUE(16u, tiffIO->GetTileHeight());
+  auto writer = itk::ImageFileWriter<RGBImageType>::New();
+  writer->SetInput(rgbImage);
+  writer->SetFileName(directory + "/itkTIFFImageIOStreamingInvalid.tif");
+  writer->SetImageIO(tiffIO);
+  ITK_TRY_EXPECT_EXCEPTION(writer->Update());
+
+  if (!success)
+  {
+    std::cout << "Test FAILED!" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
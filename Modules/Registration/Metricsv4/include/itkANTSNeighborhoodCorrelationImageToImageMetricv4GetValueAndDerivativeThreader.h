@@ -148,7 +148,10 @@ public:
 protected:
   ANTSNeighborhoodCorrelationImageToImageMetricv4GetValueAndDerivativeThreader()
     : m_ANTSAssociate(nullptr)
-  {}
+  {
+    // The points are processed over their neighborhoods, not through TransformAndEvaluateMovingPoint.
+    this->m_MapMovingPointsInBatches = false;
+  }
 
   /**
    * Dense threader and sparse threader invoke different in multi-threading. This class uses overloaded
@@ -179,13 +179,14 @@ CorrelationImageToImageMetricv4GetValueAndDerivativeThreader<
    * then we otherwise get when exceptions are caught in MultiThreaderBase. */
   try
   {
-    pointIsValid = this->m_CorrelationAssociate->TransformAndEvaluateFixedPoint(
-      virtualPoint, mappedFixedPoint, mappedFixedPixelValue);
-    if (pointIsValid && this->m_CorrelationAssociate->GetComputeDerivative() &&
-        this->m_CorrelationAssociate->GetGradientSourceIncludesFixed())
-    {
-      this->m_CorrelationAssociate->ComputeFixedImageGradientAtPoint(mappedFixedPoint, mappedFixedImageGradient);
-    }
+    pointIsValid = this->TransformAndEvaluateFixedPoint(
+      virtualPoint,
+      mappedFixedPoint,
+      mappedFixedPixelValue,
+      mappedFixedImageGradient,
+      this->m_CorrelationAssociate->GetComputeDerivative() &&
+        this->m_CorrelationAssociate->GetGradientSourceIncludesFixed(),
+      threadId);
   }
   catch (const ExceptionObject & exc)
   {
@@ -205,13 +206,14 @@ CorrelationImageToImageMetricv4GetValueAndDerivativeThreader<
   MovingImageGradientType mappedMovingImageGradient;
   try
   {
-    pointIsValid = this->m_CorrelationAssociate->TransformAndEvaluateMovingPoint(
-      virtualPoint, mappedMovingPoint, mappedMovingPixelValue);
-    if (pointIsValid && this->m_CorrelationAssociate->GetComputeDerivative() &&
-        this->m_CorrelationAssociate->GetGradientSourceIncludesMoving())
-    {
-      this->m_CorrelationAssociate->ComputeMovingImageGradientAtPoint(mappedMovingPoint, mappedMovingImageGradient);
-    }
+    pointIsValid = this->TransformAndEvaluateMovingPoint(
+      virtualPoint,
+      mappedMovingPoint,
+      mappedMovingPixelValue,
+      mappedMovingImageGradient,
+      this->m_CorrelationAssociate->GetComputeDerivative() &&
+        this->m_CorrelationAssociate->GetGradientSourceIncludesMoving(),
+      threadId);
   }
   catch (const ExceptionObject & exc)
   {
@@ -28,7 +28,10 @@ CorrelationImageToImageMetricv4HelperThreader<TDomainPartitioner, TImageToImageM
   CorrelationImageToImageMetricv4HelperThreader()
   : m_CorrelationMetricPerThreadVariables(nullptr)
   , m_CorrelationAssociate(nullptr)
-{}
+{
+  // The averages need only the fixed and moving values.
+  this->m_ComputeFixedGradientsInBatches = false;
+}
 
 
 template <typename TDomainPartitioner, typename TImageToImageMetric, typename TCorrelationMetric>
@@ -98,11 +101,13 @@ CorrelationImageToImageMetricv4HelperThreader<TDomainPartitioner, TImageToImageM
                       const VirtualPointType & virtualPoint,
                       const ThreadIdType       threadId)
 {
-  FixedImagePointType  mappedFixedPoint;
-  FixedImagePixelType  mappedFixedPixelValue;
-  MovingImagePointType mappedMovingPoint;
-  MovingImagePixelType mappedMovingPixelValue;
-  bool                 pointIsValid = false;
+  FixedImagePointType     mappedFixedPoint;
+  FixedImagePixelType     mappedFixedPixelValue;
+  FixedImageGradientType  mappedFixedImageGradient;
+  MovingImagePointType    mappedMovingPoint;
+  MovingImagePixelType    mappedMovingPixelValue;
+  MovingImageGradientType mappedMovingImageGradient;
+  bool                    pointIsValid = false;
 
   /* Transform the point into fixed and moving spaces, and evaluate.
    * Different behavior with pre-warping enabled is handled transparently.
@@ -110,8 +115,8 @@ CorrelationImageToImageMetricv4HelperThreader<TDomainPartitioner, TImageToImageM
    * then we otherwise get when exceptions are caught in MultiThreaderBase. */
   try
   {
-    pointIsValid = this->m_CorrelationAssociate->TransformAndEvaluateFixedPoint(
-      virtualPoint, mappedFixedPoint, mappedFixedPixelValue);
+    pointIsValid = this->TransformAndEvaluateFixedPoint(
+      virtualPoint, mappedFixedPoint, mappedFixedPixelValue, mappedFixedImageGradient, false, threadId);
   }
   catch (const ExceptionObject & exc)
   {
@@ -128,8 +133,8 @@ CorrelationImageToImageMetricv4HelperThreader<TDomainPartitioner, TImageToImageM
 
   try
   {
-    pointIsValid = this->m_CorrelationAssociate->TransformAndEvaluateMovingPoint(
-      virtualPoint, mappedMovingPoint, mappedMovingPixelValue);
+    pointIsValid = this->TransformAndEvaluateMovingPoint(
+      virtualPoint, mappedMovingPoint, mappedMovingPixelValue, mappedMovingImageGradient, false, threadId);
   }
   catch (const ExceptionObject & exc)
   {
@@ -32,6 +32,8 @@
 #include "itkDefaultConvertPixelTraits.h"
 #include "itkDefaultImageToImageMetricTraitsv4.h"
 
+#include <vector>
+
 namespace itk
 {
 /** \class ImageToImageMetricv4
@@ -462,6 +464,34 @@ public:
   itkGetConstReferenceMacro(UseVirtualSampledPointSet, bool);
   itkBooleanMacro(UseVirtualSampledPointSet);
 
+  /** Type of the per-point weights of the virtual sampled point set. */
+  using SampledPointSetWeightsType = Array<InternalComputationValueType>;
+
+  /** Set/Get per-point weights of the virtual sampled point set, indexed by
+   * point identifier, e.g. the inverse selection probabilities of an
+   * importance sampling. The value and derivative of each point are scaled
+   * by its weight. An empty array, the default, weights all points equally.
+   * Metrics that accumulate their own per-point statistics instead of
+   * returning them from ProcessPoint ignore the weights, except
+   * MattesMutualInformationImageToImageMetricv4, which weights its
+   * histograms. */
+  itkSetMacro(SampledPointSetWeights, SampledPointSetWeightsType);
+  itkGetConstReferenceMacro(SampledPointSetWeights, SampledPointSetWeightsType);
+
+  /** Set/Get flag to cache the fixed domain samples of the sampled point
+   * set. When on, Initialize() maps each sampled point into the fixed
+   * domain once and stores the mapped point, the fixed image value and, if
+   * the gradient source includes the fixed image, the fixed image gradient,
+   * so that GetValue() and GetValueAndDerivative() only evaluate the moving
+   * image. The cache is rebuilt when the fixed image, fixed transform, fixed
+   * image mask, sampled point set or metric settings are modified; a fixed
+   * transform changed without updating its modification time, such as a
+   * component of a CompositeTransform, requires calling Initialize() again.
+   * Off by default. */
+  itkSetMacro(UseFixedSampledValueCache, bool);
+  itkGetConstReferenceMacro(UseFixedSampledValueCache, bool);
+  itkBooleanMacro(UseFixedSampledValueCache);
+
 #if !defined(ITK_LEGACY_REMOVE)
   /** UseFixedSampledPointSet is deprecated and has been replaced
    * with UseSampledPointsSet. */
@@ -694,6 +724,13 @@ protected:
                                   MovingImagePointType &   mappedMovingPoint,
                                   MovingImagePixelType &   mappedMovingPixelValue) const;
 
+  /** Evaluate the moving image at a point already mapped into the MovingImage
+   * domain, checking it against the mask and the image buffer as
+   * \c TransformAndEvaluateMovingPoint does. */
+  bool
+  EvaluateMovingPoint(const MovingImagePointType & mappedMovingPoint,
+                      MovingImagePixelType &       mappedMovingPixelValue) const;
+
   /** Compute image derivatives for a Fixed point. */
   virtual void
   ComputeFixedImageGradientAtPoint(const FixedImagePointType & mappedPoint, FixedImageGradientType & gradient) const;
@@ -792,6 +829,30 @@ protected:
   FixedSampledPointSet */
   bool m_UseVirtualSampledPointSet{};
 
+  /** Per-point weights of the virtual sampled point set. */
+  SampledPointSetWeightsType m_SampledPointSetWeights{};
+
+  /** Flag to cache the fixed domain samples of the sampled point set. */
+  bool m_UseFixedSampledValueCache{};
+
+  /** Fixed domain samples of the virtual sampled point set, indexed by point
+   * identifier and stored as one array per quantity. Gradients is empty when
+   * the gradient source does not include the fixed image. */
+  struct FixedSampledValueCacheType
+  {
+    std::vector<FixedImagePointType>    MappedPoints;
+    std::vector<FixedImagePixelType>    PixelValues;
+    std::vector<FixedImageGradientType> Gradients;
+    std::vector<uint8_t>                PointIsValid;
+  };
+  mutable FixedSampledValueCacheType m_FixedSampledValueCache{};
+  mutable TimeStamp                  m_FixedSampledValueCacheTime{};
+
+  /** Builds the fixed sampled value cache if it is in use and out of date,
+   * and releases it if it is not in use. */
+  void
+  UpdateFixedSampledValueCache(bool force = false) const;
+
   ImageToImageMetricv4();
   ~ImageToImageMetricv4() override = default;
 
@@ -143,6 +143,20 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputat
   {
     this->MapFixedSampledPointSetToVirtual();
   }
+  if (this->m_UseSampledPointSet && this->m_SampledPointSetWeights.Size() > 0)
+  {
+    if (!this->m_UseVirtualSampledPointSet)
+    {
+      itkExceptionMacro("Sampled point set weights require a virtual sampled point set.");
+    }
+    const SizeValueType numberOfPoints =
+      this->m_VirtualSampledPointSet ? this->m_VirtualSampledPointSet->GetNumberOfPoints() : 0;
+    if (this->m_SampledPointSetWeights.Size() != numberOfPoints)
+    {
+      itkExceptionMacro("There are " << this->m_SampledPointSetWeights.Size() << " sampled point set weights for "
+                                     << numberOfPoints << " sampled points.");
+    }
+  }
 
   /* Initialize interpolators. */
   itkDebugMacro("Initialize Interpolators");
@@ -185,6 +199,9 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputat
     itkDebugMacro("Initialize: ComputeMovingImageGradientFilterImage");
     this->ComputeMovingImageGradientFilterImage();
   }
+
+  /* Map the sampled points into the fixed domain once for all iterations. */
+  this->UpdateFixedSampledValueCache(true);
 }
 
 template <typename TFixedImage,
@@ -283,6 +300,8 @@ void
 ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType, TMetricTraits>::
   InitializeForIteration() const
 {
+  this->UpdateFixedSampledValueCache();
+
   if (this->m_ComputeDerivative)
   {
     /* This size always comes from the active transform */
@@ -348,9 +367,6 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputat
                                   MovingImagePointType &   mappedMovingPoint,
                                   MovingImagePixelType &   mappedMovingPixelValue) const
 {
-  bool pointIsValid = true;
-  mappedMovingPixelValue = MovingImagePixelType{};
-
   // map the point into moving space
 
   // Before transforming points, we should convert their types from the ImagePointType (aka Point<double, dim>)
@@ -364,6 +380,22 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputat
   localMappedMovingPoint = this->m_MovingTransform->TransformPoint(localVirtualPoint);
   mappedMovingPoint.CastFrom(localMappedMovingPoint);
 
+  return this->EvaluateMovingPoint(mappedMovingPoint, mappedMovingPixelValue);
+}
+
+template <typename TFixedImage,
+          typename TMovingImage,
+          typename TVirtualImage,
+          typename TInternalComputationValueType,
+          typename TMetricTraits>
+bool
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType, TMetricTraits>::
+  EvaluateMovingPoint(const MovingImagePointType & mappedMovingPoint,
+                      MovingImagePixelType &       mappedMovingPixelValue) const
+{
+  bool pointIsValid = true;
+  mappedMovingPixelValue = MovingImagePixelType{};
+
   // check against the mask if one is assigned
   if (this->m_MovingImageMask)
   {
@@ -649,6 +681,55 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputat
   return region.GetNumberOfPixels();
 }
 
+template <typename TFixedImage,
+          typename TMovingImage,
+          typename TVirtualImage,
+          typename TInternalComputationValueType,
+          typename TMetricTraits>
+void
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType, TMetricTraits>::
+  UpdateFixedSampledValueCache(bool force) const
+{
+  FixedSampledValueCacheType & cache = this->m_FixedSampledValueCache;
+  if (!this->m_UseFixedSampledValueCache || !this->m_UseSampledPointSet || this->m_VirtualSampledPointSet.IsNull())
+  {
+    if (!cache.PointIsValid.empty())
+    {
+      cache = FixedSampledValueCacheType{};
+    }
+    return;
+  }
+
+  const SizeValueType    numberOfPoints = this->m_VirtualSampledPointSet->GetNumberOfPoints();
+  const ModifiedTimeType cacheTime = this->m_FixedSampledValueCacheTime.GetMTime();
+  if (!force && cache.PointIsValid.size() == numberOfPoints && cacheTime > this->GetMTime() &&
+      cacheTime > this->m_FixedImage->GetMTime() && cacheTime > this->m_FixedTransform->GetMTime() &&
+      cacheTime > this->m_VirtualSampledPointSet->GetMTime() &&
+      (this->m_FixedImageMask.IsNull() || cacheTime > this->m_FixedImageMask->GetMTime()))
+  {
+    return;
+  }
+
+  const bool computeGradients = this->GetGradientSourceIncludesFixed();
+  cache.MappedPoints.resize(numberOfPoints);
+  cache.PixelValues.resize(numberOfPoints);
+  cache.Gradients.resize(computeGradients ? numberOfPoints : 0);
+  cache.PointIsValid.assign(numberOfPoints, 0);
+  for (SizeValueType i = 0; i < numberOfPoints; ++i)
+  {
+    const VirtualPointType & virtualPoint = this->m_VirtualSampledPointSet->GetPoint(i);
+    if (this->TransformAndEvaluateFixedPoint(virtualPoint, cache.MappedPoints[i], cache.PixelValues[i]))
+    {
+      if (computeGradients)
+      {
+        this->ComputeFixedImageGradientAtPoint(cache.MappedPoints[i], cache.Gradients[i]);
+      }
+      cache.PointIsValid[i] = 1;
+    }
+  }
+  this->m_FixedSampledValueCacheTime.Modified();
+}
+
 template <typename TFixedImage,
           typename TMovingImage,
           typename TVirtualImage,
@@ -666,6 +747,8 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputat
      << indent << "GetUseMovingImageGradientFilter: " << this->GetUseMovingImageGradientFilter() << std::endl
      << indent << "UseFloatingPointCorrection: " << this->GetUseFloatingPointCorrection() << std::endl
      << indent << "FloatingPointCorrectionResolution: " << this->GetFloatingPointCorrectionResolution() << std::endl;
+  os << indent << "NumberOfSampledPointSetWeights: " << this->m_SampledPointSetWeights.Size() << std::endl;
+  itkPrintSelfBooleanMacro(UseFixedSampledValueCache);
 
   itkPrintSelfObjectMacro(FixedImage);
   itkPrintSelfObjectMacro(MovingImage);
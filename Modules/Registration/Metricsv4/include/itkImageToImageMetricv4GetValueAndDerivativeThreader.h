@@ -87,6 +87,7 @@ public:
   using typename Superclass::FixedTransformType;
   using typename Superclass::FixedOutputPointType;
   using typename Superclass::MovingTransformType;
+  using typename Superclass::MovingInputPointType;
   using typename Superclass::MovingOutputPointType;
 
   using typename Superclass::MeasureType;
@@ -163,6 +164,7 @@ public:
   using typename Superclass::FixedTransformType;
   using typename Superclass::FixedOutputPointType;
   using typename Superclass::MovingTransformType;
+  using typename Superclass::MovingInputPointType;
   using typename Superclass::MovingOutputPointType;
 
   using typename Superclass::MeasureType;
@@ -19,6 +19,9 @@
 #define itkImageToImageMetricv4GetValueAndDerivativeThreader_hxx
 
 #include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageScanlineConstIterator.h"
+
+#include <algorithm>
 
 namespace itk
 {
@@ -30,14 +33,30 @@ ImageToImageMetricv4GetValueAndDerivativeThreader<
   TImageToImageMetricv4>::ThreadedExecution(const DomainType & imageSubRegion, const ThreadIdType threadId)
 {
   const typename VirtualImageType::ConstPointer virtualImage = this->m_Associate->GetVirtualImage();
-  using IteratorType = ImageRegionConstIteratorWithIndex<VirtualImageType>;
-  VirtualPointType virtualPoint;
-  for (IteratorType it(virtualImage, imageSubRegion); !it.IsAtEnd(); ++it)
+  auto &                                        perThread = this->m_GetValueAndDerivativePerThreadVariables[threadId];
+
+  // The points of each scanline are evaluated in the fixed domain, then those
+  // valid there are mapped into the moving domain together.
+  using IteratorType = ImageScanlineConstIterator<VirtualImageType>;
+  const SizeValueType           lineLength = imageSubRegion.GetSize(0);
+  std::vector<VirtualPointType> virtualPoints(lineLength);
+  for (IteratorType it(virtualImage, imageSubRegion); !it.IsAtEnd(); it.NextLine())
   {
-    const VirtualIndexType & virtualIndex = it.GetIndex();
-    virtualImage->TransformIndexToPhysicalPoint(virtualIndex, virtualPoint);
-    this->ProcessVirtualPoint(virtualIndex, virtualPoint, threadId);
+    VirtualIndexType virtualIndex = it.GetIndex();
+    for (SizeValueType i = 0; i < lineLength; ++i, ++virtualIndex[0])
+    {
+      virtualImage->TransformIndexToPhysicalPoint(virtualIndex, virtualPoints[i]);
+    }
+    this->PrepareVirtualPointBatch(virtualPoints.data(), lineLength, NumericTraits<SizeValueType>::max(), threadId);
+
+    virtualIndex = it.GetIndex();
+    for (SizeValueType i = 0; i < lineLength; ++i, ++virtualIndex[0])
+    {
+      perThread.BatchPointId = i;
+      this->ProcessVirtualPoint(virtualIndex, virtualPoints[i], threadId);
+    }
   }
+  perThread.BatchPointId = NumericTraits<SizeValueType>::max();
   // Finalize per thread actions
   this->m_Associate->FinalizeThread(threadId);
 }
@@ -53,12 +72,37 @@ ImageToImageMetricv4GetValueAndDerivativeThreader<ThreadedIndexedContainerPartit
   const ElementIdentifierType                   begin = indexSubRange[0];
   const ElementIdentifierType                   end = indexSubRange[1];
   const typename VirtualImageType::ConstPointer virtualImage = this->m_Associate->GetVirtualImage();
-  for (ElementIdentifierType i = begin; i <= end; ++i)
+  const auto &                                  sampleWeights = this->m_Associate->GetSampledPointSetWeights();
+  auto &                                        perThread = this->m_GetValueAndDerivativePerThreadVariables[threadId];
+
+  // The points are evaluated in the fixed domain, then mapped into the moving
+  // domain, in blocks.
+  constexpr ElementIdentifierType blockSize = 256;
+  std::vector<VirtualPointType>   virtualPoints(std::min<ElementIdentifierType>(blockSize, end - begin + 1));
+  for (ElementIdentifierType blockBegin = begin; blockBegin <= end; blockBegin += blockSize)
   {
-    const VirtualPointType & virtualPoint = virtualSampledPointSet->GetPoint(i);
-    const auto               virtualIndex = virtualImage->TransformPhysicalPointToIndex(virtualPoint);
-    this->ProcessVirtualPoint(virtualIndex, virtualPoint, threadId);
+    const ElementIdentifierType numberOfPoints = std::min<ElementIdentifierType>(blockSize, end - blockBegin + 1);
+    for (ElementIdentifierType j = 0; j < numberOfPoints; ++j)
+    {
+      virtualPoints[j] = virtualSampledPointSet->GetPoint(blockBegin + j);
+    }
+    this->PrepareVirtualPointBatch(virtualPoints.data(), numberOfPoints, blockBegin, threadId);
+
+    for (ElementIdentifierType j = 0; j < numberOfPoints; ++j)
+    {
+      const ElementIdentifierType i = blockBegin + j;
+      perThread.SampledPointId = i;
+      if (sampleWeights.Size() > 0)
+      {
+        perThread.SampleWeight = sampleWeights[i];
+      }
+      perThread.BatchPointId = j;
+      const VirtualPointType & virtualPoint = virtualPoints[j];
+      const auto               virtualIndex = virtualImage->TransformPhysicalPointToIndex(virtualPoint);
+      this->ProcessVirtualPoint(virtualIndex, virtualPoint, threadId);
+    }
   }
+  perThread.BatchPointId = NumericTraits<SizeValueType>::max();
   // Finalize per thread actions
   this->m_Associate->FinalizeThread(threadId);
 }
@@ -22,6 +22,7 @@
 #include "itkCompensatedSummation.h"
 
 #include <memory> // For unique_ptr.
+#include <vector>
 
 namespace itk
 {
@@ -77,6 +78,7 @@ public:
   using FixedTransformType = typename ImageToImageMetricv4Type::FixedTransformType;
   using FixedOutputPointType = typename FixedTransformType::OutputPointType;
   using MovingTransformType = typename ImageToImageMetricv4Type::MovingTransformType;
+  using MovingInputPointType = typename MovingTransformType::InputPointType;
   using MovingOutputPointType = typename MovingTransformType::OutputPointType;
 
   using MeasureType = typename ImageToImageMetricv4Type::MeasureType;
@@ -122,6 +124,49 @@ protected:
                       const VirtualPointType & virtualPoint,
                       const ThreadIdType       threadId);
 
+  /** Map the virtual point into the fixed domain and evaluate the fixed image
+   * there, along with its gradient if \c computeGradient. Reads the results
+   * from the fixed sampled value cache of the metric when the work unit is
+   * processing a cached sampled point, from the batch evaluated by
+   * \c PrepareVirtualPointBatch when it is processing a point of one, and
+   * otherwise calls \c TransformAndEvaluateFixedPoint and
+   * \c ComputeFixedImageGradientAtPoint of the metric. */
+  bool
+  TransformAndEvaluateFixedPoint(const VirtualPointType & virtualPoint,
+                                 FixedImagePointType &    mappedFixedPoint,
+                                 FixedImagePixelType &    mappedFixedPixelValue,
+                                 FixedImageGradientType & mappedFixedImageGradient,
+                                 bool                     computeGradient,
+                                 ThreadIdType             threadId) const;
+
+  /** Evaluate the fixed side of a batch of virtual points, then map the
+   * points that are valid in the fixed domain into the moving domain with a
+   * single call to \c TransformPoints of the moving transform, so points
+   * outside the fixed image or its mask never reach the moving transform.
+   * \c firstSampledPointId is the identifier of the first point when the
+   * points are consecutive sampled points, and out of range otherwise. The
+   * results stay valid until the next call for the same work unit, and are
+   * used for the point at index \c BatchPointId of the batch. Does nothing
+   * when \c m_MapMovingPointsInBatches is off. */
+  void
+  PrepareVirtualPointBatch(const VirtualPointType * virtualPoints,
+                           SizeValueType            numberOfPoints,
+                           SizeValueType            firstSampledPointId,
+                           ThreadIdType             threadId);
+
+  /** Map the virtual point into the moving domain and evaluate the moving
+   * image there, along with its gradient if \c computeGradient. Uses the
+   * point mapped by \c PrepareVirtualPointBatch when the work unit is
+   * processing a point of a batch, and otherwise calls
+   * \c TransformAndEvaluateMovingPoint of the metric. */
+  bool
+  TransformAndEvaluateMovingPoint(const VirtualPointType &  virtualPoint,
+                                  MovingImagePointType &    mappedMovingPoint,
+                                  MovingImagePixelType &    mappedMovingPixelValue,
+                                  MovingImageGradientType & mappedMovingImageGradient,
+                                  bool                      computeGradient,
+                                  ThreadIdType              threadId) const;
+
   /** Method to calculate the metric value and derivative
    * given a point, value and image derivative for both fixed and moving
    * spaces. The provided values have been calculated from \c virtualPoint,
@@ -182,6 +227,23 @@ protected:
     DerivativeType LocalDerivatives;
     /** Intermediary threaded metric value storage. */
     SizeValueType NumberOfValidPoints;
+    /** Weight of the sampled point being processed, one unless the metric
+     * has sampled point set weights. */
+    InternalComputationValueType SampleWeight;
+    /** Identifier of the sampled point being processed, used to look up the
+     * fixed sampled value cache of the metric. Out of range for dense sampling. */
+    SizeValueType SampledPointId;
+    /** Index of the point being processed in the batch prepared by
+     * \c PrepareVirtualPointBatch. Out of range when it is not part of one. */
+    SizeValueType BatchPointId;
+    /** Buffers of \c PrepareVirtualPointBatch. The fixed image gradients
+     * are empty when they were not computed. */
+    std::vector<uint8_t>                FixedPointIsValidBatch;
+    std::vector<FixedImagePointType>    MappedFixedPointBatch;
+    std::vector<FixedImagePixelType>    MappedFixedPixelValueBatch;
+    std::vector<FixedImageGradientType> MappedFixedImageGradientBatch;
+    std::vector<MovingInputPointType>   VirtualPointBatch;
+    std::vector<MovingOutputPointType>  MappedMovingPointBatch;
     /** Pre-allocated transform jacobian objects, for use as needed by derived
      * classes for efficiency. */
     JacobianType MovingTransformJacobian;
@@ -200,6 +262,16 @@ protected:
    *  These will only be set once threading has been started. */
   mutable NumberOfParametersType m_CachedNumberOfParameters{};
   mutable NumberOfParametersType m_CachedNumberOfLocalParameters{};
+
+  /** Whether the threaders map the virtual points into the moving domain in
+   * batches. Threaders that process the points without
+   * \c TransformAndEvaluateMovingPoint turn it off. */
+  bool m_MapMovingPointsInBatches{ true };
+
+  /** Whether \c PrepareVirtualPointBatch computes the fixed image gradients
+   * when the metric needs them. Threaders that never ask for the fixed image
+   * gradient turn it off. */
+  bool m_ComputeFixedGradientsInBatches{ true };
 };
 
 } // end namespace itk
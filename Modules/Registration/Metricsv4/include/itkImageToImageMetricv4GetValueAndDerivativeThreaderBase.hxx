@@ -92,6 +92,10 @@ ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner,
   for (ThreadIdType workUnit = 0; workUnit < numWorkUnitsUsed; ++workUnit)
   {
     this->m_GetValueAndDerivativePerThreadVariables[workUnit].NumberOfValidPoints = SizeValueType{};
+    this->m_GetValueAndDerivativePerThreadVariables[workUnit].SampleWeight =
+      NumericTraits<InternalComputationValueType>::OneValue();
+    this->m_GetValueAndDerivativePerThreadVariables[workUnit].SampledPointId = NumericTraits<SizeValueType>::max();
+    this->m_GetValueAndDerivativePerThreadVariables[workUnit].BatchPointId = NumericTraits<SizeValueType>::max();
     this->m_GetValueAndDerivativePerThreadVariables[workUnit].Measure = InternalComputationValueType{};
     if (this->m_Associate->GetComputeDerivative())
     {
@@ -171,6 +175,175 @@ ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner,
   }
 }
 
+template <typename TDomainPartitioner, typename TImageToImageMetricv4>
+bool
+ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner, TImageToImageMetricv4>::
+  TransformAndEvaluateFixedPoint(const VirtualPointType & virtualPoint,
+                                 FixedImagePointType &    mappedFixedPoint,
+                                 FixedImagePixelType &    mappedFixedPixelValue,
+                                 FixedImageGradientType & mappedFixedImageGradient,
+                                 const bool               computeGradient,
+                                 const ThreadIdType       threadId) const
+{
+  const auto &        perThread = this->m_GetValueAndDerivativePerThreadVariables[threadId];
+  const SizeValueType batchPointId = perThread.BatchPointId;
+  if (batchPointId < perThread.FixedPointIsValidBatch.size() &&
+      !(computeGradient && perThread.MappedFixedImageGradientBatch.empty()))
+  {
+    if (!perThread.FixedPointIsValidBatch[batchPointId])
+    {
+      return false;
+    }
+    mappedFixedPoint = perThread.MappedFixedPointBatch[batchPointId];
+    mappedFixedPixelValue = perThread.MappedFixedPixelValueBatch[batchPointId];
+    if (computeGradient)
+    {
+      mappedFixedImageGradient = perThread.MappedFixedImageGradientBatch[batchPointId];
+    }
+    return true;
+  }
+
+  const auto &        cache = this->m_Associate->m_FixedSampledValueCache;
+  const SizeValueType pointId = perThread.SampledPointId;
+  if (pointId < cache.PointIsValid.size() && !(computeGradient && cache.Gradients.empty()))
+  {
+    if (!cache.PointIsValid[pointId])
+    {
+      return false;
+    }
+    mappedFixedPoint = cache.MappedPoints[pointId];
+    mappedFixedPixelValue = cache.PixelValues[pointId];
+    if (computeGradient)
+    {
+      mappedFixedImageGradient = cache.Gradients[pointId];
+    }
+    return true;
+  }
+
+  const bool pointIsValid =
+    this->m_Associate->TransformAndEvaluateFixedPoint(virtualPoint, mappedFixedPoint, mappedFixedPixelValue);
+  if (pointIsValid && computeGradient)
+  {
+    this->m_Associate->ComputeFixedImageGradientAtPoint(mappedFixedPoint, mappedFixedImageGradient);
+  }
+  return pointIsValid;
+}
+
+template <typename TDomainPartitioner, typename TImageToImageMetricv4>
+void
+ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner, TImageToImageMetricv4>::
+  PrepareVirtualPointBatch(const VirtualPointType * virtualPoints,
+                           const SizeValueType      numberOfPoints,
+                           const SizeValueType      firstSampledPointId,
+                           const ThreadIdType       threadId)
+{
+  if (!this->m_MapMovingPointsInBatches)
+  {
+    return;
+  }
+
+  auto & perThread = this->m_GetValueAndDerivativePerThreadVariables[threadId];
+  perThread.BatchPointId = NumericTraits<SizeValueType>::max();
+
+  // Evaluate the fixed side first, as ProcessVirtualPoint would.
+  const bool computeGradient = this->m_ComputeFixedGradientsInBatches && this->m_Associate->GetComputeDerivative() &&
+                               this->m_Associate->GetGradientSourceIncludesFixed();
+  perThread.FixedPointIsValidBatch.resize(numberOfPoints);
+  perThread.MappedFixedPointBatch.resize(numberOfPoints);
+  perThread.MappedFixedPixelValueBatch.resize(numberOfPoints);
+  perThread.MappedFixedImageGradientBatch.resize(computeGradient ? numberOfPoints : 0);
+  perThread.VirtualPointBatch.resize(numberOfPoints);
+  const SizeValueType    sampledPointId = perThread.SampledPointId;
+  FixedImageGradientType unusedGradient;
+  SizeValueType          numberOfValidPoints = 0;
+  for (SizeValueType i = 0; i < numberOfPoints; ++i)
+  {
+    if (firstSampledPointId < NumericTraits<SizeValueType>::max())
+    {
+      perThread.SampledPointId = firstSampledPointId + i;
+    }
+    try
+    {
+      perThread.FixedPointIsValidBatch[i] =
+        this->TransformAndEvaluateFixedPoint(virtualPoints[i],
+                                             perThread.MappedFixedPointBatch[i],
+                                             perThread.MappedFixedPixelValueBatch[i],
+                                             computeGradient ? perThread.MappedFixedImageGradientBatch[i] : unusedGradient,
+                                             computeGradient,
+                                             threadId);
+    }
+    catch (const ExceptionObject & exc)
+    {
+      std::string msg("Caught exception: \n");
+      msg += exc.what();
+      ExceptionObject err(__FILE__, __LINE__, msg);
+      throw err;
+    }
+    if (perThread.FixedPointIsValidBatch[i])
+    {
+      // Same conversions as the TransformAndEvaluateMovingPoint of the metric.
+      perThread.VirtualPointBatch[numberOfValidPoints++].CastFrom(virtualPoints[i]);
+    }
+  }
+  perThread.SampledPointId = sampledPointId;
+
+  // Map only the points valid in the fixed domain, then spread them back to
+  // the indices of their batch, from the last one so none is overwritten.
+  perThread.MappedMovingPointBatch.resize(numberOfPoints);
+  if (numberOfValidPoints > 0)
+  {
+    try
+    {
+      this->m_Associate->m_MovingTransform->TransformPoints(
+        perThread.VirtualPointBatch.data(), perThread.MappedMovingPointBatch.data(), numberOfValidPoints);
+    }
+    catch (const ExceptionObject & exc)
+    {
+      std::string msg("Caught exception: \n");
+      msg += exc.what();
+      ExceptionObject err(__FILE__, __LINE__, msg);
+      throw err;
+    }
+  }
+  for (SizeValueType i = numberOfPoints; i > 0 && numberOfValidPoints > 0; --i)
+  {
+    if (perThread.FixedPointIsValidBatch[i - 1])
+    {
+      perThread.MappedMovingPointBatch[i - 1] = perThread.MappedMovingPointBatch[--numberOfValidPoints];
+    }
+  }
+}
+
+template <typename TDomainPartitioner, typename TImageToImageMetricv4>
+bool
+ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner, TImageToImageMetricv4>::
+  TransformAndEvaluateMovingPoint(const VirtualPointType &  virtualPoint,
+                                  MovingImagePointType &    mappedMovingPoint,
+                                  MovingImagePixelType &    mappedMovingPixelValue,
+                                  MovingImageGradientType & mappedMovingImageGradient,
+                                  const bool                computeGradient,
+                                  const ThreadIdType        threadId) const
+{
+  const auto &        perThread = this->m_GetValueAndDerivativePerThreadVariables[threadId];
+  const SizeValueType batchPointId = perThread.BatchPointId;
+  bool                pointIsValid = false;
+  if (batchPointId < perThread.MappedMovingPointBatch.size())
+  {
+    mappedMovingPoint.CastFrom(perThread.MappedMovingPointBatch[batchPointId]);
+    pointIsValid = this->m_Associate->EvaluateMovingPoint(mappedMovingPoint, mappedMovingPixelValue);
+  }
+  else
+  {
+    pointIsValid =
+      this->m_Associate->TransformAndEvaluateMovingPoint(virtualPoint, mappedMovingPoint, mappedMovingPixelValue);
+  }
+  if (pointIsValid && computeGradient)
+  {
+    this->m_Associate->ComputeMovingImageGradientAtPoint(mappedMovingPoint, mappedMovingImageGradient);
+  }
+  return pointIsValid;
+}
+
 template <typename TDomainPartitioner, typename TImageToImageMetricv4>
 bool
 ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner, TImageToImageMetricv4>::ProcessVirtualPoint(
@@ -192,13 +365,13 @@ ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner, TImage
    * then we otherwise get when exceptions are caught in MultiThreaderBase. */
   try
   {
-    pointIsValid =
-      this->m_Associate->TransformAndEvaluateFixedPoint(virtualPoint, mappedFixedPoint, mappedFixedPixelValue);
-    if (pointIsValid && this->m_Associate->GetComputeDerivative() &&
-        this->m_Associate->GetGradientSourceIncludesFixed())
-    {
-      this->m_Associate->ComputeFixedImageGradientAtPoint(mappedFixedPoint, mappedFixedImageGradient);
-    }
+    pointIsValid = this->TransformAndEvaluateFixedPoint(
+      virtualPoint,
+      mappedFixedPoint,
+      mappedFixedPixelValue,
+      mappedFixedImageGradient,
+      this->m_Associate->GetComputeDerivative() && this->m_Associate->GetGradientSourceIncludesFixed(),
+      threadId);
   }
   catch (const ExceptionObject & exc)
   {
@@ -215,13 +388,13 @@ ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner, TImage
 
   try
   {
-    pointIsValid =
-      this->m_Associate->TransformAndEvaluateMovingPoint(virtualPoint, mappedMovingPoint, mappedMovingPixelValue);
-    if (pointIsValid && this->m_Associate->GetComputeDerivative() &&
-        this->m_Associate->GetGradientSourceIncludesMoving())
-    {
-      this->m_Associate->ComputeMovingImageGradientAtPoint(mappedMovingPoint, mappedMovingImageGradient);
-    }
+    pointIsValid = this->TransformAndEvaluateMovingPoint(
+      virtualPoint,
+      mappedMovingPoint,
+      mappedMovingPixelValue,
+      mappedMovingImageGradient,
+      this->m_Associate->GetComputeDerivative() && this->m_Associate->GetGradientSourceIncludesMoving(),
+      threadId);
   }
   catch (const ExceptionObject & exc)
   {
@@ -261,6 +434,16 @@ ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner, TImage
   }
   if (pointIsValid)
   {
+    const InternalComputationValueType sampleWeight =
+      this->m_GetValueAndDerivativePerThreadVariables[threadId].SampleWeight;
+    if (sampleWeight != NumericTraits<InternalComputationValueType>::OneValue())
+    {
+      metricValueResult *= sampleWeight;
+      if (this->m_Associate->GetComputeDerivative())
+      {
+        this->m_GetValueAndDerivativePerThreadVariables[threadId].LocalDerivatives *= sampleWeight;
+      }
+    }
     this->m_GetValueAndDerivativePerThreadVariables[threadId].NumberOfValidPoints++;
     this->m_GetValueAndDerivativePerThreadVariables[threadId].Measure += metricValueResult;
     if (this->m_Associate->GetComputeDerivative())
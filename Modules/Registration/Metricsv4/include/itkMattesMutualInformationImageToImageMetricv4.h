@@ -65,10 +65,14 @@ namespace itk
  * \warning Local-support transforms are not yet supported. If used,
  * an exception is thrown during Initialize().
  *
- * \note The per-iteration post-processing code is not multi-threaded, but could be
- * readily be made so for a small performance gain.
- * See GetValueCommonAfterThreadedExecution(), GetValueAndDerivative()
- * and threader::AfterThreadedExecution().
+ * Each thread accumulates into its own joint PDF, fixed image marginal PDF
+ * and, for global-support transforms with few enough parameters, its own
+ * joint PDF derivatives, without locking. After threading these are reduced
+ * in parallel, one fixed image bin (one row of each histogram) per task.
+ * Transforms with too many parameters for per-thread joint PDF derivatives
+ * fall back to DerivativeBufferManager, which reduces buffered contributions
+ * into the shared joint PDF derivatives under a lock.
+ * See threader::AfterThreadedExecution().
  *
  * The algorithm and much of the code was copied from the previous
  * Mattes MI metric, i.e. itkMattesMutualInformationImageToImageMetric.
@@ -225,7 +229,8 @@ protected:
   using CubicBSplineDerivativeFunctionType = BSplineDerivativeKernelFunction<3, PDFValueType>;
 
   /** Post-processing code common to both GetValue
-   * and GetValueAndDerivative. */
+   * and GetValueAndDerivative, run once the per-thread
+   * histograms have been reduced into those of the first thread. */
   virtual void
   GetValueCommonAfterThreadedExecution();
 
@@ -347,6 +352,13 @@ protected:
     typename JointPDFDerivativesType::Pointer m_ParentJointPDFDerivatives;
   };
 
+  /** Per-thread joint PDF derivatives, laid out as m_JointPDFDerivatives.
+   * Used instead of m_ThreaderDerivativeManager when together they hold at
+   * most MaximumThreaderJointPDFDerivativesSize values. */
+  std::vector<std::vector<PDFValueType>> m_ThreaderJointPDFDerivatives{};
+  bool                                   m_UseThreaderJointPDFDerivatives{ false };
+  static constexpr SizeValueType         MaximumThreaderJointPDFDerivativesSize = SizeValueType{ 1 } << 24;
+
   std::vector<DerivativeBufferManager>      m_ThreaderDerivativeManager{};
   std::mutex                                m_JointPDFDerivativesLock{};
   typename JointPDFDerivativesType::Pointer m_JointPDFDerivatives{};
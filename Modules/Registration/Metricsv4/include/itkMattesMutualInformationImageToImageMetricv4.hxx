@@ -283,7 +283,7 @@ MattesMutualInformationImageToImageMetricv4<TFixedImage,
                                             TInternalComputationValueType,
                                             TMetricTraits>::FinalizeThread(const ThreadIdType threadId)
 {
-  if (this->GetComputeDerivative() && (!this->HasLocalSupport()))
+  if (this->GetComputeDerivative() && (!this->HasLocalSupport()) && !this->m_UseThreaderJointPDFDerivatives)
   {
     this->m_ThreaderDerivativeManager[threadId].BlockAndReduce();
   }
@@ -457,28 +457,10 @@ MattesMutualInformationImageToImageMetricv4<TFixedImage,
                                             TInternalComputationValueType,
                                             TMetricTraits>::GetValueCommonAfterThreadedExecution()
 {
-  const ThreadIdType localNumberOfWorkUnitsUsed = this->GetNumberOfWorkUnitsUsed();
+  const SizeValueType numberOfVoxels = this->m_NumberOfHistogramBins * this->m_NumberOfHistogramBins;
 
-  const SizeValueType       numberOfVoxels = this->m_NumberOfHistogramBins * this->m_NumberOfHistogramBins;
-  JointPDFValueType * const pdfPtrStart = this->m_ThreaderJointPDF[0]->GetBufferPointer();
-
-  for (unsigned int t = 1; t < localNumberOfWorkUnitsUsed; ++t)
-  {
-    JointPDFValueType *             pdfPtr = pdfPtrStart;
-    const JointPDFValueType *       tPdfPtr = this->m_ThreaderJointPDF[t]->GetBufferPointer();
-    const JointPDFValueType * const tPdfPtrEnd = tPdfPtr + numberOfVoxels;
-    while (tPdfPtr < tPdfPtrEnd)
-    {
-      *(pdfPtr++) += *(tPdfPtr++);
-    }
-    for (SizeValueType i = 0; i < this->m_NumberOfHistogramBins; ++i)
-    {
-      this->m_ThreaderFixedImageMarginalPDF[0][i] += this->m_ThreaderFixedImageMarginalPDF[t][i];
-    }
-  }
-
-  // Sum of this threads domain into the this->m_JointPDFSum that covers that part of the domain.
-  const JointPDFValueType *          pdfPtr = pdfPtrStart;
+  // Sum the reduced joint PDF into this->m_JointPDFSum.
+  const JointPDFValueType *          pdfPtr = this->m_ThreaderJointPDF[0]->GetBufferPointer();
   CompensatedSummation<PDFValueType> jointPDFSum;
   for (SizeValueType i = 0; i < numberOfVoxels; ++i)
   {
@@ -566,10 +548,9 @@ MattesMutualInformationImageToImageMetricv4<TFixedImage,
   m_MaxBufferSize = maxBufferLength;
   m_ParentJointPDFDerivativesMutexPtr = parentDerivativeMutexPtr;
   m_ParentJointPDFDerivatives = parentJointPDFDerivatives;
-  // Allocate and initialize to zero (note the () at the end of the new
-  // operator)
-  // the memory as a single block
-  m_MemoryBlock.resize(m_MemoryBlockSize, 0.0);
+  // Allocate and initialize to zero the memory as a single block;
+  // contributions are accumulated into the zeroed elements.
+  m_MemoryBlock.assign(m_MemoryBlockSize, 0.0);
   for (size_t index = 0; index < maxBufferLength; ++index)
   {
     this->m_BufferPDFValuesContainer[index] = &(this->m_MemoryBlock[0]) + index * m_CachedNumberOfLocalParameters;
@@ -58,21 +58,31 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader<
             this->m_MattesAssociate->m_MovingImageMarginalPDF.end(),
             PDFValueType{});
 
-  const ThreadIdType mattesAssociateNumWorkUnitsUsed = this->m_MattesAssociate->GetNumberOfWorkUnitsUsed();
-  const bool         reinitializeThreaderFixedImageMarginalPDF =
-    (this->m_MattesAssociate->m_ThreaderFixedImageMarginalPDF.size() != mattesAssociateNumWorkUnitsUsed);
+  // Per-thread histograms get a cache line of spare capacity, so that the
+  // elements one thread writes never share a cache line with another's.
+  const auto allocatePerThreadHistogram = [](std::vector<PDFValueType> & histogram, SizeValueType size) {
+    histogram = std::vector<PDFValueType>();
+    histogram.reserve(size + ITK_CACHE_LINE_ALIGNMENT / sizeof(PDFValueType));
+    histogram.assign(size, PDFValueType{});
+  };
 
-  if (reinitializeThreaderFixedImageMarginalPDF)
+  const ThreadIdType mattesAssociateNumWorkUnitsUsed = this->m_MattesAssociate->GetNumberOfWorkUnitsUsed();
+  auto &             threaderFixedImageMarginalPDF = this->m_MattesAssociate->m_ThreaderFixedImageMarginalPDF;
+  if (threaderFixedImageMarginalPDF.size() != mattesAssociateNumWorkUnitsUsed ||
+      threaderFixedImageMarginalPDF[0].size() != this->m_MattesAssociate->m_NumberOfHistogramBins)
   {
-    this->m_MattesAssociate->m_ThreaderFixedImageMarginalPDF.resize(
-      mattesAssociateNumWorkUnitsUsed,
-      std::vector<PDFValueType>(this->m_MattesAssociate->m_NumberOfHistogramBins, 0.0F));
+    threaderFixedImageMarginalPDF.resize(mattesAssociateNumWorkUnitsUsed);
+    for (auto & fixedImageMarginalPDF : threaderFixedImageMarginalPDF)
+    {
+      allocatePerThreadHistogram(fixedImageMarginalPDF, this->m_MattesAssociate->m_NumberOfHistogramBins);
+    }
   }
-  for (ThreadIdType workUnitID = 0; workUnitID < mattesAssociateNumWorkUnitsUsed; ++workUnitID)
+  else
   {
-    std::fill(this->m_MattesAssociate->m_ThreaderFixedImageMarginalPDF[workUnitID].begin(),
-              this->m_MattesAssociate->m_ThreaderFixedImageMarginalPDF[workUnitID].end(),
-              PDFValueType{});
+    for (auto & fixedImageMarginalPDF : threaderFixedImageMarginalPDF)
+    {
+      std::fill(fixedImageMarginalPDF.begin(), fixedImageMarginalPDF.end(), PDFValueType{});
+    }
   }
 
   const ThreadIdType localNumberOfWorkUnitsUsed = this->GetNumberOfWorkUnitsUsed();
@@ -127,6 +137,7 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader<
   //
   // Now allocate memory according to transform type
   //
+  this->m_MattesAssociate->m_UseThreaderJointPDFDerivatives = false;
   if (!this->m_MattesAssociate->GetComputeDerivative())
   {
     // We only need these if we're computing derivatives.
@@ -184,31 +195,70 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader<
       this->m_MattesAssociate->m_JointPDFDerivatives->SetRegions(jointPDFDerivativesRegion);
       this->m_MattesAssociate->m_JointPDFDerivatives->AllocateInitialized();
     }
+
+    // Prefer a private joint PDF derivatives per thread, which needs no
+    // locking, when they all fit in the memory budget.
+    const SizeValueType jointPDFDerivativesSize = jointPDFDerivativesRegion.GetNumberOfPixels();
+    auto &              threaderJointPDFDerivatives = this->m_MattesAssociate->m_ThreaderJointPDFDerivatives;
+    this->m_MattesAssociate->m_UseThreaderJointPDFDerivatives =
+      jointPDFDerivativesSize * localNumberOfWorkUnitsUsed <=
+      TMattesMutualInformationMetric::MaximumThreaderJointPDFDerivativesSize;
+    if (this->m_MattesAssociate->m_UseThreaderJointPDFDerivatives)
+    {
+      if (threaderJointPDFDerivatives.size() != localNumberOfWorkUnitsUsed ||
+          threaderJointPDFDerivatives[0].size() != jointPDFDerivativesSize)
+      {
+        threaderJointPDFDerivatives.resize(localNumberOfWorkUnitsUsed);
+        for (auto & jointPDFDerivatives : threaderJointPDFDerivatives)
+        {
+          allocatePerThreadHistogram(jointPDFDerivatives, jointPDFDerivativesSize);
+        }
+      }
+      else
+      {
+        // Each is as large as the whole joint PDF derivatives, so clear them in parallel.
+        this->GetMultiThreader()->ParallelizeArray(
+          0,
+          localNumberOfWorkUnitsUsed,
+          [&threaderJointPDFDerivatives](SizeValueType workUnitID) {
+            std::fill(threaderJointPDFDerivatives[workUnitID].begin(),
+                      threaderJointPDFDerivatives[workUnitID].end(),
+                      PDFValueType{});
+          },
+          nullptr);
+      }
+    }
     else
     {
+      threaderJointPDFDerivatives.clear();
+
       // Initialize to zero for accumulation
       this->m_MattesAssociate->m_JointPDFDerivatives->FillBuffer(0.0F);
+      if ((this->m_MattesAssociate->m_ThreaderDerivativeManager.size() != localNumberOfWorkUnitsUsed))
+      {
+        this->m_MattesAssociate->m_ThreaderDerivativeManager.resize(localNumberOfWorkUnitsUsed);
+      }
+      for (ThreadIdType workUnitID = 0; workUnitID < localNumberOfWorkUnitsUsed; ++workUnitID)
+      {
+        this->m_MattesAssociate->m_ThreaderDerivativeManager[workUnitID].Initialize(
+          // A heuristic that assumes memory for 2x size of
+          // m_JointPDFDerivative efficient and easy to make, so
+          // split it across all the threads.  A work unit of at least 400 is needed
+          // when the thread size approaches the number of histograms so that the
+          // there is enough work to be done between thread lockings.
+          std::max<size_t>(500,
+                           this->m_MattesAssociate->m_NumberOfHistogramBins *
+                             this->m_MattesAssociate->m_NumberOfHistogramBins / localNumberOfWorkUnitsUsed),
+          this->GetCachedNumberOfLocalParameters(),
+          // Need address of the lock
+          &this->m_MattesAssociate->m_JointPDFDerivativesLock,
+          this->m_MattesAssociate->m_JointPDFDerivatives);
+      }
     }
-    if ((this->m_MattesAssociate->m_ThreaderDerivativeManager.size() != localNumberOfWorkUnitsUsed))
-    {
-      this->m_MattesAssociate->m_ThreaderDerivativeManager.resize(localNumberOfWorkUnitsUsed);
-    }
-    for (ThreadIdType workUnitID = 0; workUnitID < localNumberOfWorkUnitsUsed; ++workUnitID)
-    {
-      this->m_MattesAssociate->m_ThreaderDerivativeManager[workUnitID].Initialize(
-        // A heuristic that assumes memory for 2x size of
-        // m_JointPDFDerivative efficient and easy to make, so
-        // split it across all the threads.  A work unit of at least 400 is needed
-        // when the thread size approaches the number of histograms so that the
-        // there is enough work to be done between thread lockings.
-        std::max<size_t>(500,
-                         this->m_MattesAssociate->m_NumberOfHistogramBins *
-                           this->m_MattesAssociate->m_NumberOfHistogramBins / localNumberOfWorkUnitsUsed),
-        this->GetCachedNumberOfLocalParameters(),
-        // Need address of the lock
-        &this->m_MattesAssociate->m_JointPDFDerivativesLock,
-        this->m_MattesAssociate->m_JointPDFDerivatives);
-    }
+  }
+  else
+  {
+    this->m_MattesAssociate->m_ThreaderJointPDFDerivatives.clear();
   }
 }
 
@@ -269,10 +319,14 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader<
   const OffsetValueType fixedImageParzenWindowIndex =
     this->m_MattesAssociate->ComputeSingleFixedImageParzenWindowIndex(fixedImageValue);
 
+  // Each contribution is scaled by the weight of the sample, which is one
+  // unless the metric has sampled point set weights.
+  const PDFValueType sampleWeight = this->m_GetValueAndDerivativePerThreadVariables[threadId].SampleWeight;
+
   // Since a zero-order BSpline (box car) kernel is used for
   // the fixed image marginal pdf, we need only increment the
-  // fixedImageParzenWindowIndex by value of 1.0.
-  this->m_MattesAssociate->m_ThreaderFixedImageMarginalPDF[threadId][fixedImageParzenWindowIndex] += 1;
+  // fixedImageParzenWindowIndex by the sample weight.
+  this->m_MattesAssociate->m_ThreaderFixedImageMarginalPDF[threadId][fixedImageParzenWindowIndex] += sampleWeight;
 
   /**
    * The region of support of the parzen window determines which bins
@@ -329,13 +383,13 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader<
   while (pdfMovingIndex <= pdfMovingIndexMax)
   {
     const auto val = CubicBSplineFunctionType::FastEvaluate(movingImageParzenWindowArg);
-    *(pdfPtr++) += val;
+    *(pdfPtr++) += sampleWeight * val;
 
     if (doComputeDerivative)
     {
       // Compute the cubicBSplineDerivative for later repeated use.
       const PDFValueType cubicBSplineDerivativeValue =
-        CubicBSplineDerivativeFunctionType::FastEvaluate(movingImageParzenWindowArg);
+        sampleWeight * CubicBSplineDerivativeFunctionType::FastEvaluate(movingImageParzenWindowArg);
 
       if (transformIsDisplacement)
       {
@@ -356,8 +410,14 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader<
           (fixedImageParzenWindowIndex * this->m_MattesAssociate->m_JointPDFDerivatives->GetOffsetTable()[2]) +
           (pdfMovingIndex * this->m_MattesAssociate->m_JointPDFDerivatives->GetOffsetTable()[1]);
 
+        // Both the private joint PDF derivatives and fresh buffer elements
+        // start at zero, so the contribution is added either way.
+        const bool     useThreaderJointPDFDerivatives = this->m_MattesAssociate->m_UseThreaderJointPDFDerivatives;
         PDFValueType * derivativeContributionPtr =
-          this->m_MattesAssociate->m_ThreaderDerivativeManager[threadId].GetNextElementAndAddOffset(ThisIndexOffset);
+          useThreaderJointPDFDerivatives
+            ? this->m_MattesAssociate->m_ThreaderJointPDFDerivatives[threadId].data() + ThisIndexOffset
+            : this->m_MattesAssociate->m_ThreaderDerivativeManager[threadId].GetNextElementAndAddOffset(
+                ThisIndexOffset);
         for (NumberOfParametersType mu = 0, maxElement = this->GetCachedNumberOfLocalParameters(); mu < maxElement;
              ++mu)
         {
@@ -367,10 +427,13 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader<
             innerProduct += jacobian[dim][mu] * movingImageGradient[dim];
           }
 
-          *(derivativeContributionPtr) = innerProduct * cubicBSplineDerivativeValue;
+          *(derivativeContributionPtr) += innerProduct * cubicBSplineDerivativeValue;
           ++derivativeContributionPtr;
         }
-        this->m_MattesAssociate->m_ThreaderDerivativeManager[threadId].CheckAndReduceIfNecessary();
+        if (!useThreaderJointPDFDerivatives)
+        {
+          this->m_MattesAssociate->m_ThreaderDerivativeManager[threadId].CheckAndReduceIfNecessary();
+        }
       }
     }
 
@@ -428,35 +491,72 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader<
       this->m_GetValueAndDerivativePerThreadVariables[workUnitID].NumberOfValidPoints;
   }
 
+  /* Reduce the per-thread histograms into those of the first thread. Each
+   * task owns one fixed image bin, that is one row of the joint PDF and of
+   * the joint PDF derivatives, so the tasks need no synchronization. */
+  const SizeValueType numberOfHistogramBins = this->m_MattesAssociate->m_NumberOfHistogramBins;
+  const bool          reduceDerivatives =
+    this->m_MattesAssociate->GetComputeDerivative() && (!this->m_MattesAssociate->HasLocalSupport());
+  const bool useThreaderJointPDFDerivatives =
+    reduceDerivatives && this->m_MattesAssociate->m_UseThreaderJointPDFDerivatives;
+  const SizeValueType derivativesRowSize = this->GetCachedNumberOfLocalParameters() * numberOfHistogramBins;
+
+  // NOTE:  Negative 1 so that accumulators can all be positive accumulators
+  const PDFValueType nFactor =
+    reduceDerivatives
+      ? -1.0 / (this->m_MattesAssociate->m_MovingImageBinSize * this->m_MattesAssociate->GetNumberOfValidPoints())
+      : 0.0;
+
+  auto & threaderJointPDF = this->m_MattesAssociate->m_ThreaderJointPDF;
+  auto & threaderFixedImageMarginalPDF = this->m_MattesAssociate->m_ThreaderFixedImageMarginalPDF;
+  auto & threaderJointPDFDerivatives = this->m_MattesAssociate->m_ThreaderJointPDFDerivatives;
+  this->GetMultiThreader()->ParallelizeArray(
+    0,
+    numberOfHistogramBins,
+    [&](SizeValueType fixedIndex) {
+      JointPDFValueType * const pdfRow = threaderJointPDF[0]->GetBufferPointer() + fixedIndex * numberOfHistogramBins;
+      for (ThreadIdType workUnitID = 1; workUnitID < localNumberOfWorkUnitsUsed; ++workUnitID)
+      {
+        const JointPDFValueType * const workUnitPdfRow =
+          threaderJointPDF[workUnitID]->GetBufferPointer() + fixedIndex * numberOfHistogramBins;
+        for (SizeValueType movingIndex = 0; movingIndex < numberOfHistogramBins; ++movingIndex)
+        {
+          pdfRow[movingIndex] += workUnitPdfRow[movingIndex];
+        }
+        threaderFixedImageMarginalPDF[0][fixedIndex] += threaderFixedImageMarginalPDF[workUnitID][fixedIndex];
+      }
+
+      if (reduceDerivatives)
+      {
+        JointPDFDerivativesValueType * const derivativesRow =
+          this->m_MattesAssociate->m_JointPDFDerivatives->GetBufferPointer() + fixedIndex * derivativesRowSize;
+        if (useThreaderJointPDFDerivatives)
+        {
+          const PDFValueType * const firstRow = threaderJointPDFDerivatives[0].data() + fixedIndex * derivativesRowSize;
+          std::copy(firstRow, firstRow + derivativesRowSize, derivativesRow);
+          for (ThreadIdType workUnitID = 1; workUnitID < localNumberOfWorkUnitsUsed; ++workUnitID)
+          {
+            const PDFValueType * const workUnitRow =
+              threaderJointPDFDerivatives[workUnitID].data() + fixedIndex * derivativesRowSize;
+            for (SizeValueType i = 0; i < derivativesRowSize; ++i)
+            {
+              derivativesRow[i] += workUnitRow[i];
+            }
+          }
+        }
+        for (SizeValueType i = 0; i < derivativesRowSize; ++i)
+        {
+          derivativesRow[i] *= nFactor;
+        }
+      }
+    },
+    nullptr);
+
   /* Porting: This code is from
    * MattesMutualInformationImageToImageMetric::GetValueAndDerivativeThreadPostProcess */
   /* Post-processing that is common the GetValue and GetValueAndDerivative */
   this->m_MattesAssociate->GetValueCommonAfterThreadedExecution();
 
-  if (this->m_MattesAssociate->GetComputeDerivative() && (!this->m_MattesAssociate->HasLocalSupport()))
-  {
-    // This entire block of code is used to accumulate the per-thread buffers
-    // into 1 thread.
-    // For this thread, how many histogram elements are there?
-    const NumberOfParametersType rowSize =
-      this->GetCachedNumberOfLocalParameters() * this->m_MattesAssociate->m_NumberOfHistogramBins;
-    const SizeValueType histogramTotalElementsSize = rowSize * this->m_MattesAssociate->m_NumberOfHistogramBins;
-
-    // NOTE:  Negative 1 so that accumulators can all be positive accumulators
-    const PDFValueType nFactor =
-      -1.0 / (this->m_MattesAssociate->m_MovingImageBinSize * this->m_MattesAssociate->GetNumberOfValidPoints());
-
-    JointPDFDerivativesValueType * const accumulatorPdfDPtrStart =
-      this->m_MattesAssociate->m_JointPDFDerivatives->GetBufferPointer();
-    JointPDFDerivativesValueType *             accumulatorPdfDPtr = accumulatorPdfDPtrStart;
-    const JointPDFDerivativesValueType * const tempThreadPdfDPtrEnd =
-      accumulatorPdfDPtrStart + histogramTotalElementsSize;
-    while (accumulatorPdfDPtr < tempThreadPdfDPtrEnd)
-    {
-      *(accumulatorPdfDPtr++) *= nFactor;
-    }
-  }
-
   // Collect and compute results.
   // Value and derivative are stored in member vars.
   this->m_MattesAssociate->ComputeResults();
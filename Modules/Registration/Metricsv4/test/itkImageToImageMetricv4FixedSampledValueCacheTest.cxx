@@ -0,0 +1,205 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkCorrelationImageToImageMetricv4.h"
+#include "itkMattesMutualInformationImageToImageMetricv4.h"
+#include "itkMeanSquaresImageToImageMetricv4.h"
+#include "itkAffineTransform.h"
+#include "itkTranslationTransform.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTimeProbe.h"
+#include "itkTestingMacros.h"
+
+#include <cmath>
+
+/*
+ * Compares metrics evaluated over a sampled point set with and without the
+ * fixed sampled value cache, over several moving transforms and after the
+ * fixed transform changes, and reports the time per evaluation of each.
+ */
+
+namespace
+{
+constexpr unsigned int Dimension = 3;
+using ImageType = itk::Image<float, Dimension>;
+using PointSetType = itk::MeanSquaresImageToImageMetricv4<ImageType, ImageType>::VirtualPointSetType;
+using MovingTransformType = itk::AffineTransform<double, Dimension>;
+using FixedTransformType = itk::TranslationTransform<double, Dimension>;
+
+template <typename TMetric>
+bool
+CompareCachedToUncached(const char *                                               name,
+                        const ImageType *                                          fixedImage,
+                        const ImageType *                                          movingImage,
+                        PointSetType *                                             pointSet,
+                        const int                                                  numberOfReps,
+                        itk::ObjectToObjectMetricBaseTemplateEnums::GradientSource gradientSource)
+{
+  typename TMetric::Pointer    metrics[2];
+  MovingTransformType::Pointer movingTransforms[2];
+  FixedTransformType::Pointer  fixedTransforms[2];
+  double                       times[2];
+  for (unsigned int m = 0; m < 2; ++m)
+  {
+    movingTransforms[m] = MovingTransformType::New();
+    fixedTransforms[m] = FixedTransformType::New();
+    FixedTransformType::ParametersType offset(Dimension);
+    offset.Fill(0.25);
+    fixedTransforms[m]->SetParameters(offset);
+    metrics[m] = TMetric::New();
+    metrics[m]->SetFixedImage(fixedImage);
+    metrics[m]->SetMovingImage(movingImage);
+    metrics[m]->SetFixedTransform(fixedTransforms[m]);
+    metrics[m]->SetMovingTransform(movingTransforms[m]);
+    metrics[m]->SetVirtualDomainFromImage(fixedImage);
+    metrics[m]->SetVirtualSampledPointSet(pointSet);
+    metrics[m]->SetUseSampledPointSet(true);
+    metrics[m]->SetUseVirtualSampledPointSet(true);
+    metrics[m]->SetGradientSource(gradientSource);
+    metrics[m]->SetUseFixedSampledValueCache(m == 1);
+    metrics[m]->Initialize();
+  }
+
+  bool success = true;
+  for (unsigned int m = 0; m < 2; ++m)
+  {
+    itk::TimeProbe probe;
+    for (int r = 0; r < numberOfReps; ++r)
+    {
+      // Walk the moving transform the way an optimizer would.
+      auto parameters = movingTransforms[m]->GetParameters();
+      parameters[9] = 0.1 * r;
+      parameters[0] = 1.0 + 0.01 * r;
+      movingTransforms[m]->SetParameters(parameters);
+
+      typename TMetric::MeasureType    value{};
+      typename TMetric::DerivativeType derivative;
+      probe.Start();
+      metrics[m]->GetValueAndDerivative(value, derivative);
+      probe.Stop();
+      if (m == 1)
+      {
+        typename TMetric::MeasureType    expectedValue{};
+        typename TMetric::DerivativeType expectedDerivative;
+        movingTransforms[0]->SetParameters(parameters);
+        metrics[0]->GetValueAndDerivative(expectedValue, expectedDerivative);
+        if (itk::Math::NotAlmostEquals(value, expectedValue) ||
+            (derivative - expectedDerivative).magnitude() > 1e-12 * (1.0 + expectedDerivative.magnitude()))
+        {
+          std::cerr << name << ": cached value " << value << " derivative " << derivative << " differ from "
+                    << expectedValue << " " << expectedDerivative << std::endl;
+          success = false;
+        }
+      }
+    }
+    times[m] = probe.GetTotal() / numberOfReps;
+  }
+  std::cout << name << ": " << times[0] << " s uncached, " << times[1] << " s cached, speedup "
+            << times[0] / times[1] << std::endl;
+
+  // Changing the fixed transform rebuilds the cache.
+  FixedTransformType::ParametersType offset(Dimension);
+  offset.Fill(-0.5);
+  typename TMetric::MeasureType values[2];
+  for (unsigned int m = 0; m < 2; ++m)
+  {
+    fixedTransforms[m]->SetParameters(offset);
+    values[m] = metrics[m]->GetValue();
+  }
+  if (itk::Math::NotAlmostEquals(values[0], values[1]))
+  {
+    std::cerr << name << ": cached value " << values[1] << " after changing the fixed transform differs from "
+              << values[0] << std::endl;
+    success = false;
+  }
+  return success;
+}
+} // namespace
+
+int
+itkImageToImageMetricv4FixedSampledValueCacheTest(int argc, char * argv[])
+{
+  const int imageSize = (argc > 1) ? std::stoi(argv[1]) : 32;
+  const int numberOfReps = (argc > 2) ? std::stoi(argv[2]) : 5;
+
+  auto fixedImage = ImageType::New();
+  fixedImage->SetRegions(ImageType::SizeType::Filled(imageSize));
+  fixedImage->Allocate();
+  auto movingImage = ImageType::New();
+  movingImage->SetRegions(ImageType::SizeType::Filled(imageSize));
+  movingImage->Allocate();
+  const double center = 0.5 * imageSize;
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(fixedImage, fixedImage->GetBufferedRegion()); !it.IsAtEnd();
+       ++it)
+  {
+    const auto & index = it.GetIndex();
+    const double x = (index[0] - center) / imageSize;
+    const double y = (index[1] - center) / imageSize;
+    const double z = (index[2] - center) / imageSize;
+    it.Set(static_cast<float>(std::exp(-6.0 * (x * x + y * y + z * z)) + 0.2 * std::sin(9.0 * x * y)));
+    const double xm = x - 0.05;
+    movingImage->SetPixel(index, static_cast<float>(50.0 * std::exp(-6.0 * (xm * xm + y * y + z * z))));
+  }
+
+  // Every other voxel along each axis, moved off the grid.
+  auto               pointSet = PointSetType::New();
+  itk::SizeValueType pointId = 0;
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(fixedImage, fixedImage->GetBufferedRegion()); !it.IsAtEnd();
+       ++it)
+  {
+    const auto & index = it.GetIndex();
+    if (index[0] % 2 == 0 && index[1] % 2 == 0 && index[2] % 2 == 0)
+    {
+      PointSetType::PointType point;
+      fixedImage->TransformIndexToPhysicalPoint(index, point);
+      point[0] += 0.3;
+      point[1] -= 0.2;
+      pointSet->SetPoint(pointId++, point);
+    }
+  }
+
+  using GradientSourceEnum = itk::ObjectToObjectMetricBaseTemplateEnums::GradientSource;
+  using MeanSquaresMetricType = itk::MeanSquaresImageToImageMetricv4<ImageType, ImageType>;
+  using CorrelationMetricType = itk::CorrelationImageToImageMetricv4<ImageType, ImageType>;
+  using MattesMetricType = itk::MattesMutualInformationImageToImageMetricv4<ImageType, ImageType>;
+
+  bool success = true;
+  success &= CompareCachedToUncached<MeanSquaresMetricType>(
+    "MeanSquares", fixedImage, movingImage, pointSet, numberOfReps, GradientSourceEnum::GRADIENT_SOURCE_MOVING);
+  success &= CompareCachedToUncached<MeanSquaresMetricType>("MeanSquares, both gradients",
+                                                            fixedImage,
+                                                            movingImage,
+                                                            pointSet,
+                                                            numberOfReps,
+                                                            GradientSourceEnum::GRADIENT_SOURCE_BOTH);
+  success &= CompareCachedToUncached<CorrelationMetricType>(
+    "Correlation", fixedImage, movingImage, pointSet, numberOfReps, GradientSourceEnum::GRADIENT_SOURCE_MOVING);
+  success &= CompareCachedToUncached<MattesMetricType>("MattesMutualInformation",
+                                                       fixedImage,
+                                                       movingImage,
+                                                       pointSet,
+                                                       numberOfReps,
+                                                       GradientSourceEnum::GRADIENT_SOURCE_MOVING);
+
+  if (!success)
+  {
+    std::cout << "Test FAILED!" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
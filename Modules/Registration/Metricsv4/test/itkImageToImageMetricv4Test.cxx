@@ -18,6 +18,7 @@
 
 #define ITK_LEGACY_TEST
 #include "itkImageToImageMetricv4.h"
+#include "itkImageMaskSpatialObject.h"
 #include "itkTranslationTransform.h"
 #include "itkTestingMacros.h"
 #include "itkMath.h"
@@ -166,6 +167,43 @@ protected:
   }
 }; // Metric ///////////////////////////////////////////////////
 
+/** \class ImageToImageMetricv4TestMaskedTransform
+ * \brief Translation that throws for points outside the left half of the
+ * test images, to check that points masked out in the fixed domain are
+ * never mapped into the moving domain. */
+class ImageToImageMetricv4TestMaskedTransform : public itk::TranslationTransform<double, 2>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(ImageToImageMetricv4TestMaskedTransform);
+
+  using Self = ImageToImageMetricv4TestMaskedTransform;
+  using Superclass = itk::TranslationTransform<double, 2>;
+  using Pointer = itk::SmartPointer<Self>;
+  using ConstPointer = itk::SmartPointer<const Self>;
+
+  itkNewMacro(Self);
+
+  itkOverrideGetNameOfClassMacro(ImageToImageMetricv4TestMaskedTransform);
+
+  using typename Superclass::InputPointType;
+  using typename Superclass::OutputPointType;
+  using Superclass::TransformPoint;
+
+  OutputPointType
+  TransformPoint(const InputPointType & point) const override
+  {
+    if (point[0] >= 2.0)
+    {
+      itkExceptionMacro("Point " << point << " is masked out in the fixed domain.");
+    }
+    return Superclass::TransformPoint(point);
+  }
+
+protected:
+  ImageToImageMetricv4TestMaskedTransform() = default;
+  ~ImageToImageMetricv4TestMaskedTransform() override = default;
+};
+
 template <typename TVector>
 bool
 ImageToImageMetricv4TestTestArray(const TVector & v1, const TVector & v2)
@@ -686,6 +724,36 @@ itkImageToImageMetricv4Test(int, char ** const)
   constexpr itk::ThreadIdType thread = 0;
   metric->FinalizeThread(thread);
 
+  //
+  // Test that points outside the fixed mask never reach the moving transform
+  //
+  std::cout << "Testing with a fixed image mask:" << std::endl;
+  using MaskType = itk::ImageMaskSpatialObject<ImageToImageMetricv4TestImageDimensionality>;
+  auto maskImage = MaskType::ImageType::New();
+  maskImage->SetRegions(region);
+  maskImage->AllocateInitialized();
+  for (itk::ImageRegionIteratorWithIndex<MaskType::ImageType> itMask(maskImage, region); !itMask.IsAtEnd(); ++itMask)
+  {
+    itMask.Set(itMask.GetIndex()[0] < 2);
+  }
+  auto fixedMask = MaskType::New();
+  fixedMask->SetImage(maskImage);
+  fixedMask->Update();
+  metric->SetFixedImageMask(fixedMask);
+  metric->SetMovingTransform(ImageToImageMetricv4TestMaskedTransform::New());
+
+  for (bool useSampledPointSetWithMask : { true, false })
+  {
+    metric->SetUseSampledPointSet(useSampledPointSetWithMask);
+    if (ImageToImageMetricv4TestRunSingleTest(metric, truthValue, truthDerivative, imageSize * imageSize / 2, true) !=
+        EXIT_SUCCESS)
+    {
+      std::cerr << "Failed with a fixed image mask, use sampled point set: " << useSampledPointSetWithMask
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
 
   itk::Object::SetGlobalWarningDisplay(origGlobalWarningValue);
 
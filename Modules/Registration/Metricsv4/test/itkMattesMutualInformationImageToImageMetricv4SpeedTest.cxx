@@ -0,0 +1,247 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkMattesMutualInformationImageToImageMetricv4.h"
+#include "itkAffineTransform.h"
+#include "itkBSplineTransform.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMultiThreaderBase.h"
+#include "itkTimeProbe.h"
+#include "itkTestingMacros.h"
+
+#include <cmath>
+#include <vector>
+
+/*
+ * Times GetValueAndDerivative with an affine transform for an increasing
+ * number of work units, over the whole image and over a sampled point set,
+ * and checks that the results do not depend on the number of work units.
+ *
+ * Then checks a B-spline transform, whose joint PDF derivatives fit in the
+ * per-thread budget of the metric for one work unit but not for eight. The
+ * derivative accumulated per thread with one work unit must match the one
+ * accumulated sample by sample through DerivativeBufferManager with eight.
+ */
+
+int
+itkMattesMutualInformationImageToImageMetricv4SpeedTest(int argc, char * argv[])
+{
+  if (argc < 3)
+  {
+    std::cerr << "usage: " << itkNameOfTestExecutableMacro(argv) << ": image-dimension number-of-reps" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const int imageSize = std::stoi(argv[1]);
+  const int numberOfReps = std::stoi(argv[2]);
+
+  constexpr unsigned int imageDimensionality = 3;
+  using ImageType = itk::Image<float, imageDimensionality>;
+
+  auto fixedImage = ImageType::New();
+  fixedImage->SetRegions(ImageType::SizeType::Filled(imageSize));
+  fixedImage->Allocate();
+  auto movingImage = ImageType::New();
+  movingImage->SetRegions(ImageType::SizeType::Filled(imageSize));
+  movingImage->Allocate();
+
+  // Smooth blobs, with the moving image an intensity remapped, shifted copy.
+  const double center = 0.5 * imageSize;
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(fixedImage, fixedImage->GetBufferedRegion()); !it.IsAtEnd();
+       ++it)
+  {
+    const auto & index = it.GetIndex();
+    const double x = (index[0] - center) / imageSize;
+    const double y = (index[1] - center) / imageSize;
+    const double z = (index[2] - center) / imageSize;
+    const double value = std::exp(-8.0 * (x * x + y * y + z * z)) + 0.3 * std::sin(10.0 * x) * std::cos(7.0 * y);
+    it.Set(static_cast<float>(value));
+    ImageType::IndexType movingIndex = index;
+    movingIndex[0] = (index[0] + 2) % imageSize;
+    movingImage->SetPixel(movingIndex, static_cast<float>(100.0 - 40.0 * value));
+  }
+
+  using TransformType = itk::AffineTransform<double, imageDimensionality>;
+  using MetricType = itk::MattesMutualInformationImageToImageMetricv4<ImageType, ImageType>;
+
+  // Every third voxel along each axis.
+  auto sampledPointSet = MetricType::FixedSampledPointSetType::New();
+  {
+    itk::SizeValueType pointId = 0;
+    for (itk::ImageRegionIteratorWithIndex<ImageType> it(fixedImage, fixedImage->GetBufferedRegion()); !it.IsAtEnd();
+         ++it)
+    {
+      const auto & index = it.GetIndex();
+      if (index[0] % 3 == 0 && index[1] % 3 == 0 && index[2] % 3 == 0)
+      {
+        MetricType::FixedSampledPointSetType::PointType point;
+        fixedImage->TransformIndexToPhysicalPoint(index, point);
+        sampledPointSet->SetPoint(pointId++, point);
+      }
+    }
+  }
+
+  // 1, 2, 4, ... work units, up to the number of threads.
+  const itk::ThreadIdType        maximumNumberOfWorkUnits = itk::MultiThreaderBase::GetGlobalDefaultNumberOfThreads();
+  std::vector<itk::ThreadIdType> workUnitCounts;
+  for (itk::ThreadIdType numberOfWorkUnits = 1; numberOfWorkUnits < maximumNumberOfWorkUnits; numberOfWorkUnits *= 2)
+  {
+    workUnitCounts.push_back(numberOfWorkUnits);
+  }
+  workUnitCounts.push_back(maximumNumberOfWorkUnits);
+
+  bool success = true;
+  for (const bool useSampledPointSet : { false, true })
+  {
+    std::cout << (useSampledPointSet ? "Sampled point set" : "Dense") << ", " << imageSize << "^3 voxels, "
+              << numberOfReps << " reps" << std::endl;
+    std::cout << "work units\tseconds per call\tspeedup" << std::endl;
+
+    MetricType::MeasureType    referenceValue{};
+    MetricType::DerivativeType referenceDerivative;
+    double                     singleWorkUnitTime = 0.0;
+    for (const itk::ThreadIdType numberOfWorkUnits : workUnitCounts)
+    {
+      auto transform = TransformType::New();
+      auto metric = MetricType::New();
+      metric->SetFixedImage(fixedImage);
+      metric->SetMovingImage(movingImage);
+      metric->SetMovingTransform(transform);
+      metric->SetNumberOfHistogramBins(50);
+      metric->SetMaximumNumberOfWorkUnits(numberOfWorkUnits);
+      if (useSampledPointSet)
+      {
+        metric->SetFixedSampledPointSet(sampledPointSet);
+        metric->SetUseSampledPointSet(true);
+      }
+      metric->Initialize();
+
+      MetricType::MeasureType    value{};
+      MetricType::DerivativeType derivative;
+      metric->GetValueAndDerivative(value, derivative);
+
+      itk::TimeProbe probe;
+      for (int r = 0; r < numberOfReps; ++r)
+      {
+        probe.Start();
+        metric->GetValueAndDerivative(value, derivative);
+        probe.Stop();
+      }
+      const double time = probe.GetTotal() / numberOfReps;
+      if (numberOfWorkUnits == 1)
+      {
+        singleWorkUnitTime = time;
+        referenceValue = value;
+        referenceDerivative = derivative;
+      }
+      std::cout << metric->GetNumberOfWorkUnitsUsed() << "\t\t" << time << "\t\t" << singleWorkUnitTime / time
+                << std::endl;
+
+      // Only the order of the floating point sums depends on the work units.
+      constexpr double tolerance = 1e-8;
+      if (std::abs(value - referenceValue) > tolerance * std::abs(referenceValue))
+      {
+        std::cerr << "Value " << value << " with " << numberOfWorkUnits << " work units differs from "
+                  << referenceValue << std::endl;
+        success = false;
+      }
+      for (unsigned int i = 0; i < derivative.Size(); ++i)
+      {
+        if (std::abs(derivative[i] - referenceDerivative[i]) > tolerance * referenceDerivative.magnitude())
+        {
+          std::cerr << "Derivative[" << i << "] " << derivative[i] << " with " << numberOfWorkUnits
+                    << " work units differs from " << referenceDerivative[i] << std::endl;
+          success = false;
+        }
+      }
+    }
+  }
+
+  {
+    using BSplineTransformType = itk::BSplineTransform<double, imageDimensionality, 3>;
+    constexpr unsigned int numberOfHistogramBins = 50;
+
+    MetricType::DerivativeType bufferManagerDerivative;
+    MetricType::DerivativeType perThreadDerivative;
+    for (const itk::ThreadIdType numberOfWorkUnits : { 8, 1 })
+    {
+      auto transform = BSplineTransformType::New();
+      transform->SetTransformDomainOrigin(fixedImage->GetOrigin());
+      transform->SetTransformDomainDirection(fixedImage->GetDirection());
+      BSplineTransformType::PhysicalDimensionsType physicalDimensions;
+      for (unsigned int d = 0; d < imageDimensionality; ++d)
+      {
+        physicalDimensions[d] = fixedImage->GetSpacing()[d] * (imageSize - 1);
+      }
+      transform->SetTransformDomainPhysicalDimensions(physicalDimensions);
+      transform->SetTransformDomainMeshSize(BSplineTransformType::MeshSizeType::Filled(4));
+      transform->SetIdentity();
+
+      auto metric = MetricType::New();
+      metric->SetFixedImage(fixedImage);
+      metric->SetMovingImage(movingImage);
+      metric->SetMovingTransform(transform);
+      metric->SetNumberOfHistogramBins(numberOfHistogramBins);
+      metric->SetMaximumNumberOfWorkUnits(numberOfWorkUnits);
+      metric->SetFixedSampledPointSet(sampledPointSet);
+      metric->SetUseSampledPointSet(true);
+      metric->Initialize();
+
+      MetricType::MeasureType value{};
+      metric->GetValueAndDerivative(value, numberOfWorkUnits == 1 ? perThreadDerivative : bufferManagerDerivative);
+
+      // The per-thread budget of the metric is 2^24 joint PDF derivative values.
+      const itk::SizeValueType jointPDFDerivativesSize =
+        numberOfHistogramBins * numberOfHistogramBins * transform->GetNumberOfParameters();
+      const bool usesBufferManager =
+        jointPDFDerivativesSize * metric->GetNumberOfWorkUnitsUsed() > (itk::SizeValueType{ 1 } << 24);
+      std::cout << "B-spline, " << transform->GetNumberOfParameters() << " parameters, "
+                << metric->GetNumberOfWorkUnitsUsed() << " work units: value " << value << std::endl;
+      if (usesBufferManager != (numberOfWorkUnits != 1))
+      {
+        std::cerr << "The B-spline case with " << metric->GetNumberOfWorkUnitsUsed()
+                  << " work units does not exercise the intended accumulation" << std::endl;
+        success = false;
+      }
+    }
+
+    constexpr double tolerance = 1e-8;
+    for (unsigned int i = 0; i < perThreadDerivative.Size(); ++i)
+    {
+      if (std::abs(perThreadDerivative[i] - bufferManagerDerivative[i]) >
+          tolerance * bufferManagerDerivative.magnitude())
+      {
+        std::cerr << "B-spline derivative[" << i << "] " << perThreadDerivative[i]
+                  << " accumulated per thread differs from " << bufferManagerDerivative[i]
+                  << " accumulated through DerivativeBufferManager" << std::endl;
+        success = false;
+      }
+    }
+    if (bufferManagerDerivative.magnitude() == 0.0)
+    {
+      std::cerr << "The B-spline derivative is zero" << std::endl;
+      success = false;
+    }
+  }
+
+  if (!success)
+  {
+    std::cout << "Test FAILED!" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
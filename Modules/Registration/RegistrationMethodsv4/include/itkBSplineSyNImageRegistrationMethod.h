@@ -37,6 +37,12 @@ namespace itk
  * Output: The output is the updated transform which has been added to the
  * composite transform.
  *
+ * With UseInPlaceFieldUpdates on, the update fields are scaled, and composed
+ * with the total fields, in place. The B-spline fits of the update and total
+ * fields still allocate the fitted fields, so the memory saved is smaller than
+ * for SyNImageRegistrationMethod. MaximumNumberOfIterationsForTheInverseFields
+ * bounds the inversions of the total fields as it does there.
+ *
  * \author Nick Tustison
  * \author Brian Avants
  *
@@ -154,26 +154,41 @@ BSplineSyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, T
 
     // Add the update field to both displacement fields (from fixed/moving to middle image) and then smooth
 
-    using ComposerType = ComposeDisplacementFieldsImageFilter<DisplacementFieldType>;
+    DisplacementFieldPointer fixedToMiddleTotalField;
+    DisplacementFieldPointer movingToMiddleTotalField;
+    if (this->m_UseInPlaceFieldUpdates)
+    {
+      fixedToMiddleTotalField = this->m_FixedToMiddleTransform->GetModifiableDisplacementField();
+      this->ComposeDisplacementFieldsInPlace(fixedToMiddleSmoothUpdateField, fixedToMiddleTotalField);
 
-    auto fixedComposer = ComposerType::New();
-    fixedComposer->SetDisplacementField(fixedToMiddleSmoothUpdateField);
-    fixedComposer->SetWarpingField(this->m_FixedToMiddleTransform->GetDisplacementField());
-    fixedComposer->Update();
+      movingToMiddleTotalField = this->m_MovingToMiddleTransform->GetModifiableDisplacementField();
+      this->ComposeDisplacementFieldsInPlace(movingToMiddleSmoothUpdateField, movingToMiddleTotalField);
+    }
+    else
+    {
+      using ComposerType = ComposeDisplacementFieldsImageFilter<DisplacementFieldType>;
+
+      auto fixedComposer = ComposerType::New();
+      fixedComposer->SetDisplacementField(fixedToMiddleSmoothUpdateField);
+      fixedComposer->SetWarpingField(this->m_FixedToMiddleTransform->GetDisplacementField());
+      fixedComposer->Update();
+      fixedToMiddleTotalField = fixedComposer->GetOutput();
+
+      auto movingComposer = ComposerType::New();
+      movingComposer->SetDisplacementField(movingToMiddleSmoothUpdateField);
+      movingComposer->SetWarpingField(this->m_MovingToMiddleTransform->GetDisplacementField());
+      movingComposer->Update();
+      movingToMiddleTotalField = movingComposer->GetOutput();
+    }
 
     const DisplacementFieldPointer fixedToMiddleSmoothTotalFieldTmp =
-      this->BSplineSmoothDisplacementField(fixedComposer->GetOutput(),
+      this->BSplineSmoothDisplacementField(fixedToMiddleTotalField,
                                            this->m_FixedToMiddleTransform->GetNumberOfControlPointsForTheTotalField(),
                                            nullptr,
                                            nullptr);
 
-    auto movingComposer = ComposerType::New();
-    movingComposer->SetDisplacementField(movingToMiddleSmoothUpdateField);
-    movingComposer->SetWarpingField(this->m_MovingToMiddleTransform->GetDisplacementField());
-    movingComposer->Update();
-
     const DisplacementFieldPointer movingToMiddleSmoothTotalFieldTmp =
-      this->BSplineSmoothDisplacementField(movingComposer->GetOutput(),
+      this->BSplineSmoothDisplacementField(movingToMiddleTotalField,
                                            this->m_MovingToMiddleTransform->GetNumberOfControlPointsForTheTotalField(),
                                            nullptr,
                                            nullptr);
@@ -350,6 +365,12 @@ typename BSplineSyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTra
                                            nullptr);
   }
 
+  if (this->m_UseInPlaceFieldUpdates)
+  {
+    this->ScaleUpdateFieldInPlace(updateField);
+    return updateField;
+  }
+
   DisplacementFieldPointer scaledUpdateField = this->ScaleUpdateField(updateField);
 
   return scaledUpdateField;
@@ -368,18 +389,16 @@ typename BSplineSyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTra
                                    const WeightedMaskImageType * mask,
                                    const BSplinePointSetType *   gradientPointSet)
 {
-  using DuplicatorType = ImageDuplicator<DisplacementFieldType>;
-  auto duplicator = DuplicatorType::New();
-  duplicator->SetInputImage(field);
-  duplicator->Update();
-
-  DisplacementFieldPointer smoothField = duplicator->GetOutput();
-
   for (unsigned int d = 0; d < numberOfControlPoints.Size(); ++d)
   {
     if (numberOfControlPoints[d] <= 0)
     {
-      return smoothField;
+      // Without control points the field is returned unsmoothed, as a copy.
+      using DuplicatorType = ImageDuplicator<DisplacementFieldType>;
+      auto duplicator = DuplicatorType::New();
+      duplicator->SetInputImage(field);
+      duplicator->Update();
+      return duplicator->GetOutput();
     }
   }
 
@@ -406,7 +425,7 @@ typename BSplineSyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTra
   bspliner->SetEstimateInverse(false);
   bspliner->Update();
 
-  smoothField = bspliner->GetOutput();
+  DisplacementFieldPointer smoothField = bspliner->GetOutput();
 
   return smoothField;
 }
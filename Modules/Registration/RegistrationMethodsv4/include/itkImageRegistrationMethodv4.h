@@ -47,12 +47,25 @@ public:
    * \class MetricSamplingStrategy
    * \ingroup ITKRegistrationMethodsv4
    * \brief enum type for metric sampling strategy
+   *
+   * REGULAR takes every n-th voxel of the virtual domain and RANDOM a uniform
+   * random subset of its voxels. STRATIFIED divides the virtual domain into
+   * cells of about 1/percentage voxels and draws one uniformly distributed
+   * point in each cell, which covers the domain evenly without the aliasing
+   * of a regular grid. GRADIENTMAGNITUDE draws points with a probability
+   * that increases with the gradient magnitude of the fixed image, so that
+   * edges are sampled more densely, and passes the inverse probabilities to
+   * the metric as sample weights so that the metric stays unbiased. The
+   * gradient magnitude is evaluated once per cell of STRATIFIED, at its
+   * center, and the points are uniformly distributed within the drawn cells.
    */
   enum class MetricSamplingStrategy : uint8_t
   {
     NONE,
     REGULAR,
-    RANDOM
+    RANDOM,
+    STRATIFIED,
+    GRADIENTMAGNITUDE
   };
 };
 // Define how to print enumeration
@@ -218,6 +231,8 @@ public:
   static constexpr MetricSamplingStrategyEnum NONE = MetricSamplingStrategyEnum::NONE;
   static constexpr MetricSamplingStrategyEnum REGULAR = MetricSamplingStrategyEnum::REGULAR;
   static constexpr MetricSamplingStrategyEnum RANDOM = MetricSamplingStrategyEnum::RANDOM;
+  static constexpr MetricSamplingStrategyEnum STRATIFIED = MetricSamplingStrategyEnum::STRATIFIED;
+  static constexpr MetricSamplingStrategyEnum GRADIENTMAGNITUDE = MetricSamplingStrategyEnum::GRADIENTMAGNITUDE;
 #endif
 
 
@@ -303,7 +318,10 @@ public:
   itkSetObjectMacro(Metric, MetricType);
   itkGetModifiableObjectMacro(Metric, MetricType);
 
-  /** Set/Get the metric sampling strategy. */
+  /** Set/Get the metric sampling strategy. The samples are drawn once at the
+   * beginning of each level. GRADIENTMAGNITUDE requires a scalar fixed image
+   * and sets the sampled point set weights of the image metrics.
+   * \sa ImageRegistrationMethodv4Enums::MetricSamplingStrategy */
   itkSetEnumMacro(MetricSamplingStrategy, MetricSamplingStrategyEnum);
   itkGetEnumMacro(MetricSamplingStrategy, MetricSamplingStrategyEnum);
 
@@ -20,6 +20,7 @@
 
 
 #include "itkSmoothingRecursiveGaussianImageFilter.h"
+#include "itkCentralDifferenceImageFunction.h"
 #include "itkGradientDescentOptimizerv4.h"
 #include "itkImageRandomConstIteratorWithIndex.h"
 #include "itkImageRegionConstIteratorWithIndex.h"
@@ -29,6 +30,11 @@
 #include "itkMersenneTwisterRandomVariateGenerator.h"
 #include "itkRegistrationParameterScalesFromPhysicalShift.h"
 #include "itkPrintHelper.h"
+#include "itkIndexRange.h"
+
+#include <algorithm>
+#include <type_traits>
+#include <vector>
 
 namespace itk
 {
@@ -935,7 +941,12 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage,
 
   for (SizeValueType n = 0; n < numberOfLocalMetrics; ++n)
   {
+    ImageMetricType * metric =
+      multiMetric ? dynamic_cast<ImageMetricType *>(multiMetric->GetMetricQueue()[n].GetPointer())
+                  : dynamic_cast<ImageMetricType *>(this->m_Metric.GetPointer());
+
     auto samplePointSet = MetricSamplePointSetType::New();
+    typename ImageMetricType::SampledPointSetWeightsType sampleWeights;
 
     using SamplePointType = typename MetricSamplePointSetType::PointType;
 
@@ -1019,25 +1030,197 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage,
         }
         break;
       }
+      case MetricSamplingStrategyEnum::STRATIFIED:
+      {
+        // Cells of about 1 / percentage voxels, with one uniformly distributed point in each.
+        const double cellSize =
+          std::pow(1.0 / this->m_MetricSamplingPercentagePerLevel[this->m_CurrentLevel], 1.0 / ImageDimension);
+        const auto & regionIndex = virtualDomainRegion.GetIndex();
+        const auto & regionSize = virtualDomainRegion.GetSize();
+
+        typename VirtualDomainRegionType::SizeType numberOfCells;
+        for (unsigned int d = 0; d < ImageDimension; ++d)
+        {
+          numberOfCells[d] = static_cast<SizeValueType>(std::ceil(regionSize[d] / cellSize));
+        }
+        for (const auto & cell : ImageRegionIndexRange<ImageDimension>(VirtualDomainRegionType(numberOfCells)))
+        {
+          ContinuousIndex<typename SamplePointType::ValueType, ImageDimension> continuousIndex;
+          for (unsigned int d = 0; d < ImageDimension; ++d)
+          {
+            const double cellBegin = cell[d] * cellSize;
+            const double cellEnd = std::min((cell[d] + 1) * cellSize, static_cast<double>(regionSize[d]));
+            continuousIndex[d] =
+              regionIndex[d] - 0.5 + cellBegin + randomizer->GetUniformVariate(0.0, 1.0) * (cellEnd - cellBegin);
+          }
+          SamplePointType point;
+          virtualImage->TransformContinuousIndexToPhysicalPoint(continuousIndex, point);
+          if (!fixedMaskImage || fixedMaskImage->IsInsideInWorldSpace(point))
+          {
+            samplePointSet->SetPoint(index, point);
+            ++index;
+          }
+        }
+        break;
+      }
+      case MetricSamplingStrategyEnum::GRADIENTMAGNITUDE:
+      {
+        if constexpr (std::is_arithmetic_v<typename FixedImageType::PixelType>)
+        {
+          // The distribution is built over the cells of STRATIFIED, of about
+          // 1 / percentage voxels, from the gradient magnitude of the fixed
+          // image at their centers. It then takes about as much memory and
+          // time as the samples drawn from it.
+          const double cellSize =
+            std::pow(1.0 / this->m_MetricSamplingPercentagePerLevel[this->m_CurrentLevel], 1.0 / ImageDimension);
+          const auto & regionIndex = virtualDomainRegion.GetIndex();
+          const auto & regionSize = virtualDomainRegion.GetSize();
+
+          typename VirtualDomainRegionType::SizeType numberOfCells;
+          for (unsigned int d = 0; d < ImageDimension; ++d)
+          {
+            numberOfCells[d] = static_cast<SizeValueType>(std::ceil(regionSize[d] / cellSize));
+          }
+          const VirtualDomainRegionType cellRegion(numberOfCells);
+
+          // The bounds of a cell in voxels from the region index, and its volume in voxels.
+          const auto cellBounds = [cellSize, &regionSize](const auto & cell, double * begin, double * end) {
+            double volume = 1.0;
+            for (unsigned int d = 0; d < ImageDimension; ++d)
+            {
+              begin[d] = cell[d] * cellSize;
+              end[d] = std::min((cell[d] + 1) * cellSize, static_cast<double>(regionSize[d]));
+              volume *= end[d] - begin[d];
+            }
+            return volume;
+          };
+
+          using FixedPointType = typename ImageMetricType::FixedOutputPointType;
+          using GradientFunctionType =
+            CentralDifferenceImageFunction<FixedImageType, typename FixedPointType::ValueType>;
+          auto gradientFunction = GradientFunctionType::New();
+          gradientFunction->SetInputImage(metric->GetFixedImage());
+
+          // Gradient magnitude at each cell center, or -1 outside of the mask.
+          std::vector<double> cumulativeProbability(cellRegion.GetNumberOfPixels());
+          double              gradientMagnitudeSum = 0.0;
+          double              candidateVolume = 0.0;
+          SizeValueType       cellOffset = 0;
+          for (const auto & cell : ImageRegionIndexRange<ImageDimension>(cellRegion))
+          {
+            double       begin[ImageDimension];
+            double       end[ImageDimension];
+            const double volume = cellBounds(cell, begin, end);
+            ContinuousIndex<typename SamplePointType::ValueType, ImageDimension> continuousIndex;
+            for (unsigned int d = 0; d < ImageDimension; ++d)
+            {
+              continuousIndex[d] = regionIndex[d] - 0.5 + 0.5 * (begin[d] + end[d]);
+            }
+            SamplePointType point;
+            virtualImage->TransformContinuousIndexToPhysicalPoint(continuousIndex, point);
+            double value = -1.0;
+            if (!fixedMaskImage || fixedMaskImage->IsInsideInWorldSpace(point))
+            {
+              const FixedPointType fixedPoint = metric->GetFixedTransform()->TransformPoint(point);
+              value = gradientFunction->IsInsideBuffer(fixedPoint) ? gradientFunction->Evaluate(fixedPoint).GetNorm()
+                                                                   : 0.0;
+              gradientMagnitudeSum += volume * value;
+              candidateVolume += volume;
+            }
+            cumulativeProbability[cellOffset++] = value;
+          }
+          if (candidateVolume == 0.0)
+          {
+            itkExceptionMacro("The virtual domain has no voxels inside of the fixed image mask.");
+          }
+
+          // Mixing in the mean gradient magnitude bounds the weights of the flat regions,
+          // which are still sampled at half of the uniform rate or more. The
+          // probability of a cell is proportional to its volume, so that the
+          // partial cells at the border are not oversampled.
+          const double meanGradientMagnitude = gradientMagnitudeSum / candidateVolume;
+          const double offset = (meanGradientMagnitude > 0.0) ? meanGradientMagnitude : 1.0;
+          double       total = 0.0;
+          cellOffset = 0;
+          for (const auto & cell : ImageRegionIndexRange<ImageDimension>(cellRegion))
+          {
+            double       begin[ImageDimension];
+            double       end[ImageDimension];
+            const double volume = cellBounds(cell, begin, end);
+            double &     probability = cumulativeProbability[cellOffset++];
+            total += (probability < 0.0) ? 0.0 : volume * (probability + offset);
+            probability = total;
+          }
+
+          // Draw cells with replacement and a uniform point in each, weighting each
+          // point by its inverse selection density relative to uniform sampling so
+          // that the weights average one.
+          const auto sampleCount = static_cast<SizeValueType>(
+            static_cast<double>(virtualDomainRegion.GetNumberOfPixels()) *
+            this->m_MetricSamplingPercentagePerLevel[this->m_CurrentLevel]);
+          const SizeValueType numberOfCellsInRegion = cellRegion.GetNumberOfPixels();
+          std::vector<typename ImageMetricType::SampledPointSetWeightsType::ValueType> weights;
+          weights.reserve(sampleCount);
+          for (SizeValueType i = 0; i < sampleCount; ++i)
+          {
+            const auto selected = static_cast<SizeValueType>(
+              std::upper_bound(cumulativeProbability.cbegin(),
+                               cumulativeProbability.cend(),
+                               randomizer->GetUniformVariate(0.0, total)) -
+              cumulativeProbability.cbegin());
+            const SizeValueType selectedCell = std::min(selected, numberOfCellsInRegion - 1);
+            const double        probability = (selectedCell > 0) ? cumulativeProbability[selectedCell] -
+                                                                       cumulativeProbability[selectedCell - 1]
+                                                                 : cumulativeProbability[selectedCell];
+            if (probability <= 0.0)
+            {
+              continue;
+            }
+
+            typename VirtualDomainRegionType::IndexType cell;
+            SizeValueType                               offsetInCells = selectedCell;
+            for (unsigned int d = 0; d < ImageDimension; ++d)
+            {
+              cell[d] = static_cast<IndexValueType>(offsetInCells % numberOfCells[d]);
+              offsetInCells /= numberOfCells[d];
+            }
+            double       begin[ImageDimension];
+            double       end[ImageDimension];
+            const double volume = cellBounds(cell, begin, end);
+            ContinuousIndex<typename SamplePointType::ValueType, ImageDimension> continuousIndex;
+            for (unsigned int d = 0; d < ImageDimension; ++d)
+            {
+              continuousIndex[d] =
+                regionIndex[d] - 0.5 + begin[d] + randomizer->GetUniformVariate(0.0, 1.0) * (end[d] - begin[d]);
+            }
+            SamplePointType point;
+            virtualImage->TransformContinuousIndexToPhysicalPoint(continuousIndex, point);
+            if (!fixedMaskImage || fixedMaskImage->IsInsideInWorldSpace(point))
+            {
+              samplePointSet->SetPoint(index, point);
+              weights.push_back(total * volume / (candidateVolume * probability));
+              ++index;
+            }
+          }
+          sampleWeights.SetSize(static_cast<SizeValueType>(weights.size()));
+          std::copy(weights.cbegin(), weights.cend(), sampleWeights.begin());
+        }
+        else
+        {
+          itkExceptionMacro("Gradient magnitude sampling requires a scalar fixed image.");
+        }
+        break;
+      }
       default:
       {
         itkExceptionMacro("Invalid sampling strategy requested.");
       }
     }
 
-    if (multiMetric)
-    {
-      dynamic_cast<ImageMetricType *>(multiMetric->GetMetricQueue()[n].GetPointer())
-        ->SetVirtualSampledPointSet(samplePointSet);
-      dynamic_cast<ImageMetricType *>(multiMetric->GetMetricQueue()[n].GetPointer())->UseSampledPointSetOn();
-      dynamic_cast<ImageMetricType *>(multiMetric->GetMetricQueue()[n].GetPointer())->UseVirtualSampledPointSetOn();
-    }
-    else
-    {
-      dynamic_cast<ImageMetricType *>(this->m_Metric.GetPointer())->SetVirtualSampledPointSet(samplePointSet);
-      dynamic_cast<ImageMetricType *>(this->m_Metric.GetPointer())->UseSampledPointSetOn();
-      dynamic_cast<ImageMetricType *>(this->m_Metric.GetPointer())->UseVirtualSampledPointSetOn();
-    }
+    metric->SetVirtualSampledPointSet(samplePointSet);
+    metric->SetSampledPointSetWeights(sampleWeights);
+    metric->UseSampledPointSetOn();
+    metric->UseVirtualSampledPointSetOn();
   }
 }
 
@@ -46,6 +46,14 @@ namespace itk
  * The method evolved since that time with crucial contributions from Gang Song and
  * Nick Tustison. Though similar in spirit, this implementation is not identical.
  *
+ * The fields of the virtual domain dominate the memory use of the method.
+ * UseInPlaceFieldUpdates lets the smoothing, scaling and composition steps of
+ * each iteration overwrite the fields they act on, and an OutputTransformType
+ * of float precision, such as DisplacementFieldTransform<float, 3>, halves the
+ * memory of each field. The inversion of the total fields starts from the
+ * inverse of the previous iteration, and its number of iterations is bounded
+ * by MaximumNumberOfIterationsForTheInverseFields.
+ *
  * \todo Need to allow the fixed image to have a composite transform.
  *
  * \author Nick Tustison
@@ -175,6 +183,23 @@ public:
   itkSetMacro(GaussianSmoothingVarianceForTheTotalField, RealType);
   itkGetConstReferenceMacro(GaussianSmoothingVarianceForTheTotalField, RealType);
 
+  /** Update the fields in place. When on, the Gaussian smoothing and the
+   * scaling of the update fields, their composition with the total fields and
+   * the smoothing of the total fields overwrite the fields they act on, rather
+   * than allocating a new field at each step. The displacement fields of the
+   * FixedToMiddle and MovingToMiddle transforms are then modified in place.
+   * The results match those with the option off up to rounding. Default false.
+   */
+  itkSetMacro(UseInPlaceFieldUpdates, bool);
+  itkGetConstMacro(UseInPlaceFieldUpdates, bool);
+  itkBooleanMacro(UseInPlaceFieldUpdates);
+
+  /** Set/Get the maximum number of iterations of each inversion of the total
+   * fields. Each inversion starts from the inverse of the previous iteration,
+   * so that a few iterations usually reach the tolerances. Default 20. */
+  itkSetMacro(MaximumNumberOfIterationsForTheInverseFields, unsigned int);
+  itkGetConstMacro(MaximumNumberOfIterationsForTheInverseFields, unsigned int);
+
   /** Get modifiable FixedToMiddle and MovingToMiddle transforms to save the current state of the registration. */
   itkGetModifiableObjectMacro(FixedToMiddleTransform, OutputTransformType);
   itkGetModifiableObjectMacro(MovingToMiddleTransform, OutputTransformType);
@@ -234,6 +259,19 @@ protected:
   virtual DisplacementFieldPointer
   InvertDisplacementField(const DisplacementFieldType *, const DisplacementFieldType * = nullptr);
 
+  /** In place counterparts of ScaleUpdateField and
+   * GaussianSmoothDisplacementField, used when UseInPlaceFieldUpdates is on. */
+  virtual void
+  ScaleUpdateFieldInPlace(DisplacementFieldType *);
+  virtual void
+  GaussianSmoothDisplacementFieldInPlace(DisplacementFieldType *, const RealType);
+
+  /** Compose the update field with the field in place, as
+   * ComposeDisplacementFieldsImageFilter would, the field being the warping
+   * field. Used when UseInPlaceFieldUpdates is on. */
+  virtual void
+  ComposeDisplacementFieldsInPlace(const DisplacementFieldType * updateField, DisplacementFieldType * field);
+
   RealType m_LearningRate{ 0.25 };
 
   OutputTransformPointer m_MovingToMiddleTransform{ nullptr };
@@ -245,8 +283,23 @@ protected:
   NumberOfIterationsArrayType m_NumberOfIterationsPerLevel{};
   bool                        m_DownsampleImagesForMetricDerivatives{ true };
   bool                        m_AverageMidPointGradients{ false };
+  bool                        m_UseInPlaceFieldUpdates{ false };
+  unsigned int                m_MaximumNumberOfIterationsForTheInverseFields{ 20 };
 
 private:
+  /** The learning rate over the largest norm of the update field, in
+   * voxels. */
+  RealType
+  ComputeUpdateFieldScale(const DisplacementFieldType *);
+
+  /** Zero the field on the boundary of its largest possible region, and
+   * blend it with the unsmoothed field elsewhere when the variance is below
+   * 0.5. */
+  void
+  BlendSmoothedDisplacementField(DisplacementFieldType *       smoothField,
+                                 const DisplacementFieldType * field,
+                                 const RealType                variance);
+
   RealType m_GaussianSmoothingVarianceForTheUpdateField{ 3.0 };
   RealType m_GaussianSmoothingVarianceForTheTotalField{ 0.5 };
 };
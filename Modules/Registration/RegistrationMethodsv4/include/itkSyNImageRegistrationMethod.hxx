@@ -22,13 +22,18 @@
 #include "itkComposeDisplacementFieldsImageFilter.h"
 #include "itkGaussianOperator.h"
 #include "itkImageMaskSpatialObject.h"
+#include "itkImageLinearIteratorWithIndex.h"
+#include "itkImageScanlineIterator.h"
 #include "itkImportImageFilter.h"
 #include "itkInvertDisplacementFieldImageFilter.h"
 #include "itkIterationReporter.h"
 #include "itkMultiplyImageFilter.h"
+#include "itkVectorLinearInterpolateImageFunction.h"
 #include "itkVectorNeighborhoodOperatorImageFilter.h"
 #include "itkWindowConvergenceMonitoringFunction.h"
 
+#include <mutex>
+
 namespace itk
 {
 
@@ -148,6 +153,8 @@ SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtual
 
   IterationReporter reporter(this, 0, 1);
 
+  this->GetMultiThreader()->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+
   while (this->m_CurrentIteration++ < this->m_NumberOfIterationsPerLevel[this->m_CurrentLevel] && !this->m_IsConverged)
   {
     auto fixedComposite = CompositeTransformType::New();
@@ -193,34 +200,57 @@ SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtual
 
     if (this->m_AverageMidPointGradients)
     {
-      ImageRegionIteratorWithIndex<DisplacementFieldType> ItF(
-        fixedToMiddleSmoothUpdateField, fixedToMiddleSmoothUpdateField->GetLargestPossibleRegion());
-      for (ItF.GoToBegin(); !ItF.IsAtEnd(); ++ItF)
-      {
-        ItF.Set(ItF.Get() - movingToMiddleSmoothUpdateField->GetPixel(ItF.GetIndex()));
-        movingToMiddleSmoothUpdateField->SetPixel(ItF.GetIndex(), -ItF.Get());
-      }
+      this->GetMultiThreader()->template ParallelizeImageRegion<ImageDimension>(
+        fixedToMiddleSmoothUpdateField->GetLargestPossibleRegion(),
+        [&fixedToMiddleSmoothUpdateField,
+         &movingToMiddleSmoothUpdateField](const typename DisplacementFieldType::RegionType & region) {
+          ImageRegionIterator<DisplacementFieldType> ItF(fixedToMiddleSmoothUpdateField, region);
+          ImageRegionIterator<DisplacementFieldType> ItM(movingToMiddleSmoothUpdateField, region);
+          for (; !ItF.IsAtEnd(); ++ItF, ++ItM)
+          {
+            ItF.Set(ItF.Get() - ItM.Get());
+            ItM.Set(-ItF.Get());
+          }
+        },
+        nullptr);
     }
 
     // Add the update field to both displacement fields (from fixed/moving to middle image) and then smooth
 
-    using ComposerType = ComposeDisplacementFieldsImageFilter<DisplacementFieldType>;
+    DisplacementFieldPointer fixedToMiddleSmoothTotalFieldTmp;
+    DisplacementFieldPointer movingToMiddleSmoothTotalFieldTmp;
+    if (this->m_UseInPlaceFieldUpdates)
+    {
+      fixedToMiddleSmoothTotalFieldTmp = this->m_FixedToMiddleTransform->GetModifiableDisplacementField();
+      this->ComposeDisplacementFieldsInPlace(fixedToMiddleSmoothUpdateField, fixedToMiddleSmoothTotalFieldTmp);
+      this->GaussianSmoothDisplacementFieldInPlace(fixedToMiddleSmoothTotalFieldTmp,
+                                                   this->m_GaussianSmoothingVarianceForTheTotalField);
+
+      movingToMiddleSmoothTotalFieldTmp = this->m_MovingToMiddleTransform->GetModifiableDisplacementField();
+      this->ComposeDisplacementFieldsInPlace(movingToMiddleSmoothUpdateField, movingToMiddleSmoothTotalFieldTmp);
+      this->GaussianSmoothDisplacementFieldInPlace(movingToMiddleSmoothTotalFieldTmp,
+                                                   this->m_GaussianSmoothingVarianceForTheTotalField);
+    }
+    else
+    {
+      using ComposerType = ComposeDisplacementFieldsImageFilter<DisplacementFieldType>;
 
-    auto fixedComposer = ComposerType::New();
-    fixedComposer->SetDisplacementField(fixedToMiddleSmoothUpdateField);
-    fixedComposer->SetWarpingField(this->m_FixedToMiddleTransform->GetDisplacementField());
-    fixedComposer->Update();
+      auto fixedComposer = ComposerType::New();
+      fixedComposer->SetDisplacementField(fixedToMiddleSmoothUpdateField);
+      fixedComposer->SetWarpingField(this->m_FixedToMiddleTransform->GetDisplacementField());
+      fixedComposer->Update();
 
-    const DisplacementFieldPointer fixedToMiddleSmoothTotalFieldTmp = this->GaussianSmoothDisplacementField(
-      fixedComposer->GetOutput(), this->m_GaussianSmoothingVarianceForTheTotalField);
+      fixedToMiddleSmoothTotalFieldTmp = this->GaussianSmoothDisplacementField(
+        fixedComposer->GetOutput(), this->m_GaussianSmoothingVarianceForTheTotalField);
 
-    auto movingComposer = ComposerType::New();
-    movingComposer->SetDisplacementField(movingToMiddleSmoothUpdateField);
-    movingComposer->SetWarpingField(this->m_MovingToMiddleTransform->GetDisplacementField());
-    movingComposer->Update();
+      auto movingComposer = ComposerType::New();
+      movingComposer->SetDisplacementField(movingToMiddleSmoothUpdateField);
+      movingComposer->SetWarpingField(this->m_MovingToMiddleTransform->GetDisplacementField());
+      movingComposer->Update();
 
-    const DisplacementFieldPointer movingToMiddleSmoothTotalFieldTmp = this->GaussianSmoothDisplacementField(
-      movingComposer->GetOutput(), this->m_GaussianSmoothingVarianceForTheTotalField);
+      movingToMiddleSmoothTotalFieldTmp = this->GaussianSmoothDisplacementField(
+        movingComposer->GetOutput(), this->m_GaussianSmoothingVarianceForTheTotalField);
+    }
 
     // Iteratively estimate the inverse fields.
 
@@ -282,6 +312,14 @@ typename SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform,
                                                                                         movingImageMasks,
                                                                                         value);
 
+  if (this->m_UseInPlaceFieldUpdates)
+  {
+    this->GaussianSmoothDisplacementFieldInPlace(metricGradientField,
+                                                 this->m_GaussianSmoothingVarianceForTheUpdateField);
+    this->ScaleUpdateFieldInPlace(metricGradientField);
+    return metricGradientField;
+  }
+
   const DisplacementFieldPointer updateField =
     this->GaussianSmoothDisplacementField(metricGradientField, this->m_GaussianSmoothingVarianceForTheUpdateField);
 
@@ -290,6 +328,75 @@ typename SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform,
   return scaledUpdateField;
 }
 
+template <typename TFixedImage,
+          typename TMovingImage,
+          typename TOutputTransform,
+          typename TVirtualImage,
+          typename TPointSet>
+void
+SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtualImage, TPointSet>::
+  ScaleUpdateFieldInPlace(DisplacementFieldType * updateField)
+{
+  const RealType scale = this->ComputeUpdateFieldScale(updateField);
+
+  this->GetMultiThreader()->template ParallelizeImageRegion<ImageDimension>(
+    updateField->GetBufferedRegion(),
+    [updateField, scale](const typename DisplacementFieldType::RegionType & region) {
+      for (ImageRegionIterator<DisplacementFieldType> ItF(updateField, region); !ItF.IsAtEnd(); ++ItF)
+      {
+        ItF.Set(ItF.Get() * scale);
+      }
+    },
+    nullptr);
+  updateField->Modified();
+}
+
+template <typename TFixedImage,
+          typename TMovingImage,
+          typename TOutputTransform,
+          typename TVirtualImage,
+          typename TPointSet>
+auto
+SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtualImage, TPointSet>::
+  ComputeUpdateFieldScale(const DisplacementFieldType * updateField) -> RealType
+{
+  const typename DisplacementFieldType::SpacingType spacing = updateField->GetSpacing();
+
+  RealType   maxNorm = NumericTraits<RealType>::NonpositiveMin();
+  std::mutex maxNormMutex;
+  this->GetMultiThreader()->template ParallelizeImageRegion<ImageDimension>(
+    updateField->GetLargestPossibleRegion(),
+    [updateField, &spacing, &maxNorm, &maxNormMutex](const typename DisplacementFieldType::RegionType & region) {
+      RealType regionMaxNorm = NumericTraits<RealType>::NonpositiveMin();
+      for (ImageRegionConstIterator<DisplacementFieldType> ItF(updateField, region); !ItF.IsAtEnd(); ++ItF)
+      {
+        const DisplacementVectorType vector = ItF.Get();
+
+        RealType localNorm = 0;
+        for (SizeValueType d = 0; d < ImageDimension; ++d)
+        {
+          localNorm += itk::Math::sqr(vector[d] / spacing[d]);
+        }
+        localNorm = std::sqrt(localNorm);
+
+        if (localNorm > regionMaxNorm)
+        {
+          regionMaxNorm = localNorm;
+        }
+      }
+      const std::lock_guard<std::mutex> lock(maxNormMutex);
+      maxNorm = std::max(maxNorm, regionMaxNorm);
+    },
+    nullptr);
+
+  RealType scale = this->m_LearningRate;
+  if (maxNorm > RealType{})
+  {
+    scale /= maxNorm;
+  }
+  return scale;
+}
+
 template <typename TFixedImage,
           typename TMovingImage,
           typename TOutputTransform,
@@ -619,18 +726,24 @@ typename SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform,
   gradientField->SetRegions(virtualDomainImage->GetRequestedRegion());
   gradientField->Allocate();
 
-  SizeValueType count = 0;
-  for (ImageRegionIterator<DisplacementFieldType> ItG(gradientField, gradientField->GetRequestedRegion());
-       !ItG.IsAtEnd();
-       ++ItG)
-  {
-    DisplacementVectorType displacement;
-    for (SizeValueType d = 0; d < ImageDimension; ++d)
-    {
-      displacement[d] = metricDerivative[count++];
-    }
-    ItG.Set(displacement);
-  }
+  this->GetMultiThreader()->template ParallelizeImageRegion<ImageDimension>(
+    gradientField->GetBufferedRegion(),
+    [&gradientField, &metricDerivative](const typename DisplacementFieldType::RegionType & region) {
+      for (ImageScanlineIterator<DisplacementFieldType> ItG(gradientField, region); !ItG.IsAtEnd(); ItG.NextLine())
+      {
+        SizeValueType count = gradientField->ComputeOffset(ItG.GetIndex()) * ImageDimension;
+        for (; !ItG.IsAtEndOfLine(); ++ItG)
+        {
+          DisplacementVectorType displacement;
+          for (SizeValueType d = 0; d < ImageDimension; ++d)
+          {
+            displacement[d] = metricDerivative[count++];
+          }
+          ItG.Set(displacement);
+        }
+      }
+    },
+    nullptr);
 
   return gradientField;
 }
@@ -645,33 +758,7 @@ typename SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform,
   SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtualImage, TPointSet>::ScaleUpdateField(
     const DisplacementFieldType * updateField)
 {
-  typename DisplacementFieldType::SpacingType spacing = updateField->GetSpacing();
-
-  RealType maxNorm = NumericTraits<RealType>::NonpositiveMin();
-  for (ImageRegionConstIterator<DisplacementFieldType> ItF(updateField, updateField->GetLargestPossibleRegion());
-       !ItF.IsAtEnd();
-       ++ItF)
-  {
-    DisplacementVectorType vector = ItF.Get();
-
-    RealType localNorm = 0;
-    for (SizeValueType d = 0; d < ImageDimension; ++d)
-    {
-      localNorm += itk::Math::sqr(vector[d] / spacing[d]);
-    }
-    localNorm = std::sqrt(localNorm);
-
-    if (localNorm > maxNorm)
-    {
-      maxNorm = localNorm;
-    }
-  }
-
-  RealType scale = this->m_LearningRate;
-  if (maxNorm > RealType{})
-  {
-    scale /= maxNorm;
-  }
+  const RealType scale = this->ComputeUpdateFieldScale(updateField);
 
   using RealImageType = Image<RealType, ImageDimension>;
 
@@ -702,7 +789,7 @@ typename SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform,
   auto inverter = InverterType::New();
   inverter->SetInput(field);
   inverter->SetInverseFieldInitialEstimate(inverseFieldEstimate);
-  inverter->SetMaximumNumberOfIterations(20);
+  inverter->SetMaximumNumberOfIterations(this->m_MaximumNumberOfIterationsForTheInverseFields);
   inverter->SetMeanErrorToleranceThreshold(0.001);
   inverter->SetMaxErrorToleranceThreshold(0.1);
   inverter->Update();
@@ -769,6 +856,107 @@ typename SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform,
     smoothField->DisconnectPipeline();
   }
 
+  this->BlendSmoothedDisplacementField(smoothField, field, variance);
+
+  return smoothField;
+}
+
+template <typename TFixedImage,
+          typename TMovingImage,
+          typename TOutputTransform,
+          typename TVirtualImage,
+          typename TPointSet>
+void
+SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtualImage, TPointSet>::
+  GaussianSmoothDisplacementFieldInPlace(DisplacementFieldType * field, const RealType variance)
+{
+  if (variance <= 0.0)
+  {
+    return;
+  }
+
+  // Below a variance of 0.5 the smoothed field is blended with the original.
+  DisplacementFieldPointer unsmoothedField;
+  if (variance < 0.5)
+  {
+    using DuplicatorType = ImageDuplicator<DisplacementFieldType>;
+    auto duplicator = DuplicatorType::New();
+    duplicator->SetInputImage(field);
+    duplicator->Update();
+    unsmoothedField = duplicator->GetOutput();
+  }
+
+  using GaussianSmoothingOperatorType = GaussianOperator<RealType, ImageDimension>;
+
+  for (unsigned int d = 0; d < ImageDimension; ++d)
+  {
+    GaussianSmoothingOperatorType gaussianSmoothingOperator;
+    gaussianSmoothingOperator.SetDirection(d);
+    gaussianSmoothingOperator.SetVariance(variance);
+    gaussianSmoothingOperator.SetMaximumError(0.001);
+    gaussianSmoothingOperator.SetMaximumKernelWidth(field->GetRequestedRegion().GetSize()[d]);
+    gaussianSmoothingOperator.CreateDirectional();
+
+    const auto            radius = static_cast<SizeValueType>(gaussianSmoothingOperator.GetRadius(d));
+    std::vector<RealType> coefficients(gaussianSmoothingOperator.Begin(), gaussianSmoothingOperator.End());
+
+    // Each work unit smooths whole lines along d through a padded copy of the
+    // line, accumulating in the order of VectorNeighborhoodOperatorImageFilter
+    // and extending the line as ZeroFluxNeumannBoundaryCondition does.
+    this->GetMultiThreader()->template ParallelizeImageRegionRestrictDirection<ImageDimension>(
+      d,
+      field->GetBufferedRegion(),
+      [field, d, radius, &coefficients](const typename DisplacementFieldType::RegionType & region) {
+        const SizeValueType                 lineLength = region.GetSize(d);
+        std::vector<DisplacementVectorType> line(lineLength + 2 * radius);
+
+        ImageLinearIteratorWithIndex<DisplacementFieldType> ItF(field, region);
+        ItF.SetDirection(d);
+        for (ItF.GoToBegin(); !ItF.IsAtEnd(); ItF.NextLine())
+        {
+          for (SizeValueType i = radius; !ItF.IsAtEndOfLine(); ++ItF, ++i)
+          {
+            line[i] = ItF.Get();
+          }
+          for (SizeValueType i = 0; i < radius; ++i)
+          {
+            line[i] = line[radius];
+            line[radius + lineLength + i] = line[radius + lineLength - 1];
+          }
+
+          ItF.GoToBeginOfLine();
+          for (SizeValueType i = 0; !ItF.IsAtEndOfLine(); ++ItF, ++i)
+          {
+            DisplacementVectorType sum{};
+            for (SizeValueType k = 0; k < coefficients.size(); ++k)
+            {
+              for (unsigned int j = 0; j < ImageDimension; ++j)
+              {
+                sum[j] += coefficients[k] * line[i + k][j];
+              }
+            }
+            ItF.Set(sum);
+          }
+        }
+      },
+      nullptr);
+  }
+
+  this->BlendSmoothedDisplacementField(field, unsmoothedField, variance);
+  field->Modified();
+}
+
+template <typename TFixedImage,
+          typename TMovingImage,
+          typename TOutputTransform,
+          typename TVirtualImage,
+          typename TPointSet>
+void
+SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtualImage, TPointSet>::
+  BlendSmoothedDisplacementField(DisplacementFieldType *       smoothField,
+                                 const DisplacementFieldType * field,
+                                 const RealType                variance)
+{
   constexpr DisplacementVectorType zeroVector{};
 
   // make sure boundary does not move
@@ -779,35 +967,95 @@ typename SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform,
   }
   const RealType weight2 = 1.0 - weight1;
 
-  const typename DisplacementFieldType::RegionType region = field->GetLargestPossibleRegion();
-  const typename DisplacementFieldType::SizeType   size = region.GetSize();
-  const typename DisplacementFieldType::IndexType  startIndex = region.GetIndex();
+  const typename DisplacementFieldType::RegionType fullRegion = smoothField->GetLargestPossibleRegion();
+  const typename DisplacementFieldType::SizeType   size = fullRegion.GetSize();
+  const typename DisplacementFieldType::IndexType  startIndex = fullRegion.GetIndex();
 
-  ImageRegionConstIteratorWithIndex<DisplacementFieldType> ItF(field, field->GetLargestPossibleRegion());
-  ImageRegionIteratorWithIndex<DisplacementFieldType>      ItS(smoothField, smoothField->GetLargestPossibleRegion());
-  for (ItF.GoToBegin(), ItS.GoToBegin(); !ItF.IsAtEnd(); ++ItF, ++ItS)
-  {
-    typename DisplacementFieldType::IndexType index = ItF.GetIndex();
-    bool                                      isOnBoundary = false;
-    for (unsigned int d = 0; d < ImageDimension; ++d)
-    {
-      if (index[d] == startIndex[d] || index[d] == static_cast<IndexValueType>(size[d]) - startIndex[d] - 1)
+  this->GetMultiThreader()->template ParallelizeImageRegion<ImageDimension>(
+    fullRegion,
+    [smoothField, field, weight1, weight2, &size, &startIndex, &zeroVector](
+      const typename DisplacementFieldType::RegionType & region) {
+      ImageRegionIteratorWithIndex<DisplacementFieldType> ItS(smoothField, region);
+      for (ItS.GoToBegin(); !ItS.IsAtEnd(); ++ItS)
       {
-        isOnBoundary = true;
-        break;
+        typename DisplacementFieldType::IndexType index = ItS.GetIndex();
+        bool                                      isOnBoundary = false;
+        for (unsigned int d = 0; d < ImageDimension; ++d)
+        {
+          if (index[d] == startIndex[d] || index[d] == static_cast<IndexValueType>(size[d]) - startIndex[d] - 1)
+          {
+            isOnBoundary = true;
+            break;
+          }
+        }
+        if (isOnBoundary)
+        {
+          ItS.Set(zeroVector);
+        }
+        else if (weight2 > RealType{})
+        {
+          ItS.Set(ItS.Get() * weight1 + field->GetPixel(index) * weight2);
+        }
       }
-    }
-    if (isOnBoundary)
-    {
-      ItS.Set(zeroVector);
-    }
-    else
-    {
-      ItS.Set(ItS.Get() * weight1 + ItF.Get() * weight2);
-    }
-  }
+    },
+    nullptr);
+}
 
-  return smoothField;
+template <typename TFixedImage,
+          typename TMovingImage,
+          typename TOutputTransform,
+          typename TVirtualImage,
+          typename TPointSet>
+void
+SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtualImage, TPointSet>::
+  ComposeDisplacementFieldsInPlace(const DisplacementFieldType * updateField, DisplacementFieldType * field)
+{
+  using InterpolatorType = VectorLinearInterpolateImageFunction<DisplacementFieldType, RealType>;
+  using PointType = typename DisplacementFieldType::PointType;
+
+  auto interpolator = InterpolatorType::New();
+  interpolator->SetInputImage(updateField);
+
+  // Each displacement of the field depends only on itself and on the update
+  // field, so the field is overwritten as it is traversed.
+  this->GetMultiThreader()->template ParallelizeImageRegion<ImageDimension>(
+    field->GetBufferedRegion(),
+    [field, &interpolator](const typename DisplacementFieldType::RegionType & region) {
+      PointType pointIn1;
+      PointType pointIn2;
+      PointType pointIn3;
+
+      DisplacementVectorType outDisplacement;
+
+      for (ImageRegionIteratorWithIndex<DisplacementFieldType> ItF(field, region); !ItF.IsAtEnd(); ++ItF)
+      {
+        field->TransformIndexToPhysicalPoint(ItF.GetIndex(), pointIn1);
+
+        const DisplacementVectorType warpVector = ItF.Get();
+
+        for (unsigned int d = 0; d < ImageDimension; ++d)
+        {
+          pointIn2[d] = pointIn1[d] + warpVector[d];
+        }
+
+        typename InterpolatorType::OutputType displacement{};
+        if (interpolator->IsInsideBuffer(pointIn2))
+        {
+          displacement = interpolator->Evaluate(pointIn2);
+        }
+
+        for (unsigned int d = 0; d < ImageDimension; ++d)
+        {
+          pointIn3[d] = pointIn2[d] + displacement[d];
+        }
+
+        outDisplacement = pointIn3 - pointIn1;
+
+        ItF.Set(outDisplacement);
+      }
+    },
+    nullptr);
+  field->Modified();
 }
 
 template <typename TFixedImage,
@@ -877,6 +1125,9 @@ SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtual
   os << indent << "NumberOfIterationsPerLevel: " << this->m_NumberOfIterationsPerLevel << std::endl;
   os << indent << "DownsampleImagesForMetricDerivatives: " << m_DownsampleImagesForMetricDerivatives << std::endl;
   os << indent << "AverageMidPointGradients: " << m_AverageMidPointGradients << std::endl;
+  os << indent << "UseInPlaceFieldUpdates: " << m_UseInPlaceFieldUpdates << std::endl;
+  os << indent << "MaximumNumberOfIterationsForTheInverseFields: " << m_MaximumNumberOfIterationsForTheInverseFields
+     << std::endl;
   os << indent << "GaussianSmoothingVarianceForTheUpdateField: "
      << static_cast<typename NumericTraits<RealType>::PrintType>(this->m_GaussianSmoothingVarianceForTheUpdateField)
      << std::endl;
@@ -32,6 +32,10 @@ operator<<(std::ostream & out, const ImageRegistrationMethodv4Enums::MetricSampl
         return "itk::ImageRegistrationMethodv4Enums::MetricSamplingStrategy::REGULAR";
       case ImageRegistrationMethodv4Enums::MetricSamplingStrategy::RANDOM:
         return "itk::ImageRegistrationMethodv4Enums::MetricSamplingStrategy::RANDOM";
+      case ImageRegistrationMethodv4Enums::MetricSamplingStrategy::STRATIFIED:
+        return "itk::ImageRegistrationMethodv4Enums::MetricSamplingStrategy::STRATIFIED";
+      case ImageRegistrationMethodv4Enums::MetricSamplingStrategy::GRADIENTMAGNITUDE:
+        return "itk::ImageRegistrationMethodv4Enums::MetricSamplingStrategy::GRADIENTMAGNITUDE";
       default:
         return "INVALID VALUE FOR itk::ImageRegistrationMethodv4Enums::MetricSamplingStrategy";
     }
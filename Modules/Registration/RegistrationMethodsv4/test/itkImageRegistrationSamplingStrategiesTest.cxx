@@ -0,0 +1,175 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageRegistrationMethodv4.h"
+#include "itkGradientDescentOptimizerv4.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTranslationTransform.h"
+#include "itkTimeProbe.h"
+#include "itkTestingMacros.h"
+
+#include <cmath>
+
+/*
+ * Registers two shifted synthetic images with a translation using each
+ * metric sampling strategy at a few percent of the voxels, and checks the
+ * sampled point sets and weights handed to the metric.
+ */
+
+namespace
+{
+using ImageType = itk::Image<float, 2>;
+
+ImageType::Pointer
+MakeImage(const itk::SizeValueType size, const double shiftX, const double shiftY)
+{
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType::Filled(size));
+  image->Allocate();
+  const double center = 0.5 * size;
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    const double x = (it.GetIndex()[0] - center - shiftX) / size;
+    const double y = (it.GetIndex()[1] - center - shiftY) / size;
+    const double blob = std::exp(-12.0 * (x * x + 2.0 * y * y));
+    const double square = (std::abs(x + 0.2) < 0.1 && std::abs(y - 0.15) < 0.08) ? 0.5 : 0.0;
+    it.Set(static_cast<float>(100.0 * (blob + square)));
+  }
+  return image;
+}
+} // namespace
+
+int
+itkImageRegistrationSamplingStrategiesTest(int argc, char * argv[])
+{
+  const itk::SizeValueType imageSize = (argc > 1) ? static_cast<itk::SizeValueType>(std::stoi(argv[1])) : 96;
+  const double             samplingPercentage = (argc > 2) ? std::stod(argv[2]) : 0.03;
+
+  constexpr double shiftX = 3.5;
+  constexpr double shiftY = -2.5;
+  const auto       fixedImage = MakeImage(imageSize, 0.0, 0.0);
+  const auto       movingImage = MakeImage(imageSize, shiftX, shiftY);
+
+  using TransformType = itk::TranslationTransform<double, 2>;
+  using RegistrationType = itk::ImageRegistrationMethodv4<ImageType, ImageType, TransformType>;
+  using StrategyEnum = RegistrationType::MetricSamplingStrategyEnum;
+
+  const itk::SizeValueType numberOfVoxels = imageSize * imageSize;
+
+  bool success = true;
+  for (const StrategyEnum strategy : { StrategyEnum::NONE,
+                                       StrategyEnum::REGULAR,
+                                       StrategyEnum::RANDOM,
+                                       StrategyEnum::STRATIFIED,
+                                       StrategyEnum::GRADIENTMAGNITUDE })
+  {
+    auto registration = RegistrationType::New();
+    registration->SetFixedImage(fixedImage);
+    registration->SetMovingImage(movingImage);
+    registration->SetNumberOfLevels(1);
+    RegistrationType::ShrinkFactorsArrayType shrinkFactors(1);
+    shrinkFactors.Fill(1);
+    registration->SetShrinkFactorsPerLevel(shrinkFactors);
+    RegistrationType::SmoothingSigmasArrayType smoothingSigmas(1);
+    smoothingSigmas.Fill(0.0);
+    registration->SetSmoothingSigmasPerLevel(smoothingSigmas);
+    registration->SetMetricSamplingStrategy(strategy);
+    registration->SetMetricSamplingPercentage(samplingPercentage);
+    registration->MetricSamplingReinitializeSeed(121212);
+    auto * optimizer = dynamic_cast<itk::GradientDescentOptimizerv4 *>(registration->GetModifiableOptimizer());
+    ITK_TEST_EXPECT_TRUE(optimizer != nullptr);
+    optimizer->SetNumberOfIterations(100);
+
+    itk::TimeProbe probe;
+    probe.Start();
+    ITK_TRY_EXPECT_NO_EXCEPTION(registration->Update());
+    probe.Stop();
+
+    const auto   parameters = registration->GetTransform()->GetParameters();
+    const double error = std::hypot(parameters[0] - shiftX, parameters[1] - shiftY);
+    std::cout << strategy << ": translation " << parameters << ", error " << error << ", " << probe.GetTotal() << " s"
+              << std::endl;
+    if (error > 0.5)
+    {
+      std::cerr << "The translation is off by " << error << " with " << strategy << std::endl;
+      success = false;
+    }
+
+    if (strategy == StrategyEnum::NONE)
+    {
+      continue;
+    }
+    const auto * metric = dynamic_cast<const RegistrationType::ImageMetricType *>(registration->GetMetric());
+    const itk::SizeValueType numberOfPoints = metric->GetVirtualSampledPointSet()->GetNumberOfPoints();
+    const auto &             weights = metric->GetSampledPointSetWeights();
+    std::cout << "  " << numberOfPoints << " points, " << weights.Size() << " weights" << std::endl;
+    if (numberOfPoints < 0.8 * samplingPercentage * numberOfVoxels ||
+        numberOfPoints > 1.2 * samplingPercentage * numberOfVoxels + 4)
+    {
+      std::cerr << numberOfPoints << " points for " << samplingPercentage << " of " << numberOfVoxels << " voxels with "
+                << strategy << std::endl;
+      success = false;
+    }
+
+    if (strategy == StrategyEnum::GRADIENTMAGNITUDE)
+    {
+      // Edges are favored, and the weights undo it on average.
+      ITK_TEST_EXPECT_EQUAL(weights.Size(), numberOfPoints);
+      const double meanWeight = weights.mean();
+      std::cout << "  mean weight " << meanWeight << ", range [" << weights.min_value() << ", "
+                << weights.max_value() << "]" << std::endl;
+      if (std::abs(meanWeight - 1.0) > 0.25 || weights.max_value() > 2.0 || weights.min_value() >= 1.0)
+      {
+        std::cerr << "Unexpected gradient magnitude sampling weights" << std::endl;
+        success = false;
+      }
+    }
+    else
+    {
+      ITK_TEST_EXPECT_EQUAL(weights.Size(), 0);
+    }
+
+    if (strategy == StrategyEnum::STRATIFIED)
+    {
+      // Every quarter of the image gets its share of the points.
+      itk::SizeValueType pointsInQuadrant[4] = { 0, 0, 0, 0 };
+      for (itk::SizeValueType i = 0; i < numberOfPoints; ++i)
+      {
+        const auto & point = metric->GetVirtualSampledPointSet()->GetPoint(i);
+        const auto   half = 0.5 * (imageSize - 1);
+        ++pointsInQuadrant[(point[0] < half ? 0 : 1) + (point[1] < half ? 0 : 2)];
+      }
+      for (const auto count : pointsInQuadrant)
+      {
+        if (count < 0.2 * numberOfPoints || count > 0.3 * numberOfPoints)
+        {
+          std::cerr << count << " of " << numberOfPoints << " stratified points in a quadrant" << std::endl;
+          success = false;
+        }
+      }
+    }
+  }
+
+  if (!success)
+  {
+    std::cout << "Test FAILED!" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,309 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkSyNImageRegistrationMethod.h"
+#include "itkBSplineSyNImageRegistrationMethod.h"
+#include "itkBSplineSmoothingOnUpdateDisplacementFieldTransformParametersAdaptor.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMeanSquaresImageToImageMetricv4.h"
+#include "itkResampleImageFilter.h"
+#include "itkTimeProbe.h"
+#include "itkTestingMacros.h"
+
+#include <cmath>
+
+#if defined(__unix__) || defined(__APPLE__)
+#  include <sys/resource.h>
+#endif
+
+/*
+ * Registers a synthetic pair of 3D images with SyN, with the fields updated
+ * through new fields and in place, in double and in float precision.
+ * Compares the resulting displacement fields, and reports the time and the
+ * peak resident set size of each configuration. Also compares BSplineSyN with
+ * the fields updated in place and not.
+ */
+
+namespace
+{
+constexpr unsigned int Dimension = 3;
+using ImageType = itk::Image<float, Dimension>;
+using DoubleFieldType = itk::DisplacementFieldTransform<double, Dimension>::DisplacementFieldType;
+
+/** The peak resident set size of the process so far, in MiB, or 0 where it
+ * is not available. */
+double
+GetPeakResidentSetSize()
+{
+#if defined(__APPLE__)
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss / (1024.0 * 1024.0);
+#elif defined(__unix__)
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss / 1024.0;
+#else
+  return 0.0;
+#endif
+}
+
+template <typename TRealType>
+DoubleFieldType::Pointer
+RegisterWithSyN(const char *      name,
+                const ImageType * fixedImage,
+                const ImageType * movingImage,
+                bool              useInPlaceFieldUpdates,
+                unsigned int      maximumNumberOfIterationsForTheInverseFields)
+{
+  using OutputTransformType = itk::DisplacementFieldTransform<TRealType, Dimension>;
+  using RegistrationType = itk::SyNImageRegistrationMethod<ImageType, ImageType, OutputTransformType>;
+  using MetricType = itk::MeanSquaresImageToImageMetricv4<ImageType, ImageType, ImageType, TRealType>;
+
+  auto registration = RegistrationType::New();
+  registration->SetFixedImage(fixedImage);
+  registration->SetMovingImage(movingImage);
+  registration->SetMetric(MetricType::New());
+  registration->SetNumberOfLevels(1);
+  typename RegistrationType::ShrinkFactorsArrayType shrinkFactorsPerLevel(1);
+  shrinkFactorsPerLevel[0] = 1;
+  registration->SetShrinkFactorsPerLevel(shrinkFactorsPerLevel);
+  typename RegistrationType::SmoothingSigmasArrayType smoothingSigmasPerLevel(1);
+  smoothingSigmasPerLevel[0] = 0;
+  registration->SetSmoothingSigmasPerLevel(smoothingSigmasPerLevel);
+  typename RegistrationType::NumberOfIterationsArrayType numberOfIterationsPerLevel(1);
+  numberOfIterationsPerLevel[0] = 10;
+  registration->SetNumberOfIterationsPerLevel(numberOfIterationsPerLevel);
+  registration->SetLearningRate(0.5);
+  registration->SetUseInPlaceFieldUpdates(useInPlaceFieldUpdates);
+  registration->SetMaximumNumberOfIterationsForTheInverseFields(maximumNumberOfIterationsForTheInverseFields);
+
+  itk::TimeProbe probe;
+  probe.Start();
+  registration->Update();
+  probe.Stop();
+  std::cout << name << ": " << probe.GetTotal() << " s, peak resident set size so far "
+            << GetPeakResidentSetSize() << " MiB" << std::endl;
+
+  // The field in double precision, for the comparisons.
+  const auto * field = registration->GetModifiableTransform()->GetDisplacementField();
+  auto         doubleField = DoubleFieldType::New();
+  doubleField->CopyInformation(field);
+  doubleField->SetRegions(field->GetBufferedRegion());
+  doubleField->Allocate();
+  itk::ImageRegionConstIterator<typename OutputTransformType::DisplacementFieldType> It(field,
+                                                                                        field->GetBufferedRegion());
+  for (itk::ImageRegionIterator<DoubleFieldType> ItD(doubleField, doubleField->GetBufferedRegion()); !ItD.IsAtEnd();
+       ++ItD, ++It)
+  {
+    ItD.Set(It.Get());
+  }
+  return doubleField;
+}
+
+DoubleFieldType::Pointer
+RegisterWithBSplineSyN(const char *      name,
+                       const ImageType * fixedImage,
+                       const ImageType * movingImage,
+                       bool              useInPlaceFieldUpdates)
+{
+  using OutputTransformType = itk::BSplineSmoothingOnUpdateDisplacementFieldTransform<double, Dimension>;
+  using RegistrationType = itk::BSplineSyNImageRegistrationMethod<ImageType, ImageType, OutputTransformType>;
+  using MetricType = itk::MeanSquaresImageToImageMetricv4<ImageType, ImageType>;
+
+  auto displacementField = DoubleFieldType::New();
+  displacementField->CopyInformation(fixedImage);
+  displacementField->SetRegions(fixedImage->GetBufferedRegion());
+  displacementField->AllocateInitialized();
+  auto inverseDisplacementField = DoubleFieldType::New();
+  inverseDisplacementField->CopyInformation(fixedImage);
+  inverseDisplacementField->SetRegions(fixedImage->GetBufferedRegion());
+  inverseDisplacementField->AllocateInitialized();
+
+  auto outputTransform = OutputTransformType::New();
+  outputTransform->SetDisplacementField(displacementField);
+  outputTransform->SetInverseDisplacementField(inverseDisplacementField);
+
+  using AdaptorType = itk::BSplineSmoothingOnUpdateDisplacementFieldTransformParametersAdaptor<OutputTransformType>;
+  auto adaptor = AdaptorType::New();
+  adaptor->SetRequiredSpacing(fixedImage->GetSpacing());
+  adaptor->SetRequiredSize(fixedImage->GetBufferedRegion().GetSize());
+  adaptor->SetRequiredDirection(fixedImage->GetDirection());
+  adaptor->SetRequiredOrigin(fixedImage->GetOrigin());
+  adaptor->SetTransform(outputTransform);
+  adaptor->SetMeshSizeForTheUpdateField(itk::MakeFilled<OutputTransformType::ArrayType>(4));
+  adaptor->SetMeshSizeForTheTotalField(itk::MakeFilled<OutputTransformType::ArrayType>(0));
+  RegistrationType::TransformParametersAdaptorsContainerType adaptors;
+  adaptors.push_back(adaptor);
+
+  auto registration = RegistrationType::New();
+  registration->SetFixedImage(fixedImage);
+  registration->SetMovingImage(movingImage);
+  registration->SetMetric(MetricType::New());
+  registration->SetNumberOfLevels(1);
+  RegistrationType::ShrinkFactorsArrayType shrinkFactorsPerLevel(1);
+  shrinkFactorsPerLevel[0] = 1;
+  registration->SetShrinkFactorsPerLevel(shrinkFactorsPerLevel);
+  RegistrationType::SmoothingSigmasArrayType smoothingSigmasPerLevel(1);
+  smoothingSigmasPerLevel[0] = 0;
+  registration->SetSmoothingSigmasPerLevel(smoothingSigmasPerLevel);
+  RegistrationType::NumberOfIterationsArrayType numberOfIterationsPerLevel(1);
+  numberOfIterationsPerLevel[0] = 5;
+  registration->SetNumberOfIterationsPerLevel(numberOfIterationsPerLevel);
+  registration->SetLearningRate(0.5);
+  registration->SetTransformParametersAdaptorsPerLevel(adaptors);
+  registration->SetInitialTransform(outputTransform);
+  registration->SetUseInPlaceFieldUpdates(useInPlaceFieldUpdates);
+
+  itk::TimeProbe probe;
+  probe.Start();
+  registration->Update();
+  probe.Stop();
+  std::cout << name << ": " << probe.GetTotal() << " s" << std::endl;
+
+  return registration->GetModifiableTransform()->GetModifiableDisplacementField();
+}
+
+double
+MaximumDifference(const DoubleFieldType * field1, const DoubleFieldType * field2)
+{
+  double                                         maximumDifference = 0.0;
+  itk::ImageRegionConstIterator<DoubleFieldType> It2(field2, field2->GetBufferedRegion());
+  for (itk::ImageRegionConstIterator<DoubleFieldType> It1(field1, field1->GetBufferedRegion()); !It1.IsAtEnd();
+       ++It1, ++It2)
+  {
+    maximumDifference = std::max(maximumDifference, (It1.Get() - It2.Get()).GetNorm());
+  }
+  return maximumDifference;
+}
+} // namespace
+
+int
+itkSyNImageRegistrationInPlaceFieldUpdatesTest(int argc, char * argv[])
+{
+  const unsigned int imageSize = (argc > 1) ? std::stoi(argv[1]) : 32;
+
+  using RegistrationType = itk::SyNImageRegistrationMethod<ImageType, ImageType>;
+  auto registration = RegistrationType::New();
+  ITK_TEST_SET_GET_BOOLEAN(registration, UseInPlaceFieldUpdates, true);
+  ITK_TEST_SET_GET_BOOLEAN(registration, UseInPlaceFieldUpdates, false);
+  ITK_TEST_SET_GET_VALUE(20u, registration->GetMaximumNumberOfIterationsForTheInverseFields());
+  registration->SetMaximumNumberOfIterationsForTheInverseFields(5);
+  ITK_TEST_SET_GET_VALUE(5u, registration->GetMaximumNumberOfIterationsForTheInverseFields());
+
+  // Two blobs in the fixed image, shifted and squeezed in the moving image.
+  auto fixedImage = ImageType::New();
+  fixedImage->SetRegions(ImageType::SizeType::Filled(imageSize));
+  fixedImage->Allocate();
+  const double center = 0.5 * imageSize;
+  const double radius = 0.2 * imageSize;
+  for (itk::ImageRegionIteratorWithIndex<ImageType> It(fixedImage, fixedImage->GetBufferedRegion()); !It.IsAtEnd();
+       ++It)
+  {
+    ImageType::PointType point;
+    fixedImage->TransformIndexToPhysicalPoint(It.GetIndex(), point);
+    const double distance1 = point.EuclideanDistanceTo(itk::MakePoint(center - radius, center, center));
+    const double distance2 = point.EuclideanDistanceTo(itk::MakePoint(center + radius, center, center + 0.5 * radius));
+    It.Set(static_cast<float>(100.0 * std::exp(-itk::Math::sqr(distance1 / radius)) +
+                              60.0 * std::exp(-itk::Math::sqr(distance2 / (0.7 * radius)))));
+  }
+
+  auto deformation = itk::DisplacementFieldTransform<double, Dimension>::New();
+  auto deformationField = DoubleFieldType::New();
+  deformationField->SetRegions(fixedImage->GetBufferedRegion());
+  deformationField->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<DoubleFieldType> It(deformationField, deformationField->GetBufferedRegion());
+       !It.IsAtEnd();
+       ++It)
+  {
+    const auto & index = It.GetIndex();
+    It.Set(itk::MakeVector(1.5 * std::sin(6.0 * index[1] / imageSize),
+                           1.0 * std::cos(4.0 * index[2] / imageSize),
+                           1.0 * std::sin(5.0 * index[0] / imageSize)));
+  }
+  deformation->SetDisplacementField(deformationField);
+
+  auto resampler = itk::ResampleImageFilter<ImageType, ImageType>::New();
+  resampler->SetInput(fixedImage);
+  resampler->SetTransform(deformation);
+  resampler->SetReferenceImage(fixedImage);
+  resampler->UseReferenceImageOn();
+  resampler->Update();
+  const ImageType::Pointer movingImage = resampler->GetOutput();
+
+  // The lean configurations run first, since the peak resident set size only
+  // grows.
+  const auto leanFloatField = RegisterWithSyN<float>(
+    "In place updates, float fields, 10 inversion iterations", fixedImage, movingImage, true, 10);
+  const auto inPlaceField =
+    RegisterWithSyN<double>("In place updates, double fields", fixedImage, movingImage, true, 20);
+  const auto defaultField = RegisterWithSyN<double>("Default, double fields", fixedImage, movingImage, false, 20);
+
+  bool success = true;
+
+  const double inPlaceDifference = MaximumDifference(inPlaceField, defaultField);
+  std::cout << "Largest difference of the in place updates: " << inPlaceDifference << std::endl;
+  if (inPlaceDifference > 1e-6)
+  {
+    std::cerr << "The in place updates differ from the default" << std::endl;
+    success = false;
+  }
+
+  const double leanFloatDifference = MaximumDifference(leanFloatField, defaultField);
+  std::cout << "Largest difference of the lean float configuration: " << leanFloatDifference << std::endl;
+  if (leanFloatDifference > 0.05)
+  {
+    std::cerr << "The lean float configuration differs from the default" << std::endl;
+    success = false;
+  }
+
+  const auto bSplineInPlaceField =
+    RegisterWithBSplineSyN("BSplineSyN, in place updates", fixedImage, movingImage, true);
+  const auto bSplineDefaultField = RegisterWithBSplineSyN("BSplineSyN, default", fixedImage, movingImage, false);
+  const double bSplineInPlaceDifference = MaximumDifference(bSplineInPlaceField, bSplineDefaultField);
+  std::cout << "Largest difference of the BSplineSyN in place updates: " << bSplineInPlaceDifference << std::endl;
+  if (bSplineInPlaceDifference > 1e-6)
+  {
+    std::cerr << "The BSplineSyN in place updates differ from the default" << std::endl;
+    success = false;
+  }
+
+  for (const auto & field : { defaultField, bSplineDefaultField })
+  {
+    double                                         largestDisplacement = 0.0;
+    itk::ImageRegionConstIterator<DoubleFieldType> It(field, field->GetBufferedRegion());
+    for (; !It.IsAtEnd(); ++It)
+    {
+      largestDisplacement = std::max(largestDisplacement, It.Get().GetNorm());
+    }
+    std::cout << "Largest displacement: " << largestDisplacement << std::endl;
+    if (largestDisplacement < 0.1)
+    {
+      std::cerr << "The registration did not move" << std::endl;
+      success = false;
+    }
+  }
+
+  if (!success)
+  {
+    std::cout << "Test FAILED!" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}